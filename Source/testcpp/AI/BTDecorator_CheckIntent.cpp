@@ -2,16 +2,64 @@
 #include "AI/BTDecorator_CheckIntent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMAgentComponent.h"
+#include "AIController.h"
 
 UBTDecorator_CheckIntent::UBTDecorator_CheckIntent()
 {
 	NodeName = "Check Intent";
 	
 	// Set default blackboard key
+	IntentKey.AddNameFilter(this, GET_MEMBER_NAME_CHECKED(UBTDecorator_CheckIntent, IntentKey));
 	IntentKey.AddStringFilter(this, GET_MEMBER_NAME_CHECKED(UBTDecorator_CheckIntent, IntentKey));
 	
 	// Default expected intent
 	ExpectedIntent = TEXT("MoveTo");
+
+	// Needed to report branch results to the plan queue
+	bNotifyActivation = true;
+	bNotifyDeactivation = true;
+
+	// Observe the Intent key while relevant; aborting on a change is opt-in through FlowAbortMode
+	bNotifyBecomeRelevant = true;
+	bNotifyCeaseRelevant = true;
+	FlowAbortMode = EBTFlowAbortMode::None;
+}
+
+void UBTDecorator_CheckIntent::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	if (const UBlackboardData* BBAsset = GetBlackboardAsset())
+	{
+		IntentKey.ResolveSelectedKey(*BBAsset);
+	}
+
+	// Resolve both forms of the expected intent once
+	const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+	const ULLMIntentDefinition* Definition = nullptr;
+	if (Registry)
+	{
+		Definition = ExpectedIntentTag.IsValid() ? Registry->FindByTag(ExpectedIntentTag) : Registry->FindByWireName(ExpectedIntent);
+	}
+
+	if (Definition)
+	{
+		ExpectedTagName = Definition->IntentTag.GetTagName();
+		ExpectedWireName = Definition->GetWireName();
+	}
+	else
+	{
+		ExpectedTagName = ExpectedIntentTag.GetTagName();
+		ExpectedWireName = ExpectedIntentTag.IsValid() ? ExpectedIntentTag.GetTagLeafName().ToString() : ExpectedIntent;
+	}
+
+	bIntentIsName = IntentKey.SelectedKeyType == UBlackboardKeyType_Name::StaticClass();
 }
 
 bool UBTDecorator_CheckIntent::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
@@ -22,19 +70,109 @@ bool UBTDecorator_CheckIntent::CalculateRawConditionValue(UBehaviorTreeComponent
 		return false;
 	}
 
-	FString CurrentIntent = BlackboardComp->GetValueAsString(IntentKey.SelectedKeyName);
-	bool bMatches = CurrentIntent.Equals(ExpectedIntent, ESearchCase::IgnoreCase);
+	bool bMatches;
+	if (bIntentIsName)
+	{
+		bMatches = BlackboardComp->GetValue<UBlackboardKeyType_Name>(IntentKey.GetSelectedKeyID()) == ExpectedTagName;
+	}
+	else
+	{
+		bMatches = BlackboardComp->GetValue<UBlackboardKeyType_String>(IntentKey.GetSelectedKeyID()).Equals(ExpectedWireName, ESearchCase::IgnoreCase);
+	}
 
 	if (bMatches)
 	{
-		UE_LOG(LogTemp, Verbose, TEXT("[BTDecorator_CheckIntent] Intent '%s' matches expected '%s'"), 
-			*CurrentIntent, *ExpectedIntent);
+		UE_LOG(LogTemp, Verbose, TEXT("[BTDecorator_CheckIntent] Intent matches expected '%s'"), *ExpectedWireName);
 	}
 
 	return bMatches;
 }
 
+void UBTDecorator_CheckIntent::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	// A change could not abort anything, so there is nothing to observe
+	if (FlowAbortMode == EBTFlowAbortMode::None)
+	{
+		return;
+	}
+
+	if (UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent())
+	{
+		BlackboardComp->RegisterObserver(IntentKey.GetSelectedKeyID(), this,
+			FOnBlackboardChangeNotification::CreateUObject(this, &UBTDecorator_CheckIntent::OnIntentKeyChanged));
+	}
+}
+
+void UBTDecorator_CheckIntent::OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	if (FlowAbortMode == EBTFlowAbortMode::None)
+	{
+		return;
+	}
+
+	if (UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent())
+	{
+		BlackboardComp->UnregisterObserversFrom(this);
+	}
+}
+
+EBlackboardNotificationResult UBTDecorator_CheckIntent::OnIntentKeyChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID)
+{
+	UBehaviorTreeComponent* BehaviorComp = Cast<UBehaviorTreeComponent>(Blackboard.GetBrainComponent());
+	if (!BehaviorComp)
+	{
+		return EBlackboardNotificationResult::RemoveObserver;
+	}
+
+	// Only acts when the condition flipped and FlowAbortMode allows aborting the affected branch
+	if (ChangedKeyID == IntentKey.GetSelectedKeyID())
+	{
+		ConditionalFlowAbort(*BehaviorComp, EBTDecoratorAbortRequest::ConditionResultChanged);
+	}
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+void UBTDecorator_CheckIntent::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FNodeMemory>(NodeMemory, InitType);
+}
+
+void UBTDecorator_CheckIntent::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FNodeMemory>(NodeMemory, CleanupType);
+}
+
+void UBTDecorator_CheckIntent::OnNodeActivation(FBehaviorTreeSearchData& SearchData)
+{
+	const ULLMAgentComponent* Agent = bAdvancePlanOnFinish ? ULLMAgentComponent::FindForActor(SearchData.OwnerComp.GetAIOwner()) : nullptr;
+	GetNodeMemory<FNodeMemory>(SearchData)->StepSequence = Agent ? Agent->GetCurrentStepSequence() : INDEX_NONE;
+}
+
+void UBTDecorator_CheckIntent::OnNodeDeactivation(FBehaviorTreeSearchData& SearchData, EBTNodeResult::Type NodeResult)
+{
+	FNodeMemory* Memory = GetNodeMemory<FNodeMemory>(SearchData);
+	const int32 StepSequence = Memory->StepSequence;
+	Memory->StepSequence = INDEX_NONE;
+
+	// Aborted branches (e.g. the plan already moved on) are not step outcomes
+	if (!bAdvancePlanOnFinish || StepSequence == INDEX_NONE || (NodeResult != EBTNodeResult::Succeeded && NodeResult != EBTNodeResult::Failed))
+	{
+		return;
+	}
+
+	// Only the step this branch started for is reported; the agent writes the next step after the search
+	if (ULLMAgentComponent* Agent = ULLMAgentComponent::FindForActor(SearchData.OwnerComp.GetAIOwner()))
+	{
+		Agent->ReportStepResult(StepSequence, NodeResult == EBTNodeResult::Succeeded);
+	}
+}
+
 FString UBTDecorator_CheckIntent::GetStaticDescription() const
 {
-	return FString::Printf(TEXT("Check if Intent == '%s'"), *ExpectedIntent);
+	// Super adds the abort mode and inversion
+	if (ExpectedIntentTag.IsValid())
+	{
+		return FString::Printf(TEXT("%s: Check if Intent == %s"), *Super::GetStaticDescription(), *ExpectedIntentTag.ToString());
+	}
+	return FString::Printf(TEXT("%s: Check if Intent == '%s'"), *Super::GetStaticDescription(), *ExpectedIntent);
 }
@@ -3,11 +3,17 @@
 
 #include "CoreMinimal.h"
 #include "BehaviorTree/BTDecorator.h"
+#include "GameplayTagContainer.h"
 #include "BTDecorator_CheckIntent.generated.h"
 
 /**
  * Decorator that checks if the Intent blackboard key matches expected value
  * Used to branch behavior tree execution based on LLM intent
+ * Name keys are compared against the intent tag, String keys against the wire name
+ * When the branch finishes, the outcome is reported to the agent's plan queue (ULLMAgentComponent)
+ * With an Observer Aborts mode it observes the Intent key while relevant, so a new intent aborts
+ * the running branch (or a lower-priority one) as soon as it is written; nothing polls the key.
+ * Without one it registers no observer.
  */
 UCLASS()
 class TESTCPP_API UBTDecorator_CheckIntent : public UBTDecorator
@@ -17,15 +23,46 @@ class TESTCPP_API UBTDecorator_CheckIntent : public UBTDecorator
 public:
 	UBTDecorator_CheckIntent();
 
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
 	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
 	virtual FString GetStaticDescription() const override;
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FNodeMemory); }
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 
 protected:
-	// Blackboard key for the intent (should be String type)
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnNodeActivation(FBehaviorTreeSearchData& SearchData) override;
+	virtual void OnNodeDeactivation(FBehaviorTreeSearchData& SearchData, EBTNodeResult::Type NodeResult) override;
+
+	// Blackboard key for the intent (Name or String type)
 	UPROPERTY(EditAnywhere, Category = "Blackboard")
 	FBlackboardKeySelector IntentKey;
 
-	// Expected intent value to match
+	// Expected intent tag; takes precedence over ExpectedIntent when set
+	UPROPERTY(EditAnywhere, Category = "Condition", meta = (Categories = "LLM.Intent"))
+	FGameplayTag ExpectedIntentTag;
+
+	// Expected intent wire name (legacy; used when ExpectedIntentTag is not set)
 	UPROPERTY(EditAnywhere, Category = "Condition")
 	FString ExpectedIntent;
+
+	// Report branch success/failure to the agent's plan so the next step is written
+	UPROPERTY(EditAnywhere, Category = "Plan")
+	bool bAdvancePlanOnFinish = true;
+
+private:
+	struct FNodeMemory
+	{
+		// Agent's step sequence when the branch started: the step this branch runs
+		int32 StepSequence = INDEX_NONE;
+	};
+
+	EBlackboardNotificationResult OnIntentKeyChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID);
+
+	// Resolved in InitializeFromAsset so evaluation does no lookups
+	FName ExpectedTagName;
+	FString ExpectedWireName;
+	bool bIntentIsName = false;
 };
@@ -3,6 +3,7 @@
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "AIController.h"
+#include "LLM/LLMInteractableRegistry.h"
 #include "GameFramework/Actor.h"
 
 UBTTask_InteractTarget::UBTTask_InteractTarget()
@@ -35,7 +36,17 @@ EBTNodeResult::Type UBTTask_InteractTarget::ExecuteTask(UBehaviorTreeComponent&
 
 	// Try to get target actor from blackboard
 	AActor* TargetActor = Cast<AActor>(BlackboardComp->GetValueAsObject(TargetActorKey.SelectedKeyName));
-	
+
+	// Otherwise resolve TargetId, then the nearest target of TargetType, through the interactable registry
+	if (!TargetActor)
+	{
+		TargetActor = ResolveTarget(*BlackboardComp, ControlledPawn ? ControlledPawn->GetActorLocation() : AIController->GetActorLocation());
+		if (TargetActor)
+		{
+			BlackboardComp->SetValueAsObject(TargetActorKey.SelectedKeyName, TargetActor);
+		}
+	}
+
 	if (TargetActor)
 	{
 		// MVP implementation: Just log the interaction
@@ -57,27 +68,36 @@ EBTNodeResult::Type UBTTask_InteractTarget::ExecuteTask(UBehaviorTreeComponent&
 	}
 	else
 	{
-		// Fallback: try to use TargetId or TargetType to find an actor
-		FString TargetId = BlackboardComp->GetValueAsString(TargetIdKey.SelectedKeyName);
-		FString TargetType = BlackboardComp->GetValueAsString(TargetTypeKey.SelectedKeyName);
-		
-		if (!TargetId.IsEmpty())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("[BTTask_InteractTarget] TargetActor not set, but TargetId='%s' found. Need to resolve to actor."), *TargetId);
-			// In a full implementation, you would query a registry or world to find the actor by ID
-		}
-		
-		if (!TargetType.IsEmpty())
-		{
-			UE_LOG(LogTemp, Warning, TEXT("[BTTask_InteractTarget] Could search for nearest actor of type '%s'"), *TargetType);
-			// In a full implementation, you would find the nearest interactable of this type
-		}
-		
-		UE_LOG(LogTemp, Error, TEXT("[BTTask_InteractTarget] No valid target to interact with"));
+		UE_LOG(LogTemp, Error, TEXT("[BTTask_InteractTarget] No valid target to interact with (TargetId='%s', TargetType='%s')"),
+			*BlackboardComp->GetValueAsString(TargetIdKey.SelectedKeyName), *BlackboardComp->GetValueAsString(TargetTypeKey.SelectedKeyName));
 		return EBTNodeResult::Failed;
 	}
 }
 
+AActor* UBTTask_InteractTarget::ResolveTarget(const UBlackboardComponent& BlackboardComp, const FVector& Origin) const
+{
+	ULLMInteractableRegistry* Registry = ULLMInteractableRegistry::Get(BlackboardComp.GetOwner());
+	if (!Registry)
+	{
+		return nullptr;
+	}
+
+	const FString TargetId = BlackboardComp.GetValueAsString(TargetIdKey.SelectedKeyName);
+	if (AActor* Actor = TargetId.IsEmpty() ? nullptr : Registry->FindById(TargetId))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[BTTask_InteractTarget] Resolved TargetId '%s' to %s"), *TargetId, *Actor->GetName());
+		return Actor;
+	}
+
+	const FString TargetType = BlackboardComp.GetValueAsString(TargetTypeKey.SelectedKeyName);
+	if (AActor* Actor = TargetType.IsEmpty() ? nullptr : Registry->FindNearest(TargetType, Origin, MaxSearchDistance))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[BTTask_InteractTarget] Nearest '%s' is %s"), *TargetType, *Actor->GetName());
+		return Actor;
+	}
+	return nullptr;
+}
+
 FString UBTTask_InteractTarget::GetStaticDescription() const
 {
 	return FString::Printf(TEXT("Interact with target actor from blackboard\nActor Key: %s\nID Key: %s\nType Key: %s"),
@@ -5,9 +5,12 @@
 #include "BehaviorTree/BTTaskNode.h"
 #include "BTTask_InteractTarget.generated.h"
 
+class UBlackboardComponent;
+
 /**
  * Behavior Tree task that interacts with the target actor
- * Requires TargetActor to be set in Blackboard
+ * Uses TargetActor when set; otherwise resolves TargetId, then the nearest target of TargetType,
+ * through ULLMInteractableRegistry and writes the result back to TargetActor
  * For MVP, logs the interaction; can be extended to call IInteractable interface
  */
 UCLASS()
@@ -30,7 +33,14 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Blackboard")
 	FBlackboardKeySelector TargetIdKey;
 
-	// Blackboard key for target type (additional context)
+	// Blackboard key for target type (nearest target of this type when no id resolves)
 	UPROPERTY(EditAnywhere, Category = "Blackboard")
 	FBlackboardKeySelector TargetTypeKey;
+
+	// How far to look for a target of TargetType (cm); 0 is unlimited
+	UPROPERTY(EditAnywhere, Category = "Interaction", meta = (ClampMin = "0.0"))
+	float MaxSearchDistance = 0.0f;
+
+private:
+	AActor* ResolveTarget(const UBlackboardComponent& BlackboardComp, const FVector& Origin) const;
 };
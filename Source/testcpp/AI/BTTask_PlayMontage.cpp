@@ -1,5 +1,6 @@
 // Behavior Tree task to play an animation montage on the AI character
 #include "AI/BTTask_PlayMontage.h"
+#include "LLM/LLMWorldVocabulary.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "AIController.h"
@@ -119,6 +120,47 @@ EBTNodeResult::Type UBTTask_PlayMontage::ExecuteTask(UBehaviorTreeComponent& Own
 	return EBTNodeResult::Succeeded;
 }
 
+void UBTTask_PlayMontage::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	Super::InitializeMemory(OwnerComp, NodeMemory, InitType);
+
+	// RestoreSubtree re-initializes memory that was only stored, not destroyed
+	if (InitType != EBTMemoryInit::Initialize)
+	{
+		return;
+	}
+
+	if (ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(&OwnerComp))
+	{
+		for (const FNamedMontage& Entry : MontageMap)
+		{
+			if (!Entry.Montage.IsNull())
+			{
+				Vocabulary->RegisterName(ELLMVocabularyCategory::Montage, Entry.Name);
+			}
+		}
+	}
+}
+
+void UBTTask_PlayMontage::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	if (CleanupType == EBTMemoryClear::Destroy)
+	{
+		if (ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(&OwnerComp))
+		{
+			for (const FNamedMontage& Entry : MontageMap)
+			{
+				if (!Entry.Montage.IsNull())
+				{
+					Vocabulary->UnregisterName(ELLMVocabularyCategory::Montage, Entry.Name);
+				}
+			}
+		}
+	}
+
+	Super::CleanupMemory(OwnerComp, NodeMemory, CleanupType);
+}
+
 FString UBTTask_PlayMontage::GetStaticDescription() const
 {
 	return FString::Printf(TEXT("Play animation montage from blackboard\nMontage Key: %s\nSection Key: %s\nPlay Rate Key: %s\nLoop Key: %s\nWait for Finish: %s\nMapping Count: %d"),
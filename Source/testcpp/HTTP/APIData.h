@@ -6,6 +6,20 @@
 #include "Engine/DataAsset.h"
 #include "APIData.generated.h"
 
+/**
+ * Backend that serves requests for an endpoint profile
+ */
+UENUM(BlueprintType)
+enum class ELLMProvider : uint8
+{
+	// Google Gemini generateContent over HTTP
+	Gemini UMETA(DisplayName = "Gemini"),
+	// In-process runtime (ULLMLocalProvider); URL and APIKey are ignored, Model is passed to the runtime
+	Local UMETA(DisplayName = "Local"),
+	// OpenAI-style /v1/chat/completions (self-hosted inference servers); URL is the /v1 base, APIKey is sent as a bearer token
+	OpenAICompatible UMETA(DisplayName = "OpenAI Compatible")
+};
+
 /**
  * 
  */
@@ -28,6 +42,12 @@ public:
 	UFUNCTION(BlueprintPure, Category="API Data")
 	FString GetModel() const { return Model; }
 
+	UFUNCTION(BlueprintPure, Category="API Data")
+	ELLMProvider GetProvider() const { return Provider; }
+
+	UFUNCTION(BlueprintPure, Category="API Data")
+	int32 GetMaxInputTokens() const { return MaxInputTokens; }
+
 protected:
 	// Name of the API, not used in code
 	UPROPERTY(EditDefaultsOnly, Category="API Data")
@@ -41,5 +61,12 @@ protected:
 
 	UPROPERTY(EditDefaultsOnly, Category="API Data")
 	FString Model;
+
+	UPROPERTY(EditDefaultsOnly, Category="API Data")
+	ELLMProvider Provider = ELLMProvider::Gemini;
+
+	// Input token budget per request (system prompt, schema, context and user prompt); context is trimmed to fit. 0 = no limit
+	UPROPERTY(EditDefaultsOnly, Category="API Data", meta=(ClampMin="0"))
+	int32 MaxInputTokens = 0;
 	
 };
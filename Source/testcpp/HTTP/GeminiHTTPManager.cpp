@@ -1,5 +1,12 @@
 ﻿#include "HTTP/GeminiHTTPManager.h"
 #include "HTTP/APIData.h"
+#include "HTTP/LLMProviderAdapter.h"
+#include "LLM/LLMLocalProvider.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Paths.h"
 #include "HttpModule.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
@@ -8,117 +15,383 @@
 #include "Serialization/JsonWriter.h"
 #include "GenericPlatform/GenericPlatformHttp.h"
 
+void UGeminiHTTPManager::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	if (!Settings->bEnableSharedResponseCache)
+	{
+		return;
+	}
+
+	FString Path = Settings->SharedResponseCachePath;
+	if (Path.IsEmpty())
+	{
+		Path = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LLM"), TEXT("SharedResponses.cache"));
+	}
+	else if (FPaths::IsRelative(Path))
+	{
+		Path = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), Path);
+	}
+
+	SharedCache = FLLMSharedResponseCache::Attach(Path, Settings->SharedResponseCacheSlots, Settings->SharedResponseCacheSlotBytes,
+		Settings->SharedResponseCacheTTLSeconds);
+}
+
+void UGeminiHTTPManager::Deinitialize()
+{
+	SharedCache.Reset();
+	Super::Deinitialize();
+}
+
+bool UGeminiHTTPManager::GetSharedCacheStats(FLLMSharedResponseCache::FStats& OutStats) const
+{
+	if (!SharedCache)
+	{
+		return false;
+	}
+	OutStats = SharedCache->GetStats();
+	return true;
+}
+
 void UGeminiHTTPManager::InitializeWithData(UAPIData* InAPIData)
 {
 	APIData = InAPIData;
 }
 
-void UGeminiHTTPManager::GenerateContent(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FOnGeminiResponse& OnDone)
+int32 UGeminiHTTPManager::GenerateContent(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FOnGeminiResponse& OnDone)
 {
 	if (!APIData)
 	{
 		UE_LOG(LogTemp, Error, TEXT("[GeminiHTTP] Not initialized: APIData is null"));
 		OnDone.ExecuteIfBound(false, TEXT("{""error"": ""No APIData""}"));
-		return;
+		return 0;
+	}
+
+	// response schema (optional): pre-built object, else the parsed string form
+	TSharedPtr<FJsonObject> SchemaObj = Config.ResponseSchema;
+	if (!SchemaObj.IsValid() && !Config.ResponseSchemaJson.IsEmpty())
+	{
+		SchemaObj = GetParsedResponseSchema(Config.ResponseSchemaJson);
+	}
+
+	// Size the prompt before it leaves: context sections are trimmed to the profile's input budget
+	const FString EstimatorModel = APIData->GetModel().IsEmpty() ? Config.Model : APIData->GetModel();
+	FLLMTokenEstimator& Estimator = TokenEstimators.FindOrAdd(EstimatorModel);
+	int32 FixedRawTokens = FLLMTokenEstimator::EstimateRaw(Config.SystemInstruction) + GetSchemaRawTokens(SchemaObj);
+	for (const FLLMConversationTurn& Turn : Config.History)
+	{
+		FixedRawTokens += FLLMTokenEstimator::EstimateRaw(Turn.Text);
+	}
+	TArray<FLLMPromptSection> Sections = Config.ContextSections;
+	FString TrimmedPrompt = UserPrompt;
+	int32 TrimmedSections = 0;
+	bool bPromptTruncated = false;
+	const int32 Budget = APIData->GetMaxInputTokens();
+	const int32 VariableTokens = Estimator.FitToBudget(Budget, Estimator.Scale(FixedRawTokens), Sections, TrimmedPrompt, TrimmedSections, bPromptTruncated);
+	const FString Prompt = FLLMTokenEstimator::Compose(Sections, TrimmedPrompt);
+	const int32 RawPromptTokens = FixedRawTokens + FLLMTokenEstimator::EstimateRaw(Prompt);
+
+	++PromptStats.Requests;
+	if (TrimmedSections > 0 || bPromptTruncated)
+	{
+		++PromptStats.OverBudget;
+		PromptStats.SectionsTrimmed += TrimmedSections;
+		PromptStats.PromptsTruncated += bPromptTruncated ? 1 : 0;
+		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] Prompt over the %d token input budget: trimmed %d context sections%s, now ~%d tokens"),
+			Budget, TrimmedSections, bPromptTruncated ? TEXT(" and the prompt") : TEXT(""), Estimator.Scale(FixedRawTokens) + VariableTokens);
+	}
+
+	// In-process provider: same response shape, no HTTP
+	if (APIData->GetProvider() == ELLMProvider::Local)
+	{
+		ULLMLocalProvider* LocalProvider = GetGameInstance()->GetSubsystem<ULLMLocalProvider>();
+		if (!LocalProvider)
+		{
+			UE_LOG(LogTemp, Error, TEXT("[GeminiHTTP] Local provider requested but ULLMLocalProvider is unavailable"));
+			OnDone.ExecuteIfBound(false, TEXT("{""error"": ""No local provider""}"));
+			return 0;
+		}
+		LocalProvider->GenerateContent(APIData->GetModel(), Prompt, Config, OnDone);
+		return 0;
 	}
 
-	// Prefer model from APIData, then Config, then default
+	const ILLMProviderAdapter* Adapter = ILLMProviderAdapter::Get(APIData->GetProvider());
+	check(Adapter);
+
+	// Prefer model from APIData, then the provider's fallback (Config, then default for Gemini)
 	FString EffectiveModel = APIData->GetModel();
 	if (EffectiveModel.IsEmpty())
 	{
-		EffectiveModel = Config.Model.IsEmpty() ? TEXT("gemini-1.5-flash") : Config.Model;
+		EffectiveModel = Adapter->GetFallbackModel(Config);
+	}
+	if (EffectiveModel.IsEmpty())
+	{
+		UE_LOG(LogTemp, Error, TEXT("[GeminiHTTP] %s has no Model; OpenAI-compatible endpoints need the model name the server serves"), *APIData->GetName());
+		OnDone.ExecuteIfBound(false, TEXT("{""error"": ""No model configured for this provider""}"));
+		return 0;
 	}
 
-	FString Url = BuildGenerateUrl(EffectiveModel);
+	const FString Url = Adapter->BuildUrl(*APIData, EffectiveModel);
 	FString Payload;
-	if (!BuildGeneratePayload(UserPrompt, Config, Payload))
+	if (!Adapter->BuildPayload(Prompt, Config, EffectiveModel, SchemaObj, Payload))
 	{
 		UE_LOG(LogTemp, Error, TEXT("[GeminiHTTP] Failed to build request payload"));
 		OnDone.ExecuteIfBound(false, TEXT("{""error"": ""Failed to build payload""}"));
-		return;
+		return 0;
+	}
+
+	// The Gemini adapter puts the key in the query string; keep it out of the log
+	FString LoggedUrl = Url;
+	if (!APIData->GetAPIKey().IsEmpty())
+	{
+		LoggedUrl.ReplaceInline(*FGenericPlatformHttp::UrlEncode(APIData->GetAPIKey()), TEXT("***"));
+	}
+
+	// Identical structured requests from any game process on this host share one response
+	const uint64 SharedCacheKey = SharedCache && Config.bForceJsonResponse ? FLLMSharedResponseCache::MakeKey(LoggedUrl, Payload) : 0;
+	FString SharedBody;
+	if (SharedCacheKey != 0 && SharedCache->Find(SharedCacheKey, SharedBody))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Served from the shared response cache"));
+		OnDone.ExecuteIfBound(true, SharedBody);
+		return 0;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Request URL: %s"), *Url);
+	UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Request URL: %s"), *LoggedUrl);
 	UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Request Payload: %s"), *Payload);
 
 	FHttpModule& Http = FHttpModule::Get();
 	TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = Http.CreateRequest();
 
-	// Some Gemini endpoints accept API key via query string: ?key=API_KEY
-	if (!APIData->GetAPIKey().IsEmpty())
-	{
-		const TCHAR* Delim = Url.Contains(TEXT("?")) ? TEXT("&") : TEXT("?");
-		const FString EncKey = FGenericPlatformHttp::UrlEncode(APIData->GetAPIKey());
-		Url += FString::Printf(TEXT("%skey=%s"), Delim, *EncKey);
-	}
-
 	Request->SetURL(Url);
 	Request->SetVerb(TEXT("POST"));
-	Request->SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+	Adapter->ApplyHeaders(*Request, *APIData);
 	Request->SetContentAsString(Payload);
 
-	Request->OnProcessRequestComplete().BindUObject(this, &UGeminiHTTPManager::HandleResponse, OnDone);
+	// Ids wrap but skip 0, which means "no handle"
+	LastRequestId = LastRequestId == MAX_int32 ? 1 : LastRequestId + 1;
+	const int32 RequestId = LastRequestId;
+	ActiveRequests.Add(RequestId, Request);
+	++SentRequestCount;
+
+	Request->OnProcessRequestComplete().BindUObject(this, &UGeminiHTTPManager::HandleResponse, OnDone, Adapter, SharedCacheKey, RequestId,
+		EstimatorModel, RawPromptTokens);
 	Request->ProcessRequest();
+	return RequestId;
 }
 
-bool UGeminiHTTPManager::TryExtractTextFromResponse(const FString& Json, FString& OutText)
+bool UGeminiHTTPManager::CancelRequest(int32 RequestId)
 {
-	OutText.Empty();
-	TSharedPtr<FJsonObject> RootObj;
-	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
-	if (!FJsonSerializer::Deserialize(Reader, RootObj) || !RootObj.IsValid())
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe>* Found = ActiveRequests.Find(RequestId);
+	if (!Found)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: Failed to parse JSON"));
 		return false;
 	}
+	const TSharedRef<IHttpRequest, ESPMode::ThreadSafe> Request = *Found;
+	ActiveRequests.Remove(RequestId);
 
-	const TArray<TSharedPtr<FJsonValue>>* CandidatesArr = nullptr;
-	if (!RootObj->TryGetArrayField(TEXT("candidates"), CandidatesArr) || CandidatesArr == nullptr || CandidatesArr->Num() == 0)
+	UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Cancelling request %d"), RequestId);
+	Request->OnProcessRequestComplete().Unbind();
+	Request->CancelRequest();
+	return true;
+}
+
+namespace GeminiHTTPManagerPrivate
+{
+	// Only complete, parseable answers are shared: every process on the host would replay a bad one until it expires
+	static bool IsShareableResponse(const FString& Body)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: No candidates found"));
-		return false;
+		FGeminiResponseUsage Usage;
+		FString Json;
+		TSharedPtr<FJsonObject> Object;
+		return UGeminiHTTPManager::TryExtractUsage(Body, Usage) && Usage.TruncatedCandidates == 0
+			&& UGeminiHTTPManager::TryExtractStructuredJsonString(Body, Json)
+			&& FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Object) && Object.IsValid();
 	}
 
-	// Typically take first candidate
-	const TSharedPtr<FJsonObject>* CandidateObjPtr = nullptr;
-	if (!(*CandidatesArr)[0]->TryGetObject(CandidateObjPtr) || CandidateObjPtr == nullptr)
+	static void LogSharedCacheStats(UWorld* World)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: First candidate invalid"));
-		return false;
+		const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(World);
+		const UGeminiHTTPManager* Manager = GameInstance ? GameInstance->GetSubsystem<UGeminiHTTPManager>() : nullptr;
+		FLLMSharedResponseCache::FStats Stats;
+		if (!Manager || !Manager->GetSharedCacheStats(Stats))
+		{
+			UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Shared response cache is not attached"));
+			return;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Shared cache: this process %lld/%lld hits, %lld inserts (%lld skipped) | host %lld hits, %lld inserts"),
+			Stats.Hits, Stats.Lookups, Stats.Inserts, Stats.SkippedInserts, Stats.HostHits, Stats.HostInserts);
 	}
-	const FJsonObject& CandidateObj = *CandidateObjPtr->Get();
 
-	const TSharedPtr<FJsonObject>* ContentObjPtr = nullptr;
-	if (!CandidateObj.TryGetObjectField(TEXT("content"), ContentObjPtr) || ContentObjPtr == nullptr)
+	static FAutoConsoleCommandWithWorld LogSharedCacheStatsCommand(
+		TEXT("LLM.SharedCacheStats"),
+		TEXT("Log hit counts of the host-wide shared response cache"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogSharedCacheStats));
+
+	static void LogPromptBudgetStats(UWorld* World)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: No content field"));
-		return false;
+		const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(World);
+		const UGeminiHTTPManager* Manager = GameInstance ? GameInstance->GetSubsystem<UGeminiHTTPManager>() : nullptr;
+		if (!Manager)
+		{
+			return;
+		}
+
+		const FLLMPromptBudgetStats Stats = Manager->GetPromptBudgetStats();
+		UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Prompts: %d sent, %d measured | estimated %lld vs actual %lld tokens (mean error %.1f%%) | %d over budget, %d sections trimmed, %d prompts cut"),
+			Stats.Requests, Stats.Measured, Stats.EstimatedTokens, Stats.ActualTokens,
+			Stats.ActualTokens > 0 ? 100.0 * Stats.AbsoluteError / Stats.ActualTokens : 0.0,
+			Stats.OverBudget, Stats.SectionsTrimmed, Stats.PromptsTruncated);
+		for (const TPair<FString, FLLMTokenEstimator>& Pair : Manager->GetTokenEstimators())
+		{
+			UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP]   %s: scale %.3f from %d responses"),
+				Pair.Key.IsEmpty() ? TEXT("(default model)") : *Pair.Key, Pair.Value.GetScale(), Pair.Value.GetNumCalibrations());
+		}
 	}
-	const FJsonObject& ContentObj = *ContentObjPtr->Get();
 
-	const TArray<TSharedPtr<FJsonValue>>* PartsArr = nullptr;
-	if (!ContentObj.TryGetArrayField(TEXT("parts"), PartsArr) || PartsArr == nullptr)
+	static FAutoConsoleCommandWithWorld LogPromptBudgetStatsCommand(
+		TEXT("LLM.PromptBudgetStats"),
+		TEXT("Log estimated versus reported prompt tokens and input budget trimming"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogPromptBudgetStats));
+
+	static bool IsValidJson(const FString& Text)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: No parts array"));
-		return false;
+		{
+			TSharedPtr<FJsonObject> Obj;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+			if (FJsonSerializer::Deserialize(Reader, Obj) && Obj.IsValid())
+			{
+				return true;
+			}
+		}
+		{
+			TArray<TSharedPtr<FJsonValue>> Arr;
+			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Text);
+			return FJsonSerializer::Deserialize(Reader, Arr);
+		}
 	}
 
-	FString Accum;
-	for (const TSharedPtr<FJsonValue>& PartVal : *PartsArr)
+	// Concatenate candidate.content.parts[].text
+	static bool ExtractCandidateText(const FJsonObject& CandidateObj, FString& OutText)
 	{
-		if (!PartVal.IsValid()) continue;
-		const TSharedPtr<FJsonObject>* PartObjPtr = nullptr;
-		if (PartVal->TryGetObject(PartObjPtr) && PartObjPtr && PartObjPtr->IsValid())
+		OutText.Empty();
+
+		const TSharedPtr<FJsonObject>* ContentObjPtr = nullptr;
+		if (!CandidateObj.TryGetObjectField(TEXT("content"), ContentObjPtr) || ContentObjPtr == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: No content field"));
+			return false;
+		}
+		const FJsonObject& ContentObj = *ContentObjPtr->Get();
+
+		const TArray<TSharedPtr<FJsonValue>>* PartsArr = nullptr;
+		if (!ContentObj.TryGetArrayField(TEXT("parts"), PartsArr) || PartsArr == nullptr)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: No parts array"));
+			return false;
+		}
+
+		for (const TSharedPtr<FJsonValue>& PartVal : *PartsArr)
 		{
-			FString Text;
-			if ((*PartObjPtr)->TryGetStringField(TEXT("text"), Text))
+			if (!PartVal.IsValid()) continue;
+			const TSharedPtr<FJsonObject>* PartObjPtr = nullptr;
+			if (PartVal->TryGetObject(PartObjPtr) && PartObjPtr && PartObjPtr->IsValid())
 			{
-				Accum += Text;
+				FString Text;
+				if ((*PartObjPtr)->TryGetStringField(TEXT("text"), Text))
+				{
+					OutText += Text;
+				}
 			}
 		}
+		return !OutText.IsEmpty();
 	}
 
-	OutText = Accum;
+	// Heuristic: extract the first top-level JSON object/array substring
+	static bool ExtractJsonSegment(const FString& Source, FString& OutJsonString)
+	{
+		int32 Start = INDEX_NONE;
+		int32 End = INDEX_NONE;
+		for (int32 i = 0; i < Source.Len(); ++i)
+		{
+			TCHAR C = Source[i];
+			if (C == TEXT('{') || C == TEXT('[')) { Start = i; break; }
+		}
+		if (Start == INDEX_NONE) return false;
+
+		// Find matching closing brace/bracket using a simple stack counter
+		TCHAR Open = Source[Start];
+		TCHAR Close = (Open == TEXT('{')) ? TEXT('}') : TEXT(']');
+		int32 Depth = 0;
+		for (int32 i = Start; i < Source.Len(); ++i)
+		{
+			TCHAR C = Source[i];
+			if (C == Open) Depth++;
+			else if (C == Close) {
+				Depth--;
+				if (Depth == 0) { End = i; break; }
+			}
+		}
+		if (End == INDEX_NONE) return false;
+
+		// Validate that the candidate is valid JSON (object or array)
+		FString Candidate = Source.Mid(Start, End - Start + 1);
+		if (IsValidJson(Candidate))
+		{
+			OutJsonString = MoveTemp(Candidate);
+			return true;
+		}
+		return false;
+	}
+
+	// Parsed "candidates" array of a generateContent response body, or null
+	static const TArray<TSharedPtr<FJsonValue>>* GetCandidates(const FString& Json, TSharedPtr<FJsonObject>& OutRoot)
+	{
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Json);
+		if (!FJsonSerializer::Deserialize(Reader, OutRoot) || !OutRoot.IsValid())
+		{
+			return nullptr;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* CandidatesArr = nullptr;
+		if (!OutRoot->TryGetArrayField(TEXT("candidates"), CandidatesArr) || CandidatesArr == nullptr || CandidatesArr->Num() == 0)
+		{
+			return nullptr;
+		}
+		return CandidatesArr;
+	}
+}
+
+bool UGeminiHTTPManager::TryExtractTextFromResponse(const FString& Json, FString& OutText)
+{
+	using namespace GeminiHTTPManagerPrivate;
+
+	OutText.Empty();
+	TSharedPtr<FJsonObject> RootObj;
+	const TArray<TSharedPtr<FJsonValue>>* CandidatesArr = GetCandidates(Json, RootObj);
+	if (!RootObj.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: Failed to parse JSON"));
+		return false;
+	}
+	if (!CandidatesArr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: No candidates found"));
+		return false;
+	}
+
+	// Typically take first candidate
+	const TSharedPtr<FJsonObject>* CandidateObjPtr = nullptr;
+	if (!(*CandidatesArr)[0]->TryGetObject(CandidateObjPtr) || CandidateObjPtr == nullptr)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] TryExtractText: First candidate invalid"));
+		return false;
+	}
+
+	ExtractCandidateText(*CandidateObjPtr->Get(), OutText);
 	if (!OutText.IsEmpty())
 	{
 		UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Extracted text: %s"), *OutText);
@@ -128,6 +401,8 @@ bool UGeminiHTTPManager::TryExtractTextFromResponse(const FString& Json, FString
 
 bool UGeminiHTTPManager::TryExtractStructuredJsonString(const FString& JsonResponse, FString& OutJsonString)
 {
+	using namespace GeminiHTTPManagerPrivate;
+
 	OutJsonString.Empty();
 
 	// 1) Fast path: if input already looks like a JSON object/array and parses, just return it
@@ -135,11 +410,11 @@ bool UGeminiHTTPManager::TryExtractStructuredJsonString(const FString& JsonRespo
 	Trimmed.TrimStartAndEndInline();
 	if (!Trimmed.IsEmpty() && (Trimmed[0] == TEXT('{') || Trimmed[0] == TEXT('[')))
 	{
-		// Try parse as object
+		// Try parse as object; a generateContent response body is JSON too, so it is unwrapped below instead
 		{
 			TSharedPtr<FJsonObject> Obj;
 			TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Trimmed);
-			if (FJsonSerializer::Deserialize(Reader, Obj) && Obj.IsValid())
+			if (FJsonSerializer::Deserialize(Reader, Obj) && Obj.IsValid() && !Obj->HasField(TEXT("candidates")))
 			{
 				OutJsonString = Trimmed;
 				return true;
@@ -163,147 +438,136 @@ bool UGeminiHTTPManager::TryExtractStructuredJsonString(const FString& JsonRespo
 
 	// 3) Choose a source string to scan for JSON segment: extracted text if available, otherwise the input itself
 	const FString& Source = bGotText ? Text : Trimmed;
+	return ExtractJsonSegment(Source, OutJsonString);
+}
 
-	// Heuristic: extract the first top-level JSON object/array substring
-	int32 Start = INDEX_NONE;
-	int32 End = INDEX_NONE;
-	for (int32 i = 0; i < Source.Len(); ++i)
-	{
-		TCHAR C = Source[i];
-		if (C == TEXT('{') || C == TEXT('[')) { Start = i; break; }
-	}
-	if (Start == INDEX_NONE) return false;
-
-	// Find matching closing brace/bracket using a simple stack counter
-	TCHAR Open = Source[Start];
-	TCHAR Close = (Open == TEXT('{')) ? TEXT('}') : TEXT(']');
-	int32 Depth = 0;
-	for (int32 i = Start; i < Source.Len(); ++i)
-	{
-		TCHAR C = Source[i];
-		if (C == Open) Depth++;
-		else if (C == Close) {
-			Depth--;
-			if (Depth == 0) { End = i; break; }
-		}
-	}
-	if (End == INDEX_NONE) return false;
+bool UGeminiHTTPManager::TryExtractAllStructuredJsonStrings(const FString& JsonResponse, TArray<FString>& OutJsonStrings)
+{
+	using namespace GeminiHTTPManagerPrivate;
 
-	FString Candidate = Source.Mid(Start, End - Start + 1);
+	OutJsonStrings.Reset();
 
-	// Validate that the candidate is valid JSON (object or array)
+	TSharedPtr<FJsonObject> RootObj;
+	const TArray<TSharedPtr<FJsonValue>>* CandidatesArr = GetCandidates(JsonResponse, RootObj);
+	if (!CandidatesArr)
 	{
-		TSharedPtr<FJsonObject> Obj;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Candidate);
-		if (FJsonSerializer::Deserialize(Reader, Obj) && Obj.IsValid())
+		// Not a generateContent body (or no candidates): single-result path
+		FString JsonString;
+		if (TryExtractStructuredJsonString(JsonResponse, JsonString))
 		{
-			OutJsonString = Candidate;
-			return true;
+			OutJsonStrings.Add(MoveTemp(JsonString));
 		}
+		return OutJsonStrings.Num() > 0;
 	}
+
+	OutJsonStrings.Reserve(CandidatesArr->Num());
+	for (const TSharedPtr<FJsonValue>& CandidateVal : *CandidatesArr)
 	{
-		TArray<TSharedPtr<FJsonValue>> Arr;
-		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Candidate);
-		if (FJsonSerializer::Deserialize(Reader, Arr))
+		const TSharedPtr<FJsonObject>* CandidateObjPtr = nullptr;
+		FString Text;
+		FString JsonString;
+		if (CandidateVal.IsValid() && CandidateVal->TryGetObject(CandidateObjPtr) && CandidateObjPtr
+			&& ExtractCandidateText(*CandidateObjPtr->Get(), Text) && ExtractJsonSegment(Text, JsonString))
 		{
-			OutJsonString = Candidate;
-			return true;
+			OutJsonStrings.Add(MoveTemp(JsonString));
 		}
 	}
 
-	return false;
+	UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Extracted %d/%d structured candidates"), OutJsonStrings.Num(), CandidatesArr->Num());
+	return OutJsonStrings.Num() > 0;
 }
 
-FString UGeminiHTTPManager::BuildGenerateUrl(const FString& Model) const
+bool UGeminiHTTPManager::TryExtractUsage(const FString& JsonResponse, FGeminiResponseUsage& OutUsage)
 {
-	// Expected base URL example: https://generativelanguage.googleapis.com/v1
-	FString Base = APIData ? APIData->GetURL() : TEXT("https://generativelanguage.googleapis.com/v1");
-	Base.RemoveFromEnd(TEXT("/"));
-	FString ModelPath = Model;
-	if (ModelPath.IsEmpty())
-	{
-		ModelPath = TEXT("models/gemini-1.5-flash");
-	}
-	if (!ModelPath.StartsWith(TEXT("models/")))
-	{
-		ModelPath = FString::Printf(TEXT("models/%s"), *ModelPath);
-	}
-	return FString::Printf(TEXT("%s/%s:generateContent"), *Base, *ModelPath);
-}
+	using namespace GeminiHTTPManagerPrivate;
 
-bool UGeminiHTTPManager::BuildGeneratePayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, FString& OutPayload) const
-{
-	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	OutUsage = FGeminiResponseUsage();
 
-	// contents: [{ role: "user", parts: [{ text: "..." }] }]
-	TArray<TSharedPtr<FJsonValue>> Contents;
+	TSharedPtr<FJsonObject> RootObj;
+	const TArray<TSharedPtr<FJsonValue>>* CandidatesArr = GetCandidates(JsonResponse, RootObj);
+	if (!CandidatesArr)
 	{
-		TSharedRef<FJsonObject> ContentObj = MakeShared<FJsonObject>();
-		ContentObj->SetStringField(TEXT("role"), TEXT("user"));
-
-		TArray<TSharedPtr<FJsonValue>> Parts;
-		{
-			TSharedRef<FJsonObject> PartObj = MakeShared<FJsonObject>();
-			PartObj->SetStringField(TEXT("text"), UserPrompt);
-			Parts.Add(MakeShared<FJsonValueObject>(PartObj));
-		}
-		ContentObj->SetArrayField(TEXT("parts"), Parts);
-		Contents.Add(MakeShared<FJsonValueObject>(ContentObj));
+		return false;
 	}
-	Root->SetArrayField(TEXT("contents"), Contents);
 
-	// generationConfig
+	OutUsage.CandidateCount = CandidatesArr->Num();
+	for (int32 Index = 0; Index < CandidatesArr->Num(); ++Index)
 	{
-		TSharedRef<FJsonObject> GenCfg = MakeShared<FJsonObject>();
-		GenCfg->SetNumberField(TEXT("temperature"), Config.Temperature);
-		GenCfg->SetNumberField(TEXT("maxOutputTokens"), Config.MaxOutputTokens);
-
-		if (Config.bForceJsonResponse)
+		const TSharedPtr<FJsonObject>* CandidateObjPtr = nullptr;
+		FString FinishReason;
+		if ((*CandidatesArr)[Index].IsValid() && (*CandidatesArr)[Index]->TryGetObject(CandidateObjPtr) && CandidateObjPtr
+			&& (*CandidateObjPtr)->TryGetStringField(TEXT("finishReason"), FinishReason))
 		{
-			GenCfg->SetStringField(TEXT("response_mime_type"), TEXT("application/json"));
+			if (Index == 0)
+			{
+				OutUsage.FinishReason = FinishReason;
+			}
+			if (FinishReason == TEXT("MAX_TOKENS"))
+			{
+				++OutUsage.TruncatedCandidates;
+			}
 		}
+	}
 
-		Root->SetObjectField(TEXT("generationConfig"), GenCfg);
+	const TSharedPtr<FJsonObject>* UsageObjPtr = nullptr;
+	if (RootObj->TryGetObjectField(TEXT("usageMetadata"), UsageObjPtr) && UsageObjPtr)
+	{
+		(*UsageObjPtr)->TryGetNumberField(TEXT("promptTokenCount"), OutUsage.PromptTokenCount);
+		(*UsageObjPtr)->TryGetNumberField(TEXT("candidatesTokenCount"), OutUsage.CandidatesTokenCount);
+		(*UsageObjPtr)->TryGetNumberField(TEXT("totalTokenCount"), OutUsage.TotalTokenCount);
 	}
+	return true;
+}
 
-	// systemInstruction (optional)
-	if (!Config.SystemInstruction.IsEmpty())
+int32 UGeminiHTTPManager::GetSchemaRawTokens(const TSharedPtr<FJsonObject>& Schema) const
+{
+	if (!Schema.IsValid())
 	{
-		TSharedRef<FJsonObject> SysContent = MakeShared<FJsonObject>();
-		TArray<TSharedPtr<FJsonValue>> SysParts;
-		{
-			TSharedRef<FJsonObject> PartObj = MakeShared<FJsonObject>();
-			PartObj->SetStringField(TEXT("text"), Config.SystemInstruction);
-			SysParts.Add(MakeShared<FJsonValueObject>(PartObj));
-		}
-		SysContent->SetArrayField(TEXT("parts"), SysParts);
-		Root->SetObjectField(TEXT("systemInstruction"), SysContent);
+		return 0;
+	}
+	if (Schema != EstimatedSchema)
+	{
+		FString SchemaJson;
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&SchemaJson);
+		FJsonSerializer::Serialize(Schema.ToSharedRef(), Writer);
+		EstimatedSchema = Schema;
+		EstimatedSchemaRawTokens = FLLMTokenEstimator::EstimateRaw(SchemaJson);
 	}
+	return EstimatedSchemaRawTokens;
+}
 
-	// response_schema (optional)
-	if (!Config.ResponseSchemaJson.IsEmpty())
+TSharedPtr<FJsonObject> UGeminiHTTPManager::GetParsedResponseSchema(const FString& SchemaJson) const
+{
+	if (CachedSchemaObject.IsValid() && CachedSchemaSource.Equals(SchemaJson, ESearchCase::CaseSensitive))
 	{
-		TSharedPtr<FJsonObject> SchemaObj;
-		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Config.ResponseSchemaJson);
-		if (FJsonSerializer::Deserialize(Reader, SchemaObj) && SchemaObj.IsValid())
-		{
-			Root->SetObjectField(TEXT("response_schema"), SchemaObj.ToSharedRef());
-		}
+		return CachedSchemaObject;
 	}
 
-	// Serialize
-	TSharedPtr<FJsonObject> RootPtr = Root;
-	if (!RootPtr.IsValid()) return false;
+	TSharedPtr<FJsonObject> SchemaObj;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(SchemaJson);
+	if (!FJsonSerializer::Deserialize(Reader, SchemaObj) || !SchemaObj.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] ResponseSchemaJson is not a valid JSON object, ignoring"));
+		return nullptr;
+	}
 
-	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutPayload);
-	return FJsonSerializer::Serialize(RootPtr.ToSharedRef(), Writer);
+	CachedSchemaSource = SchemaJson;
+	CachedSchemaObject = SchemaObj;
+	return CachedSchemaObject;
 }
 
 void UGeminiHTTPManager::HandleResponse(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request,
 	TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> Response,
 	bool bWasSuccessful,
-	FOnGeminiResponse Callback)
+	FOnGeminiResponse Callback,
+	const ILLMProviderAdapter* Adapter,
+	uint64 SharedCacheKey,
+	int32 RequestId,
+	FString EstimatorModel,
+	int32 RawPromptTokens)
 {
+	ActiveRequests.Remove(RequestId);
+
 	if (!bWasSuccessful || !Response.IsValid())
 	{
 		UE_LOG(LogTemp, Error, TEXT("[GeminiHTTP] Request failed or no response received"));
@@ -312,12 +576,31 @@ void UGeminiHTTPManager::HandleResponse(TSharedPtr<IHttpRequest, ESPMode::Thread
 	}
 
 	const int32 Code = Response->GetResponseCode();
-	const FString Body = Response->GetContentAsString();
 	const bool bOk = Code >= 200 && Code < 300;
-	
+
+	// Callers always see generateContent-shaped bodies
+	const FString Body = bOk ? Adapter->NormalizeResponse(Response->GetContentAsString()) : Response->GetContentAsString();
+
 	if (bOk)
 	{
 		UE_LOG(LogTemp, Log, TEXT("[GeminiHTTP] Response (Code %d): %s"), Code, *Body);
+		if (SharedCache && SharedCacheKey != 0 && GeminiHTTPManagerPrivate::IsShareableResponse(Body))
+		{
+			SharedCache->Insert(SharedCacheKey, Body);
+		}
+
+		// Compare the estimate with what the provider counted and refine the estimator
+		FGeminiResponseUsage Usage;
+		FLLMTokenEstimator* Estimator = TokenEstimators.Find(EstimatorModel);
+		if (Estimator && TryExtractUsage(Body, Usage) && Usage.PromptTokenCount > 0)
+		{
+			const int32 Estimated = Estimator->Scale(RawPromptTokens);
+			++PromptStats.Measured;
+			PromptStats.EstimatedTokens += Estimated;
+			PromptStats.ActualTokens += Usage.PromptTokenCount;
+			PromptStats.AbsoluteError += FMath::Abs(Estimated - Usage.PromptTokenCount);
+			Estimator->Calibrate(RawPromptTokens, Usage.PromptTokenCount);
+		}
 	}
 	else
 	{
@@ -5,12 +5,52 @@
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "Interfaces/IHttpRequest.h"
 #include "Interfaces/IHttpResponse.h"
+#include "Dom/JsonObject.h"
+#include "HTTP/LLMSharedResponseCache.h"
+#include "HTTP/LLMTokenEstimator.h"
 #include "GeminiHTTPManager.generated.h"
 
 class UAPIData;
+class ILLMProviderAdapter;
 
 DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnGeminiResponse, bool, bSuccess, const FString&, JsonResponse);
 
+// Context placed ahead of the user prompt; trimmed first when the prompt exceeds the profile's input budget
+USTRUCT(BlueprintType)
+struct FLLMPromptSection
+{
+	GENERATED_BODY()
+
+	// Heading the section is sent under
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Prompt")
+	FString Name;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(MultiLine="true"), Category="Gemini|Prompt")
+	FString Text;
+
+	// Lower priorities are trimmed first
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Prompt")
+	int32 Priority = 0;
+
+	// Trim from the start instead of the end (for sections whose newest lines come last)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Prompt")
+	bool bKeepTail = false;
+};
+
+// One earlier message of a multi-turn conversation
+USTRUCT(BlueprintType)
+struct FLLMConversationTurn
+{
+	GENERATED_BODY()
+
+	// Sent as the model's message (false: the user's)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Prompt")
+	bool bFromModel = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(MultiLine="true"), Category="Gemini|Prompt")
+	FString Text;
+};
+
 USTRUCT(BlueprintType)
 struct FGeminiGenerateContentConfig
 {
@@ -36,9 +76,89 @@ struct FGeminiGenerateContentConfig
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Structured Output")
 	bool bForceJsonResponse = false;
 
+	// Number of alternative responses to generate in one request (1 = default single candidate)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="1", ClampMax="8"), Category="Gemini")
+	int32 CandidateCount = 1;
+
 	// Optional JSON Schema string to constrain the response shape
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(MultiLine="true"), Category="Gemini|Structured Output")
 	FString ResponseSchemaJson;
+
+	// Pre-built schema object (C++ only). Takes precedence over ResponseSchemaJson and is sent without re-parsing
+	TSharedPtr<FJsonObject> ResponseSchema;
+
+	// Context sent ahead of the user prompt, in this order
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Prompt")
+	TArray<FLLMPromptSection> ContextSections;
+
+	// Earlier conversation, oldest first, sent as separate messages before the user prompt (ignored by the local provider)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Gemini|Prompt")
+	TArray<FLLMConversationTurn> History;
+};
+
+// Why generation stopped and what it cost (finishReason / usageMetadata of a generateContent response)
+USTRUCT(BlueprintType)
+struct FGeminiResponseUsage
+{
+	GENERATED_BODY()
+
+	// finishReason of the first candidate, e.g. "STOP" or "MAX_TOKENS"
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Usage")
+	FString FinishReason;
+
+	// Candidates that stopped at MaxOutputTokens
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Usage")
+	int32 TruncatedCandidates = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Usage")
+	int32 CandidateCount = 0;
+
+	// Token counts; -1 when the response carries no usageMetadata (e.g. the local provider)
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Usage")
+	int32 PromptTokenCount = -1;
+
+	// Output tokens of all candidates together
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Usage")
+	int32 CandidatesTokenCount = -1;
+
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Usage")
+	int32 TotalTokenCount = -1;
+};
+
+// Estimated versus reported prompt sizes and input budget enforcement
+USTRUCT(BlueprintType)
+struct FLLMPromptBudgetStats
+{
+	GENERATED_BODY()
+
+	// Requests whose prompt was estimated (all providers)
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int32 Requests = 0;
+
+	// Responses that reported promptTokenCount
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int32 Measured = 0;
+
+	// Sums over the measured requests
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int64 EstimatedTokens = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int64 ActualTokens = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int64 AbsoluteError = 0;
+
+	// Requests over the profile's MaxInputTokens before trimming
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int32 OverBudget = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int32 SectionsTrimmed = 0;
+
+	// Requests whose user prompt had to be cut as well
+	UPROPERTY(BlueprintReadOnly, Category="Gemini|Prompt")
+	int32 PromptsTruncated = 0;
 };
 
 UCLASS(BlueprintType)
@@ -46,13 +166,29 @@ class TESTCPP_API UGeminiHTTPManager : public UGameInstanceSubsystem
 {
 	GENERATED_BODY()
 public:
+	// Attaches the host-wide shared response cache when ULLMSettings::bEnableSharedResponseCache is set
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
 	// Provide API settings via a Data Asset created in editor (URL must be the base endpoint; APIKey must be valid key)
+	// The profile's Provider picks the request/response adapter (Gemini, OpenAI-compatible) or the in-process provider
 	UFUNCTION(BlueprintCallable, Category="Gemini")
 	void InitializeWithData(UAPIData* InAPIData);
 
 	// Simple text prompt -> JSON string response callback. Non-blocking.
+	// Returns a handle for CancelRequest, or 0 when the request cannot be cancelled (answered from cache, local provider, failed)
+	UFUNCTION(BlueprintCallable, Category="Gemini")
+	int32 GenerateContent(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FOnGeminiResponse& OnDone);
+
+	// Abort an in-flight request; its callback is not called. Returns false if it already completed
 	UFUNCTION(BlueprintCallable, Category="Gemini")
-	void GenerateContent(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FOnGeminiResponse& OnDone);
+	bool CancelRequest(int32 RequestId);
+
+	// HTTP requests currently in flight
+	int32 GetActiveRequestCount() const { return ActiveRequests.Num(); }
+
+	// HTTP requests sent since startup (cache hits not included)
+	int64 GetSentRequestCount() const { return SentRequestCount; }
 
 	// Convenience: try to extract concatenated text from Gemini JSON response
 	UFUNCTION(BlueprintPure, Category="Gemini")
@@ -62,20 +198,63 @@ public:
 	UFUNCTION(BlueprintPure, Category="Gemini|Structured Output")
 	static bool TryExtractStructuredJsonString(const FString& JsonResponse, FString& OutJsonString);
 
-private:
-	// Builds the URL for generateContent endpoint (picks model from APIData->Model if set, otherwise from Config)
-	FString BuildGenerateUrl(const FString& Model) const;
+	// Convenience: structured JSON from every candidate (CandidateCount > 1), in response order
+	UFUNCTION(BlueprintPure, Category="Gemini|Structured Output")
+	static bool TryExtractAllStructuredJsonStrings(const FString& JsonResponse, TArray<FString>& OutJsonStrings);
+
+	// Convenience: finish reason and token usage of a response; false when it has no candidates
+	UFUNCTION(BlueprintPure, Category="Gemini|Usage")
+	static bool TryExtractUsage(const FString& JsonResponse, FGeminiResponseUsage& OutUsage);
 
-	// Builds JSON payload per Google Generative Language API v1
-	bool BuildGeneratePayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, FString& OutPayload) const;
+	// Counters of the shared response cache; false when it is not attached
+	bool GetSharedCacheStats(FLLMSharedResponseCache::FStats& OutStats) const;
 
-	// Handle HTTP response
+	UFUNCTION(BlueprintPure, Category="Gemini|Prompt")
+	FLLMPromptBudgetStats GetPromptBudgetStats() const { return PromptStats; }
+
+	UFUNCTION(BlueprintCallable, Category="Gemini|Prompt")
+	void ResetPromptBudgetStats() { PromptStats = FLLMPromptBudgetStats(); }
+
+	// Token estimators by model, calibrated from the usage each response reports
+	const TMap<FString, FLLMTokenEstimator>& GetTokenEstimators() const { return TokenEstimators; }
+
+private:
+	// Handle HTTP response; SharedCacheKey is 0 for responses that are not shared
 	void HandleResponse(TSharedPtr<IHttpRequest, ESPMode::ThreadSafe> Request,
 		TSharedPtr<IHttpResponse, ESPMode::ThreadSafe> Response,
 		bool bWasSuccessful,
-		FOnGeminiResponse Callback);
+		FOnGeminiResponse Callback,
+		const ILLMProviderAdapter* Adapter,
+		uint64 SharedCacheKey,
+		int32 RequestId,
+		FString EstimatorModel,
+		int32 RawPromptTokens);
+
+	// Returns the parsed ResponseSchemaJson, re-parsing only when the string changes
+	TSharedPtr<FJsonObject> GetParsedResponseSchema(const FString& SchemaJson) const;
+
+	// Raw token estimate of a schema, recomputed only when the schema object changes
+	int32 GetSchemaRawTokens(const TSharedPtr<FJsonObject>& Schema) const;
 
 private:
 	UPROPERTY()
 	UAPIData* APIData = nullptr;
+
+	// Last parsed ResponseSchemaJson and its source string
+	mutable FString CachedSchemaSource;
+	mutable TSharedPtr<FJsonObject> CachedSchemaObject;
+
+	// In-flight HTTP requests by handle
+	TMap<int32, TSharedRef<IHttpRequest, ESPMode::ThreadSafe>> ActiveRequests;
+	int32 LastRequestId = 0;
+	int64 SentRequestCount = 0;
+
+	// Structured responses shared with the other game processes on this host (optional)
+	TUniquePtr<FLLMSharedResponseCache> SharedCache;
+
+	TMap<FString, FLLMTokenEstimator> TokenEstimators;
+	FLLMPromptBudgetStats PromptStats;
+
+	mutable TSharedPtr<FJsonObject> EstimatedSchema;
+	mutable int32 EstimatedSchemaRawTokens = 0;
 };
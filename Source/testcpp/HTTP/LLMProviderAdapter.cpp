@@ -0,0 +1,333 @@
+﻿// Provider-specific request building and response normalization behind UGeminiHTTPManager
+#include "HTTP/LLMProviderAdapter.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+
+const ILLMProviderAdapter* ILLMProviderAdapter::Get(ELLMProvider Provider)
+{
+	static const FGeminiProviderAdapter Gemini;
+	static const FOpenAIChatProviderAdapter OpenAIChat;
+
+	switch (Provider)
+	{
+	case ELLMProvider::Gemini: return &Gemini;
+	case ELLMProvider::OpenAICompatible: return &OpenAIChat;
+	default: return nullptr;
+	}
+}
+
+namespace LLMProviderAdapterPrivate
+{
+	static bool Serialize(const TSharedRef<FJsonObject>& Root, FString& OutPayload)
+	{
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&OutPayload);
+		return FJsonSerializer::Serialize(Root, Writer);
+	}
+
+	static FString GetBaseUrl(const UAPIData& APIData, const TCHAR* Default)
+	{
+		FString Base = APIData.GetURL().IsEmpty() ? FString(Default) : APIData.GetURL();
+		Base.RemoveFromEnd(TEXT("/"));
+		return Base;
+	}
+}
+
+// Gemini
+
+FString FGeminiProviderAdapter::GetFallbackModel(const FGeminiGenerateContentConfig& Config) const
+{
+	return Config.Model.IsEmpty() ? TEXT("gemini-1.5-flash") : Config.Model;
+}
+
+FString FGeminiProviderAdapter::BuildUrl(const UAPIData& APIData, const FString& Model) const
+{
+	// Expected base URL example: https://generativelanguage.googleapis.com/v1
+	const FString Base = LLMProviderAdapterPrivate::GetBaseUrl(APIData, TEXT("https://generativelanguage.googleapis.com/v1"));
+	FString ModelPath = Model;
+	if (ModelPath.IsEmpty())
+	{
+		ModelPath = TEXT("models/gemini-1.5-flash");
+	}
+	if (!ModelPath.StartsWith(TEXT("models/")))
+	{
+		ModelPath = FString::Printf(TEXT("models/%s"), *ModelPath);
+	}
+	FString Url = FString::Printf(TEXT("%s/%s:generateContent"), *Base, *ModelPath);
+
+	// Some Gemini endpoints accept API key via query string: ?key=API_KEY
+	if (!APIData.GetAPIKey().IsEmpty())
+	{
+		const TCHAR* Delim = Url.Contains(TEXT("?")) ? TEXT("&") : TEXT("?");
+		const FString EncKey = FGenericPlatformHttp::UrlEncode(APIData.GetAPIKey());
+		Url += FString::Printf(TEXT("%skey=%s"), Delim, *EncKey);
+	}
+	return Url;
+}
+
+void FGeminiProviderAdapter::ApplyHeaders(IHttpRequest& Request, const UAPIData& APIData) const
+{
+	Request.SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+}
+
+bool FGeminiProviderAdapter::BuildPayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FString& Model,
+	const TSharedPtr<FJsonObject>& Schema, FString& OutPayload) const
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+
+	// contents: earlier turns, then [{ role: "user", parts: [{ text: "..." }] }]
+	TArray<TSharedPtr<FJsonValue>> Contents;
+	auto AddContent = [&Contents](const TCHAR* Role, const FString& Text)
+	{
+		TSharedRef<FJsonObject> ContentObj = MakeShared<FJsonObject>();
+		ContentObj->SetStringField(TEXT("role"), Role);
+
+		TArray<TSharedPtr<FJsonValue>> Parts;
+		{
+			TSharedRef<FJsonObject> PartObj = MakeShared<FJsonObject>();
+			PartObj->SetStringField(TEXT("text"), Text);
+			Parts.Add(MakeShared<FJsonValueObject>(PartObj));
+		}
+		ContentObj->SetArrayField(TEXT("parts"), Parts);
+		Contents.Add(MakeShared<FJsonValueObject>(ContentObj));
+	};
+	for (const FLLMConversationTurn& Turn : Config.History)
+	{
+		AddContent(Turn.bFromModel ? TEXT("model") : TEXT("user"), Turn.Text);
+	}
+	AddContent(TEXT("user"), UserPrompt);
+	Root->SetArrayField(TEXT("contents"), Contents);
+
+	// generationConfig
+	{
+		TSharedRef<FJsonObject> GenCfg = MakeShared<FJsonObject>();
+		GenCfg->SetNumberField(TEXT("temperature"), Config.Temperature);
+		GenCfg->SetNumberField(TEXT("maxOutputTokens"), Config.MaxOutputTokens);
+		if (Config.CandidateCount > 1)
+		{
+			GenCfg->SetNumberField(TEXT("candidateCount"), Config.CandidateCount);
+		}
+
+		// response_schema (optional) belongs to generationConfig and requires a JSON mime type
+		if (Config.bForceJsonResponse || Schema.IsValid())
+		{
+			GenCfg->SetStringField(TEXT("response_mime_type"), TEXT("application/json"));
+		}
+		if (Schema.IsValid())
+		{
+			GenCfg->SetObjectField(TEXT("response_schema"), Schema);
+		}
+
+		Root->SetObjectField(TEXT("generationConfig"), GenCfg);
+	}
+
+	// systemInstruction (optional)
+	if (!Config.SystemInstruction.IsEmpty())
+	{
+		TSharedRef<FJsonObject> SysContent = MakeShared<FJsonObject>();
+		TArray<TSharedPtr<FJsonValue>> SysParts;
+		{
+			TSharedRef<FJsonObject> PartObj = MakeShared<FJsonObject>();
+			PartObj->SetStringField(TEXT("text"), Config.SystemInstruction);
+			SysParts.Add(MakeShared<FJsonValueObject>(PartObj));
+		}
+		SysContent->SetArrayField(TEXT("parts"), SysParts);
+		Root->SetObjectField(TEXT("systemInstruction"), SysContent);
+	}
+
+	return LLMProviderAdapterPrivate::Serialize(Root, OutPayload);
+}
+
+// OpenAI-compatible chat completions
+
+FString FOpenAIChatProviderAdapter::BuildUrl(const UAPIData& APIData, const FString& Model) const
+{
+	// Expected base URL example: http://localhost:8000/v1 (a full .../chat/completions URL is used as is)
+	const FString Base = LLMProviderAdapterPrivate::GetBaseUrl(APIData, TEXT("http://localhost:8000/v1"));
+	return Base.EndsWith(TEXT("/chat/completions")) ? Base : Base + TEXT("/chat/completions");
+}
+
+void FOpenAIChatProviderAdapter::ApplyHeaders(IHttpRequest& Request, const UAPIData& APIData) const
+{
+	Request.SetHeader(TEXT("Content-Type"), TEXT("application/json"));
+	if (!APIData.GetAPIKey().IsEmpty())
+	{
+		Request.SetHeader(TEXT("Authorization"), FString::Printf(TEXT("Bearer %s"), *APIData.GetAPIKey()));
+	}
+}
+
+bool FOpenAIChatProviderAdapter::BuildPayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FString& Model,
+	const TSharedPtr<FJsonObject>& Schema, FString& OutPayload) const
+{
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("model"), Model);
+
+	// messages: [{ role: "system", content }, earlier turns, { role: "user", content }]
+	TArray<TSharedPtr<FJsonValue>> Messages;
+	auto AddMessage = [&Messages](const TCHAR* Role, const FString& Content)
+	{
+		TSharedRef<FJsonObject> Message = MakeShared<FJsonObject>();
+		Message->SetStringField(TEXT("role"), Role);
+		Message->SetStringField(TEXT("content"), Content);
+		Messages.Add(MakeShared<FJsonValueObject>(Message));
+	};
+	if (!Config.SystemInstruction.IsEmpty())
+	{
+		AddMessage(TEXT("system"), Config.SystemInstruction);
+	}
+	for (const FLLMConversationTurn& Turn : Config.History)
+	{
+		AddMessage(Turn.bFromModel ? TEXT("assistant") : TEXT("user"), Turn.Text);
+	}
+	AddMessage(TEXT("user"), UserPrompt);
+	Root->SetArrayField(TEXT("messages"), Messages);
+
+	Root->SetNumberField(TEXT("temperature"), Config.Temperature);
+	Root->SetNumberField(TEXT("max_tokens"), Config.MaxOutputTokens);
+	if (Config.CandidateCount > 1)
+	{
+		Root->SetNumberField(TEXT("n"), Config.CandidateCount);
+	}
+
+	// response_format: json_schema when a schema is set, json_object for JSON-only output
+	if (Schema.IsValid())
+	{
+		if (CachedSourceSchema != Schema)
+		{
+			CachedSourceSchema = Schema;
+			CachedConvertedSchema = ConvertSchema(*Schema);
+		}
+
+		TSharedRef<FJsonObject> JsonSchema = MakeShared<FJsonObject>();
+		JsonSchema->SetStringField(TEXT("name"), TEXT("response"));
+		JsonSchema->SetObjectField(TEXT("schema"), CachedConvertedSchema);
+
+		TSharedRef<FJsonObject> Format = MakeShared<FJsonObject>();
+		Format->SetStringField(TEXT("type"), TEXT("json_schema"));
+		Format->SetObjectField(TEXT("json_schema"), JsonSchema);
+		Root->SetObjectField(TEXT("response_format"), Format);
+	}
+	else if (Config.bForceJsonResponse)
+	{
+		TSharedRef<FJsonObject> Format = MakeShared<FJsonObject>();
+		Format->SetStringField(TEXT("type"), TEXT("json_object"));
+		Root->SetObjectField(TEXT("response_format"), Format);
+	}
+
+	return LLMProviderAdapterPrivate::Serialize(Root, OutPayload);
+}
+
+TSharedRef<FJsonObject> FOpenAIChatProviderAdapter::ConvertSchema(const FJsonObject& GeminiSchema)
+{
+	TSharedRef<FJsonObject> Result = MakeShared<FJsonObject>();
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& Field : GeminiSchema.Values)
+	{
+		if (Field.Key == TEXT("propertyOrdering"))
+		{
+			continue;
+		}
+
+		if (Field.Key == TEXT("type") && Field.Value->Type == EJson::String)
+		{
+			Result->SetStringField(Field.Key, Field.Value->AsString().ToLower());
+		}
+		else if (Field.Key == TEXT("properties") && Field.Value->Type == EJson::Object)
+		{
+			TSharedRef<FJsonObject> Props = MakeShared<FJsonObject>();
+			for (const TPair<FString, TSharedPtr<FJsonValue>>& Prop : Field.Value->AsObject()->Values)
+			{
+				Props->SetObjectField(Prop.Key, ConvertSchema(*Prop.Value->AsObject()));
+			}
+			Result->SetObjectField(Field.Key, Props);
+		}
+		else if (Field.Key == TEXT("items") && Field.Value->Type == EJson::Object)
+		{
+			Result->SetObjectField(Field.Key, ConvertSchema(*Field.Value->AsObject()));
+		}
+		else if (Field.Key == TEXT("anyOf") && Field.Value->Type == EJson::Array)
+		{
+			TArray<TSharedPtr<FJsonValue>> Variants;
+			for (const TSharedPtr<FJsonValue>& Variant : Field.Value->AsArray())
+			{
+				Variants.Add(MakeShared<FJsonValueObject>(ConvertSchema(*Variant->AsObject())));
+			}
+			Result->SetArrayField(Field.Key, Variants);
+		}
+		else
+		{
+			Result->SetField(Field.Key, Field.Value);
+		}
+	}
+	return Result;
+}
+
+FString FOpenAIChatProviderAdapter::NormalizeResponse(const FString& Body) const
+{
+	TSharedPtr<FJsonObject> Root;
+	const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Body);
+	const TArray<TSharedPtr<FJsonValue>>* Choices = nullptr;
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("choices"), Choices))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[GeminiHTTP] OpenAI-compatible response has no choices"));
+		return Body;
+	}
+
+	// choices[].message.content -> candidates[].content.parts[0].text
+	TArray<TSharedPtr<FJsonValue>> Candidates;
+	for (const TSharedPtr<FJsonValue>& ChoiceVal : *Choices)
+	{
+		const TSharedPtr<FJsonObject>* Choice = nullptr;
+		const TSharedPtr<FJsonObject>* Message = nullptr;
+		FString Text;
+		if (!ChoiceVal->TryGetObject(Choice) || !(*Choice)->TryGetObjectField(TEXT("message"), Message)
+			|| !(*Message)->TryGetStringField(TEXT("content"), Text))
+		{
+			continue;
+		}
+
+		TSharedRef<FJsonObject> Part = MakeShared<FJsonObject>();
+		Part->SetStringField(TEXT("text"), Text);
+		TArray<TSharedPtr<FJsonValue>> Parts;
+		Parts.Add(MakeShared<FJsonValueObject>(Part));
+
+		TSharedRef<FJsonObject> Content = MakeShared<FJsonObject>();
+		Content->SetStringField(TEXT("role"), TEXT("model"));
+		Content->SetArrayField(TEXT("parts"), Parts);
+
+		TSharedRef<FJsonObject> Candidate = MakeShared<FJsonObject>();
+		Candidate->SetObjectField(TEXT("content"), Content);
+		FString FinishReason;
+		if ((*Choice)->TryGetStringField(TEXT("finish_reason"), FinishReason))
+		{
+			Candidate->SetStringField(TEXT("finishReason"), FinishReason == TEXT("length") ? TEXT("MAX_TOKENS") : FinishReason.ToUpper());
+		}
+		Candidates.Add(MakeShared<FJsonValueObject>(Candidate));
+	}
+
+	TSharedRef<FJsonObject> Normalized = MakeShared<FJsonObject>();
+	Normalized->SetArrayField(TEXT("candidates"), Candidates);
+
+	// usage -> usageMetadata
+	const TSharedPtr<FJsonObject>* Usage = nullptr;
+	if (Root->TryGetObjectField(TEXT("usage"), Usage))
+	{
+		TSharedRef<FJsonObject> UsageMetadata = MakeShared<FJsonObject>();
+		for (const TPair<const TCHAR*, const TCHAR*>& Key : {
+			TPair<const TCHAR*, const TCHAR*>(TEXT("prompt_tokens"), TEXT("promptTokenCount")),
+			TPair<const TCHAR*, const TCHAR*>(TEXT("completion_tokens"), TEXT("candidatesTokenCount")),
+			TPair<const TCHAR*, const TCHAR*>(TEXT("total_tokens"), TEXT("totalTokenCount")) })
+		{
+			int32 Count = 0;
+			if ((*Usage)->TryGetNumberField(Key.Key, Count))
+			{
+				UsageMetadata->SetNumberField(Key.Value, Count);
+			}
+		}
+		Normalized->SetObjectField(TEXT("usageMetadata"), UsageMetadata);
+	}
+
+	FString Result;
+	LLMProviderAdapterPrivate::Serialize(Normalized, Result);
+	return Result;
+}
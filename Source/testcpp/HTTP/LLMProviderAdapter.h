@@ -0,0 +1,75 @@
+﻿// Provider-specific request building and response normalization behind UGeminiHTTPManager
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Interfaces/IHttpRequest.h"
+#include "Dom/JsonObject.h"
+#include "HTTP/APIData.h"
+
+struct FGeminiGenerateContentConfig;
+
+/**
+ * Translates between the manager's request config and one HTTP API
+ * The rest of the pipeline only understands generateContent response bodies, so each adapter
+ * rewrites its provider's successful responses into that shape.
+ */
+class TESTCPP_API ILLMProviderAdapter
+{
+public:
+	virtual ~ILLMProviderAdapter() = default;
+
+	// Adapter for an HTTP provider; null for providers that do not use HTTP (Local)
+	static const ILLMProviderAdapter* Get(ELLMProvider Provider);
+
+	// Model used when the profile names none; empty when the profile must name one
+	virtual FString GetFallbackModel(const FGeminiGenerateContentConfig& Config) const { return FString(); }
+
+	// Full endpoint URL for one generate call
+	virtual FString BuildUrl(const UAPIData& APIData, const FString& Model) const = 0;
+
+	// Auth and content headers
+	virtual void ApplyHeaders(IHttpRequest& Request, const UAPIData& APIData) const = 0;
+
+	// Request body; Schema is the resolved response schema (may be null)
+	virtual bool BuildPayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FString& Model,
+		const TSharedPtr<FJsonObject>& Schema, FString& OutPayload) const = 0;
+
+	// Successful response body rewritten to the generateContent shape
+	virtual FString NormalizeResponse(const FString& Body) const { return Body; }
+};
+
+/**
+ * Google Generative Language API (generateContent)
+ */
+class FGeminiProviderAdapter : public ILLMProviderAdapter
+{
+public:
+	virtual FString GetFallbackModel(const FGeminiGenerateContentConfig& Config) const override;
+	virtual FString BuildUrl(const UAPIData& APIData, const FString& Model) const override;
+	virtual void ApplyHeaders(IHttpRequest& Request, const UAPIData& APIData) const override;
+	virtual bool BuildPayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FString& Model,
+		const TSharedPtr<FJsonObject>& Schema, FString& OutPayload) const override;
+};
+
+/**
+ * OpenAI-style /v1/chat/completions, as exposed by self-hosted batching servers (vLLM, llama.cpp server, TGI, ...)
+ * The response schema is sent as response_format json_schema with standard lowercase types.
+ * Model names are server-specific, so the profile's Model is required.
+ */
+class FOpenAIChatProviderAdapter : public ILLMProviderAdapter
+{
+public:
+	virtual FString BuildUrl(const UAPIData& APIData, const FString& Model) const override;
+	virtual void ApplyHeaders(IHttpRequest& Request, const UAPIData& APIData) const override;
+	virtual bool BuildPayload(const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FString& Model,
+		const TSharedPtr<FJsonObject>& Schema, FString& OutPayload) const override;
+	virtual FString NormalizeResponse(const FString& Body) const override;
+
+	// Gemini schema dialect (uppercase types, propertyOrdering) to JSON Schema
+	static TSharedRef<FJsonObject> ConvertSchema(const FJsonObject& GeminiSchema);
+
+private:
+	// Last converted schema; schemas are shared and cached upstream, so identity is enough (game thread only)
+	mutable TSharedPtr<FJsonObject> CachedSourceSchema;
+	mutable TSharedPtr<FJsonObject> CachedConvertedSchema;
+};
@@ -0,0 +1,371 @@
+﻿// Host-wide response cache shared by every game process through a memory-mapped file
+#include "HTTP/LLMSharedResponseCache.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Hash/CityHash.h"
+#include "Misc/Crc.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include <atomic>
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace LLMSharedResponseCachePrivate
+{
+	static constexpr uint32 FileMagic = 0x534D4C4C; // "LLMS"
+	static constexpr uint32 FileVersion = 2;
+	// Header State: 0 = new file, 1 = ready, anything else = initialization started at that Unix time
+	static constexpr int64 StateEmpty = 0;
+	static constexpr int64 StateReady = 1;
+	// Slots a key may occupy, starting at its home slot
+	static constexpr uint32 ProbeWindow = 8;
+	// A claim (slot write or header initialization) older than this belongs to a process that died
+	static constexpr int64 StaleClaimSeconds = 10;
+	static constexpr double InitWaitSeconds = 2.0;
+
+	// Shared with other processes: fields read concurrently are volatile and accessed through FPlatformAtomics
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 NumSlots;
+		uint32 SlotBytes;
+		volatile int64 State;
+		volatile int64 Hits;
+		volatile int64 Inserts;
+		uint8 Reserved[24];
+	};
+	static_assert(sizeof(FHeader) == 64, "Shared cache header layout changed");
+
+	// Followed by Length bytes of UTF-8 response body
+	struct FSlotHeader
+	{
+		// Low 32 bits: counter, odd while a writer owns the slot; high 32 bits: claim time (Unix seconds)
+		// Both change in the one CAS that claims the slot, so a fresh claim never looks stale
+		volatile int64 Sequence;
+		volatile int64 Key;
+		// Write time, Unix seconds
+		volatile int64 Stamp;
+		volatile uint32 Length;
+		// Covers Key, Length and body
+		volatile uint32 Checksum;
+	};
+	static_assert(sizeof(FSlotHeader) == 32, "Shared cache slot layout changed");
+
+	static int64 Now()
+	{
+		return FDateTime::UtcNow().ToUnixTimestamp();
+	}
+
+	static bool IsClaimed(int64 Sequence)
+	{
+		return (Sequence & 1) != 0;
+	}
+
+	static int64 GetClaimTime(int64 Sequence)
+	{
+		return static_cast<int64>(static_cast<uint64>(Sequence) >> 32);
+	}
+
+	// Counter arithmetic wraps instead of overflowing
+	static int64 NextSequence(int64 Sequence, uint32 Step, int64 ClaimTime)
+	{
+		const uint32 Counter = static_cast<uint32>(Sequence) + Step;
+		return static_cast<int64>((static_cast<uint64>(static_cast<uint32>(ClaimTime)) << 32) | Counter);
+	}
+
+	static uint32 RecordChecksum(uint64 Key, uint32 Length, const void* Body)
+	{
+		uint32 Crc = FCrc::MemCrc32(&Key, sizeof(Key));
+		Crc = FCrc::MemCrc32(&Length, sizeof(Length), Crc);
+		return FCrc::MemCrc32(Body, Length, Crc);
+	}
+}
+
+FLLMSharedResponseCache::~FLLMSharedResponseCache()
+{
+#if PLATFORM_WINDOWS
+	if (Base)
+	{
+		UnmapViewOfFile(Base);
+	}
+	if (MappingHandle)
+	{
+		CloseHandle(static_cast<HANDLE>(MappingHandle));
+	}
+	if (FileHandle)
+	{
+		CloseHandle(static_cast<HANDLE>(FileHandle));
+	}
+#elif PLATFORM_UNIX || PLATFORM_MAC
+	if (Base)
+	{
+		munmap(Base, MappedSize);
+	}
+#endif
+}
+
+TUniquePtr<FLLMSharedResponseCache> FLLMSharedResponseCache::Attach(const FString& InPath, int32 InNumSlots, int32 InSlotBytes, int32 InTimeToLiveSeconds)
+{
+	using namespace LLMSharedResponseCachePrivate;
+
+	TUniquePtr<FLLMSharedResponseCache> Cache(new FLLMSharedResponseCache());
+	Cache->Path = InPath;
+	Cache->NumSlots = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Max<int32>(InNumSlots, ProbeWindow)));
+	Cache->SlotBytes = Align(static_cast<uint32>(FMath::Max(InSlotBytes, 256)), 64u);
+	Cache->TimeToLiveSeconds = InTimeToLiveSeconds;
+	const int64 Size = sizeof(FHeader) + static_cast<int64>(Cache->NumSlots) * Cache->SlotBytes;
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(InPath), true);
+
+#if PLATFORM_WINDOWS
+	HANDLE File = CreateFileW(*InPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+		nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (File == INVALID_HANDLE_VALUE)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] Cannot open %s (error %u)"), *InPath, GetLastError());
+		return nullptr;
+	}
+	Cache->FileHandle = File;
+
+	// A mapping larger than the file grows it with zeros
+	HANDLE Mapping = CreateFileMappingW(File, nullptr, PAGE_READWRITE, static_cast<DWORD>(Size >> 32), static_cast<DWORD>(Size & 0xFFFFFFFF), nullptr);
+	if (!Mapping)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] Cannot map %s (error %u)"), *InPath, GetLastError());
+		return nullptr;
+	}
+	Cache->MappingHandle = Mapping;
+	Cache->Base = static_cast<uint8*>(MapViewOfFile(Mapping, FILE_MAP_ALL_ACCESS, 0, 0, Size));
+#elif PLATFORM_UNIX || PLATFORM_MAC
+	const int File = open(TCHAR_TO_UTF8(*InPath), O_RDWR | O_CREAT, 0666);
+	if (File < 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] Cannot open %s (errno %d)"), *InPath, errno);
+		return nullptr;
+	}
+
+	// Only ever grown: every process asks for its layout's size and ftruncate fills with zeros
+	struct stat FileStat;
+	if (fstat(File, &FileStat) != 0 || (FileStat.st_size < Size && ftruncate(File, Size) != 0))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] Cannot size %s (errno %d)"), *InPath, errno);
+		close(File);
+		return nullptr;
+	}
+
+	void* Mapped = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0);
+	close(File);
+	Cache->Base = Mapped != MAP_FAILED ? static_cast<uint8*>(Mapped) : nullptr;
+#else
+	UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] Shared response cache is not supported on this platform"));
+	return nullptr;
+#endif
+
+	if (!Cache->Base)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] Cannot map %s"), *InPath);
+		return nullptr;
+	}
+	Cache->MappedSize = Size;
+
+	if (!Cache->InitializeHeader())
+	{
+		return nullptr;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMSharedCache] Attached to %s (%u slots of %u bytes)"), *InPath, Cache->NumSlots, Cache->SlotBytes);
+	return Cache;
+}
+
+bool FLLMSharedResponseCache::InitializeHeader()
+{
+	using namespace LLMSharedResponseCachePrivate;
+
+	FHeader& Header = *reinterpret_cast<FHeader*>(Base);
+	const double WaitStart = FPlatformTime::Seconds();
+	for (;;)
+	{
+		const int64 State = FPlatformAtomics::AtomicRead(&Header.State);
+		if (State == StateReady)
+		{
+			break;
+		}
+
+		// First process on a new file, or the one that finds an initializer that crashed part-way
+		const int64 Time = Now();
+		const bool bMayClaim = State == StateEmpty || Time - State > StaleClaimSeconds;
+		if (bMayClaim && FPlatformAtomics::InterlockedCompareExchange(&Header.State, Time, State) == State)
+		{
+			FMemory::Memzero(Base + sizeof(FHeader), MappedSize - sizeof(FHeader));
+			Header.Magic = FileMagic;
+			Header.Version = FileVersion;
+			Header.NumSlots = NumSlots;
+			Header.SlotBytes = SlotBytes;
+			FPlatformAtomics::AtomicStore(&Header.Hits, 0);
+			FPlatformAtomics::AtomicStore(&Header.Inserts, 0);
+			FPlatformAtomics::AtomicStore(&Header.State, StateReady);
+			break;
+		}
+
+		if (FPlatformTime::Seconds() - WaitStart > InitWaitSeconds)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] %s is being initialized by another process, not attaching"), *Path);
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+
+	if (Header.Magic != FileMagic || Header.Version != FileVersion || Header.NumSlots != NumSlots || Header.SlotBytes != SlotBytes)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMSharedCache] %s has another version or layout (version %u, %u slots of %u bytes); use another path or delete it while no server runs"),
+			*Path, Header.Version, Header.NumSlots, Header.SlotBytes);
+		return false;
+	}
+	return true;
+}
+
+uint8* FLLMSharedResponseCache::GetSlot(uint32 Index) const
+{
+	return Base + sizeof(LLMSharedResponseCachePrivate::FHeader) + static_cast<int64>(Index & (NumSlots - 1)) * SlotBytes;
+}
+
+uint64 FLLMSharedResponseCache::MakeKey(const FString& Endpoint, const FString& Payload)
+{
+	const FTCHARToUTF8 Request(*(Endpoint + TEXT("\n") + Payload));
+	const uint64 Key = CityHash64(Request.Get(), Request.Length());
+	return Key != 0 ? Key : 1;
+}
+
+bool FLLMSharedResponseCache::Find(uint64 Key, FString& OutBody)
+{
+	using namespace LLMSharedResponseCachePrivate;
+
+	++Stats.Lookups;
+	const uint32 MaxLength = SlotBytes - sizeof(FSlotHeader);
+	TArray<uint8> Buffer;
+	for (uint32 Probe = 0; Probe < ProbeWindow; ++Probe)
+	{
+		FSlotHeader& Slot = *reinterpret_cast<FSlotHeader*>(GetSlot(static_cast<uint32>(Key) + Probe));
+		// Sequence, then payload, then the sequence again: the atomic reads order the payload between them
+		const int64 Before = FPlatformAtomics::AtomicRead(&Slot.Sequence);
+		if (IsClaimed(Before) || static_cast<uint64>(FPlatformAtomics::AtomicRead(&Slot.Key)) != Key)
+		{
+			continue;
+		}
+
+		const uint32 Length = Slot.Length;
+		const uint32 Checksum = Slot.Checksum;
+		const int64 Stamp = FPlatformAtomics::AtomicRead(&Slot.Stamp);
+		if (Length > MaxLength)
+		{
+			continue;
+		}
+		Buffer.SetNumUninitialized(Length);
+		FMemory::Memcpy(Buffer.GetData(), reinterpret_cast<const uint8*>(&Slot) + sizeof(FSlotHeader), Length);
+
+		// Rewritten while copying, or torn by a writer that died
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (FPlatformAtomics::AtomicRead(&Slot.Sequence) != Before || RecordChecksum(Key, Length, Buffer.GetData()) != Checksum)
+		{
+			continue;
+		}
+		if (Now() - Stamp > TimeToLiveSeconds)
+		{
+			return false;
+		}
+
+		const FUTF8ToTCHAR Body(reinterpret_cast<const ANSICHAR*>(Buffer.GetData()), Length);
+		OutBody = FString(Body.Length(), Body.Get());
+		++Stats.Hits;
+		FPlatformAtomics::InterlockedIncrement(&reinterpret_cast<FHeader*>(Base)->Hits);
+		return true;
+	}
+	return false;
+}
+
+void FLLMSharedResponseCache::Insert(uint64 Key, const FString& Body)
+{
+	using namespace LLMSharedResponseCachePrivate;
+
+	const FTCHARToUTF8 Utf8(*Body);
+	const uint32 Length = Utf8.Length();
+	if (Key == 0 || Length > SlotBytes - sizeof(FSlotHeader))
+	{
+		++Stats.SkippedInserts;
+		return;
+	}
+
+	// Same key, else the emptiest/oldest slot of the window; claims of dead writers count as empty
+	const int64 Time = Now();
+	FSlotHeader* Victim = nullptr;
+	int64 VictimSequence = 0;
+	int64 VictimAge = -1;
+	for (uint32 Probe = 0; Probe < ProbeWindow; ++Probe)
+	{
+		FSlotHeader& Slot = *reinterpret_cast<FSlotHeader*>(GetSlot(static_cast<uint32>(Key) + Probe));
+		const int64 Sequence = FPlatformAtomics::AtomicRead(&Slot.Sequence);
+		const int64 SlotKey = FPlatformAtomics::AtomicRead(&Slot.Key);
+		const bool bClaimed = IsClaimed(Sequence);
+		const int64 Age = Time - (bClaimed ? GetClaimTime(Sequence) : FPlatformAtomics::AtomicRead(&Slot.Stamp));
+
+		if (bClaimed && Age <= StaleClaimSeconds)
+		{
+			continue;
+		}
+		if (!bClaimed && static_cast<uint64>(SlotKey) == Key)
+		{
+			Victim = &Slot;
+			VictimSequence = Sequence;
+			break;
+		}
+
+		const int64 Score = (bClaimed || SlotKey == 0) ? MAX_int64 : Age;
+		if (Score > VictimAge)
+		{
+			Victim = &Slot;
+			VictimSequence = Sequence;
+			VictimAge = Score;
+		}
+	}
+
+	// Never wait: if another process got there first, this response is simply not shared
+	const int64 Claimed = NextSequence(VictimSequence, IsClaimed(VictimSequence) ? 2 : 1, Time);
+	if (!Victim || FPlatformAtomics::InterlockedCompareExchange(&Victim->Sequence, Claimed, VictimSequence) != VictimSequence)
+	{
+		++Stats.SkippedInserts;
+		return;
+	}
+
+	FPlatformAtomics::AtomicStore(&Victim->Stamp, Time);
+	FPlatformAtomics::AtomicStore(&Victim->Key, static_cast<int64>(Key));
+	Victim->Length = Length;
+	FMemory::Memcpy(reinterpret_cast<uint8*>(Victim) + sizeof(FSlotHeader), Utf8.Get(), Length);
+	Victim->Checksum = RecordChecksum(Key, Length, Utf8.Get());
+
+	// Fails only if the claim was reclaimed as stale; the checksum guards what readers see
+	FPlatformAtomics::InterlockedCompareExchange(&Victim->Sequence, NextSequence(Claimed, 1, 0), Claimed);
+
+	++Stats.Inserts;
+	FPlatformAtomics::InterlockedIncrement(&reinterpret_cast<FHeader*>(Base)->Inserts);
+}
+
+FLLMSharedResponseCache::FStats FLLMSharedResponseCache::GetStats() const
+{
+	const LLMSharedResponseCachePrivate::FHeader& Header = *reinterpret_cast<const LLMSharedResponseCachePrivate::FHeader*>(Base);
+	FStats Result = Stats;
+	Result.HostHits = FPlatformAtomics::AtomicRead(&Header.Hits);
+	Result.HostInserts = FPlatformAtomics::AtomicRead(&Header.Inserts);
+	return Result;
+}
@@ -0,0 +1,74 @@
+﻿// Host-wide response cache shared by every game process through a memory-mapped file
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Lock-free open-addressing hash table in a memory-mapped file
+ * Dedicated servers on one host attach to the same file, so a response fetched by one process
+ * answers the identical request in all of them. Slots have a fixed size and are guarded by a
+ * sequence lock: a writer claims a slot by moving its sequence to an odd value with a CAS that
+ * also stamps the claim time, readers retry nothing and treat an odd or changed sequence as a
+ * miss, and a CRC of key, length and body rejects anything torn. Nobody ever waits on another process.
+ * - Versioning: the header records format version and layout; a mismatching file is left alone
+ * - Eviction: a key may live in a small probe window; inserting into a full window replaces its oldest entry
+ * - Crash safety: a slot whose writer died mid-write is reclaimed once its claim is stale, and a
+ *   header left half-initialized by a crashed process is initialized again
+ */
+class TESTCPP_API FLLMSharedResponseCache
+{
+public:
+	struct FStats
+	{
+		// This process
+		int64 Lookups = 0;
+		int64 Hits = 0;
+		int64 Inserts = 0;
+		// Inserts dropped because the slot was being written or the body did not fit
+		int64 SkippedInserts = 0;
+		// Every attached process since the file was created
+		int64 HostHits = 0;
+		int64 HostInserts = 0;
+	};
+
+	~FLLMSharedResponseCache();
+
+	/**
+	 * Map (creating if needed) the cache file
+	 * @param NumSlots - Slot count, rounded up to a power of two
+	 * @param SlotBytes - Bytes per slot including its header; larger responses are not cached
+	 * @param TimeToLiveSeconds - Entries older than this are misses
+	 * @return null when the file cannot be mapped or has an incompatible layout
+	 */
+	static TUniquePtr<FLLMSharedResponseCache> Attach(const FString& Path, int32 NumSlots, int32 SlotBytes, int32 TimeToLiveSeconds);
+
+	// Key of a request: endpoint (without credentials) and exact payload
+	static uint64 MakeKey(const FString& Endpoint, const FString& Payload);
+
+	bool Find(uint64 Key, FString& OutBody);
+
+	void Insert(uint64 Key, const FString& Body);
+
+	FStats GetStats() const;
+
+	const FString& GetPath() const { return Path; }
+
+private:
+	FLLMSharedResponseCache() = default;
+
+	bool InitializeHeader();
+	uint8* GetSlot(uint32 Index) const;
+
+	FString Path;
+	uint8* Base = nullptr;
+	int64 MappedSize = 0;
+	uint32 NumSlots = 0;
+	uint32 SlotBytes = 0;
+	int64 TimeToLiveSeconds = 0;
+
+	// Platform mapping handles (file mapping on Windows, unused elsewhere)
+	void* FileHandle = nullptr;
+	void* MappingHandle = nullptr;
+
+	FStats Stats;
+};
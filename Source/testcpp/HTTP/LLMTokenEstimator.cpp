@@ -0,0 +1,204 @@
+﻿// Local prompt token estimate, calibrated against the token counts providers report
+#include "HTTP/LLMTokenEstimator.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "Algo/StableSort.h"
+
+namespace LLMTokenEstimatorPrivate
+{
+	// Weight of one measurement in the running scale
+	static constexpr double CalibrationRate = 0.1;
+
+	// A section shorter than this is dropped rather than cut
+	static constexpr int32 MinSectionTokens = 8;
+
+	static const TCHAR* TrimMarker = TEXT("...");
+
+	static FString FormatSection(const FLLMPromptSection& Section)
+	{
+		return FString::Printf(TEXT("[%s]\n%s\n\n"), *Section.Name, *Section.Text);
+	}
+}
+
+int32 FLLMTokenEstimator::EstimateRaw(const FString& Text)
+{
+	int32 Tokens = 0;
+	int32 Index = 0;
+	const int32 Len = Text.Len();
+	while (Index < Len)
+	{
+		const TCHAR C = Text[Index];
+		if (FChar::IsWhitespace(C))
+		{
+			++Index;
+			continue;
+		}
+
+		int32 RunEnd = Index + 1;
+		if (C < 128 && FChar::IsAlpha(C))
+		{
+			while (RunEnd < Len && Text[RunEnd] < 128 && FChar::IsAlpha(Text[RunEnd]))
+			{
+				++RunEnd;
+			}
+			Tokens += 1 + (RunEnd - Index - 1) / 5;
+		}
+		else if (FChar::IsDigit(C))
+		{
+			while (RunEnd < Len && FChar::IsDigit(Text[RunEnd]))
+			{
+				++RunEnd;
+			}
+			Tokens += 1 + (RunEnd - Index - 1) / 3;
+		}
+		else
+		{
+			// Punctuation, symbols and non-Latin characters
+			++Tokens;
+		}
+		Index = RunEnd;
+	}
+	return Tokens;
+}
+
+int32 FLLMTokenEstimator::Scale(int32 RawTokens) const
+{
+	return FMath::CeilToInt32(RawTokens * ScaleFactor);
+}
+
+void FLLMTokenEstimator::Calibrate(int32 RawTokens, int32 ActualTokens)
+{
+	if (RawTokens <= 0 || ActualTokens <= 0)
+	{
+		return;
+	}
+
+	const double Ratio = FMath::Clamp(double(ActualTokens) / RawTokens, 0.25, 4.0);
+	ScaleFactor = NumCalibrations == 0 ? Ratio : FMath::Lerp(ScaleFactor, Ratio, LLMTokenEstimatorPrivate::CalibrationRate);
+	++NumCalibrations;
+}
+
+int32 FLLMTokenEstimator::FitToBudget(int32 Budget, int32 FixedTokens, TArray<FLLMPromptSection>& Sections, FString& Prompt,
+	int32& OutTrimmedSections, bool& bOutPromptTruncated) const
+{
+	using namespace LLMTokenEstimatorPrivate;
+
+	OutTrimmedSections = 0;
+	bOutPromptTruncated = false;
+
+	auto SectionTokens = [this](const FLLMPromptSection& Section)
+	{
+		return Section.Text.IsEmpty() ? 0 : Estimate(FormatSection(Section));
+	};
+
+	int32 PromptTokens = Estimate(Prompt);
+	int32 Total = FixedTokens + PromptTokens;
+	for (const FLLMPromptSection& Section : Sections)
+	{
+		Total += SectionTokens(Section);
+	}
+	if (Budget <= 0 || Total <= Budget)
+	{
+		return Total - FixedTokens;
+	}
+
+	// Lowest priority first; equal priorities keep their order in the prompt
+	TArray<int32> Order;
+	for (int32 Index = 0; Index < Sections.Num(); ++Index)
+	{
+		Order.Add(Index);
+	}
+	Algo::StableSortBy(Order, [&Sections](int32 Index) { return Sections[Index].Priority; });
+
+	for (int32 Index : Order)
+	{
+		FLLMPromptSection& Section = Sections[Index];
+		if (Total <= Budget)
+		{
+			break;
+		}
+		if (Section.Text.IsEmpty())
+		{
+			continue;
+		}
+
+		const int32 Before = SectionTokens(Section);
+		TrimSection(Section, Before - (Total - Budget));
+		Total += SectionTokens(Section) - Before;
+		++OutTrimmedSections;
+	}
+
+	if (Total > Budget && PromptTokens > 0)
+	{
+		// Keep the beginning of what the player wrote; that is where requests state their intent
+		const int32 Allowed = FMath::Max(PromptTokens - (Total - Budget), 1);
+		Prompt = Prompt.Left(FMath::Max(1, int32(int64(Prompt.Len()) * Allowed / PromptTokens)));
+		Total += Estimate(Prompt) - PromptTokens;
+		bOutPromptTruncated = true;
+	}
+	return Total - FixedTokens;
+}
+
+void FLLMTokenEstimator::TrimSection(FLLMPromptSection& Section, int32 TargetTokens) const
+{
+	using namespace LLMTokenEstimatorPrivate;
+
+	FLLMPromptSection Empty;
+	Empty.Name = Section.Name;
+	Empty.Text = TrimMarker;
+	const int32 Overhead = Estimate(FormatSection(Empty));
+
+	TArray<FString> Lines;
+	Section.Text.ParseIntoArrayLines(Lines, false);
+	if (TargetTokens - Overhead < MinSectionTokens || Lines.Num() == 0)
+	{
+		Section.Text.Empty();
+		return;
+	}
+
+	int32 Tokens = Overhead;
+	TArray<int32> LineTokens;
+	for (const FString& Line : Lines)
+	{
+		Tokens += LineTokens.Add_GetRef(Estimate(Line));
+	}
+
+	// Drop lines from the low-value end (the start for sections whose newest lines come last)
+	while (Lines.Num() > 1 && Tokens > TargetTokens)
+	{
+		const int32 Drop = Section.bKeepTail ? 0 : Lines.Num() - 1;
+		Tokens -= LineTokens[Drop];
+		Lines.RemoveAt(Drop);
+		LineTokens.RemoveAt(Drop);
+	}
+
+	FString& Remaining = Lines[0];
+	if (Lines.Num() == 1 && Tokens > TargetTokens && LineTokens[0] > 0)
+	{
+		const int32 Keep = FMath::Max(1, int32(int64(Remaining.Len()) * (TargetTokens - Overhead) / LineTokens[0]));
+		Remaining = Section.bKeepTail ? Remaining.Right(Keep) : Remaining.Left(Keep);
+	}
+
+	if (Section.bKeepTail)
+	{
+		Lines.Insert(TrimMarker, 0);
+	}
+	else
+	{
+		Lines.Add(TrimMarker);
+	}
+	Section.Text = FString::Join(Lines, TEXT("\n"));
+}
+
+FString FLLMTokenEstimator::Compose(const TArray<FLLMPromptSection>& Sections, const FString& Prompt)
+{
+	FString Result;
+	for (const FLLMPromptSection& Section : Sections)
+	{
+		if (!Section.Text.IsEmpty())
+		{
+			Result += LLMTokenEstimatorPrivate::FormatSection(Section);
+		}
+	}
+	Result += Prompt;
+	return Result;
+}
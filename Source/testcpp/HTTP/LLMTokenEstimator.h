@@ -0,0 +1,54 @@
+﻿// Local prompt token estimate, calibrated against the token counts providers report
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FLLMPromptSection;
+
+/**
+ * Approximates a subword tokenizer without its vocabulary: letter runs cost about one token
+ * per five characters, digit runs one per three, punctuation one each and non-Latin characters
+ * one each. The raw count is multiplied by a per-model scale learned from usageMetadata, so the
+ * estimate converges on what the provider actually bills.
+ */
+class TESTCPP_API FLLMTokenEstimator
+{
+public:
+	/** Uncalibrated token count of a text */
+	static int32 EstimateRaw(const FString& Text);
+
+	/** Calibrated token count of a text */
+	int32 Estimate(const FString& Text) const { return Scale(EstimateRaw(Text)); }
+
+	/** Raw count converted with the learned scale */
+	int32 Scale(int32 RawTokens) const;
+
+	/** Fold in one prompt whose actual token count the provider reported */
+	void Calibrate(int32 RawTokens, int32 ActualTokens);
+
+	double GetScale() const { return ScaleFactor; }
+	int32 GetNumCalibrations() const { return NumCalibrations; }
+
+	/**
+	 * Trim context sections, lowest Priority first, until the prompt fits a budget; the player's
+	 * prompt itself is only shortened when removing every section is not enough
+	 * @param Budget - Max input tokens (<= 0: no limit)
+	 * @param FixedTokens - Tokens that cannot be trimmed (system instruction, schema)
+	 * @param Sections - Shortened or emptied in place
+	 * @param Prompt - Cut when still over budget
+	 * @param OutTrimmedSections - Sections that were shortened or emptied
+	 * @return Estimated tokens of the sections and prompt after trimming
+	 */
+	int32 FitToBudget(int32 Budget, int32 FixedTokens, TArray<FLLMPromptSection>& Sections, FString& Prompt,
+		int32& OutTrimmedSections, bool& bOutPromptTruncated) const;
+
+	/** Text sent to the model: each non-empty section under its name, then the prompt */
+	static FString Compose(const TArray<FLLMPromptSection>& Sections, const FString& Prompt);
+
+private:
+	// Shorten a section to about TargetTokens, dropping whole lines from its low-value end
+	void TrimSection(FLLMPromptSection& Section, int32 TargetTokens) const;
+
+	double ScaleFactor = 1.0;
+	int32 NumCalibrations = 0;
+};
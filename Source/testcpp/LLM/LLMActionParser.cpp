@@ -1,22 +1,22 @@
 // Parses and validates LLM JSON output into structured actions
 #include "LLM/LLMActionParser.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMPromptTemplate.h"
+#include "LLM/LLMNavPointRegistry.h"
+#include "LLM/LLMSettings.h"
 #include "Dom/JsonObject.h"
 #include "Serialization/JsonReader.h"
 #include "Serialization/JsonSerializer.h"
 #include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
 #include "Kismet/GameplayStatics.h"
 
-// Validation constants
-namespace LLMActionConstants
-{
-	static constexpr float MinConfidenceThreshold = 0.5f;
-	static constexpr int32 MaxSpeakTextLength = 500;
-}
-
 bool ULLMActionParser::ParseAction(const FString& JsonText, FLLMAction& OutAction)
 {
 	OutAction = FLLMAction(); // Reset to defaults
-	OutAction.RawJson = JsonText;
 
 	// Parse JSON
 	TSharedPtr<FJsonObject> JsonObj;
@@ -27,6 +27,104 @@ bool ULLMActionParser::ParseAction(const FString& JsonText, FLLMAction& OutActio
 		return false;
 	}
 
+	// A plan answers with its first step here; use ParsePlan to keep the rest
+	const TArray<TSharedPtr<FJsonValue>>* PlanArray;
+	if (JsonObj->TryGetArrayField(TEXT("plan"), PlanArray))
+	{
+		const TSharedPtr<FJsonObject>* FirstStep;
+		if (PlanArray->Num() == 0 || !(*PlanArray)[0]->TryGetObject(FirstStep))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMActionParser] 'plan' has no valid steps"));
+			return false;
+		}
+		if (PlanArray->Num() > 1)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] ParseAction received a %d-step plan, using the first step"), PlanArray->Num());
+		}
+		JsonObj = *FirstStep;
+	}
+
+	OutAction.RawJson = JsonText;
+	return ParseActionObject(*JsonObj, OutAction);
+}
+
+bool ULLMActionParser::ParsePlan(const FString& JsonText, FLLMPlan& OutPlan)
+{
+	OutPlan = FLLMPlan();
+	OutPlan.RawJson = JsonText;
+
+	TSharedPtr<FJsonObject> JsonObj;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, JsonObj) || !JsonObj.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMActionParser] Failed to parse JSON: %s"), *JsonText);
+		return false;
+	}
+
+	// Single action: a one-step plan
+	const TArray<TSharedPtr<FJsonValue>>* PlanArray;
+	if (!JsonObj->TryGetArrayField(TEXT("plan"), PlanArray))
+	{
+		FLLMPlanStep& Step = OutPlan.Steps.AddDefaulted_GetRef();
+		Step.Action.RawJson = JsonText;
+		return ParseActionObject(*JsonObj, Step.Action);
+	}
+
+	const int32 MaxSteps = GetDefault<ULLMSettings>()->MaxPlanSteps;
+	if (PlanArray->Num() > MaxSteps)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Plan has %d steps, truncating to %d"), PlanArray->Num(), MaxSteps);
+	}
+
+	const int32 NumSteps = FMath::Min(PlanArray->Num(), MaxSteps);
+	OutPlan.Steps.Reserve(NumSteps);
+	for (int32 Index = 0; Index < NumSteps; ++Index)
+	{
+		const TSharedPtr<FJsonObject>* StepObj;
+		if (!(*PlanArray)[Index]->TryGetObject(StepObj))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMActionParser] Plan step %d is not an object"), Index);
+			return false;
+		}
+
+		FLLMPlanStep& Step = OutPlan.Steps.AddDefaulted_GetRef();
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Step.Action.RawJson);
+		FJsonSerializer::Serialize(StepObj->ToSharedRef(), Writer);
+		if (!ParseActionObject(**StepObj, Step.Action))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMActionParser] Failed to parse plan step %d"), Index);
+			return false;
+		}
+
+		FString ConditionStr;
+		if ((*StepObj)->TryGetStringField(TEXT("condition"), ConditionStr))
+		{
+			const int64 Value = StaticEnum<ELLMPlanStepCondition>()->GetValueByNameString(ConditionStr);
+			if (Value != INDEX_NONE)
+			{
+				Step.Condition = static_cast<ELLMPlanStepCondition>(Value);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Unknown step condition '%s', using OnSuccess"), *ConditionStr);
+			}
+		}
+	}
+
+	if (OutPlan.Steps.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMActionParser] 'plan' has no steps"));
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMActionParser] Parsed plan with %d steps"), OutPlan.Steps.Num());
+	return true;
+}
+
+bool ULLMActionParser::ParseActionObject(const FJsonObject& Json, FLLMAction& OutAction)
+{
+	const FJsonObject* JsonObj = &Json;
+
 	// Parse intent (required)
 	FString IntentStr;
 	if (!JsonObj->TryGetStringField(TEXT("intent"), IntentStr))
@@ -34,7 +132,7 @@ bool ULLMActionParser::ParseAction(const FString& JsonText, FLLMAction& OutActio
 		UE_LOG(LogTemp, Error, TEXT("[LLMActionParser] Missing 'intent' field in JSON"));
 		return false;
 	}
-	OutAction.Intent = ParseIntent(IntentStr);
+	ParseIntent(IntentStr, OutAction);
 
 	// Parse target (optional)
 	const TSharedPtr<FJsonObject>* TargetObj;
@@ -115,113 +213,38 @@ bool ULLMActionParser::ParseAction(const FString& JsonText, FLLMAction& OutActio
 	}
 
 	UE_LOG(LogTemp, Log, TEXT("[LLMActionParser] Parsed action - Intent: %s, Confidence: %.2f"), 
-		*IntentToString(OutAction.Intent), OutAction.Confidence);
+		*ULLMIntentRegistry::GetWireName(OutAction), OutAction.Confidence);
 
 	return true;
 }
 
 bool ULLMActionParser::ValidateAction(const FLLMAction& Action, FString& OutErrorMessage)
 {
-	OutErrorMessage.Empty();
-
-	// Idle is always valid
-	if (Action.Intent == ELLMIntent::Idle)
-	{
-		return true;
-	}
-
-	// Check confidence threshold (hardcoded to 0.5 for MVP)
-	if (Action.Confidence < LLMActionConstants::MinConfidenceThreshold)
-	{
-		OutErrorMessage = FString::Printf(TEXT("Confidence %.2f below threshold %.2f"), 
-			Action.Confidence, LLMActionConstants::MinConfidenceThreshold);
-		UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-		return false;
-	}
-
-	// Validate MoveTo
-	if (Action.Intent == ELLMIntent::MoveTo)
-	{
-		if (Action.Location.bUseCoordinates)
-		{
-			// Note: We don't validate against zero as (0,0,0) could be a valid world location
-			// In production, consider validating against world bounds or NavMesh
-		}
-		else
-		{
-			if (Action.Location.NavPointName.IsEmpty())
-			{
-				OutErrorMessage = TEXT("MoveTo requires either coordinates or NavPointName");
-				UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-				return false;
-			}
-		}
-		return true;
-	}
+	// Rules are compiled once from the same description that generates the response schema
+	return ULLMActionSchema::Validate(Action, OutErrorMessage);
+}
 
-	// Validate Interact
-	if (Action.Intent == ELLMIntent::Interact)
+bool ULLMActionParser::NormalizeAction(FLLMAction& Action, UObject* WorldContext)
+{
+	// Resolve a named navigation point to its navmesh location; the name is kept so cached plans
+	// are re-resolved for whichever agent replays them
+	bool bNormalized = true;
+	if (Action.Intent == ELLMIntent::MoveTo && !Action.Location.bUseCoordinates)
 	{
-		if (Action.Target.Id.IsEmpty() && Action.Target.Type.IsEmpty())
+		const AActor* Agent = Cast<AActor>(WorldContext);
+		if (const AController* Controller = Cast<AController>(Agent))
 		{
-			OutErrorMessage = TEXT("Interact requires target id or type");
-			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-			return false;
+			Agent = Controller->GetPawn() ? Controller->GetPawn() : Agent;
 		}
-		return true;
-	}
 
-	// Validate Speak
-	if (Action.Intent == ELLMIntent::Speak)
-	{
-		if (Action.Speak.IsEmpty())
+		ULLMNavPointRegistry* Registry = ULLMNavPointRegistry::Get(WorldContext);
+		Action.Location.bResolved = Registry && Registry->ResolveName(Action.Location.NavPointName,
+			Agent ? Agent->GetActorLocation() : FVector::ZeroVector, Action.Location.Coordinates);
+		if (!Action.Location.bResolved)
 		{
-			OutErrorMessage = TEXT("Speak requires non-empty speak text");
-			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-			return false;
-		}
-		// MVP: limit speak length to configured maximum
-		if (Action.Speak.Len() > LLMActionConstants::MaxSpeakTextLength)
-		{
-			OutErrorMessage = FString::Printf(TEXT("Speak text exceeds %d character limit"), 
-				LLMActionConstants::MaxSpeakTextLength);
-			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-			return false;
+			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Named navigation point '%s' is not registered"), *Action.Location.NavPointName);
+			bNormalized = false;
 		}
-		return true;
-	}
-
-	// Validate PlayMontage
-	if (Action.Intent == ELLMIntent::PlayMontage)
-	{
-		if (Action.Montage.Name.IsEmpty())
-		{
-			OutErrorMessage = TEXT("PlayMontage requires montage.name");
-			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-			return false;
-		}
-		if (Action.Montage.PlayRate <= 0.0f || Action.Montage.PlayRate > 5.0f)
-		{
-			OutErrorMessage = TEXT("PlayMontage playRate must be in (0, 5.0]");
-			UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-			return false;
-		}
-		return true;
-	}
-
-	// Unknown intent
-	OutErrorMessage = FString::Printf(TEXT("Unknown intent: %s"), *IntentToString(Action.Intent));
-	UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Validation failed: %s"), *OutErrorMessage);
-	return false;
-}
-
-bool ULLMActionParser::NormalizeAction(FLLMAction& Action, UObject* WorldContext)
-{
-	// If using named navigation point, try to resolve it to coordinates
-	if (Action.Intent == ELLMIntent::MoveTo && !Action.Location.bUseCoordinates)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Named navigation point '%s' requires game-specific resolution"), 
-			*Action.Location.NavPointName);
 	}
 
 	// Apply any default values
@@ -230,78 +253,27 @@ bool ULLMActionParser::NormalizeAction(FLLMAction& Action, UObject* WorldContext
 		Action.Confidence = 1.0f;
 	}
 
-	return true;
+	return bNormalized;
 }
 
 FString ULLMActionParser::GetRecommendedSystemPrompt()
 {
-	return TEXT(
-		"You are an AI assistant that converts natural language commands into structured JSON actions for a game character. "
-		"You must ONLY output valid JSON with no additional text or explanation.\n\n"
-		"Supported intents:\n"
-		"- MoveTo: Move character to a location\n"
-		"- Interact: Interact with an object\n"
-		"- Speak: Make character speak\n"
-		"- PlayMontage: Play an animation montage by name\n\n"
-		"JSON schema:\n"
-		"{\n"
-		"  \"intent\": \"MoveTo\" | \"Interact\" | \"Speak\" | \"PlayMontage\",\n"
-		"  \"target\": {\"id\": \"string\", \"type\": \"string\"} (optional, for Interact),\n"
-		"  \"location\": {\"x\": 0, \"y\": 0, \"z\": 0} | \"NavPointName\" (for MoveTo),\n"
-		"  \"speak\": \"text to say\" (for Speak),\n"
-		"  \"montage\": { \"name\": \"string\", \"section\": \"string?\", \"playRate\": 1.0, \"loop\": false } (for PlayMontage),\n"
-		"  \"params\": {} (optional),\n"
-		"  \"confidence\": 0.0-1.0 (required)\n"
-		"}\n\n"
-		"Examples:\n"
-		"User: \"Go to the fountain\"\n"
-		"{\"intent\":\"MoveTo\",\"location\":\"Fountain\",\"confidence\":0.9}\n\n"
-		"User: \"Talk to the guard\"\n"
-		"{\"intent\":\"Interact\",\"target\":{\"type\":\"Guard\"},\"confidence\":0.85}\n\n"
-		"User: \"Say hello\"\n"
-		"{\"intent\":\"Speak\",\"speak\":\"Hello\",\"confidence\":0.95}\n\n"
-		"User: \"Do a wave animation\"\n"
-		"{\"intent\":\"PlayMontage\",\"montage\":{\"name\":\"Wave\",\"playRate\":1.0},\"confidence\":0.9}\n\n"
-		"Output ONLY valid JSON. No markdown, no explanation."
-	);
+	// The built-in template with no persona; rendered once per intent registry and plan settings
+	return ULLMPromptTemplate::BuildSystemPrompt(nullptr, nullptr);
 }
 
-ELLMIntent ULLMActionParser::ParseIntent(const FString& IntentStr)
+void ULLMActionParser::ParseIntent(const FString& IntentStr, FLLMAction& OutAction)
 {
-	if (IntentStr.Equals(TEXT("MoveTo"), ESearchCase::IgnoreCase))
-	{
-		return ELLMIntent::MoveTo;
-	}
-	if (IntentStr.Equals(TEXT("Interact"), ESearchCase::IgnoreCase))
-	{
-		return ELLMIntent::Interact;
-	}
-	if (IntentStr.Equals(TEXT("Speak"), ESearchCase::IgnoreCase))
-	{
-		return ELLMIntent::Speak;
-	}
-	if (IntentStr.Equals(TEXT("PlayMontage"), ESearchCase::IgnoreCase))
+	// Hashed, case-insensitive lookup of the wire name
+	const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+	if (const ULLMIntentDefinition* Definition = Registry ? Registry->FindByWireName(IntentStr) : nullptr)
 	{
-		return ELLMIntent::PlayMontage;
-	}
-	if (IntentStr.Equals(TEXT("Idle"), ESearchCase::IgnoreCase))
-	{
-		return ELLMIntent::Idle;
+		OutAction.Intent = Definition->BuiltInIntent;
+		OutAction.IntentTag = Definition->IntentTag;
+		return;
 	}
 
 	UE_LOG(LogTemp, Warning, TEXT("[LLMActionParser] Unknown intent '%s', defaulting to Idle"), *IntentStr);
-	return ELLMIntent::Idle;
-}
-
-FString ULLMActionParser::IntentToString(ELLMIntent Intent)
-{
-	switch (Intent)
-	{
-	case ELLMIntent::MoveTo: return TEXT("MoveTo");
-	case ELLMIntent::Interact: return TEXT("Interact");
-	case ELLMIntent::Speak: return TEXT("Speak");
-	case ELLMIntent::PlayMontage: return TEXT("PlayMontage");
-	case ELLMIntent::Idle: return TEXT("Idle");
-	default: return TEXT("Unknown");
-	}
+	OutAction.Intent = ELLMIntent::Idle;
+	OutAction.IntentTag = ULLMIntentRegistry::GetBuiltInTag(ELLMIntent::Idle);
 }
@@ -4,6 +4,7 @@
 #include "CoreMinimal.h"
 #include "UObject/NoExportTypes.h"
 #include "LLM/LLMActionTypes.h"
+#include "Dom/JsonObject.h"
 #include "LLMActionParser.generated.h"
 
 /**
@@ -25,6 +26,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "LLM|Parser")
 	static bool ParseAction(const FString& JsonText, FLLMAction& OutAction);
 
+	/**
+	 * Parse JSON string from LLM into a plan
+	 * Accepts {"plan": [action, ...]} (each step may carry a "condition") or a single action object
+	 * @param JsonText - JSON string to parse
+	 * @param OutPlan - Populated plan; a single action yields one step
+	 * @return true if every step parsed
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Parser")
+	static bool ParsePlan(const FString& JsonText, FLLMPlan& OutPlan);
+
 	/**
 	 * Validate that an action has required fields and correct types
 	 * @param Action - Action to validate
@@ -37,8 +48,8 @@ public:
 	/**
 	 * Normalize action: apply defaults, resolve named locations to coordinates
 	 * @param Action - Action to normalize (modified in place)
-	 * @param WorldContext - World context for navigation point lookup
-	 * @return true if normalization succeeded
+	 * @param WorldContext - The agent (controller or pawn): named points resolve nearest to it through ULLMNavPointRegistry
+	 * @return false if a named navigation point is not registered
 	 */
 	UFUNCTION(BlueprintCallable, Category = "LLM|Parser", meta = (WorldContext = "WorldContext"))
 	static bool NormalizeAction(UPARAM(ref) FLLMAction& Action, UObject* WorldContext);
@@ -51,9 +62,9 @@ public:
 	static FString GetRecommendedSystemPrompt();
 
 private:
-	// Helper: parse intent string to enum
-	static ELLMIntent ParseIntent(const FString& IntentStr);
+	// Helper: populate an action from one parsed action object
+	static bool ParseActionObject(const FJsonObject& Json, FLLMAction& OutAction);
 
-	// Helper: intent enum to string
-	static FString IntentToString(ELLMIntent Intent);
+	// Helper: resolve intent string through the intent registry, setting Intent and IntentTag
+	static void ParseIntent(const FString& IntentStr, FLLMAction& OutAction);
 };
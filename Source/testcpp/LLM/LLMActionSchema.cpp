@@ -0,0 +1,710 @@
+// Reflection-driven response schema and compiled validator for FLLMAction
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMSettings.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/UnrealType.h"
+
+namespace LLMActionSchemaPrivate
+{
+	static constexpr float MinConfidenceThreshold = 0.5f;
+	static constexpr int32 MaxSpeakTextLength = 500;
+	// Response schemas have no exclusive bounds; an exclusive minimum is offered as the minimum plus this step
+	static constexpr float ExclusiveMinStep = 0.01f;
+
+	// How a field is stored inside FLLMAction, resolved once from reflection
+	enum class EFieldStorage : uint8
+	{
+		String,
+		Float,
+		Bool,
+		Location
+	};
+
+	struct FCompiledRule
+	{
+		int32 Offset = 0;
+		int32 AltOffset = INDEX_NONE;
+		EFieldStorage Storage = EFieldStorage::String;
+		EFieldStorage AltStorage = EFieldStorage::String;
+		ELLMRuleKind Kind = ELLMRuleKind::Required;
+		float Min = 0.0f;
+		float Max = 0.0f;
+		bool bExclusiveMin = false;
+		FString ErrorMessage;
+	};
+
+	// Contiguous slice of the rule table for one intent; Num == INDEX_NONE means the intent is unknown
+	struct FRuleSpan
+	{
+		int32 First = 0;
+		int32 Num = INDEX_NONE;
+	};
+
+	// Inputs shared by every node of one schema build
+	struct FBuildContext
+	{
+		// Range/MaxLength rules keyed by reflected path (e.g. "Montage.PlayRate")
+		TMap<FString, FLLMFieldRule> Bounds;
+		// Optional "enum" value sets keyed by reflected path
+		TMap<FString, const TArray<FString>*> Enums;
+	};
+
+	struct FSchemaCache
+	{
+		FBuildContext Context;
+		TArray<FString> IntentNames;
+		TSharedPtr<FJsonObject> Schema;
+		FString SchemaJson;
+		TArray<FCompiledRule> Rules;
+		TMap<FGameplayTag, FRuleSpan> SpansByTag;
+		int32 RegistryRevision = INDEX_NONE;
+
+		// Plan wrapper around Schema, built on first request for the current step limit
+		mutable TSharedPtr<FJsonObject> PlanSchema;
+		mutable int32 PlanMaxSteps = INDEX_NONE;
+	};
+
+	// One intent as seen by the compiler, from the registry or the built-in fallback
+	struct FIntentSource
+	{
+		FGameplayTag Tag;
+		FString WireName;
+		TConstArrayView<FLLMFieldRule> Rules;
+	};
+
+	// Runtime-only properties that never appear in the wire contract
+	static const FName SkippedProperties[] = { TEXT("RawJson"), TEXT("Params"), TEXT("IntentTag"), TEXT("bUseCoordinates") };
+
+	// Top-level fields the model must always emit
+	static const FName RequiredProperties[] = { TEXT("Intent"), TEXT("Confidence") };
+
+	static FLLMFieldRule MakeRule(ELLMActionField Field, ELLMRuleKind Kind, const TCHAR* Error,
+		float Min = 0.0f, float Max = 0.0f, bool bExclusiveMin = false, ELLMActionField Alternate = ELLMActionField::None)
+	{
+		FLLMFieldRule Rule;
+		Rule.Field = Field;
+		Rule.Kind = Kind;
+		Rule.AlternateField = Alternate;
+		Rule.Min = Min;
+		Rule.Max = Max;
+		Rule.bExclusiveMin = bExclusiveMin;
+		Rule.ErrorMessage = Error;
+		return Rule;
+	}
+
+	// Rules applied to every non-Idle intent
+	static const TArray<FLLMFieldRule>& GetGlobalRules()
+	{
+		static const TArray<FLLMFieldRule> Rules = {
+			MakeRule(ELLMActionField::Confidence, ELLMRuleKind::Range, TEXT("Confidence must be in [0, 1]"), 0.0f, 1.0f)
+		};
+		return Rules;
+	}
+
+	static bool IsSkipped(const FProperty* Property)
+	{
+		for (const FName& Name : SkippedProperties)
+		{
+			if (Property->GetFName() == Name)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// C++ property name -> contract name: "PlayRate" -> "playRate", "bLoop" -> "loop"
+	static FString ToWireName(const FProperty* Property)
+	{
+		FString Name = Property->GetName();
+		if (Property->IsA<FBoolProperty>() && Name.Len() > 1 && Name[0] == TEXT('b') && FChar::IsUpper(Name[1]))
+		{
+			Name.RightChopInline(1);
+		}
+		if (!Name.IsEmpty())
+		{
+			Name[0] = FChar::ToLower(Name[0]);
+		}
+		return Name;
+	}
+
+	// Resolve a field to a byte offset inside FLLMAction by walking its reflected property path
+	static bool ResolveField(ELLMActionField Field, int32& OutOffset, EFieldStorage& OutStorage)
+	{
+		const TCHAR* Path = ULLMActionSchema::GetFieldPath(Field);
+		if (!Path)
+		{
+			return false;
+		}
+
+		TArray<FString> Segments;
+		FString(Path).ParseIntoArray(Segments, TEXT("."));
+
+		const UStruct* Struct = FLLMAction::StaticStruct();
+		const FProperty* Property = nullptr;
+		int32 Offset = 0;
+		for (const FString& Segment : Segments)
+		{
+			if (!Struct)
+			{
+				return false;
+			}
+			Property = FindFProperty<FProperty>(Struct, FName(*Segment));
+			if (!Property)
+			{
+				return false;
+			}
+			Offset += Property->GetOffset_ForInternal();
+			const FStructProperty* StructProperty = CastField<FStructProperty>(Property);
+			Struct = StructProperty ? StructProperty->Struct : nullptr;
+		}
+
+		if (Property->IsA<FStrProperty>())
+		{
+			OutStorage = EFieldStorage::String;
+		}
+		else if (Property->IsA<FFloatProperty>())
+		{
+			OutStorage = EFieldStorage::Float;
+		}
+		else if (Property->IsA<FBoolProperty>())
+		{
+			OutStorage = EFieldStorage::Bool;
+		}
+		else if (Struct == FLLMLocation::StaticStruct())
+		{
+			OutStorage = EFieldStorage::Location;
+		}
+		else
+		{
+			return false;
+		}
+
+		OutOffset = Offset;
+		return true;
+	}
+
+	static bool CompileRule(const FLLMFieldRule& Rule, FCompiledRule& OutRule)
+	{
+		if (!ResolveField(Rule.Field, OutRule.Offset, OutRule.Storage))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMActionSchema] Rule references unresolvable field %d"), static_cast<int32>(Rule.Field));
+			return false;
+		}
+		if (Rule.Kind == ELLMRuleKind::Required && Rule.AlternateField != ELLMActionField::None)
+		{
+			if (!ResolveField(Rule.AlternateField, OutRule.AltOffset, OutRule.AltStorage))
+			{
+				UE_LOG(LogTemp, Error, TEXT("[LLMActionSchema] Rule references unresolvable alternate field %d"), static_cast<int32>(Rule.AlternateField));
+				return false;
+			}
+		}
+		if (Rule.Kind == ELLMRuleKind::Range && OutRule.Storage != EFieldStorage::Float)
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMActionSchema] Range rule on non-numeric field %d"), static_cast<int32>(Rule.Field));
+			return false;
+		}
+		if (Rule.Kind == ELLMRuleKind::MaxLength && OutRule.Storage != EFieldStorage::String)
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMActionSchema] MaxLength rule on non-string field %d"), static_cast<int32>(Rule.Field));
+			return false;
+		}
+
+		OutRule.Kind = Rule.Kind;
+		OutRule.Min = Rule.Min;
+		OutRule.Max = Rule.Max;
+		OutRule.bExclusiveMin = Rule.bExclusiveMin;
+		OutRule.ErrorMessage = Rule.ErrorMessage;
+		return true;
+	}
+
+	static bool IsFieldSet(const uint8* Base, int32 Offset, EFieldStorage Storage)
+	{
+		switch (Storage)
+		{
+		case EFieldStorage::String:
+			return !reinterpret_cast<const FString*>(Base + Offset)->IsEmpty();
+		case EFieldStorage::Location:
+		{
+			const FLLMLocation* Location = reinterpret_cast<const FLLMLocation*>(Base + Offset);
+			return Location->bUseCoordinates || !Location->NavPointName.IsEmpty();
+		}
+		default:
+			return true;
+		}
+	}
+
+	static bool EvaluateRule(const FCompiledRule& Rule, const uint8* Base)
+	{
+		switch (Rule.Kind)
+		{
+		case ELLMRuleKind::Required:
+			return IsFieldSet(Base, Rule.Offset, Rule.Storage)
+				|| (Rule.AltOffset != INDEX_NONE && IsFieldSet(Base, Rule.AltOffset, Rule.AltStorage));
+		case ELLMRuleKind::MaxLength:
+			return reinterpret_cast<const FString*>(Base + Rule.Offset)->Len() <= static_cast<int32>(Rule.Max);
+		case ELLMRuleKind::Range:
+		{
+			const float Value = *reinterpret_cast<const float*>(Base + Rule.Offset);
+			const bool bAboveMin = Rule.bExclusiveMin ? Value > Rule.Min : Value >= Rule.Min;
+			return bAboveMin && Value <= Rule.Max;
+		}
+		default:
+			return false;
+		}
+	}
+
+	// Collect Range/MaxLength bounds keyed by contract path so the schema mirrors the validator
+	static void CollectBounds(TMap<FString, FLLMFieldRule>& OutBounds, TConstArrayView<FLLMFieldRule> Rules)
+	{
+		for (const FLLMFieldRule& Rule : Rules)
+		{
+			if (Rule.Kind != ELLMRuleKind::Required)
+			{
+				if (const TCHAR* Path = ULLMActionSchema::GetFieldPath(Rule.Field))
+				{
+					OutBounds.Add(Path, Rule);
+				}
+			}
+		}
+	}
+
+	static const UEnum* GetPropertyEnum(const FProperty* Property)
+	{
+		if (const FEnumProperty* EnumProperty = CastField<FEnumProperty>(Property))
+		{
+			return EnumProperty->GetEnum();
+		}
+		if (const FByteProperty* ByteProperty = CastField<FByteProperty>(Property))
+		{
+			return ByteProperty->Enum;
+		}
+		return nullptr;
+	}
+
+	static TSharedRef<FJsonObject> MakeTypeSchema(const TCHAR* Type)
+	{
+		TSharedRef<FJsonObject> Schema = MakeShared<FJsonObject>();
+		Schema->SetStringField(TEXT("type"), Type);
+		return Schema;
+	}
+
+	static TSharedRef<FJsonObject> BuildStructSchema(const UStruct* Struct, const FString& PathPrefix, const FBuildContext& Context);
+
+	static TSharedPtr<FJsonObject> BuildPropertySchema(const FProperty* Property, const FString& Path, const FBuildContext& Context)
+	{
+		TSharedPtr<FJsonObject> Schema;
+
+		if (Property->IsA<FStrProperty>() || Property->IsA<FNameProperty>())
+		{
+			Schema = MakeTypeSchema(TEXT("STRING"));
+			const TArray<FString>* const* EnumValues = Context.Enums.Find(Path);
+			if (EnumValues && (*EnumValues)->Num() > 0)
+			{
+				TArray<TSharedPtr<FJsonValue>> Values;
+				Values.Reserve((*EnumValues)->Num());
+				for (const FString& Value : **EnumValues)
+				{
+					Values.Add(MakeShared<FJsonValueString>(Value));
+				}
+				Schema->SetArrayField(TEXT("enum"), Values);
+			}
+		}
+		else if (Property->IsA<FFloatProperty>() || Property->IsA<FDoubleProperty>())
+		{
+			Schema = MakeTypeSchema(TEXT("NUMBER"));
+		}
+		else if (Property->IsA<FIntProperty>())
+		{
+			Schema = MakeTypeSchema(TEXT("INTEGER"));
+		}
+		else if (Property->IsA<FBoolProperty>())
+		{
+			Schema = MakeTypeSchema(TEXT("BOOLEAN"));
+		}
+		else if (const UEnum* Enum = GetPropertyEnum(Property))
+		{
+			Schema = MakeTypeSchema(TEXT("STRING"));
+			TArray<TSharedPtr<FJsonValue>> Values;
+			if (const TArray<FString>* const* EnumValues = Context.Enums.Find(Path))
+			{
+				// Explicit value set (e.g. registry wire names) replaces the reflected enum
+				for (const FString& Value : **EnumValues)
+				{
+					Values.Add(MakeShared<FJsonValueString>(Value));
+				}
+			}
+			else
+			{
+				// NumEnums() includes the implicit _MAX entry
+				for (int32 Index = 0; Index < Enum->NumEnums() - 1; ++Index)
+				{
+					Values.Add(MakeShared<FJsonValueString>(Enum->GetNameStringByIndex(Index)));
+				}
+			}
+			Schema->SetArrayField(TEXT("enum"), Values);
+		}
+		else if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property))
+		{
+			if (StructProperty->Struct == TBaseStructure<FVector>::Get())
+			{
+				Schema = MakeTypeSchema(TEXT("OBJECT"));
+				TSharedRef<FJsonObject> Props = MakeShared<FJsonObject>();
+				TArray<TSharedPtr<FJsonValue>> Axes;
+				for (const TCHAR* Axis : { TEXT("x"), TEXT("y"), TEXT("z") })
+				{
+					Props->SetObjectField(Axis, MakeTypeSchema(TEXT("NUMBER")));
+					Axes.Add(MakeShared<FJsonValueString>(Axis));
+				}
+				Schema->SetObjectField(TEXT("properties"), Props);
+				Schema->SetArrayField(TEXT("required"), Axes);
+				Schema->SetArrayField(TEXT("propertyOrdering"), Axes);
+			}
+			else if (StructProperty->Struct == FLLMLocation::StaticStruct())
+			{
+				// On the wire a location is either {x,y,z} or a bare nav-point name (bUseCoordinates is the discriminator)
+				TArray<TSharedPtr<FJsonValue>> Variants;
+				for (TFieldIterator<FProperty> It(StructProperty->Struct); It; ++It)
+				{
+					if (!IsSkipped(*It))
+					{
+						if (TSharedPtr<FJsonObject> Variant = BuildPropertySchema(*It, Path + TEXT(".") + It->GetName(), Context))
+						{
+							Variants.Add(MakeShared<FJsonValueObject>(Variant));
+						}
+					}
+				}
+				Schema = MakeShared<FJsonObject>();
+				Schema->SetArrayField(TEXT("anyOf"), Variants);
+			}
+			else
+			{
+				Schema = BuildStructSchema(StructProperty->Struct, Path + TEXT("."), Context);
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMActionSchema] Property '%s' has no schema mapping, skipping"), *Path);
+			return nullptr;
+		}
+
+		if (const FLLMFieldRule* Bound = Context.Bounds.Find(Path))
+		{
+			if (Bound->Kind == ELLMRuleKind::Range)
+			{
+				// Otherwise the schema would allow the bound itself, which Validate rejects
+				Schema->SetNumberField(TEXT("minimum"), Bound->bExclusiveMin ? Bound->Min + ExclusiveMinStep : Bound->Min);
+				Schema->SetNumberField(TEXT("maximum"), Bound->Max);
+			}
+			else if (Bound->Kind == ELLMRuleKind::MaxLength)
+			{
+				Schema->SetNumberField(TEXT("maxLength"), Bound->Max);
+			}
+		}
+
+		return Schema;
+	}
+
+	static TSharedRef<FJsonObject> BuildStructSchema(const UStruct* Struct, const FString& PathPrefix, const FBuildContext& Context)
+	{
+		TSharedRef<FJsonObject> Schema = MakeTypeSchema(TEXT("OBJECT"));
+		TSharedRef<FJsonObject> Props = MakeShared<FJsonObject>();
+		TArray<TSharedPtr<FJsonValue>> Ordering;
+		TArray<TSharedPtr<FJsonValue>> Required;
+
+		for (TFieldIterator<FProperty> It(Struct); It; ++It)
+		{
+			const FProperty* Property = *It;
+			if (IsSkipped(Property))
+			{
+				continue;
+			}
+
+			TSharedPtr<FJsonObject> PropSchema = BuildPropertySchema(Property, PathPrefix + Property->GetName(), Context);
+			if (!PropSchema.IsValid())
+			{
+				continue;
+			}
+
+			const FString WireName = ToWireName(Property);
+			Props->SetObjectField(WireName, PropSchema);
+			Ordering.Add(MakeShared<FJsonValueString>(WireName));
+
+			if (Struct == FLLMAction::StaticStruct())
+			{
+				for (const FName& RequiredName : RequiredProperties)
+				{
+					if (Property->GetFName() == RequiredName)
+					{
+						Required.Add(MakeShared<FJsonValueString>(WireName));
+					}
+				}
+			}
+		}
+
+		Schema->SetObjectField(TEXT("properties"), Props);
+		Schema->SetArrayField(TEXT("propertyOrdering"), Ordering);
+		if (Required.Num() > 0)
+		{
+			Schema->SetArrayField(TEXT("required"), Required);
+		}
+		return Schema;
+	}
+
+	static TArray<FIntentSource> GatherIntents(const ULLMIntentRegistry* Registry)
+	{
+		TArray<FIntentSource> Intents;
+		if (Registry)
+		{
+			for (const ULLMIntentDefinition* Definition : Registry->GetDefinitions())
+			{
+				Intents.Add({ Definition->IntentTag, Definition->GetWireName(), Definition->Rules });
+			}
+			return Intents;
+		}
+
+		// No registry (e.g. very early startup): fall back to the built-in contract
+		const UEnum* IntentEnum = StaticEnum<ELLMIntent>();
+		for (int32 Index = 0; Index < IntentEnum->NumEnums() - 1; ++Index)
+		{
+			const ELLMIntent Intent = static_cast<ELLMIntent>(IntentEnum->GetValueByIndex(Index));
+			if (Intent != ELLMIntent::Custom)
+			{
+				Intents.Add({ ULLMIntentRegistry::GetBuiltInTag(Intent), IntentEnum->GetNameStringByIndex(Index),
+					ULLMActionSchema::GetBuiltInRules(Intent) });
+			}
+		}
+		return Intents;
+	}
+
+	static TSharedRef<const FSchemaCache> BuildCache(const ULLMIntentRegistry* Registry)
+	{
+		TSharedRef<FSchemaCache> Cache = MakeShared<FSchemaCache>();
+		Cache->RegistryRevision = Registry ? Registry->GetRevision() : INDEX_NONE;
+
+		// Compile the flat rule table: global rules + intent rules, one contiguous span per intent
+		TMap<FString, FLLMFieldRule>& Bounds = Cache->Context.Bounds;
+		CollectBounds(Bounds, GetGlobalRules());
+		for (const FIntentSource& Intent : GatherIntents(Registry))
+		{
+			CollectBounds(Bounds, Intent.Rules);
+			Cache->IntentNames.Add(Intent.WireName);
+
+			FRuleSpan& Span = Cache->SpansByTag.Add(Intent.Tag);
+			Span.First = Cache->Rules.Num();
+			for (TConstArrayView<FLLMFieldRule> Source : { TConstArrayView<FLLMFieldRule>(GetGlobalRules()), Intent.Rules })
+			{
+				for (const FLLMFieldRule& Rule : Source)
+				{
+					FCompiledRule Compiled;
+					if (CompileRule(Rule, Compiled))
+					{
+						Cache->Rules.Add(MoveTemp(Compiled));
+					}
+				}
+			}
+			Span.Num = Cache->Rules.Num() - Span.First;
+		}
+
+		Cache->Context.Enums.Add(TEXT("Intent"), &Cache->IntentNames);
+		Cache->Schema = BuildStructSchema(FLLMAction::StaticStruct(), FString(), Cache->Context);
+
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Cache->SchemaJson);
+		FJsonSerializer::Serialize(Cache->Schema.ToSharedRef(), Writer);
+
+		UE_LOG(LogTemp, Log, TEXT("[LLMActionSchema] Built response schema (%d chars), %d intents, %d compiled rules"),
+			Cache->SchemaJson.Len(), Cache->IntentNames.Num(), Cache->Rules.Num());
+		return Cache;
+	}
+
+	// Rebuilt on first use after the intent registry changes; call from the game thread
+	static TSharedRef<const FSchemaCache> GetCache()
+	{
+		static TSharedPtr<const FSchemaCache> CurrentCache;
+
+		const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+		const int32 Revision = Registry ? Registry->GetRevision() : INDEX_NONE;
+		if (!CurrentCache.IsValid() || CurrentCache->RegistryRevision != Revision)
+		{
+			CurrentCache = BuildCache(Registry);
+		}
+		return CurrentCache.ToSharedRef();
+	}
+}
+
+FString ULLMActionSchema::GetResponseSchemaJson()
+{
+	return LLMActionSchemaPrivate::GetCache()->SchemaJson;
+}
+
+TSharedRef<FJsonObject> ULLMActionSchema::GetResponseSchema()
+{
+	return LLMActionSchemaPrivate::GetCache()->Schema.ToSharedRef();
+}
+
+int32 ULLMActionSchema::GetRevision()
+{
+	return LLMActionSchemaPrivate::GetCache()->RegistryRevision;
+}
+
+TSharedRef<FJsonObject> ULLMActionSchema::BuildConstrainedSchema(const FLLMSchemaConstraints& Constraints)
+{
+	using namespace LLMActionSchemaPrivate;
+
+	const TSharedRef<const FSchemaCache> Cache = GetCache();
+	FBuildContext Context = Cache->Context;
+	Context.Enums.Add(GetFieldPath(ELLMActionField::MontageName), &Constraints.MontageNames);
+	Context.Enums.Add(TEXT("Location.NavPointName"), &Constraints.NavPointNames);
+	Context.Enums.Add(GetFieldPath(ELLMActionField::TargetType), &Constraints.TargetTypes);
+	return BuildStructSchema(FLLMAction::StaticStruct(), FString(), Context);
+}
+
+TSharedRef<FJsonObject> ULLMActionSchema::GetPlanResponseSchema()
+{
+	using namespace LLMActionSchemaPrivate;
+
+	const TSharedRef<const FSchemaCache> Cache = GetCache();
+	const int32 MaxSteps = GetDefault<ULLMSettings>()->MaxPlanSteps;
+	if (!Cache->PlanSchema.IsValid() || Cache->PlanMaxSteps != MaxSteps)
+	{
+		Cache->PlanSchema = MakePlanSchema(Cache->Schema.ToSharedRef());
+		Cache->PlanMaxSteps = MaxSteps;
+	}
+	return Cache->PlanSchema.ToSharedRef();
+}
+
+TSharedRef<FJsonObject> ULLMActionSchema::MakePlanSchema(const TSharedRef<FJsonObject>& ActionSchema)
+{
+	using namespace LLMActionSchemaPrivate;
+
+	// Step = action object plus an optional "condition"; copies share the untouched child nodes
+	TSharedRef<FJsonObject> StepSchema = MakeShared<FJsonObject>(*ActionSchema);
+	TSharedRef<FJsonObject> StepProps = MakeShared<FJsonObject>(*ActionSchema->GetObjectField(TEXT("properties")));
+	TArray<TSharedPtr<FJsonValue>> Ordering = ActionSchema->GetArrayField(TEXT("propertyOrdering"));
+
+	const UEnum* ConditionEnum = StaticEnum<ELLMPlanStepCondition>();
+	TSharedRef<FJsonObject> ConditionSchema = MakeTypeSchema(TEXT("STRING"));
+	TArray<TSharedPtr<FJsonValue>> ConditionValues;
+	for (int32 Index = 0; Index < ConditionEnum->NumEnums() - 1; ++Index)
+	{
+		ConditionValues.Add(MakeShared<FJsonValueString>(ConditionEnum->GetNameStringByIndex(Index)));
+	}
+	ConditionSchema->SetArrayField(TEXT("enum"), ConditionValues);
+	StepProps->SetObjectField(TEXT("condition"), ConditionSchema);
+	Ordering.Add(MakeShared<FJsonValueString>(TEXT("condition")));
+
+	StepSchema->SetObjectField(TEXT("properties"), StepProps);
+	StepSchema->SetArrayField(TEXT("propertyOrdering"), Ordering);
+
+	TSharedRef<FJsonObject> PlanArray = MakeTypeSchema(TEXT("ARRAY"));
+	PlanArray->SetObjectField(TEXT("items"), StepSchema);
+	PlanArray->SetNumberField(TEXT("minItems"), 1);
+	PlanArray->SetNumberField(TEXT("maxItems"), GetDefault<ULLMSettings>()->MaxPlanSteps);
+
+	TSharedRef<FJsonObject> Schema = MakeTypeSchema(TEXT("OBJECT"));
+	TSharedRef<FJsonObject> Props = MakeShared<FJsonObject>();
+	Props->SetObjectField(TEXT("plan"), PlanArray);
+	TArray<TSharedPtr<FJsonValue>> Required;
+	Required.Add(MakeShared<FJsonValueString>(TEXT("plan")));
+	Schema->SetObjectField(TEXT("properties"), Props);
+	Schema->SetArrayField(TEXT("required"), Required);
+	return Schema;
+}
+
+bool ULLMActionSchema::Validate(const FLLMAction& Action, FString& OutErrorMessage)
+{
+	using namespace LLMActionSchemaPrivate;
+
+	OutErrorMessage.Empty();
+
+	// Idle is always valid
+	if (Action.Intent == ELLMIntent::Idle)
+	{
+		return true;
+	}
+
+	if (Action.Confidence < MinConfidenceThreshold)
+	{
+		OutErrorMessage = FString::Printf(TEXT("Confidence %.2f below threshold %.2f"),
+			Action.Confidence, MinConfidenceThreshold);
+		UE_LOG(LogTemp, Warning, TEXT("[LLMActionSchema] Validation failed: %s"), *OutErrorMessage);
+		return false;
+	}
+
+	const TSharedRef<const FSchemaCache> Cache = GetCache();
+	const FGameplayTag Tag = Action.IntentTag.IsValid() ? Action.IntentTag : ULLMIntentRegistry::GetBuiltInTag(Action.Intent);
+	const FRuleSpan* Span = Cache->SpansByTag.Find(Tag);
+	if (!Span)
+	{
+		OutErrorMessage = FString::Printf(TEXT("Unknown intent: %s"), *ULLMIntentRegistry::GetWireName(Action));
+		UE_LOG(LogTemp, Warning, TEXT("[LLMActionSchema] Validation failed: %s"), *OutErrorMessage);
+		return false;
+	}
+
+	const uint8* Base = reinterpret_cast<const uint8*>(&Action);
+	for (int32 Index = Span->First; Index < Span->First + Span->Num; ++Index)
+	{
+		const FCompiledRule& Rule = Cache->Rules[Index];
+		if (!EvaluateRule(Rule, Base))
+		{
+			OutErrorMessage = Rule.ErrorMessage;
+			UE_LOG(LogTemp, Warning, TEXT("[LLMActionSchema] Validation failed: %s"), *OutErrorMessage);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+TConstArrayView<FLLMFieldRule> ULLMActionSchema::GetBuiltInRules(ELLMIntent Intent)
+{
+	using namespace LLMActionSchemaPrivate;
+
+	static const TArray<FLLMFieldRule> MoveToRules = {
+		MakeRule(ELLMActionField::Location, ELLMRuleKind::Required, TEXT("MoveTo requires either coordinates or NavPointName"))
+	};
+	static const TArray<FLLMFieldRule> InteractRules = {
+		MakeRule(ELLMActionField::TargetId, ELLMRuleKind::Required, TEXT("Interact requires target id or type"),
+			0.0f, 0.0f, false, ELLMActionField::TargetType)
+	};
+	static const TArray<FLLMFieldRule> SpeakRules = {
+		MakeRule(ELLMActionField::Speak, ELLMRuleKind::Required, TEXT("Speak requires non-empty speak text")),
+		MakeRule(ELLMActionField::Speak, ELLMRuleKind::MaxLength,
+			*FString::Printf(TEXT("Speak text exceeds %d character limit"), MaxSpeakTextLength),
+			0.0f, static_cast<float>(MaxSpeakTextLength))
+	};
+	static const TArray<FLLMFieldRule> PlayMontageRules = {
+		MakeRule(ELLMActionField::MontageName, ELLMRuleKind::Required, TEXT("PlayMontage requires montage.name")),
+		MakeRule(ELLMActionField::MontagePlayRate, ELLMRuleKind::Range, TEXT("PlayMontage playRate must be in (0, 5.0]"),
+			0.0f, 5.0f, true)
+	};
+
+	switch (Intent)
+	{
+	case ELLMIntent::MoveTo: return MoveToRules;
+	case ELLMIntent::Interact: return InteractRules;
+	case ELLMIntent::Speak: return SpeakRules;
+	case ELLMIntent::PlayMontage: return PlayMontageRules;
+	default: return TConstArrayView<FLLMFieldRule>();
+	}
+}
+
+const TCHAR* ULLMActionSchema::GetFieldPath(ELLMActionField Field)
+{
+	switch (Field)
+	{
+	case ELLMActionField::TargetId: return TEXT("Target.Id");
+	case ELLMActionField::TargetType: return TEXT("Target.Type");
+	case ELLMActionField::Location: return TEXT("Location");
+	case ELLMActionField::Speak: return TEXT("Speak");
+	case ELLMActionField::MontageName: return TEXT("Montage.Name");
+	case ELLMActionField::MontageSection: return TEXT("Montage.Section");
+	case ELLMActionField::MontagePlayRate: return TEXT("Montage.PlayRate");
+	case ELLMActionField::Confidence: return TEXT("Confidence");
+	case ELLMActionField::MontageLoop: return TEXT("Montage.bLoop");
+	default: return nullptr;
+	}
+}
@@ -0,0 +1,164 @@
+// Reflection-driven response schema and compiled validator for FLLMAction
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "Dom/JsonObject.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMActionSchema.generated.h"
+
+/**
+ * Action fields that validation rules can address
+ * Each field maps to a reflected property path inside FLLMAction
+ */
+UENUM(BlueprintType)
+enum class ELLMActionField : uint8
+{
+	None UMETA(DisplayName = "None"),
+	TargetId UMETA(DisplayName = "Target Id"),
+	TargetType UMETA(DisplayName = "Target Type"),
+	Location UMETA(DisplayName = "Location"),
+	Speak UMETA(DisplayName = "Speak"),
+	MontageName UMETA(DisplayName = "Montage Name"),
+	MontageSection UMETA(DisplayName = "Montage Section"),
+	MontagePlayRate UMETA(DisplayName = "Montage Play Rate"),
+	Confidence UMETA(DisplayName = "Confidence"),
+	MontageLoop UMETA(DisplayName = "Montage Loop")
+};
+
+/**
+ * Kind of check a validation rule performs
+ */
+UENUM(BlueprintType)
+enum class ELLMRuleKind : uint8
+{
+	// Field (or its alternate) must be non-empty
+	Required UMETA(DisplayName = "Required"),
+	// String length must not exceed Max
+	MaxLength UMETA(DisplayName = "Max Length"),
+	// Number must lie in [Min, Max] (or (Min, Max] when bExclusiveMin)
+	Range UMETA(DisplayName = "Range")
+};
+
+/**
+ * One row of the action contract: a check applied to a single field for a given intent
+ * Rules also feed the generated response schema (e.g. Range -> minimum/maximum)
+ */
+USTRUCT(BlueprintType)
+struct FLLMFieldRule
+{
+	GENERATED_BODY()
+
+	// Field the rule applies to
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema")
+	ELLMActionField Field = ELLMActionField::None;
+
+	// Check to perform
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema")
+	ELLMRuleKind Kind = ELLMRuleKind::Required;
+
+	// For Required: a second field that also satisfies the rule (e.g. target id OR type)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema", meta = (EditCondition = "Kind == ELLMRuleKind::Required"))
+	ELLMActionField AlternateField = ELLMActionField::None;
+
+	// Lower bound for Range
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema")
+	float Min = 0.0f;
+
+	// Upper bound for Range, max length for MaxLength
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema")
+	float Max = 0.0f;
+
+	// For Range: treat Min as exclusive
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema")
+	bool bExclusiveMin = false;
+
+	// Error reported when the rule fails
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Schema")
+	FString ErrorMessage;
+};
+
+/**
+ * Live value sets injected as "enum" constraints into the response schema
+ * Empty sets leave the corresponding field unconstrained
+ */
+USTRUCT(BlueprintType)
+struct FLLMSchemaConstraints
+{
+	GENERATED_BODY()
+
+	// Allowed values for montage.name
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Schema")
+	TArray<FString> MontageNames;
+
+	// Allowed values for a named location
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Schema")
+	TArray<FString> NavPointNames;
+
+	// Allowed values for target.type
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Schema")
+	TArray<FString> TargetTypes;
+};
+
+/**
+ * Builds the Gemini response_schema from FLLMAction reflection data and
+ * compiles the per-intent rule description into a flat validator table.
+ * Intent names and rules come from ULLMIntentRegistry; both products are built
+ * on first use and cached until the registry changes.
+ */
+UCLASS(BlueprintType)
+class TESTCPP_API ULLMActionSchema : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Cached response schema serialized as JSON (for inspection or for FGeminiGenerateContentConfig::ResponseSchemaJson)
+	 */
+	UFUNCTION(BlueprintPure, Category = "LLM|Schema")
+	static FString GetResponseSchemaJson();
+
+	/**
+	 * Validate an action against the compiled rule table
+	 * @param Action - Action to validate
+	 * @param OutErrorMessage - Error message of the first failing rule
+	 * @return true if all rules for the action's intent pass
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Schema")
+	static bool Validate(const FLLMAction& Action, FString& OutErrorMessage);
+
+	/**
+	 * Cached response schema object; shared, treat as read-only
+	 */
+	static TSharedRef<FJsonObject> GetResponseSchema();
+
+	/**
+	 * Build a fresh schema with enum constraints applied; callers should cache the result
+	 */
+	static TSharedRef<FJsonObject> BuildConstrainedSchema(const FLLMSchemaConstraints& Constraints);
+
+	/**
+	 * Cached schema for a multi-step answer: {"plan": [action + optional "condition", ...]}
+	 */
+	static TSharedRef<FJsonObject> GetPlanResponseSchema();
+
+	/**
+	 * Wrap an action schema (e.g. a constrained one) into the plan form; callers should cache the result
+	 */
+	static TSharedRef<FJsonObject> MakePlanSchema(const TSharedRef<FJsonObject>& ActionSchema);
+
+	/**
+	 * Registry revision the cached schema and rule table were built from
+	 */
+	static int32 GetRevision();
+
+	/**
+	 * Built-in rule description for an intent (the single source for schema bounds and validation)
+	 */
+	static TConstArrayView<FLLMFieldRule> GetBuiltInRules(ELLMIntent Intent);
+
+	/**
+	 * Reflected property path for a field, relative to FLLMAction (e.g. "Montage.PlayRate")
+	 */
+	static const TCHAR* GetFieldPath(ELLMActionField Field);
+};
@@ -2,11 +2,13 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
 #include "LLMActionTypes.generated.h"
 
 /**
  * Intent types supported by the LLM action system
  * MVP scope: MoveTo, Interact, Speak, PlayMontage
+ * Custom marks data-defined intents, which are identified by FLLMAction::IntentTag
  */
 UENUM(BlueprintType)
 enum class ELLMIntent : uint8
@@ -15,7 +17,8 @@ enum class ELLMIntent : uint8
 	MoveTo UMETA(DisplayName = "Move To"),
 	Interact UMETA(DisplayName = "Interact"),
 	Speak UMETA(DisplayName = "Speak"),
-	PlayMontage UMETA(DisplayName = "Play Montage")
+	PlayMontage UMETA(DisplayName = "Play Montage"),
+	Custom UMETA(DisplayName = "Custom (Data-Defined)")
 };
 
 /**
@@ -55,6 +58,10 @@ struct FLLMLocation
 	// True if using coordinates, false if using NavPointName
 	UPROPERTY(BlueprintReadWrite, Category = "LLM|Action")
 	bool bUseCoordinates = true;
+
+	// NavPointName was resolved into Coordinates (ULLMNavPointRegistry); the name stays authoritative
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Action")
+	bool bResolved = false;
 };
 
 /**
@@ -95,6 +102,10 @@ struct FLLMAction
 	UPROPERTY(BlueprintReadWrite, Category = "LLM|Action")
 	ELLMIntent Intent = ELLMIntent::Idle;
 
+	// Registry tag for the intent (LLM.Intent.*); authoritative for data-defined intents
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Action", meta = (Categories = "LLM.Intent"))
+	FGameplayTag IntentTag;
+
 	// Target for Interact actions (optional)
 	UPROPERTY(BlueprintReadWrite, Category = "LLM|Action")
 	FLLMTarget Target;
@@ -123,3 +134,52 @@ struct FLLMAction
 	UPROPERTY(BlueprintReadWrite, Category = "LLM|Action")
 	FString RawJson;
 };
+
+/**
+ * When a plan step runs, relative to the outcome of the step before it
+ */
+UENUM(BlueprintType)
+enum class ELLMPlanStepCondition : uint8
+{
+	// Run regardless of the previous step's outcome
+	Always UMETA(DisplayName = "Always"),
+	// Run only if the previous step succeeded (default)
+	OnSuccess UMETA(DisplayName = "On Success"),
+	// Run only if the previous step failed (recovery step)
+	OnFailure UMETA(DisplayName = "On Failure")
+};
+
+/**
+ * One entry of a multi-step plan
+ */
+USTRUCT(BlueprintType)
+struct FLLMPlanStep
+{
+	GENERATED_BODY()
+
+	// Action executed by this step
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Plan")
+	FLLMAction Action;
+
+	// Gate evaluated against the previous step's outcome
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Plan")
+	ELLMPlanStepCondition Condition = ELLMPlanStepCondition::OnSuccess;
+};
+
+/**
+ * Ordered action sequence returned by a single LLM call
+ * A response containing a single action parses as a one-step plan
+ */
+USTRUCT(BlueprintType)
+struct FLLMPlan
+{
+	GENERATED_BODY()
+
+	// Steps in execution order
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Plan")
+	TArray<FLLMPlanStep> Steps;
+
+	// Raw JSON string that was parsed (for debugging)
+	UPROPERTY(BlueprintReadWrite, Category = "LLM|Plan")
+	FString RawJson;
+};
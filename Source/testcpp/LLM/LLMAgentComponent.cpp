@@ -0,0 +1,267 @@
+// Per-agent LLM state: plan queue fed to the blackboard one step at a time
+#include "LLM/LLMAgentComponent.h"
+#include "LLM/LLMBlackboardMapper.h"
+#include "LLM/LLMGenerateActionAsync.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMMemoryStore.h"
+#include "LLM/LLMSettings.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+ULLMAgentComponent::ULLMAgentComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+}
+
+ULLMAgentComponent* ULLMAgentComponent::FindForActor(const AActor* Actor)
+{
+	if (!Actor)
+	{
+		return nullptr;
+	}
+
+	if (ULLMAgentComponent* Agent = Actor->FindComponentByClass<ULLMAgentComponent>())
+	{
+		return Agent;
+	}
+
+	if (const AController* Controller = Cast<AController>(Actor))
+	{
+		const APawn* Pawn = Controller->GetPawn();
+		return Pawn ? Pawn->FindComponentByClass<ULLMAgentComponent>() : nullptr;
+	}
+
+	if (const APawn* Pawn = Cast<APawn>(Actor))
+	{
+		const AController* Controller = Pawn->GetController();
+		return Controller ? Controller->FindComponentByClass<ULLMAgentComponent>() : nullptr;
+	}
+
+	return nullptr;
+}
+
+FName ULLMAgentComponent::GetMemoryId() const
+{
+	if (!MemoryId.IsNone())
+	{
+		return MemoryId;
+	}
+	// Placed NPCs keep their names between sessions, so their memories do too (controllers are spawned: use the pawn)
+	const AController* Controller = Cast<AController>(GetOwner());
+	const AActor* Actor = Controller && Controller->GetPawn() ? Controller->GetPawn() : GetOwner();
+	return Actor ? Actor->GetFName() : NAME_None;
+}
+
+void ULLMAgentComponent::Remember(const FString& Fact)
+{
+	if (ULLMMemoryStore* Store = ULLMMemoryStore::Get(this))
+	{
+		Store->Remember(GetMemoryId(), Fact);
+	}
+}
+
+bool ULLMAgentComponent::StartPlan(const FLLMPlan& Plan, UBlackboardComponent* InBlackboard)
+{
+	if (!InBlackboard)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMAgentComponent] StartPlan called without a blackboard"));
+		return false;
+	}
+
+	if (HasActivePlan())
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Replacing active plan (%d steps left)"), GetRemainingStepCount() + 1);
+	}
+
+	ActivePlan = Plan;
+	Blackboard = InBlackboard;
+	CurrentStep = INDEX_NONE;
+	++StepSequence;
+	LastFailedStep = INDEX_NONE;
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Starting plan with %d steps"), ActivePlan.Steps.Num());
+	Advance(true);
+	return HasActivePlan();
+}
+
+void ULLMAgentComponent::NotifyStepFinished(bool bSucceeded)
+{
+	if (!HasActivePlan())
+	{
+		return;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Step %d (%s) %s"), CurrentStep,
+		*ULLMIntentRegistry::GetWireName(ActivePlan.Steps[CurrentStep].Action), bSucceeded ? TEXT("succeeded") : TEXT("failed"));
+
+	if (!bSucceeded)
+	{
+		LastFailedStep = CurrentStep;
+	}
+	Advance(bSucceeded);
+}
+
+void ULLMAgentComponent::ReportStepResult(int32 InStepSequence, bool bSucceeded)
+{
+	if (InStepSequence == INDEX_NONE || InStepSequence != GetCurrentStepSequence())
+	{
+		return;
+	}
+
+	// Writing the next step now would change the blackboard in the middle of the reporter's tree search
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+	World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateWeakLambda(this, [this, InStepSequence, bSucceeded]()
+	{
+		if (InStepSequence == GetCurrentStepSequence())
+		{
+			NotifyStepFinished(bSucceeded);
+		}
+	}));
+}
+
+bool ULLMAgentComponent::GetCurrentAction(FLLMAction& OutAction) const
+{
+	if (!HasActivePlan())
+	{
+		return false;
+	}
+	OutAction = ActivePlan.Steps[CurrentStep].Action;
+	return true;
+}
+
+void ULLMAgentComponent::CancelPlan()
+{
+	if (HasActivePlan())
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Plan cancelled at step %d"), CurrentStep);
+		FinishPlan(false);
+	}
+}
+
+void ULLMAgentComponent::SetGoal(const FString& UserInput, UAPIData* APIData, float Temperature)
+{
+	if (PendingReplan)
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] New goal; cancelling the re-plan in flight"));
+		PendingReplan->OnCompleted.RemoveAll(this);
+		PendingReplan->Cancel();
+		PendingReplan = nullptr;
+	}
+
+	Goal = UserInput;
+	GoalAPIData = APIData;
+	GoalTemperature = Temperature;
+	ReplanAttempts = 0;
+}
+
+void ULLMAgentComponent::Advance(bool bPreviousSucceeded)
+{
+	UBlackboardComponent* BlackboardComp = Blackboard.Get();
+	if (!BlackboardComp)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMAgentComponent] Blackboard is gone, dropping plan"));
+		ActivePlan.Steps.Reset();
+		CurrentStep = INDEX_NONE;
+		return;
+	}
+
+	for (int32 Next = CurrentStep + 1; Next < ActivePlan.Steps.Num(); ++Next)
+	{
+		const FLLMPlanStep& Step = ActivePlan.Steps[Next];
+		const bool bRuns = Step.Condition == ELLMPlanStepCondition::Always
+			|| (Step.Condition == ELLMPlanStepCondition::OnSuccess) == bPreviousSucceeded;
+		if (!bRuns)
+		{
+			continue;
+		}
+
+		CurrentStep = Next;
+		++StepSequence;
+		if (ULLMBlackboardMapper::WriteActionToBlackboard(BlackboardComp, Step.Action, ConfidenceThreshold))
+		{
+			UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Step %d/%d: %s"), Next + 1, ActivePlan.Steps.Num(),
+				*ULLMIntentRegistry::GetWireName(Step.Action));
+			OnStepStarted.Broadcast(Step.Action, Next);
+			return;
+		}
+
+		// A step that cannot be written counts as a failed step
+		bPreviousSucceeded = false;
+		LastFailedStep = Next;
+	}
+
+	CurrentStep = ActivePlan.Steps.Num();
+	if (bPreviousSucceeded)
+	{
+		FinishPlan(true);
+	}
+	else
+	{
+		RequestReplan(TEXT("step failed"));
+	}
+}
+
+void ULLMAgentComponent::FinishPlan(bool bSucceeded)
+{
+	if (UBlackboardComponent* BlackboardComp = Blackboard.Get())
+	{
+		ULLMBlackboardMapper::ClearLLMKeys(BlackboardComp);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Plan finished (%s)"), bSucceeded ? TEXT("succeeded") : TEXT("failed"));
+	ActivePlan.Steps.Reset();
+	CurrentStep = INDEX_NONE;
+	++StepSequence;
+	OnPlanFinished.Broadcast(bSucceeded);
+}
+
+void ULLMAgentComponent::RequestReplan(const FString& Reason)
+{
+	const FLLMAction FailedAction = ActivePlan.Steps.IsValidIndex(LastFailedStep) ? ActivePlan.Steps[LastFailedStep].Action : FLLMAction();
+	const int32 FailedIndex = LastFailedStep;
+
+	UE_LOG(LogTemp, Warning, TEXT("[LLMAgentComponent] Step %d (%s) failed with no fallback step"), FailedIndex,
+		*ULLMIntentRegistry::GetWireName(FailedAction));
+	OnReplanRequested.Broadcast(FailedAction, FailedIndex, Reason);
+
+	const int32 MaxAttempts = GetDefault<ULLMSettings>()->MaxReplanAttempts;
+	if (!bAutoReplan || Goal.IsEmpty() || !GoalAPIData || ReplanAttempts >= MaxAttempts || !Blackboard.IsValid())
+	{
+		FinishPlan(false);
+		return;
+	}
+
+	++ReplanAttempts;
+	const FString ReplanInput = FString::Printf(
+		TEXT("%s\n\nThe previous plan failed at step %d (%s: %s). Reply with a new plan that starts from the current situation."),
+		*Goal, FailedIndex + 1, *ULLMIntentRegistry::GetWireName(FailedAction), *Reason);
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMAgentComponent] Requesting re-plan (attempt %d/%d)"), ReplanAttempts, MaxAttempts);
+
+	// Keep the failed plan's keys cleared while the new plan is generated
+	ULLMBlackboardMapper::ClearLLMKeys(Blackboard.Get());
+	ActivePlan.Steps.Reset();
+	CurrentStep = INDEX_NONE;
+
+	PendingReplan = ULLMGenerateActionAsync::GenerateAction(GetOwner(), GoalAPIData, ReplanInput, Blackboard.Get(), GoalTemperature);
+	PendingReplan->OnCompleted.AddDynamic(this, &ULLMAgentComponent::OnReplanCompleted);
+	PendingReplan->MarkAsReplan();
+	PendingReplan->Activate();
+}
+
+void ULLMAgentComponent::OnReplanCompleted(bool bSuccess, const FLLMAction& Action, const FString& ErrorMessage)
+{
+	PendingReplan = nullptr;
+	if (!bSuccess)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMAgentComponent] Re-plan failed: %s"), *ErrorMessage);
+		OnPlanFinished.Broadcast(false);
+	}
+}
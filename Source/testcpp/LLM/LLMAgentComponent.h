@@ -0,0 +1,179 @@
+// Per-agent LLM state: plan queue fed to the blackboard one step at a time
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLM/LLMConversationHistory.h"
+#include "LLMAgentComponent.generated.h"
+
+class UAPIData;
+class UBlackboardComponent;
+class ULLMGenerateActionAsync;
+class ULLMPromptTemplate;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FLLMPlanStepEvent, const FLLMAction&, Action, int32, StepIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLLMPlanFinishedEvent, bool, bSucceeded);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FLLMReplanRequestedEvent, const FLLMAction&, FailedAction, int32, FailedStepIndex, const FString&, Reason);
+
+/**
+ * Holds the LLM plan an agent is executing
+ * Add to the AIController (or its pawn). Steps are written to the blackboard one at a time;
+ * the next step is written when the current one reports completion (UBTDecorator_CheckIntent
+ * does this when its branch finishes). When a step fails and no later step handles the
+ * failure, OnReplanRequested fires and, with bAutoReplan, the goal is sent back to the LLM
+ * together with the failure.
+ */
+UCLASS(ClassGroup = (AI), meta = (BlueprintSpawnableComponent))
+class TESTCPP_API ULLMAgentComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	ULLMAgentComponent();
+
+	/** Component on the actor itself, on its controller (for pawns) or on its pawn (for controllers) */
+	static ULLMAgentComponent* FindForActor(const AActor* Actor);
+
+	/**
+	 * Replace the current plan and write its first runnable step to the blackboard
+	 * @param Plan - Parsed and validated plan
+	 * @param InBlackboard - Blackboard the steps are written to
+	 * @return true if a step is now active
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Plan")
+	bool StartPlan(const FLLMPlan& Plan, UBlackboardComponent* InBlackboard);
+
+	/**
+	 * Report the outcome of the active step and advance the queue
+	 * @param bSucceeded - Whether the step's behavior succeeded
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Plan")
+	void NotifyStepFinished(bool bSucceeded);
+
+	/**
+	 * Report the outcome of the step written with StepSequence; reports for any other step are ignored
+	 * The queue advances on the next tick, so this is safe during a behavior tree search
+	 * @param StepSequence - GetCurrentStepSequence() when the step's behavior started
+	 * @param bSucceeded - Whether the step's behavior succeeded
+	 */
+	void ReportStepResult(int32 StepSequence, bool bSucceeded);
+
+	/** Drop the remaining steps and clear the LLM blackboard keys */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Plan")
+	void CancelPlan();
+
+	/**
+	 * Remember the request that produced the current plan so a failed plan can be re-planned
+	 * A re-plan of the previous goal still in flight is cancelled: the new command supersedes it
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Plan")
+	void SetGoal(const FString& UserInput, UAPIData* APIData, float Temperature = 0.7f);
+
+	/** Whether a re-plan request is in flight */
+	UFUNCTION(BlueprintPure, Category = "LLM|Plan")
+	bool IsReplanPending() const { return PendingReplan != nullptr; }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Plan")
+	bool HasActivePlan() const { return ActivePlan.Steps.IsValidIndex(CurrentStep); }
+
+	/** Index of the step currently on the blackboard, or INDEX_NONE */
+	UFUNCTION(BlueprintPure, Category = "LLM|Plan")
+	int32 GetCurrentStepIndex() const { return HasActivePlan() ? CurrentStep : INDEX_NONE; }
+
+	/** Number written with the current step, unique per step write (two MoveTo steps in a row differ); INDEX_NONE without a plan */
+	UFUNCTION(BlueprintPure, Category = "LLM|Plan")
+	int32 GetCurrentStepSequence() const { return HasActivePlan() ? StepSequence : INDEX_NONE; }
+
+	/** Action of the step currently on the blackboard; false when no plan is active */
+	UFUNCTION(BlueprintPure, Category = "LLM|Plan")
+	bool GetCurrentAction(FLLMAction& OutAction) const;
+
+	/** Steps after the current one (some may be skipped by their conditions) */
+	UFUNCTION(BlueprintPure, Category = "LLM|Plan")
+	int32 GetRemainingStepCount() const { return HasActivePlan() ? ActivePlan.Steps.Num() - CurrentStep - 1 : 0; }
+
+	/** What this agent and the player have said to each other */
+	FLLMConversationHistory& GetConversation() { return Conversation; }
+
+	/** Forget the conversation (new encounter, reset dialogue) */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Agent")
+	void ClearConversation() { Conversation.Reset(); }
+
+	/** Long-term memory this agent reads and writes: MemoryId, or the owning actor's name */
+	FName GetMemoryId() const;
+
+	/** Store a fact or event in the agent's long-term memory (ULLMMemoryStore) */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Agent")
+	void Remember(const FString& Fact);
+
+public:
+	// Called when a step is written to the blackboard
+	UPROPERTY(BlueprintAssignable, Category = "LLM|Plan")
+	FLLMPlanStepEvent OnStepStarted;
+
+	// Called when the plan runs out of steps (or is cancelled / abandoned)
+	UPROPERTY(BlueprintAssignable, Category = "LLM|Plan")
+	FLLMPlanFinishedEvent OnPlanFinished;
+
+	// Re-plan hook: a step failed and no remaining step handles the failure
+	UPROPERTY(BlueprintAssignable, Category = "LLM|Plan")
+	FLLMReplanRequestedEvent OnReplanRequested;
+
+	// Automatically ask the LLM for a new plan after a failure (needs SetGoal)
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Plan")
+	bool bAutoReplan = true;
+
+	// Persona this agent plays; cached LLM answers are only shared between agents with the same persona
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Agent")
+	FName PersonaId;
+
+	// Who this agent is, for the template's {Persona} slot ("a gruff dwarven blacksmith who distrusts strangers")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Agent", meta = (MultiLine = true))
+	FString Persona;
+
+	// System prompt template for this agent; None uses ULLMSettings::DefaultPromptTemplate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Agent")
+	TObjectPtr<ULLMPromptTemplate> PromptTemplate;
+
+	// Long-term memory key; agents with the same id share memories (e.g. one per persona). None: the owning actor's name
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Agent")
+	FName MemoryId;
+
+	// Minimum confidence for a step to be written to the blackboard
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LLM|Plan", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float ConfidenceThreshold = 0.5f;
+
+private:
+	// Write the next step whose condition matches the previous outcome; finish or re-plan when none is left
+	void Advance(bool bPreviousSucceeded);
+	void FinishPlan(bool bSucceeded);
+	void RequestReplan(const FString& Reason);
+
+	UFUNCTION()
+	void OnReplanCompleted(bool bSuccess, const FLLMAction& Action, const FString& ErrorMessage);
+
+	UPROPERTY()
+	FLLMPlan ActivePlan;
+
+	UPROPERTY()
+	TWeakObjectPtr<UBlackboardComponent> Blackboard;
+
+	UPROPERTY()
+	TObjectPtr<UAPIData> GoalAPIData;
+
+	// Keeps the in-flight re-plan request alive until it completes
+	UPROPERTY()
+	TObjectPtr<ULLMGenerateActionAsync> PendingReplan;
+
+	FString Goal;
+	float GoalTemperature = 0.7f;
+
+	int32 CurrentStep = INDEX_NONE;
+	// Bumped for every step written and every plan change, so stale step reports can be told apart
+	int32 StepSequence = 0;
+	int32 LastFailedStep = INDEX_NONE;
+	int32 ReplanAttempts = 0;
+
+	FLLMConversationHistory Conversation;
+};
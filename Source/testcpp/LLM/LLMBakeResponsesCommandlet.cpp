@@ -0,0 +1,175 @@
+// Offline baker for the shipped response table
+#include "LLM/LLMBakeResponsesCommandlet.h"
+#include "LLM/LLMBlueprintLibrary.h"
+#include "LLM/LLMGenerateActionAsync.h"
+#include "LLM/LLMResponseTable.h"
+#include "LLM/LLMSettings.h"
+#include "HTTP/APIData.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+#include "HttpManager.h"
+#include "HttpModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace LLMBakeResponsesPrivate
+{
+	struct FCorpusEntry
+	{
+		FString Input;
+		FName PersonaId;
+	};
+
+	static constexpr float TickSeconds = 0.01f;
+
+	static bool ParseCorpusLine(const FString& Line, FCorpusEntry& OutEntry)
+	{
+		const FString Trimmed = Line.TrimStartAndEnd();
+		if (Trimmed.IsEmpty() || Trimmed.StartsWith(TEXT("#")))
+		{
+			return false;
+		}
+
+		if (!Trimmed.StartsWith(TEXT("{")))
+		{
+			OutEntry.Input = Trimmed;
+			return true;
+		}
+
+		TSharedPtr<FJsonObject> Json;
+		FString Persona;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Trimmed), Json) || !Json.IsValid()
+			|| !Json->TryGetStringField(TEXT("input"), OutEntry.Input))
+		{
+			return false;
+		}
+		Json->TryGetStringField(TEXT("persona"), Persona);
+		OutEntry.PersonaId = Persona.IsEmpty() ? NAME_None : FName(*Persona);
+		return true;
+	}
+}
+
+ULLMBakeResponsesCommandlet::ULLMBakeResponsesCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+void ULLMBakeResponsesCommandlet::OnResponse(bool bSuccess, const FString& JsonResponse)
+{
+	bResponseReceived = true;
+	bResponseSucceeded = bSuccess;
+	ResponseBody = JsonResponse;
+}
+
+int32 ULLMBakeResponsesCommandlet::Main(const FString& Params)
+{
+	using namespace LLMBakeResponsesPrivate;
+
+	FString APIDataPath;
+	FString CorpusPath = FPaths::Combine(FPaths::ProjectContentDir(), TEXT("LLM"), TEXT("ResponseCorpus.txt"));
+	FString OutPath = FPaths::Combine(FPaths::ProjectContentDir(), GetDefault<ULLMSettings>()->BakedResponseTablePath);
+	float Temperature = 0.0f;
+	float TimeoutSeconds = 60.0f;
+	FParse::Value(*Params, TEXT("APIData="), APIDataPath);
+	FParse::Value(*Params, TEXT("Corpus="), CorpusPath);
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+	FParse::Value(*Params, TEXT("Temperature="), Temperature);
+	FParse::Value(*Params, TEXT("Timeout="), TimeoutSeconds);
+
+	UAPIData* APIData = APIDataPath.IsEmpty() ? nullptr : LoadObject<UAPIData>(nullptr, *APIDataPath);
+	if (!APIData)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMBakeResponses] -APIData=<asset path> is required (got '%s')"), *APIDataPath);
+		return 1;
+	}
+	if (APIData->GetProvider() == ELLMProvider::Local)
+	{
+		// The in-process provider lives on a game instance, which commandlets do not have
+		UE_LOG(LogTemp, Error, TEXT("[LLMBakeResponses] %s uses the local provider; bake against a remote endpoint"), *APIDataPath);
+		return 1;
+	}
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *CorpusPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMBakeResponses] Cannot read %s"), *CorpusPath);
+		return 1;
+	}
+
+	TArray<FCorpusEntry> Corpus;
+	for (const FString& Line : Lines)
+	{
+		FCorpusEntry Entry;
+		if (ParseCorpusLine(Line, Entry))
+		{
+			Corpus.Add(MoveTemp(Entry));
+		}
+	}
+
+	// Not owned by a game instance; GenerateContent only needs the game instance for the local provider
+	UGeminiHTTPManager* Manager = NewObject<UGeminiHTTPManager>(this);
+	Manager->InitializeWithData(APIData);
+	const FGeminiGenerateContentConfig Config = ULLMGenerateActionAsync::MakeActionConfig(nullptr, Temperature);
+
+	FOnGeminiResponse Delegate;
+	Delegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(ULLMBakeResponsesCommandlet, OnResponse));
+
+	TMap<uint64, TArray<uint8>> Records;
+	int32 Failures = 0;
+	for (const FCorpusEntry& Entry : Corpus)
+	{
+		const uint64 Key = FLLMResponseTableFile::MakeKey(Entry.Input, Entry.PersonaId);
+		if (Records.Contains(Key))
+		{
+			continue;
+		}
+
+		bResponseReceived = false;
+		Manager->GenerateContent(Entry.Input, Config, Delegate);
+
+		double Waited = 0.0;
+		while (!bResponseReceived && Waited < TimeoutSeconds)
+		{
+			FHttpModule::Get().GetHttpManager().Tick(TickSeconds);
+			FTSTicker::GetCoreTicker().Tick(TickSeconds);
+			FPlatformProcess::Sleep(TickSeconds);
+			Waited += TickSeconds;
+		}
+
+		FLLMPlan Plan;
+		FString ErrorMessage = bResponseReceived ? TEXT("LLM request failed") : TEXT("Timed out");
+		if (!bResponseReceived || !bResponseSucceeded
+			|| !ULLMBlueprintLibrary::ParseLLMPlanResponse(ResponseBody, nullptr, Plan, ErrorMessage))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMBakeResponses] Skipping '%s': %s"), *Entry.Input, *ErrorMessage);
+			++Failures;
+			continue;
+		}
+
+		TArray<uint8>& Record = Records.Add(Key);
+		FMemoryWriter Writer(Record);
+		FLLMResponseTableFile::SerializePlan(Writer, Plan);
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("[LLMBakeResponses] %d corpus lines, %d baked, %d failed"), Corpus.Num(), Records.Num(), Failures);
+	if (Records.Num() == 0)
+	{
+		return 1;
+	}
+
+	if (!FLLMResponseTableFile::Write(OutPath, FLLMResponseTableFile::GetCurrentContractHash(), Records))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMBakeResponses] Failed to write %s"), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("[LLMBakeResponses] Wrote %s"), *OutPath);
+	return 0;
+}
@@ -0,0 +1,34 @@
+// Offline baker for the shipped response table
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LLMBakeResponsesCommandlet.generated.h"
+
+/**
+ * Runs a corpus of expected player inputs through the LLM pipeline (GenerateContent, then the
+ * extract/parse/validate steps of ProcessLLMPlanResponse) and writes the validated plans as a
+ * FLLMResponseTableFile that ULLMResponseTable maps at runtime
+ * UnrealEditor-Cmd testcpp.uproject -run=LLMBakeResponses -APIData=/Game/Path/To/APIData [-Corpus=<file>] [-Out=<bin>] [-Temperature=T] [-Timeout=S]
+ * Corpus: one input per line, or JSON lines with "input" and optional "persona" (decision logs work as-is)
+ * Defaults: Content/LLM/ResponseCorpus.txt -> Content/<ULLMSettings::BakedResponseTablePath>, temperature 0, 60 s per request
+ */
+UCLASS()
+class TESTCPP_API ULLMBakeResponsesCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULLMBakeResponsesCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	UFUNCTION()
+	void OnResponse(bool bSuccess, const FString& JsonResponse);
+
+	// Last response; requests are sent one at a time
+	bool bResponseReceived = false;
+	bool bResponseSucceeded = false;
+	FString ResponseBody;
+};
@@ -1,7 +1,16 @@
 // Maps parsed LLM actions to Blackboard keys for Behavior Tree execution
 #include "LLM/LLMBlackboardMapper.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "LLM/LLMActionParser.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMIntentDefinition.h"
 
 // Define Blackboard key names
 const FName ULLMBlackboardMapper::KEY_Intent = FName(TEXT("Intent"));
@@ -16,6 +25,124 @@ const FName ULLMBlackboardMapper::KEY_MontageSection = FName(TEXT("MontageSectio
 const FName ULLMBlackboardMapper::KEY_MontagePlayRate = FName(TEXT("MontagePlayRate"));
 const FName ULLMBlackboardMapper::KEY_MontageLoop = FName(TEXT("MontageLoop"));
 
+struct ULLMBlackboardMapper::FKeyBindings
+{
+	enum EKey : int32
+	{
+		Intent, TargetLocation, TargetActor, TargetId, TargetType, SpeakText, Confidence,
+		MontageName, MontageSection, MontagePlayRate, MontageLoop,
+		Count
+	};
+
+	// InvalidKey for keys the asset lacks or has with the wrong type
+	FBlackboard::FKey Ids[Count];
+	bool bIntentIsName = false;
+
+	FKeyBindings()
+	{
+		for (FBlackboard::FKey& Id : Ids)
+		{
+			Id = FBlackboard::InvalidKey;
+		}
+	}
+
+	/** Set a key; SetValue only notifies observers when the value changed */
+	template <typename TDataClass>
+	void Set(UBlackboardComponent& Blackboard, EKey Key, typename TDataClass::FDataType Value, uint32& Written) const
+	{
+		if (Ids[Key] != FBlackboard::InvalidKey)
+		{
+			Blackboard.SetValue<TDataClass>(Ids[Key], Value);
+		}
+		Written |= 1u << Key;
+	}
+
+	/** Clear every bound key not in Written; keys that are already empty do not notify */
+	void ClearOthers(UBlackboardComponent& Blackboard, uint32 Written) const
+	{
+		for (int32 Key = 0; Key < Count; ++Key)
+		{
+			if (!(Written & (1u << Key)) && Ids[Key] != FBlackboard::InvalidKey)
+			{
+				Blackboard.ClearValue(Ids[Key]);
+			}
+		}
+	}
+};
+
+const ULLMBlackboardMapper::FKeyBindings* ULLMBlackboardMapper::GetBindings(const UBlackboardComponent& Blackboard)
+{
+	const UBlackboardData* Asset = Blackboard.GetBlackboardAsset();
+	if (!Asset)
+	{
+		return nullptr;
+	}
+
+	static TMap<TObjectKey<UBlackboardData>, FKeyBindings> Cache;
+#if WITH_EDITOR
+	// Key edits can renumber the keys of the asset and of every asset that inherits from it
+	static const FDelegateHandle KeysUpdatedHandle = UBlackboardData::OnUpdateKeys.AddLambda([](UBlackboardData*) { Cache.Reset(); });
+#endif
+
+	if (const FKeyBindings* Cached = Cache.Find(Asset))
+	{
+		return Cached;
+	}
+
+	struct FKeySpec
+	{
+		FName Name;
+		UClass* Type;
+		UClass* AltType;
+	};
+	const FKeySpec Specs[FKeyBindings::Count] =
+	{
+		{ KEY_Intent, UBlackboardKeyType_Name::StaticClass(), UBlackboardKeyType_String::StaticClass() },
+		{ KEY_TargetLocation, UBlackboardKeyType_Vector::StaticClass(), nullptr },
+		{ KEY_TargetActor, UBlackboardKeyType_Object::StaticClass(), nullptr },
+		{ KEY_TargetId, UBlackboardKeyType_String::StaticClass(), nullptr },
+		{ KEY_TargetType, UBlackboardKeyType_String::StaticClass(), nullptr },
+		{ KEY_SpeakText, UBlackboardKeyType_String::StaticClass(), nullptr },
+		{ KEY_Confidence, UBlackboardKeyType_Float::StaticClass(), nullptr },
+		{ KEY_MontageName, UBlackboardKeyType_String::StaticClass(), nullptr },
+		{ KEY_MontageSection, UBlackboardKeyType_String::StaticClass(), nullptr },
+		{ KEY_MontagePlayRate, UBlackboardKeyType_Float::StaticClass(), nullptr },
+		{ KEY_MontageLoop, UBlackboardKeyType_Bool::StaticClass(), nullptr },
+	};
+
+	FKeyBindings Bindings;
+	TArray<FString> Missing;
+	for (int32 Key = 0; Key < FKeyBindings::Count; ++Key)
+	{
+		const FKeySpec& Spec = Specs[Key];
+		const FBlackboard::FKey Id = Asset->GetKeyID(Spec.Name);
+		if (Id == FBlackboard::InvalidKey)
+		{
+			Missing.Add(Spec.Name.ToString());
+			continue;
+		}
+
+		const UClass* Type = Asset->GetKeyType(Id);
+		if (Type != Spec.Type && Type != Spec.AltType)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMBlackboardMapper] Key %s of %s is %s, expected %s; it will not be written"),
+				*Spec.Name.ToString(), *Asset->GetName(), *GetNameSafe(Type), *GetNameSafe(Spec.Type));
+			continue;
+		}
+		Bindings.Ids[Key] = Id;
+	}
+	Bindings.bIntentIsName = Bindings.Ids[FKeyBindings::Intent] != FBlackboard::InvalidKey
+		&& Asset->GetKeyType(Bindings.Ids[FKeyBindings::Intent]) == UBlackboardKeyType_Name::StaticClass();
+
+	if (Missing.Num() > 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMBlackboardMapper] %s has no %s key(s); they will not be written"),
+			*Asset->GetName(), *FString::Join(Missing, TEXT(", ")));
+	}
+
+	return &Cache.Add(Asset, Bindings);
+}
+
 bool ULLMBlackboardMapper::WriteActionToBlackboard(UBlackboardComponent* Blackboard, const FLLMAction& Action, float ConfidenceThreshold)
 {
 	if (!Blackboard)
@@ -40,101 +167,121 @@ bool ULLMBlackboardMapper::WriteActionToBlackboard(UBlackboardComponent* Blackbo
 		return false;
 	}
 
-	// Clear previous values
-	ClearLLMKeys(Blackboard);
-
-	// Write Intent as String (convert enum to string)
-	FString IntentStr;
-	switch (Action.Intent)
+	const FKeyBindings* Keys = GetBindings(*Blackboard);
+	if (!Keys)
 	{
-	case ELLMIntent::MoveTo: IntentStr = TEXT("MoveTo"); break;
-	case ELLMIntent::Interact: IntentStr = TEXT("Interact"); break;
-	case ELLMIntent::Speak: IntentStr = TEXT("Speak"); break;
-	case ELLMIntent::PlayMontage: IntentStr = TEXT("PlayMontage"); break;
-	case ELLMIntent::Idle: IntentStr = TEXT("Idle"); break;
-	default: IntentStr = TEXT("Idle"); break;
+		UE_LOG(LogTemp, Error, TEXT("[LLMBlackboardMapper] Blackboard has no asset"));
+		return false;
 	}
-	Blackboard->SetValueAsString(KEY_Intent, IntentStr);
-	UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set Intent: %s"), *IntentStr);
 
-	// Write Confidence
-	Blackboard->SetValueAsFloat(KEY_Confidence, Action.Confidence);
+	// Observers hear about the changed keys once the whole action is written
+	UBlackboardComponent& BB = *Blackboard;
+	BB.PauseObserverNotifications();
+	uint32 Written = 0;
 
-	// Write intent-specific data
-	if (Action.Intent == ELLMIntent::MoveTo)
+	// Write Intent: the tag name when the key is a Name key, otherwise the wire name
+	const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+	const ULLMIntentDefinition* Definition = Registry ? Registry->Resolve(Action) : nullptr;
+	const FString IntentStr = ULLMIntentRegistry::GetWireName(Action);
+	if (Keys->bIntentIsName)
 	{
-		if (Action.Location.bUseCoordinates)
-		{
-			Blackboard->SetValueAsVector(KEY_TargetLocation, Action.Location.Coordinates);
-			UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetLocation: %s"), *Action.Location.Coordinates.ToString());
-		}
-		else
-		{
-			// If using named point, store the name in TargetId for resolution later
-			Blackboard->SetValueAsString(KEY_TargetId, Action.Location.NavPointName);
-			UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetId (NavPoint): %s"), *Action.Location.NavPointName);
-		}
+		const FGameplayTag IntentTag = Definition ? Definition->IntentTag : ULLMIntentRegistry::GetBuiltInTag(Action.Intent);
+		Keys->Set<UBlackboardKeyType_Name>(BB, FKeyBindings::Intent, IntentTag.GetTagName(), Written);
+		UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set Intent: %s"), *IntentTag.ToString());
 	}
-	else if (Action.Intent == ELLMIntent::Interact)
+	else
 	{
-		if (!Action.Target.Id.IsEmpty())
-		{
-			Blackboard->SetValueAsString(KEY_TargetId, Action.Target.Id);
-			UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetId: %s"), *Action.Target.Id);
-		}
-		if (!Action.Target.Type.IsEmpty())
-		{
-			Blackboard->SetValueAsString(KEY_TargetType, Action.Target.Type);
-			UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetType: %s"), *Action.Target.Type);
-		}
+		Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::Intent, IntentStr, Written);
+		UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set Intent: %s"), *IntentStr);
 	}
-	else if (Action.Intent == ELLMIntent::Speak)
+
+	// Write Confidence
+	Keys->Set<UBlackboardKeyType_Float>(BB, FKeyBindings::Confidence, Action.Confidence, Written);
+
+	// Write intent-specific data listed by the intent definition
+	const TArray<ELLMActionField> NoFields;
+	for (const ELLMActionField Field : Definition ? Definition->BlackboardFields : NoFields)
 	{
-		Blackboard->SetValueAsString(KEY_SpeakText, Action.Speak);
-		UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set SpeakText: %s"), *Action.Speak);
-	}
-	else if (Action.Intent == ELLMIntent::PlayMontage)
-	{
-		Blackboard->SetValueAsString(KEY_MontageName, Action.Montage.Name);
-		Blackboard->SetValueAsString(KEY_MontageSection, Action.Montage.Section);
-		Blackboard->SetValueAsFloat(KEY_MontagePlayRate, Action.Montage.PlayRate);
-		Blackboard->SetValueAsBool(KEY_MontageLoop, Action.Montage.bLoop);
-		UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set Montage: Name=%s, Section=%s, Rate=%.2f, Loop=%s"),
-			*Action.Montage.Name,
-			Action.Montage.Section.IsEmpty() ? TEXT("None") : *Action.Montage.Section,
-			Action.Montage.PlayRate,
-			Action.Montage.bLoop ? TEXT("Yes") : TEXT("No"));
+		switch (Field)
+		{
+		case ELLMActionField::Location:
+			if (Action.Location.bUseCoordinates)
+			{
+				Keys->Set<UBlackboardKeyType_Vector>(BB, FKeyBindings::TargetLocation, Action.Location.Coordinates, Written);
+				UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetLocation: %s"), *Action.Location.Coordinates.ToString());
+			}
+			else
+			{
+				// Named point: the name goes to TargetId, and its location too once the registry resolved it
+				Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::TargetId, Action.Location.NavPointName, Written);
+				UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetId (NavPoint): %s"), *Action.Location.NavPointName);
+				if (Action.Location.bResolved)
+				{
+					Keys->Set<UBlackboardKeyType_Vector>(BB, FKeyBindings::TargetLocation, Action.Location.Coordinates, Written);
+					UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetLocation (NavPoint): %s"), *Action.Location.Coordinates.ToString());
+				}
+			}
+			break;
+		case ELLMActionField::TargetId:
+			if (!Action.Target.Id.IsEmpty())
+			{
+				Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::TargetId, Action.Target.Id, Written);
+				UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetId: %s"), *Action.Target.Id);
+			}
+			break;
+		case ELLMActionField::TargetType:
+			if (!Action.Target.Type.IsEmpty())
+			{
+				Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::TargetType, Action.Target.Type, Written);
+				UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set TargetType: %s"), *Action.Target.Type);
+			}
+			break;
+		case ELLMActionField::Speak:
+			Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::SpeakText, Action.Speak, Written);
+			UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set SpeakText: %s"), *Action.Speak);
+			break;
+		case ELLMActionField::MontageName:
+			Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::MontageName, Action.Montage.Name, Written);
+			UE_LOG(LogTemp, Log, TEXT("[LLMBlackboardMapper] Set MontageName: %s"), *Action.Montage.Name);
+			break;
+		case ELLMActionField::MontageSection:
+			Keys->Set<UBlackboardKeyType_String>(BB, FKeyBindings::MontageSection, Action.Montage.Section, Written);
+			break;
+		case ELLMActionField::MontagePlayRate:
+			Keys->Set<UBlackboardKeyType_Float>(BB, FKeyBindings::MontagePlayRate, Action.Montage.PlayRate, Written);
+			break;
+		case ELLMActionField::MontageLoop:
+			Keys->Set<UBlackboardKeyType_Bool>(BB, FKeyBindings::MontageLoop, Action.Montage.bLoop, Written);
+			break;
+		default:
+			break;
+		}
 	}
 
+	// Keys the previous action set and this one does not
+	Keys->ClearOthers(BB, Written);
+	BB.ResumeObserverNotifications(true);
 	return true;
 }
 
 void ULLMBlackboardMapper::ClearLLMKeys(UBlackboardComponent* Blackboard)
 {
-	if (!Blackboard)
+	const FKeyBindings* Keys = Blackboard ? GetBindings(*Blackboard) : nullptr;
+	if (!Keys)
 	{
 		return;
 	}
 
-	Blackboard->ClearValue(KEY_Intent);
-	Blackboard->ClearValue(KEY_TargetLocation);
-	Blackboard->ClearValue(KEY_TargetActor);
-	Blackboard->ClearValue(KEY_TargetId);
-	Blackboard->ClearValue(KEY_TargetType);
-	Blackboard->ClearValue(KEY_SpeakText);
-	Blackboard->ClearValue(KEY_Confidence);
-	// Clear montage-related keys if they exist
-	Blackboard->ClearValue(KEY_MontageName);
-	Blackboard->ClearValue(KEY_MontageSection);
-	Blackboard->ClearValue(KEY_MontagePlayRate);
-	Blackboard->ClearValue(KEY_MontageLoop);
+	Blackboard->PauseObserverNotifications();
+	Keys->ClearOthers(*Blackboard, 0);
+	Blackboard->ResumeObserverNotifications(true);
 }
 
 FString ULLMBlackboardMapper::GetRequiredBlackboardKeysDescription()
 {
 	return TEXT(
 		"Required Blackboard Keys for BB_LLM:\n\n"
-		"1. Intent (String) - The action intent: 'MoveTo', 'Interact', 'Speak', 'PlayMontage', 'Idle'\n"
+		"1. Intent (Name or String) - Name key: intent tag (e.g. 'LLM.Intent.MoveTo'); String key: wire name ('MoveTo', 'Interact', ...)\n"
 		"2. TargetLocation (Vector) - World position for MoveTo actions\n"
 		"3. TargetActor (Object) - Actor reference for Interact actions\n"
 		"4. TargetId (String) - Target identifier or NavPoint name\n"
@@ -24,6 +24,10 @@ class UBlackboardComponent;
  * - MontageSection (String): Optional section name
  * - MontagePlayRate (Float): Play rate
  * - MontageLoop (Bool): Loop flag
+ *
+ * Key ids are resolved once per blackboard asset and cached; missing or mistyped keys are reported
+ * then and skipped afterwards. Each write sets or clears every key at most once, only keys whose
+ * value changes notify, and the notifications are sent together after the last key is written.
  */
 UCLASS(BlueprintType)
 class TESTCPP_API ULLMBlackboardMapper : public UObject
@@ -56,6 +60,11 @@ public:
 	static FString GetRequiredBlackboardKeysDescription();
 
 private:
+	struct FKeyBindings;
+
+	/** Key ids for the component's blackboard asset, resolved and checked on first use */
+	static const FKeyBindings* GetBindings(const UBlackboardComponent& Blackboard);
+
 	// Blackboard key names (must match the keys created in BB_LLM asset)
 	static const FName KEY_Intent;
 	static const FName KEY_TargetLocation;
@@ -2,6 +2,9 @@
 #include "LLM/LLMBlueprintLibrary.h"
 #include "LLM/LLMActionParser.h"
 #include "LLM/LLMBlackboardMapper.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMAgentComponent.h"
+#include "LLM/LLMCandidateRanker.h"
 #include "HTTP/GeminiHTTPManager.h"
 #include "BehaviorTree/BlackboardComponent.h"
 
@@ -13,8 +16,20 @@ bool ULLMBlueprintLibrary::ProcessLLMResponse(
 	UBlackboardComponent* Blackboard,
 	UObject* WorldContext,
 	FString& OutErrorMessage)
+{
+	FLLMPlan Plan;
+	return ProcessLLMPlanResponse(LLMResponseBody, Blackboard, WorldContext, Plan, OutErrorMessage);
+}
+
+bool ULLMBlueprintLibrary::ProcessLLMPlanResponse(
+	const FString& LLMResponseBody,
+	UBlackboardComponent* Blackboard,
+	UObject* WorldContext,
+	FLLMPlan& OutPlan,
+	FString& OutErrorMessage)
 {
 	OutErrorMessage.Empty();
+	OutPlan = FLLMPlan();
 
 	if (!Blackboard)
 	{
@@ -23,64 +38,133 @@ bool ULLMBlueprintLibrary::ProcessLLMResponse(
 		return false;
 	}
 
-	// Step 1: Extract JSON from LLM response
-	FString JsonString;
-	if (!UGeminiHTTPManager::TryExtractStructuredJsonString(LLMResponseBody, JsonString))
+	if (!ParseLLMPlanResponse(LLMResponseBody, WorldContext, OutPlan, OutErrorMessage))
 	{
-		OutErrorMessage = TEXT("Failed to extract JSON from LLM response");
-		UE_LOG(LogTemp, Error, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
 		return false;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[LLMBlueprintLibrary] Extracted JSON: %s"), *JsonString);
+	// Steps 4-5: Normalize and hand over to the agent / blackboard
+	return ExecutePlan(OutPlan, Blackboard, WorldContext, OutErrorMessage);
+}
 
-	// Step 2: Parse JSON to action
-	FLLMAction Action;
-	if (!ULLMActionParser::ParseAction(JsonString, Action))
+bool ULLMBlueprintLibrary::ParseLLMPlanResponse(
+	const FString& LLMResponseBody,
+	UObject* WorldContext,
+	FLLMPlan& OutPlan,
+	FString& OutErrorMessage)
+{
+	OutErrorMessage.Empty();
+	OutPlan = FLLMPlan();
+
+	// Step 1: Extract JSON from LLM response (one string per candidate)
+	TArray<FString> CandidateJson;
+	if (!UGeminiHTTPManager::TryExtractAllStructuredJsonStrings(LLMResponseBody, CandidateJson))
 	{
-		OutErrorMessage = TEXT("Failed to parse JSON to action");
+		OutErrorMessage = TEXT("Failed to extract JSON from LLM response");
 		UE_LOG(LogTemp, Error, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
 		return false;
 	}
 
-	// Step 3: Validate action
-	if (!ULLMActionParser::ValidateAction(Action, OutErrorMessage))
+	if (CandidateJson.Num() > 1)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("[LLMBlueprintLibrary] Action validation failed: %s"), *OutErrorMessage);
-		return false;
+		// Steps 2-3 for several candidates: parse and validate all, keep the best
+		if (!ULLMCandidateRanker::SelectBestPlan(CandidateJson, WorldContext, OutPlan, OutErrorMessage))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMBlueprintLibrary] Action validation failed: %s"), *OutErrorMessage);
+			return false;
+		}
 	}
-
-	// Step 4: Normalize action
-	if (!ULLMActionParser::NormalizeAction(Action, WorldContext))
+	else
 	{
-		OutErrorMessage = TEXT("Failed to normalize action");
-		UE_LOG(LogTemp, Warning, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
-		// Continue anyway, normalization is not critical
+		const FString& JsonString = CandidateJson[0];
+		UE_LOG(LogTemp, Log, TEXT("[LLMBlueprintLibrary] Extracted JSON: %s"), *JsonString);
+
+		// Step 2: Parse JSON to a plan (a single action is a one-step plan)
+		if (!ULLMActionParser::ParsePlan(JsonString, OutPlan))
+		{
+			OutErrorMessage = TEXT("Failed to parse JSON to action");
+			UE_LOG(LogTemp, Error, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
+			return false;
+		}
+
+		// Step 3: Validate action; one bad step rejects the whole plan
+		for (int32 Index = 0; Index < OutPlan.Steps.Num(); ++Index)
+		{
+			if (!ULLMActionParser::ValidateAction(OutPlan.Steps[Index].Action, OutErrorMessage))
+			{
+				if (OutPlan.Steps.Num() > 1)
+				{
+					OutErrorMessage = FString::Printf(TEXT("Plan step %d: %s"), Index + 1, *OutErrorMessage);
+				}
+				UE_LOG(LogTemp, Warning, TEXT("[LLMBlueprintLibrary] Action validation failed: %s"), *OutErrorMessage);
+				return false;
+			}
+		}
 	}
+	return true;
+}
+
+bool ULLMBlueprintLibrary::ExecutePlan(
+	FLLMPlan& Plan,
+	UBlackboardComponent* Blackboard,
+	UObject* WorldContext,
+	FString& OutErrorMessage)
+{
+	OutErrorMessage.Empty();
 
-	// Step 5: Write to blackboard (using default threshold)
-	if (!ULLMBlackboardMapper::WriteActionToBlackboard(Blackboard, Action, DefaultConfidenceThreshold))
+	if (!Blackboard || Plan.Steps.Num() == 0)
 	{
-		OutErrorMessage = TEXT("Failed to write action to blackboard");
+		OutErrorMessage = Blackboard ? TEXT("Plan has no steps") : TEXT("Blackboard is null");
 		UE_LOG(LogTemp, Error, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
 		return false;
 	}
 
-	UE_LOG(LogTemp, Log, TEXT("[LLMBlueprintLibrary] Successfully processed LLM response and updated blackboard"));
+	for (int32 Index = 0; Index < Plan.Steps.Num(); ++Index)
+	{
+		FLLMAction& Action = Plan.Steps[Index].Action;
+
+		// Step 4: Normalize action (named points resolve relative to the blackboard's agent)
+		if (!ULLMActionParser::NormalizeAction(Action, Blackboard->GetOwner() ? Blackboard->GetOwner() : WorldContext))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMBlueprintLibrary] Failed to normalize action (step %d)"), Index + 1);
+			// Continue anyway, normalization is not critical
+		}
+	}
+
+	// Step 5: Hand the plan to the agent's queue, or write the single action directly
+	if (ULLMAgentComponent* Agent = ULLMAgentComponent::FindForActor(Blackboard->GetOwner()))
+	{
+		if (!Agent->StartPlan(Plan, Blackboard))
+		{
+			OutErrorMessage = TEXT("Failed to write action to blackboard");
+			UE_LOG(LogTemp, Error, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
+			return false;
+		}
+	}
+	else
+	{
+		if (Plan.Steps.Num() > 1)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMBlueprintLibrary] %d-step plan but no LLMAgentComponent on %s, executing the first step only"),
+				Plan.Steps.Num(), *GetNameSafe(Blackboard->GetOwner()));
+		}
+
+		// Write to blackboard (using default threshold)
+		if (!ULLMBlackboardMapper::WriteActionToBlackboard(Blackboard, Plan.Steps[0].Action, DefaultConfidenceThreshold))
+		{
+			OutErrorMessage = TEXT("Failed to write action to blackboard");
+			UE_LOG(LogTemp, Error, TEXT("[LLMBlueprintLibrary] %s"), *OutErrorMessage);
+			return false;
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMBlueprintLibrary] Successfully executed plan and updated blackboard"));
 	return true;
 }
 
 FString ULLMBlueprintLibrary::GetIntentAsString(const FLLMAction& Action)
 {
-	switch (Action.Intent)
-	{
-	case ELLMIntent::MoveTo: return TEXT("MoveTo");
-	case ELLMIntent::Interact: return TEXT("Interact");
-	case ELLMIntent::Speak: return TEXT("Speak");
-	case ELLMIntent::PlayMontage: return TEXT("PlayMontage");
-	case ELLMIntent::Idle: return TEXT("Idle");
-	default: return TEXT("Unknown");
-	}
+	return ULLMIntentRegistry::GetWireName(Action);
 }
 
 FString ULLMBlueprintLibrary::GetLLMActionSystemPrompt()
@@ -33,6 +33,47 @@ public:
 		UObject* WorldContext,
 		FString& OutErrorMessage);
 
+	/**
+	 * Same pipeline for plan responses: every step is parsed, validated and normalized
+	 * The plan is queued on the blackboard owner's ULLMAgentComponent when it has one;
+	 * otherwise only the first step is written
+	 * @param OutPlan - Parsed plan (a single action yields one step)
+	 * @return true if the first step was written to blackboard
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Actions", meta = (WorldContext = "WorldContext"))
+	static bool ProcessLLMPlanResponse(
+		const FString& LLMResponseBody,
+		UBlackboardComponent* Blackboard,
+		UObject* WorldContext,
+		FLLMPlan& OutPlan,
+		FString& OutErrorMessage);
+
+	/**
+	 * Steps 1-3 of ProcessLLMPlanResponse without touching a blackboard: extract, parse and
+	 * validate (ranking candidates when there are several). The plan is not normalized.
+	 * @param WorldContext - World whose vocabulary ranks candidates (optional)
+	 * @return true if a valid plan was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Actions", meta = (WorldContext = "WorldContext"))
+	static bool ParseLLMPlanResponse(
+		const FString& LLMResponseBody,
+		UObject* WorldContext,
+		FLLMPlan& OutPlan,
+		FString& OutErrorMessage);
+
+	/**
+	 * Last stage of the pipeline for an already validated plan: normalize every step, then
+	 * queue it on the agent (or write the first step), as ProcessLLMPlanResponse does
+	 * @param Plan - Validated plan; normalized in place
+	 * @return true if the first step was written to blackboard
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Actions", meta = (WorldContext = "WorldContext"))
+	static bool ExecutePlan(
+		UPARAM(ref) FLLMPlan& Plan,
+		UBlackboardComponent* Blackboard,
+		UObject* WorldContext,
+		FString& OutErrorMessage);
+
 	/**
 	 * Get the intent from an FLLMAction as a string
 	 */
@@ -0,0 +1,176 @@
+// Picks the best of several LLM response candidates without another round trip
+#include "LLM/LLMCandidateRanker.h"
+#include "LLM/LLMActionParser.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMCandidateRankerPrivate
+{
+	struct FCandidateResult
+	{
+		FLLMPlan Plan;
+		FString Error;
+		bool bParsed = false;
+		bool bValid = false;
+		float Confidence = 0.0f;
+		int32 VocabularyMisses = 0;
+	};
+
+	// Game-thread only
+	static FLLMCandidateStats Stats;
+
+	// Higher is better: validity, then vocabulary fit, then confidence
+	static bool IsBetter(const FCandidateResult& A, const FCandidateResult& B)
+	{
+		if (A.bValid != B.bValid)
+		{
+			return A.bValid;
+		}
+		if (A.VocabularyMisses != B.VocabularyMisses)
+		{
+			return A.VocabularyMisses < B.VocabularyMisses;
+		}
+		return A.Confidence > B.Confidence;
+	}
+
+	static void LogStats()
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMCandidateRanker] %d rankings, %d candidates | losers: %d parse, %d validation, %d vocabulary, %d outscored | first wins %d, rescues %d, none valid %d"),
+			Stats.Rankings, Stats.Candidates, Stats.ParseFailures, Stats.ValidationFailures, Stats.VocabularyLosers,
+			Stats.OutscoredLosers, Stats.FirstCandidateWins, Stats.Rescues, Stats.NoValidCandidate);
+	}
+
+	static FAutoConsoleCommand LogStatsCommand(
+		TEXT("LLM.CandidateStats"),
+		TEXT("Log multi-candidate ranking statistics"),
+		FConsoleCommandDelegate::CreateStatic(&LogStats));
+}
+
+bool ULLMCandidateRanker::SelectBestPlan(const TArray<FString>& CandidateJson, UObject* WorldContext, FLLMPlan& OutPlan, FString& OutErrorMessage)
+{
+	using namespace LLMCandidateRankerPrivate;
+
+	check(IsInGameThread());
+	OutErrorMessage.Empty();
+
+	if (CandidateJson.Num() == 0)
+	{
+		OutErrorMessage = TEXT("No candidates");
+		return false;
+	}
+
+	// Serial on purpose: parsing touches the intent registry, enum reflection and the lazily built
+	// schema, none of which are safe off the game thread, and there are only a handful of candidates
+	TArray<FCandidateResult> Results;
+	Results.SetNum(CandidateJson.Num());
+	for (int32 Index = 0; Index < CandidateJson.Num(); ++Index)
+	{
+		FCandidateResult& Result = Results[Index];
+		Result.bParsed = ULLMActionParser::ParsePlan(CandidateJson[Index], Result.Plan);
+		if (!Result.bParsed)
+		{
+			Result.Error = TEXT("Failed to parse JSON to action");
+			continue;
+		}
+
+		float ConfidenceSum = 0.0f;
+		bool bAllValid = true;
+		for (const FLLMPlanStep& Step : Result.Plan.Steps)
+		{
+			if (!ULLMActionParser::ValidateAction(Step.Action, Result.Error))
+			{
+				bAllValid = false;
+				break;
+			}
+			ConfidenceSum += Step.Action.Confidence;
+		}
+		Result.bValid = bAllValid;
+		Result.Confidence = bAllValid ? ConfidenceSum / Result.Plan.Steps.Num() : 0.0f;
+	}
+
+	// Prefer candidates whose names exist in the world
+	if (const ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(WorldContext))
+	{
+		for (FCandidateResult& Result : Results)
+		{
+			if (Result.bValid)
+			{
+				Result.VocabularyMisses = Vocabulary->CountUnknownNames(Result.Plan);
+			}
+		}
+	}
+
+	int32 BestIndex = 0;
+	for (int32 Index = 1; Index < Results.Num(); ++Index)
+	{
+		if (IsBetter(Results[Index], Results[BestIndex]))
+		{
+			BestIndex = Index;
+		}
+	}
+	const FCandidateResult& Best = Results[BestIndex];
+
+	++Stats.Rankings;
+	Stats.Candidates += Results.Num();
+	for (int32 Index = 0; Index < Results.Num(); ++Index)
+	{
+		const FCandidateResult& Result = Results[Index];
+		if (Index == BestIndex && Result.bValid)
+		{
+			continue;
+		}
+
+		if (!Result.bParsed)
+		{
+			++Stats.ParseFailures;
+		}
+		else if (!Result.bValid)
+		{
+			++Stats.ValidationFailures;
+		}
+		else if (Result.VocabularyMisses > Best.VocabularyMisses)
+		{
+			++Stats.VocabularyLosers;
+		}
+		else
+		{
+			++Stats.OutscoredLosers;
+		}
+
+		UE_LOG(LogTemp, Verbose, TEXT("[LLMCandidateRanker] Candidate %d lost: %s"), Index,
+			Result.bValid ? *FString::Printf(TEXT("confidence %.2f, %d unknown names"), Result.Confidence, Result.VocabularyMisses) : *Result.Error);
+	}
+
+	if (!Best.bValid)
+	{
+		++Stats.NoValidCandidate;
+		OutErrorMessage = Results[0].Error;
+		UE_LOG(LogTemp, Warning, TEXT("[LLMCandidateRanker] None of %d candidates is valid: %s"), Results.Num(), *OutErrorMessage);
+		return false;
+	}
+
+	if (BestIndex == 0)
+	{
+		++Stats.FirstCandidateWins;
+	}
+	else if (!Results[0].bValid)
+	{
+		++Stats.Rescues;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMCandidateRanker] Picked candidate %d of %d (confidence %.2f, %d unknown names)"),
+		BestIndex, Results.Num(), Best.Confidence, Best.VocabularyMisses);
+
+	OutPlan = MoveTemp(Results[BestIndex].Plan);
+	return true;
+}
+
+FLLMCandidateStats ULLMCandidateRanker::GetStats()
+{
+	return LLMCandidateRankerPrivate::Stats;
+}
+
+void ULLMCandidateRanker::ResetStats()
+{
+	LLMCandidateRankerPrivate::Stats = FLLMCandidateStats();
+}
@@ -0,0 +1,81 @@
+// Picks the best of several LLM response candidates without another round trip
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMCandidateRanker.generated.h"
+
+/**
+ * Running totals over every ranking pass, including why the losing candidates lost
+ */
+USTRUCT(BlueprintType)
+struct FLLMCandidateStats
+{
+	GENERATED_BODY()
+
+	// Ranking passes (responses with more than one candidate)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 Rankings = 0;
+
+	// Candidates seen across all passes
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 Candidates = 0;
+
+	// Losers that were not valid plan/action JSON
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 ParseFailures = 0;
+
+	// Losers rejected by ValidateAction (confidence, missing fields, ...)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 ValidationFailures = 0;
+
+	// Valid losers ranked down for naming montages, nav points or target types the world does not have
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 VocabularyLosers = 0;
+
+	// Valid losers with lower confidence
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 OutscoredLosers = 0;
+
+	// Passes won by the first candidate (what a single-candidate request would have returned)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 FirstCandidateWins = 0;
+
+	// Passes where the first candidate was unusable but another one was: each is a retry avoided
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 Rescues = 0;
+
+	// Passes where no candidate was usable
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Candidates")
+	int32 NoValidCandidate = 0;
+};
+
+/**
+ * Parses and validates all candidates of a multi-candidate response and keeps the best:
+ * valid first, then fewest names unknown to ULLMWorldVocabulary, then highest mean confidence
+ */
+UCLASS(BlueprintType)
+class TESTCPP_API ULLMCandidateRanker : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Select the best candidate; call from the game thread
+	 * @param CandidateJson - Structured JSON of each candidate (see UGeminiHTTPManager::TryExtractAllStructuredJsonStrings)
+	 * @param WorldContext - World whose vocabulary is used for scoring (optional)
+	 * @param OutPlan - Winning plan (a single action yields one step)
+	 * @param OutErrorMessage - First candidate's error when none is usable
+	 * @return true if a valid candidate was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Candidates", meta = (WorldContext = "WorldContext"))
+	static bool SelectBestPlan(const TArray<FString>& CandidateJson, UObject* WorldContext, FLLMPlan& OutPlan, FString& OutErrorMessage);
+
+	/** Totals since startup or the last ResetStats */
+	UFUNCTION(BlueprintPure, Category = "LLM|Candidates")
+	static FLLMCandidateStats GetStats();
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|Candidates")
+	static void ResetStats();
+};
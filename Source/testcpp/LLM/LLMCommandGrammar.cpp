@@ -0,0 +1,29 @@
+// Data-driven grammar for commands that can be resolved without the LLM
+#include "LLM/LLMCommandGrammar.h"
+#include "LLM/LLMIntentRegistry.h"
+
+ULLMCommandGrammar* ULLMCommandGrammar::CreateDefault(UObject* Outer)
+{
+	ULLMCommandGrammar* Grammar = NewObject<ULLMCommandGrammar>(Outer);
+
+	auto AddRule = [Grammar](const FGameplayTag& Tag, ELLMCommandSlot Slot, float Confidence, TArray<FString> Phrases)
+	{
+		FLLMCommandRule& Rule = Grammar->Rules.AddDefaulted_GetRef();
+		Rule.IntentTag = Tag;
+		Rule.Slot = Slot;
+		Rule.Confidence = Confidence;
+		Rule.Phrases = MoveTemp(Phrases);
+	};
+
+	AddRule(TAG_LLM_Intent_MoveTo, ELLMCommandSlot::NavPoint, 0.95f,
+		{ TEXT("go to"), TEXT("go"), TEXT("walk to"), TEXT("move to"), TEXT("run to"), TEXT("head to"), TEXT("travel to") });
+	AddRule(TAG_LLM_Intent_Interact, ELLMCommandSlot::TargetType, 0.9f,
+		{ TEXT("open"), TEXT("use"), TEXT("interact with"), TEXT("talk to"), TEXT("speak to"), TEXT("activate") });
+	AddRule(TAG_LLM_Intent_Speak, ELLMCommandSlot::FreeText, 0.95f,
+		{ TEXT("say"), TEXT("shout"), TEXT("yell"), TEXT("announce") });
+	AddRule(TAG_LLM_Intent_PlayMontage, ELLMCommandSlot::Montage, 0.9f,
+		{ TEXT(""), TEXT("play"), TEXT("do"), TEXT("perform") });
+
+	Grammar->FillerWords = { TEXT("please"), TEXT("the"), TEXT("a"), TEXT("an"), TEXT("now"), TEXT("this"), TEXT("that") };
+	return Grammar;
+}
@@ -0,0 +1,71 @@
+// Data-driven grammar for commands that can be resolved without the LLM
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "LLMCommandGrammar.generated.h"
+
+/**
+ * What must follow a rule's verb phrase
+ */
+UENUM(BlueprintType)
+enum class ELLMCommandSlot : uint8
+{
+	// Nothing: the phrase alone is the command
+	None UMETA(DisplayName = "None"),
+	// A registered nav point name (MoveTo)
+	NavPoint UMETA(DisplayName = "Nav Point"),
+	// A registered target type (Interact)
+	TargetType UMETA(DisplayName = "Target Type"),
+	// A registered montage name (PlayMontage)
+	Montage UMETA(DisplayName = "Montage"),
+	// Any non-empty text, kept verbatim (Speak)
+	FreeText UMETA(DisplayName = "Free Text")
+};
+
+/**
+ * One verb pattern: any of Phrases followed by the slot
+ */
+USTRUCT(BlueprintType)
+struct FLLMCommandRule
+{
+	GENERATED_BODY()
+
+	// Intent produced by a match
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grammar", meta = (Categories = "LLM.Intent"))
+	FGameplayTag IntentTag;
+
+	// Verb synonyms ("go to", "walk to"); an empty phrase matches the slot alone ("wave")
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grammar")
+	TArray<FString> Phrases;
+
+	// Slot that must follow the phrase
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grammar")
+	ELLMCommandSlot Slot = ELLMCommandSlot::None;
+
+	// Confidence reported for a match
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grammar", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float Confidence = 0.95f;
+};
+
+/**
+ * Verb synonyms and filler words for ULLMLocalCommandMatcher
+ * Slot values come from the live world vocabulary, so the grammar only lists verbs
+ */
+UCLASS(BlueprintType)
+class TESTCPP_API ULLMCommandGrammar : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Grammar")
+	TArray<FLLMCommandRule> Rules;
+
+	// Words ignored before the verb and inside name slots ("please", "the")
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Grammar")
+	TArray<FString> FillerWords;
+
+	/** Built-in English grammar for the built-in intents */
+	static ULLMCommandGrammar* CreateDefault(UObject* Outer);
+};
@@ -0,0 +1,157 @@
+// Per-agent conversation memory: recent turns verbatim, older turns folded into a rolling summary
+#include "LLM/LLMConversationHistory.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMSettings.h"
+#include "HTTP/LLMTokenEstimator.h"
+
+namespace LLMConversationHistoryPrivate
+{
+	static const TCHAR* SpeakerName(const FLLMConversationTurn& Turn)
+	{
+		return Turn.bFromModel ? TEXT("Character") : TEXT("Player");
+	}
+}
+
+void FLLMConversationHistory::AddExchange(const FString& UserText, const FString& ModelText)
+{
+	if (Ring.Num() == 0)
+	{
+		Ring.SetNum(FMath::Max(1, GetDefault<ULLMSettings>()->ConversationVerbatimTurns) * 2);
+	}
+
+	Push(false, UserText);
+	Push(true, ModelText);
+
+	// Nothing has summarized for a while (no summarizer, or requests keep failing): fold locally
+	if (NumSummarizing == 0 && FoldedTurns.Num() > Ring.Num())
+	{
+		FoldWithoutModel(GetDefault<ULLMSettings>()->ConversationSummaryTokens);
+	}
+}
+
+void FLLMConversationHistory::Push(bool bFromModel, const FString& Text)
+{
+	if (Count == Ring.Num())
+	{
+		FoldedTurns.Add(MoveTemp(Ring[Head]));
+		Head = (Head + 1) % Ring.Num();
+		--Count;
+	}
+
+	FLLMConversationTurn& Turn = Ring[(Head + Count) % Ring.Num()];
+	Turn.bFromModel = bFromModel;
+	Turn.Text = Text;
+	++Count;
+}
+
+void FLLMConversationHistory::GetRecentTurns(int32 TokenBudget, TArray<FLLMConversationTurn>& OutTurns) const
+{
+	OutTurns.Reset();
+
+	// Newest exchanges first until the budget is spent; an exchange is kept or dropped whole
+	int32 First = Count;
+	int32 Tokens = 0;
+	while (First >= 2)
+	{
+		const FLLMConversationTurn& User = Ring[(Head + First - 2) % Ring.Num()];
+		const FLLMConversationTurn& Model = Ring[(Head + First - 1) % Ring.Num()];
+		const int32 ExchangeTokens = FLLMTokenEstimator::EstimateRaw(User.Text) + FLLMTokenEstimator::EstimateRaw(Model.Text);
+		if (Tokens + ExchangeTokens > TokenBudget)
+		{
+			break;
+		}
+		Tokens += ExchangeTokens;
+		First -= 2;
+	}
+
+	for (int32 Index = First; Index < Count; ++Index)
+	{
+		OutTurns.Add(Ring[(Head + Index) % Ring.Num()]);
+	}
+}
+
+FString FLLMConversationHistory::BeginSummary()
+{
+	NumSummarizing = FoldedTurns.Num();
+
+	FString Prompt = FString::Printf(TEXT("Current summary:\n%s\n\nEarlier messages:\n"), Summary.IsEmpty() ? TEXT("(none)") : *Summary);
+	for (int32 Index = 0; Index < NumSummarizing; ++Index)
+	{
+		Prompt += FString::Printf(TEXT("%s: %s\n"), LLMConversationHistoryPrivate::SpeakerName(FoldedTurns[Index]), *FoldedTurns[Index].Text);
+	}
+	return Prompt;
+}
+
+bool FLLMConversationHistory::CompleteSummary(const FString& NewSummary, uint32 InGeneration)
+{
+	// Reset while the request was out: the turns it summarized are gone and must not come back
+	if (InGeneration != Generation)
+	{
+		return false;
+	}
+
+	FoldedTurns.RemoveAt(0, FMath::Min(NumSummarizing, FoldedTurns.Num()));
+	NumSummarizing = 0;
+	Summary = NewSummary;
+	return true;
+}
+
+void FLLMConversationHistory::FoldWithoutModel(int32 MaxSummaryTokens)
+{
+	TArray<FString> Lines;
+	Summary.ParseIntoArrayLines(Lines);
+	for (const FLLMConversationTurn& Turn : FoldedTurns)
+	{
+		// Model turns are plan JSON; what the player asked for carries the conversation
+		if (!Turn.bFromModel)
+		{
+			Lines.Add(FString::Printf(TEXT("Player: %s"), *Turn.Text));
+		}
+	}
+	FoldedTurns.Reset();
+	NumSummarizing = 0;
+
+	int32 Tokens = 0;
+	int32 First = Lines.Num();
+	while (First > 0 && Tokens + FLLMTokenEstimator::EstimateRaw(Lines[First - 1]) <= MaxSummaryTokens)
+	{
+		Tokens += FLLMTokenEstimator::EstimateRaw(Lines[--First]);
+	}
+	Lines.RemoveAt(0, First);
+	Summary = FString::Join(Lines, TEXT("\n"));
+}
+
+void FLLMConversationHistory::Reset()
+{
+	Ring.Reset();
+	Head = 0;
+	Count = 0;
+	FoldedTurns.Reset();
+	NumSummarizing = 0;
+	Summary.Empty();
+	++Generation;
+}
+
+FString FLLMConversationHistory::DescribePlan(const FLLMPlan& Plan)
+{
+	TArray<FString> Steps;
+	for (const FLLMPlanStep& Step : Plan.Steps)
+	{
+		const FLLMAction& Action = Step.Action;
+		FString Description = ULLMIntentRegistry::GetWireName(Action);
+		if (!Action.Target.Id.IsEmpty())
+		{
+			Description += FString::Printf(TEXT(" %s"), *Action.Target.Id);
+		}
+		if (!Action.Location.bUseCoordinates && !Action.Location.NavPointName.IsEmpty())
+		{
+			Description += FString::Printf(TEXT(" to %s"), *Action.Location.NavPointName);
+		}
+		if (!Action.Speak.IsEmpty())
+		{
+			Description += FString::Printf(TEXT(" \"%s\""), *Action.Speak);
+		}
+		Steps.Add(MoveTemp(Description));
+	}
+	return FString::Join(Steps, TEXT(", then "));
+}
@@ -0,0 +1,76 @@
+// Per-agent conversation memory: recent turns verbatim, older turns folded into a rolling summary
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "LLM/LLMActionTypes.h"
+
+/**
+ * Conversation of one agent with the player
+ * The last ConversationVerbatimTurns exchanges live in a fixed ring and are sent as real
+ * multi-turn contents. Exchanges pushed out of the ring wait in a fold list until
+ * ULLMConversationSummarizer merges them into the summary, which is sent as a context section.
+ * Prompt size therefore stays bounded however long the session runs.
+ */
+class TESTCPP_API FLLMConversationHistory
+{
+public:
+	/** Remember one exchange; the oldest exchange leaves the ring when it is full */
+	void AddExchange(const FString& UserText, const FString& ModelText);
+
+	/**
+	 * Most recent turns that fit a token budget, oldest first
+	 * @param TokenBudget - Estimated tokens the turns may use
+	 */
+	void GetRecentTurns(int32 TokenBudget, TArray<FLLMConversationTurn>& OutTurns) const;
+
+	/** Everything older than the verbatim turns, condensed; empty until the first fold */
+	const FString& GetSummary() const { return Summary; }
+
+	/** Folded turns are waiting and no summary request is running */
+	bool NeedsSummary() const { return FoldedTurns.Num() > 0 && NumSummarizing == 0; }
+
+	/** Prompt asking to merge the folded turns into the summary; they stay folded until CompleteSummary */
+	FString BeginSummary();
+
+	/**
+	 * Replace the summary with the model's merge of the turns handed out by BeginSummary
+	 * @param InGeneration - GetGeneration() when BeginSummary was called; a summary of a conversation since reset is dropped
+	 * @return false if the conversation was reset meanwhile and the summary was dropped
+	 */
+	bool CompleteSummary(const FString& NewSummary, uint32 InGeneration);
+
+	/** Changes on every Reset, so work started on the old conversation can tell it is stale */
+	uint32 GetGeneration() const { return Generation; }
+
+	/**
+	 * Fold without a model: append the player's lines to the summary and keep its newest part
+	 * @param MaxSummaryTokens - Estimated size the summary is cut to
+	 */
+	void FoldWithoutModel(int32 MaxSummaryTokens);
+
+	void Reset();
+
+	/** Verbatim turns currently held */
+	int32 Num() const { return Count; }
+
+	/** Model turn for a plan served without the LLM (no raw JSON to replay) */
+	static FString DescribePlan(const FLLMPlan& Plan);
+
+private:
+	void Push(bool bFromModel, const FString& Text);
+
+	// Verbatim turns; Head is the oldest
+	TArray<FLLMConversationTurn> Ring;
+	int32 Head = 0;
+	int32 Count = 0;
+
+	// Turns that left the ring and are not in the summary yet, oldest first
+	TArray<FLLMConversationTurn> FoldedTurns;
+	// Leading FoldedTurns handed to the summary request in flight
+	int32 NumSummarizing = 0;
+
+	FString Summary;
+
+	uint32 Generation = 0;
+};
@@ -0,0 +1,125 @@
+// Low-priority background requests that fold old conversation turns into each agent's summary
+#include "LLM/LLMConversationSummarizer.h"
+#include "LLM/LLMAgentComponent.h"
+#include "LLM/LLMSettings.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "HTTP/APIData.h"
+#include "Engine/GameInstance.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace LLMConversationSummarizerPrivate
+{
+	static constexpr float TickInterval = 0.25f;
+
+	static const TCHAR* SystemInstruction =
+		TEXT("You keep a running summary of a conversation between a player and a game character. ")
+		TEXT("Merge the earlier messages into the current summary. Keep names, requests, promises and facts the character ")
+		TEXT("learned; drop greetings and small talk. Character messages may be JSON actions: summarize what the character did or said. ")
+		TEXT("Reply with the updated summary only, as short plain sentences.");
+}
+
+ULLMConversationSummarizer* ULLMConversationSummarizer::Get(const UObject* WorldContext)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContext);
+	return GameInstance ? GameInstance->GetSubsystem<ULLMConversationSummarizer>() : nullptr;
+}
+
+void ULLMConversationSummarizer::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULLMConversationSummarizer::Tick),
+		LLMConversationSummarizerPrivate::TickInterval);
+}
+
+void ULLMConversationSummarizer::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Queue.Reset();
+	Super::Deinitialize();
+}
+
+void ULLMConversationSummarizer::Request(ULLMAgentComponent* Agent, UAPIData* APIData)
+{
+	if (!Agent || Queue.ContainsByPredicate([Agent](const FQueuedAgent& Queued) { return Queued.Agent == Agent; }))
+	{
+		return;
+	}
+	Queue.Add({ Agent, APIData });
+}
+
+bool ULLMConversationSummarizer::Tick(float DeltaTime)
+{
+	if (bInFlight || Queue.Num() == 0)
+	{
+		return true;
+	}
+
+	// Low priority: wait until no other request is in flight
+	UGeminiHTTPManager* Manager = GetGameInstance()->GetSubsystem<UGeminiHTTPManager>();
+	if (!Manager || Manager->GetActiveRequestCount() > 0)
+	{
+		return true;
+	}
+
+	const FQueuedAgent Next = Queue[0];
+	Queue.RemoveAt(0);
+	ULLMAgentComponent* Agent = Next.Agent.Get();
+	if (!Agent || !Agent->GetConversation().NeedsSummary())
+	{
+		return true;
+	}
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	UAPIData* APIData = Next.APIData.Get();
+	if (!APIData || APIData->GetProvider() == ELLMProvider::Local)
+	{
+		Agent->GetConversation().FoldWithoutModel(Settings->ConversationSummaryTokens);
+		return true;
+	}
+
+	FGeminiGenerateContentConfig Config;
+	Config.SystemInstruction = LLMConversationSummarizerPrivate::SystemInstruction;
+	Config.Temperature = 0.2f;
+	Config.MaxOutputTokens = Settings->ConversationSummaryTokens;
+
+	FOnGeminiResponse Delegate;
+	Delegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(ULLMConversationSummarizer, OnSummaryResponse));
+
+	bInFlight = true;
+	InFlightAgent = Agent;
+	InFlightGeneration = Agent->GetConversation().GetGeneration();
+	Manager->InitializeWithData(APIData);
+	Manager->GenerateContent(Agent->GetConversation().BeginSummary(), Config, Delegate);
+	return true;
+}
+
+void ULLMConversationSummarizer::OnSummaryResponse(bool bSuccess, const FString& JsonResponse)
+{
+	bInFlight = false;
+	ULLMAgentComponent* Agent = InFlightAgent.Get();
+	InFlightAgent.Reset();
+	if (!Agent)
+	{
+		return;
+	}
+
+	FLLMConversationHistory& Conversation = Agent->GetConversation();
+	if (Conversation.GetGeneration() != InFlightGeneration)
+	{
+		UE_LOG(LogTemp, Verbose, TEXT("[LLMConversationSummarizer] Conversation of %s was reset; summary dropped"), *GetNameSafe(Agent->GetOwner()));
+		return;
+	}
+
+	FString Summary;
+	FGeminiResponseUsage Usage;
+	const bool bTruncated = UGeminiHTTPManager::TryExtractUsage(JsonResponse, Usage) && Usage.TruncatedCandidates > 0;
+	if (bSuccess && !bTruncated && UGeminiHTTPManager::TryExtractTextFromResponse(JsonResponse, Summary) && !Summary.TrimStartAndEnd().IsEmpty())
+	{
+		Conversation.CompleteSummary(Summary.TrimStartAndEnd(), InFlightGeneration);
+		UE_LOG(LogTemp, Verbose, TEXT("[LLMConversationSummarizer] Summary of %s updated (%d chars)"), *GetNameSafe(Agent->GetOwner()), Summary.Len());
+		return;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("[LLMConversationSummarizer] Summary request failed for %s; folding without a model"), *GetNameSafe(Agent->GetOwner()));
+	Conversation.FoldWithoutModel(GetDefault<ULLMSettings>()->ConversationSummaryTokens);
+}
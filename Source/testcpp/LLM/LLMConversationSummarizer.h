@@ -0,0 +1,56 @@
+// Low-priority background requests that fold old conversation turns into each agent's summary
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "LLMConversationSummarizer.generated.h"
+
+class UAPIData;
+class ULLMAgentComponent;
+
+/**
+ * Summarizes conversation history off the turn path
+ * Agents whose FLLMConversationHistory has folded turns are queued; one summary request runs
+ * at a time and only while no other request is in flight, so dialogue turns never wait on it.
+ * The local provider cannot summarize, and failed requests are not retried: in both cases the
+ * turns are folded without a model.
+ */
+UCLASS()
+class TESTCPP_API ULLMConversationSummarizer : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMConversationSummarizer* Get(const UObject* WorldContext);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Queue an agent whose history has turns to fold
+	 * @param APIData - Profile the summary request uses
+	 */
+	void Request(ULLMAgentComponent* Agent, UAPIData* APIData);
+
+private:
+	bool Tick(float DeltaTime);
+
+	UFUNCTION()
+	void OnSummaryResponse(bool bSuccess, const FString& JsonResponse);
+
+	struct FQueuedAgent
+	{
+		TWeakObjectPtr<ULLMAgentComponent> Agent;
+		TWeakObjectPtr<UAPIData> APIData;
+	};
+	TArray<FQueuedAgent> Queue;
+
+	// Agent whose summary request is in flight
+	TWeakObjectPtr<ULLMAgentComponent> InFlightAgent;
+	// Conversation generation the request in flight summarizes
+	uint32 InFlightGeneration = 0;
+	bool bInFlight = false;
+
+	FTSTicker::FDelegateHandle TickHandle;
+};
@@ -0,0 +1,97 @@
+// Append-only log of validated LLM decisions used to train the on-device classifier
+#include "LLM/LLMDecisionLog.h"
+#include "LLM/LLMSettings.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/CoreDelegates.h"
+#include "Async/Async.h"
+
+namespace LLMDecisionLogPrivate
+{
+	// Lines not written yet; Pending is guarded by PendingLock
+	static FCriticalSection PendingLock;
+	static FString Pending;
+	static bool bFlushQueued = false;
+
+	// Keeps appends from overlapping so lines stay in order
+	static FCriticalSection FileLock;
+}
+
+void ULLMDecisionLog::Record(const FString& Input, const FLLMAction& Action)
+{
+	if (!GetDefault<ULLMSettings>()->bLogDecisions || Input.IsEmpty() || !Action.IntentTag.IsValid())
+	{
+		return;
+	}
+
+	TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+	Entry->SetStringField(TEXT("input"), Input);
+	Entry->SetStringField(TEXT("intent"), Action.IntentTag.ToString());
+	if (!Action.Location.bUseCoordinates && !Action.Location.NavPointName.IsEmpty())
+	{
+		Entry->SetStringField(TEXT("navPoint"), Action.Location.NavPointName);
+	}
+	if (!Action.Target.Type.IsEmpty())
+	{
+		Entry->SetStringField(TEXT("targetType"), Action.Target.Type);
+	}
+	if (!Action.Montage.Name.IsEmpty())
+	{
+		Entry->SetStringField(TEXT("montage"), Action.Montage.Name);
+	}
+	if (!Action.Speak.IsEmpty())
+	{
+		Entry->SetStringField(TEXT("speak"), Action.Speak);
+	}
+
+	FString Line;
+	TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Line);
+	FJsonSerializer::Serialize(Entry, Writer);
+	Line.AppendChar(TEXT('\n'));
+
+	using namespace LLMDecisionLogPrivate;
+	static const FDelegateHandle ExitHandle = FCoreDelegates::OnPreExit.AddStatic(&ULLMDecisionLog::Flush);
+
+	// One background append at a time; lines recorded meanwhile go out with the next one
+	FScopeLock Lock(&PendingLock);
+	Pending += Line;
+	if (!bFlushQueued)
+	{
+		bFlushQueued = true;
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, []()
+		{
+			ULLMDecisionLog::Flush();
+		});
+	}
+}
+
+void ULLMDecisionLog::Flush()
+{
+	using namespace LLMDecisionLogPrivate;
+
+	FScopeLock FileScope(&FileLock);
+	FString Lines;
+	{
+		FScopeLock Lock(&PendingLock);
+		Lines = MoveTemp(Pending);
+		Pending.Reset();
+		bFlushQueued = false;
+	}
+	if (Lines.IsEmpty())
+	{
+		return;
+	}
+
+	if (!FFileHelper::SaveStringToFile(Lines, *GetLogPath(), FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMDecisionLog] Failed to append to %s"), *GetLogPath());
+	}
+}
+
+FString ULLMDecisionLog::GetLogPath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LLM"), TEXT("Decisions.jsonl"));
+}
@@ -0,0 +1,34 @@
+// Append-only log of validated LLM decisions used to train the on-device classifier
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMDecisionLog.generated.h"
+
+/**
+ * Writes one JSON line per validated single-action LLM response:
+ * {"input": "...", "intent": "LLM.Intent.MoveTo", "navPoint": ..., "targetType": ..., "montage": ..., "speak": ...}
+ * The file is the training set for the LLMTrainIntentModel commandlet.
+ * Lines are buffered and appended by a background task, so recording never touches the disk on
+ * the caller's thread; whatever is still buffered is written when the engine exits.
+ */
+UCLASS()
+class TESTCPP_API ULLMDecisionLog : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Append a decision when ULLMSettings::bLogDecisions is set
+	 * @param Input - Player text that was sent to the LLM
+	 * @param Action - Validated action the LLM answered with
+	 */
+	static void Record(const FString& Input, const FLLMAction& Action);
+
+	/** Write buffered decisions now, on the calling thread */
+	static void Flush();
+
+	/** Saved/LLM/Decisions.jsonl */
+	static FString GetLogPath();
+};
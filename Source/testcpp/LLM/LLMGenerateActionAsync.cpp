@@ -1,6 +1,22 @@
 // High-level async node for LLM-to-Blackboard pipeline
 #include "LLM/LLMGenerateActionAsync.h"
 #include "LLM/LLMBlueprintLibrary.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMActionParser.h"
+#include "LLM/LLMLocalCommandMatcher.h"
+#include "LLM/LLMIntentClassifier.h"
+#include "LLM/LLMDecisionLog.h"
+#include "LLM/LLMResponseTable.h"
+#include "LLM/LLMOutputBudget.h"
+#include "LLM/LLMSemanticCache.h"
+#include "LLM/LLMSpeculativeGenerator.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "LLM/LLMAgentComponent.h"
+#include "LLM/LLMConversationSummarizer.h"
+#include "LLM/LLMMemoryStore.h"
+#include "LLM/LLMPromptTemplate.h"
+#include "LLM/LLMWorldContext.h"
+#include "LLM/LLMSettings.h"
 #include "HTTP/GeminiHTTPManager.h"
 #include "HTTP/APIData.h"
 #include "Engine/GameInstance.h"
@@ -38,6 +54,129 @@ void ULLMGenerateActionAsync::Activate()
 		return;
 	}
 
+	// Remember the request so a failed plan can be re-planned (a re-plan's own prompt is not a new goal)
+	ULLMAgentComponent* AgentComponent = ULLMAgentComponent::FindForActor(Blackboard->GetOwner());
+	if (AgentComponent && !bIsReplan)
+	{
+		AgentComponent->SetGoal(UserInput, APIData, Temperature);
+	}
+	Agent = AgentComponent;
+	PersonaId = AgentComponent ? AgentComponent->PersonaId : NAME_None;
+
+	// Simple commands are resolved by the local grammar; re-plan prompts always go to the LLM
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	if (Settings->bEnableLocalCommands && !bIsReplan && TryLocalCommand())
+	{
+		return;
+	}
+
+	// Exact repeats: baked lines shipped with the game and answers saved by earlier sessions
+	if (Settings->bEnableResponseTable && !bIsReplan && TryResponseTable())
+	{
+		return;
+	}
+
+	// Paraphrases of requests the LLM already answered for this persona
+	if (Settings->bEnableSemanticCache && !bIsReplan && TryCachedPlan())
+	{
+		return;
+	}
+
+	// Routine requests the distilled classifier is confident about skip the network as well
+	ULLMIntentClassifier* Classifier = ULLMIntentClassifier::Get();
+	if (Settings->bEnableIntentClassifier && !bIsReplan && Classifier && Classifier->HasModel())
+	{
+		Classifier->ClassifyAsync(UserInput, WorldContextObject, FOnLLMClassified::CreateUObject(this, &ULLMGenerateActionAsync::OnClassified));
+		return;
+	}
+
+	SendToLLM();
+}
+
+bool ULLMGenerateActionAsync::TryResponseTable()
+{
+	ULLMResponseTable* Table = ULLMResponseTable::Get(WorldContextObject);
+	FLLMPlan Plan;
+	if (!Table || !Table->Lookup(UserInput, PersonaId, WorldContextObject, Plan))
+	{
+		return false;
+	}
+
+	FString ErrorMessage;
+	if (!ULLMBlueprintLibrary::ExecutePlan(Plan, Blackboard, WorldContextObject, ErrorMessage))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMGenerateActionAsync] Stored plan not executable, asking the LLM: %s"), *ErrorMessage);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Served from the response table: %s"), *UserInput);
+	RecordExchange(Plan);
+	OnCompleted.Broadcast(true, Plan.Steps[0].Action, TEXT(""));
+	return true;
+}
+
+bool ULLMGenerateActionAsync::TryCachedPlan()
+{
+	ULLMSemanticCache* Cache = ULLMSemanticCache::Get(WorldContextObject);
+	FLLMPlan Plan;
+	float Similarity = 0.0f;
+	if (!Cache || !Cache->Lookup(UserInput, PersonaId, WorldContextObject, Plan, Similarity))
+	{
+		return false;
+	}
+
+	FString ErrorMessage;
+	if (!ULLMBlueprintLibrary::ExecutePlan(Plan, Blackboard, WorldContextObject, ErrorMessage))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMGenerateActionAsync] Cached plan not executable, asking the LLM: %s"), *ErrorMessage);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Served from the semantic cache (similarity %.2f): %s"), Similarity, *UserInput);
+	RecordExchange(Plan);
+	OnCompleted.Broadcast(true, Plan.Steps[0].Action, TEXT(""));
+	return true;
+}
+
+void ULLMGenerateActionAsync::OnClassified(bool bServed, const FLLMAction& Action)
+{
+	if (!bServed || !Blackboard)
+	{
+		ExpectedIntent = bServed ? FGameplayTag() : Action.IntentTag;
+		SendToLLM();
+		return;
+	}
+
+	FLLMPlan Plan;
+	Plan.Steps.AddDefaulted_GetRef().Action = Action;
+	FString ErrorMessage;
+	if (ULLMBlueprintLibrary::ExecutePlan(Plan, Blackboard, WorldContextObject, ErrorMessage))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Served by the intent classifier without an LLM call: %s"), *UserInput);
+		RecordExchange(Plan);
+		OnCompleted.Broadcast(true, Plan.Steps[0].Action, TEXT(""));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMGenerateActionAsync] Classifier action not executable, asking the LLM: %s"), *ErrorMessage);
+		SendToLLM();
+	}
+}
+
+void ULLMGenerateActionAsync::SendToLLM()
+{
+	// Relevant long-term memories are looked up on a worker thread first (bounded by MemoryRetrievalBudgetMs)
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	ULLMAgentComponent* AgentComponent = Agent.Get();
+	ULLMMemoryStore* MemoryStore = Settings->bEnableLongTermMemory && AgentComponent ? ULLMMemoryStore::Get(WorldContextObject) : nullptr;
+	if (MemoryStore && !bMemoriesRetrieved)
+	{
+		bMemoriesRetrieved = true;
+		MemoryStore->RetrieveAsync(AgentComponent->GetMemoryId(), UserInput,
+			FOnLLMMemoriesRetrieved::CreateUObject(this, &ULLMGenerateActionAsync::OnMemoriesRetrieved));
+		return;
+	}
+
 	UGameInstance* GI = UGameplayStatics::GetGameInstance(WorldContextObject);
 	if (!GI)
 	{
@@ -58,21 +197,191 @@ void ULLMGenerateActionAsync::Activate()
 	Manager->InitializeWithData(APIData);
 
 	// Create config with action system prompt and JSON output
-	FGeminiGenerateContentConfig Config;
-	Config.Temperature = Temperature;
-	Config.SystemInstruction = ULLMBlueprintLibrary::GetLLMActionSystemPrompt();
-	Config.bForceJsonResponse = true; // Force JSON-only output
+	FGeminiGenerateContentConfig Config = MakeActionConfig(WorldContextObject, Temperature, AgentComponent);
+
+	// Only as many output tokens as answers like this one have needed (a retry brings its own, wider cap)
+	ULLMOutputBudget* Budget = Settings->bAdaptiveOutputCap ? ULLMOutputBudget::Get(WorldContextObject) : nullptr;
+	if (OutputCap == 0 && Budget)
+	{
+		OutputCap = Budget->GetOutputCap(PersonaId, ExpectedIntent, Config.MaxOutputTokens);
+		if (OutputCap < Config.MaxOutputTokens)
+		{
+			Budget->NotifyCapped();
+		}
+	}
+	if (OutputCap > 0)
+	{
+		Config.MaxOutputTokens = FMath::Min(OutputCap, Config.MaxOutputTokens);
+	}
+	OutputCap = Config.MaxOutputTokens;
+
+	// Recent turns verbatim, older ones as a summary section that is trimmed first under an input budget
+	if (AgentComponent && Settings->bEnableConversationHistory)
+	{
+		FLLMConversationHistory& Conversation = AgentComponent->GetConversation();
+		Conversation.GetRecentTurns(Settings->ConversationTokenBudget, Config.History);
+		if (!Conversation.GetSummary().IsEmpty())
+		{
+			FLLMPromptSection& Section = Config.ContextSections.AddDefaulted_GetRef();
+			Section.Name = TEXT("Conversation so far");
+			Section.Text = Conversation.GetSummary();
+			Section.bKeepTail = true;
+		}
+	}
+
+	if (Memories.Num() > 0)
+	{
+		// Memories go before the summary when the input budget is tight
+		FLLMPromptSection& Section = Config.ContextSections.AddDefaulted_GetRef();
+		Section.Name = TEXT("What you remember");
+		Section.Text = TEXT("- ") + FString::Join(Memories, TEXT("\n- "));
+		Section.Priority = -1;
+	}
+
+	// The previous answer could not be carried out; kept under any input budget
+	if (!RejectionFeedback.IsEmpty())
+	{
+		FLLMPromptSection& Section = Config.ContextSections.AddDefaulted_GetRef();
+		Section.Name = TEXT("Rejected answer");
+		Section.Text = RejectionFeedback;
+		Section.Priority = 2;
+	}
+
+	// Nearby entities, pre-serialized by the world context; kept longest under an input budget
+	ULLMWorldContext* WorldContext = Settings->bEnableWorldContext ? ULLMWorldContext::Get(WorldContextObject) : nullptr;
+	if (WorldContext && Blackboard)
+	{
+		const FString& Surroundings = WorldContext->GetContextFor(Blackboard->GetOwner());
+		if (!Surroundings.IsEmpty())
+		{
+			FLLMPromptSection& Section = Config.ContextSections.AddDefaulted_GetRef();
+			Section.Name = TEXT("Surroundings");
+			Section.Text = Surroundings;
+			Section.Priority = 1;
+		}
+	}
 
-	UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Sending user input to LLM: %s"), *UserInput);
+	UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Sending user input to LLM (max %d output tokens): %s"), OutputCap, *UserInput);
 
 	// Call LLM
 	FOnGeminiResponse Delegate;
 	Delegate.BindUFunction(this, FName("InternalJsonCallback"));
+
+	// The player paused on this text while typing: reuse the request already made for it
+	// (speculations carry no conversation, surroundings or persona, so they cannot stand in for a request that does)
+	const bool bAgentPrompt = AgentComponent && (AgentComponent->PromptTemplate || !AgentComponent->Persona.IsEmpty());
+	const bool bCanUseSpeculation = !bIsReplan && !bTruncationRetried && !bAgentPrompt && Config.History.Num() == 0 && Config.ContextSections.Num() == 0;
+	ULLMSpeculativeGenerator* Speculation = bCanUseSpeculation ? ULLMSpeculativeGenerator::Get(WorldContextObject) : nullptr;
+	if (Speculation && Speculation->Claim(UserInput, APIData, Temperature, Delegate))
+	{
+		return;
+	}
+
 	Manager->GenerateContent(UserInput, Config, Delegate);
 }
 
+bool ULLMGenerateActionAsync::SendsPlainPrompt(UObject* WorldContextObject, UBlackboardComponent* Blackboard)
+{
+	// Mirrors what SendToLLM adds to the config; memories depend on the input, so any agent with a store counts
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	ULLMAgentComponent* AgentComponent = Blackboard ? ULLMAgentComponent::FindForActor(Blackboard->GetOwner()) : nullptr;
+	if (AgentComponent)
+	{
+		if (AgentComponent->PromptTemplate || !AgentComponent->Persona.IsEmpty())
+		{
+			return false;
+		}
+
+		FLLMConversationHistory& Conversation = AgentComponent->GetConversation();
+		if (Settings->bEnableConversationHistory && (Conversation.Num() > 0 || !Conversation.GetSummary().IsEmpty()))
+		{
+			return false;
+		}
+
+		if (Settings->bEnableLongTermMemory && ULLMMemoryStore::Get(WorldContextObject))
+		{
+			return false;
+		}
+	}
+
+	ULLMWorldContext* WorldContext = Settings->bEnableWorldContext ? ULLMWorldContext::Get(WorldContextObject) : nullptr;
+	return !WorldContext || (Blackboard && WorldContext->GetContextFor(Blackboard->GetOwner()).IsEmpty());
+}
+
+bool ULLMGenerateActionAsync::TryLocalCommand()
+{
+	ULLMLocalCommandMatcher* Matcher = ULLMLocalCommandMatcher::Get(WorldContextObject);
+	FLLMPlan Plan;
+	FLLMPlanStep& Step = Plan.Steps.AddDefaulted_GetRef();
+	if (!Matcher || !Matcher->TryMatch(UserInput, Step.Action)
+		|| Step.Action.Confidence < GetDefault<ULLMSettings>()->LocalCommandMinConfidence)
+	{
+		return false;
+	}
+
+	FString ErrorMessage;
+	if (!ULLMActionParser::ValidateAction(Step.Action, ErrorMessage))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMGenerateActionAsync] Local match rejected, asking the LLM: %s"), *ErrorMessage);
+		return false;
+	}
+
+	if (ULLMBlueprintLibrary::ExecutePlan(Plan, Blackboard, WorldContextObject, ErrorMessage))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Resolved locally without an LLM call: %s"), *UserInput);
+		RecordExchange(Plan);
+		OnCompleted.Broadcast(true, Plan.Steps[0].Action, TEXT(""));
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMGenerateActionAsync] Failed to execute local command: %s"), *ErrorMessage);
+		OnCompleted.Broadcast(false, FLLMAction(), ErrorMessage);
+	}
+	return true;
+}
+
+FGeminiGenerateContentConfig ULLMGenerateActionAsync::MakeActionConfig(UObject* WorldContextObject, float Temperature, const ULLMAgentComponent* AgentComponent)
+{
+	FGeminiGenerateContentConfig Config;
+	Config.Temperature = Temperature;
+	Config.SystemInstruction = ULLMPromptTemplate::BuildSystemPrompt(WorldContextObject, AgentComponent);
+	Config.bForceJsonResponse = true; // Force JSON-only output
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	Config.CandidateCount = Settings->CandidateCount;
+
+	// Constrain names to what exists in the world; the vocabulary caches the schema per revision
+	const bool bAllowPlans = Settings->bAllowPlans;
+	if (ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(WorldContextObject))
+	{
+		Config.ResponseSchema = bAllowPlans ? Vocabulary->GetConstrainedPlanSchema() : Vocabulary->GetConstrainedResponseSchema();
+	}
+	else
+	{
+		Config.ResponseSchema = bAllowPlans ? ULLMActionSchema::GetPlanResponseSchema() : ULLMActionSchema::GetResponseSchema();
+	}
+	return Config;
+}
+
+bool ULLMGenerateActionAsync::HandleCancelled()
+{
+	if (!bCancelled)
+	{
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Request cancelled; response dropped: %s"), *UserInput);
+	OnCompleted.Broadcast(false, FLLMAction(), TEXT("Cancelled"));
+	return true;
+}
+
 void ULLMGenerateActionAsync::InternalJsonCallback(bool bSuccess, const FString& JsonResponse)
 {
+	if (HandleCancelled())
+	{
+		return;
+	}
+
 	if (!bSuccess)
 	{
 		UE_LOG(LogTemp, Error, TEXT("[LLMGenerateActionAsync] LLM request failed"));
@@ -80,21 +389,159 @@ void ULLMGenerateActionAsync::InternalJsonCallback(bool bSuccess, const FString&
 		return;
 	}
 
-	// Process the response using the pipeline
+	if (RetryTruncated(JsonResponse))
+	{
+		return;
+	}
+
+	// Parse and validate; the plan reaches the blackboard once its moves are known to be reachable
 	FString ErrorMessage;
-	bool bProcessed = ULLMBlueprintLibrary::ProcessLLMResponse(
-		JsonResponse,
-		Blackboard,
-		WorldContextObject,
-		ErrorMessage);
+	FLLMPlan Plan;
+	if (!ULLMBlueprintLibrary::ParseLLMPlanResponse(JsonResponse, WorldContextObject, Plan, ErrorMessage))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMGenerateActionAsync] Failed to process LLM response: %s"), *ErrorMessage);
+		OnCompleted.Broadcast(false, FLLMAction(), ErrorMessage);
+		return;
+	}
+
+	if (!ValidateMoves(Plan, JsonResponse))
+	{
+		CompleteResponse(Plan, JsonResponse);
+	}
+}
+
+bool ULLMGenerateActionAsync::ValidateMoves(const FLLMPlan& Plan, const FString& JsonResponse)
+{
+	ULLMMoveValidator* Validator = GetDefault<ULLMSettings>()->bValidateMoves && Blackboard ? ULLMMoveValidator::Get(WorldContextObject) : nullptr;
+	if (!Validator)
+	{
+		return false;
+	}
+
+	PendingPlan = Plan;
+	PendingResponse = JsonResponse;
+	CheckedSteps.Reset();
+	TArray<FVector> Targets;
+	for (int32 Index = 0; Index < PendingPlan.Steps.Num(); ++Index)
+	{
+		// Named points are resolved first so they are checked at their navmesh location
+		FLLMAction& Action = PendingPlan.Steps[Index].Action;
+		if (Action.Intent != ELLMIntent::MoveTo)
+		{
+			continue;
+		}
+		ULLMActionParser::NormalizeAction(Action, Blackboard->GetOwner());
+		if (Action.Location.bUseCoordinates || Action.Location.bResolved)
+		{
+			CheckedSteps.Add(Index);
+			Targets.Add(Action.Location.Coordinates);
+		}
+	}
+
+	if (Targets.Num() == 0)
+	{
+		return false;
+	}
+
+	Validator->ValidateAsync(Blackboard->GetOwner(), Targets, FOnLLMMovesValidated::CreateUObject(this, &ULLMGenerateActionAsync::OnMovesValidated));
+	return true;
+}
+
+void ULLMGenerateActionAsync::OnMovesValidated(const TArray<FLLMMoveCheck>& Checks)
+{
+	if (HandleCancelled())
+	{
+		return;
+	}
+
+	FString Unreachable;
+	for (int32 Check = 0; Check < Checks.Num() && Check < CheckedSteps.Num(); ++Check)
+	{
+		FLLMLocation& Location = PendingPlan.Steps[CheckedSteps[Check]].Action.Location;
+		if (!Checks[Check].bReachable)
+		{
+			const FString Where = Location.bUseCoordinates ? Location.Coordinates.ToCompactString() : Location.NavPointName;
+			Unreachable += FString::Printf(TEXT("%s%s (%s)"), Unreachable.IsEmpty() ? TEXT("") : TEXT(", "), *Where,
+				Checks[Check].bOnNavMesh ? TEXT("no path") : TEXT("not walkable"));
+		}
+		else if (Location.bUseCoordinates)
+		{
+			// The agent moves to the walkable point under the requested one
+			Location.Coordinates = Checks[Check].Projected;
+		}
+	}
+
+	if (Unreachable.IsEmpty())
+	{
+		FLLMPlan Plan = MoveTemp(PendingPlan);
+		CompleteResponse(Plan, PendingResponse);
+		return;
+	}
+
+	// Cheap re-plan: ask once more with the reason, before any behavior tree time is spent on it
+	if (!bMoveRetried)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMGenerateActionAsync] Unreachable MoveTo target: %s; asking again"), *Unreachable);
+		bMoveRetried = true;
+		RejectionFeedback = FString::Printf(TEXT("Your previous answer moved to %s, which the character cannot reach from here. Choose a reachable location."), *Unreachable);
+		SendToLLM();
+		return;
+	}
+
+	const FString ErrorMessage = FString::Printf(TEXT("Unreachable MoveTo target: %s"), *Unreachable);
+	UE_LOG(LogTemp, Error, TEXT("[LLMGenerateActionAsync] %s"), *ErrorMessage);
+	OnCompleted.Broadcast(false, FLLMAction(), ErrorMessage);
+}
+
+void ULLMGenerateActionAsync::CompleteResponse(FLLMPlan& Plan, const FString& JsonResponse)
+{
+	FString ErrorMessage;
+	const bool bProcessed = ULLMBlueprintLibrary::ExecutePlan(Plan, Blackboard, WorldContextObject, ErrorMessage);
 
 	if (bProcessed)
 	{
-		// Extract the action from blackboard for the event
-		// For now, just create a placeholder action (could read back from blackboard)
-		FLLMAction ResultAction;
-		UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Successfully generated and processed action"));
-		OnCompleted.Broadcast(true, ResultAction, TEXT(""));
+		// Answers that finished on their own train the output caps
+		FGeminiResponseUsage Usage;
+		ULLMOutputBudget* Budget = GetDefault<ULLMSettings>()->bAdaptiveOutputCap ? ULLMOutputBudget::Get(WorldContextObject) : nullptr;
+		if (Budget && UGeminiHTTPManager::TryExtractUsage(JsonResponse, Usage))
+		{
+			if (Usage.TruncatedCandidates == 0 && Usage.CandidatesTokenCount > 0)
+			{
+				Budget->Record(PersonaId, Plan.Steps[0].Action.IntentTag, Usage.CandidatesTokenCount / FMath::Max(1, Usage.CandidateCount));
+			}
+			if (bTruncationRetried)
+			{
+				Budget->NotifyRetryRecovered();
+			}
+		}
+
+		if (!bIsReplan)
+		{
+			if (Plan.Steps.Num() == 1)
+			{
+				ULLMDecisionLog::Record(UserInput, Plan.Steps[0].Action);
+			}
+			const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+			if (ULLMSemanticCache* Cache = Settings->bEnableSemanticCache ? ULLMSemanticCache::Get(WorldContextObject) : nullptr)
+			{
+				Cache->Insert(UserInput, PersonaId, WorldContextObject, Plan);
+			}
+			if (ULLMResponseTable* Table = Settings->bEnableResponseTable ? ULLMResponseTable::Get(WorldContextObject) : nullptr)
+			{
+				Table->Insert(UserInput, PersonaId, Plan);
+			}
+			ULLMAgentComponent* AgentComponent = Agent.Get();
+			if (AgentComponent && Settings->bEnableLongTermMemory && Settings->bRememberPlayerRequests)
+			{
+				AgentComponent->Remember(FString::Printf(TEXT("The player asked: %s"), *UserInput));
+			}
+		}
+
+		RecordExchange(Plan);
+
+		// Report the first step; further steps are queued on the agent
+		UE_LOG(LogTemp, Log, TEXT("[LLMGenerateActionAsync] Successfully generated and processed action (%d steps)"), Plan.Steps.Num());
+		OnCompleted.Broadcast(true, Plan.Steps[0].Action, TEXT(""));
 	}
 	else
 	{
@@ -102,3 +549,60 @@ void ULLMGenerateActionAsync::InternalJsonCallback(bool bSuccess, const FString&
 		OnCompleted.Broadcast(false, FLLMAction(), ErrorMessage);
 	}
 }
+
+bool ULLMGenerateActionAsync::RetryTruncated(const FString& JsonResponse)
+{
+	// Only when every candidate was cut off; the ranker can still use a complete one
+	FGeminiResponseUsage Usage;
+	if (!UGeminiHTTPManager::TryExtractUsage(JsonResponse, Usage) || Usage.TruncatedCandidates < Usage.CandidateCount)
+	{
+		return false;
+	}
+
+	const int32 WiderCap = FMath::Min(OutputCap * 2, FGeminiGenerateContentConfig().MaxOutputTokens);
+	const bool bRetry = !bTruncationRetried && WiderCap > OutputCap;
+	if (ULLMOutputBudget* Budget = ULLMOutputBudget::Get(WorldContextObject))
+	{
+		Budget->NotifyTruncated(bRetry);
+	}
+	if (!bRetry)
+	{
+		return false;
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("[LLMGenerateActionAsync] Answer truncated at %d output tokens, retrying with %d"), OutputCap, WiderCap);
+	bTruncationRetried = true;
+	OutputCap = WiderCap;
+	SendToLLM();
+	return true;
+}
+
+void ULLMGenerateActionAsync::RecordExchange(const FLLMPlan& Plan)
+{
+	ULLMAgentComponent* AgentComponent = Agent.Get();
+	if (bIsReplan || !AgentComponent || !GetDefault<ULLMSettings>()->bEnableConversationHistory)
+	{
+		return;
+	}
+
+	FLLMConversationHistory& Conversation = AgentComponent->GetConversation();
+	Conversation.AddExchange(UserInput, Plan.RawJson.IsEmpty() ? FLLMConversationHistory::DescribePlan(Plan) : Plan.RawJson);
+	if (Conversation.NeedsSummary())
+	{
+		if (ULLMConversationSummarizer* Summarizer = ULLMConversationSummarizer::Get(WorldContextObject))
+		{
+			Summarizer->Request(AgentComponent, APIData);
+		}
+	}
+}
+
+void ULLMGenerateActionAsync::OnMemoriesRetrieved(const TArray<FString>& InMemories)
+{
+	if (HandleCancelled())
+	{
+		return;
+	}
+
+	Memories = InMemories;
+	SendToLLM();
+}
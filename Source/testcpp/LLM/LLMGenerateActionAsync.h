@@ -5,10 +5,12 @@
 #include "Kismet/BlueprintAsyncActionBase.h"
 #include "HTTP/GeminiHTTPManager.h"
 #include "LLM/LLMActionTypes.h"
+#include "LLM/LLMMoveValidator.h"
 #include "LLMGenerateActionAsync.generated.h"
 
 class UAPIData;
 class UBlackboardComponent;
+class ULLMAgentComponent;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FLLMActionEvent, bool, bSuccess, const FLLMAction&, Action, const FString&, ErrorMessage);
 
@@ -42,6 +44,27 @@ public:
 
 	virtual void Activate() override;
 
+	/** Mark this request as an agent's re-plan (ULLMAgentComponent::RequestReplan); call before Activate */
+	void MarkAsReplan() { bIsReplan = true; }
+
+	/** Stop the request: a response still to come is ignored and nothing reaches the blackboard */
+	void Cancel() { bCancelled = true; }
+
+	/**
+	 * Request config used for action generation: action system prompt, JSON output and
+	 * the response schema constrained to the world's current vocabulary
+	 * @param AgentComponent - Agent whose prompt template and persona are used; null uses the default template
+	 */
+	static FGeminiGenerateContentConfig MakeActionConfig(UObject* WorldContextObject, float Temperature, const ULLMAgentComponent* AgentComponent = nullptr);
+
+	/**
+	 * Whether a request for this blackboard would go out as the bare MakeActionConfig prompt:
+	 * no persona or template, conversation, memories or surroundings. Only such requests can
+	 * reuse a type-ahead speculation, so drafts for any other request are not speculated on.
+	 * @param Blackboard - Blackboard the request will be made for; null if not known
+	 */
+	static bool SendsPlainPrompt(UObject* WorldContextObject, UBlackboardComponent* Blackboard);
+
 public:
 	// Called when action generation completes (success or failure)
 	UPROPERTY(BlueprintAssignable)
@@ -60,6 +83,71 @@ private:
 	FString UserInput;
 	float Temperature;
 
+	// Set by the agent that issued this request as a re-plan; such prompts skip the local paths and the decision log
+	bool bIsReplan = false;
+
+	// Superseded (e.g. a re-plan overtaken by a new player command); responses are dropped
+	bool bCancelled = false;
+
+	// Broadcast the cancellation once a callback arrives for a cancelled request; true if it was cancelled
+	bool HandleCancelled();
+
+	// Resolve the input with ULLMLocalCommandMatcher; true if it was handled (OnCompleted broadcast)
+	bool TryLocalCommand();
+
+	// Persona scope for the response table and the semantic cache (from the agent)
+	FName PersonaId;
+
+	// Agent the blackboard belongs to; holds the conversation history
+	TWeakObjectPtr<ULLMAgentComponent> Agent;
+
+	// Add this input and its answer to the agent's conversation (not for re-plans)
+	void RecordExchange(const FLLMPlan& Plan);
+
+	// Long-term memories relevant to the input; fetched once before the first LLM request
+	TArray<FString> Memories;
+	bool bMemoriesRetrieved = false;
+
+	void OnMemoriesRetrieved(const TArray<FString>& InMemories);
+
+	// Answer from ULLMResponseTable; true if it was handled (OnCompleted broadcast)
+	bool TryResponseTable();
+
+	// Answer from ULLMSemanticCache; true if it was handled (OnCompleted broadcast)
+	bool TryCachedPlan();
+
+	// ULLMIntentClassifier result; falls through to the LLM when not served
+	void OnClassified(bool bServed, const FLLMAction& Action);
+
+	void SendToLLM();
+
+	// Intent the classifier predicted without serving it; picks the output cap distribution
+	FGameplayTag ExpectedIntent;
+
+	// MaxOutputTokens of the request in flight, and whether a truncated answer was already retried
+	int32 OutputCap = 0;
+	bool bTruncationRetried = false;
+
+	// Ask again with a doubled output cap; false when the answer was not truncated or cannot be widened
+	bool RetryTruncated(const FString& JsonResponse);
+
+	// Check the plan's MoveTo targets against the navmesh first; true if a check is in flight
+	bool ValidateMoves(const FLLMPlan& Plan, const FString& JsonResponse);
+	void OnMovesValidated(const TArray<FLLMMoveCheck>& Checks);
+
+	// Write a parsed (and validated) plan to the blackboard, feed the caches and broadcast
+	void CompleteResponse(FLLMPlan& Plan, const FString& JsonResponse);
+
+	// Plan waiting for ULLMMoveValidator, its response body and the steps that were checked
+	UPROPERTY()
+	FLLMPlan PendingPlan;
+	FString PendingResponse;
+	TArray<int32> CheckedSteps;
+
+	// Why the previous answer was rejected, sent with the one cheap re-ask an unreachable move gets
+	FString RejectionFeedback;
+	bool bMoveRetried = false;
+
 	UFUNCTION()
 	void InternalJsonCallback(bool bSuccess, const FString& JsonResponse);
 };
@@ -0,0 +1,197 @@
+// On-device intent classifier that answers routine requests without the LLM
+#include "LLM/LLMIntentClassifier.h"
+#include "LLM/LLMIntentModel.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMActionParser.h"
+#include "LLM/LLMLocalCommandMatcher.h"
+#include "LLM/LLMSettings.h"
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Paths.h"
+
+namespace LLMIntentClassifierPrivate
+{
+	// Speak is only served when the line to say is quoted; free-form requests go to the LLM
+	static bool ExtractQuotedText(const FString& Input, FString& OutText)
+	{
+		int32 Open = INDEX_NONE;
+		int32 Close = INDEX_NONE;
+		if (!Input.FindChar(TEXT('"'), Open) || !Input.FindLastChar(TEXT('"'), Close) || Close <= Open + 1)
+		{
+			return false;
+		}
+		OutText = Input.Mid(Open + 1, Close - Open - 1).TrimStartAndEnd();
+		return !OutText.IsEmpty();
+	}
+
+	static void LogStats()
+	{
+		const ULLMIntentClassifier* Classifier = ULLMIntentClassifier::Get();
+		if (!Classifier)
+		{
+			return;
+		}
+
+		const FLLMIntentClassifierStats Stats = Classifier->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMIntentClassifier] %d predictions: %d served, %d low confidence, %d slot misses | %.3f ms average inference"),
+			Stats.Predictions, Stats.Served, Stats.LowConfidence, Stats.SlotMisses,
+			Stats.Predictions > 0 ? Stats.InferenceSeconds * 1000.0 / Stats.Predictions : 0.0);
+	}
+
+	static FAutoConsoleCommand LogStatsCommand(
+		TEXT("LLM.ClassifierStats"),
+		TEXT("Log how many requests the on-device intent classifier served"),
+		FConsoleCommandDelegate::CreateStatic(&LogStats));
+}
+
+ULLMIntentClassifier* ULLMIntentClassifier::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<ULLMIntentClassifier>() : nullptr;
+}
+
+void ULLMIntentClassifier::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ReloadModel();
+}
+
+bool ULLMIntentClassifier::ReloadModel()
+{
+	const FString& RelativePath = GetDefault<ULLMSettings>()->IntentModelPath;
+	Model.Reset();
+	if (RelativePath.IsEmpty())
+	{
+		return false;
+	}
+
+	const FString Path = FPaths::Combine(FPaths::ProjectContentDir(), RelativePath);
+	TSharedPtr<FLLMIntentModel, ESPMode::ThreadSafe> Loaded = MakeShared<FLLMIntentModel, ESPMode::ThreadSafe>();
+	if (!Loaded->LoadFromFile(Path))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMIntentClassifier] No intent model at %s, classifier disabled"), *Path);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMIntentClassifier] Loaded %d intents, %d buckets from %s"),
+		Loaded->GetNumLabels(), Loaded->GetNumBuckets(), *Path);
+	Model = Loaded;
+	return true;
+}
+
+void ULLMIntentClassifier::ClassifyAsync(const FString& Input, UObject* WorldContext, FOnLLMClassified OnComplete)
+{
+	if (!Model.IsValid())
+	{
+		OnComplete.ExecuteIfBound(false, FLLMAction());
+		return;
+	}
+
+	TWeakObjectPtr<ULLMIntentClassifier> WeakThis(this);
+	TWeakObjectPtr<UObject> WeakContext(WorldContext);
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [WeakThis, WeakContext, LocalModel = Model, Input, OnComplete]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		float Confidence = 0.0f;
+		const int32 Label = LocalModel->Predict(Input, Confidence);
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, WeakContext, LocalModel, Input, OnComplete, Label, Confidence, Seconds]()
+		{
+			ULLMIntentClassifier* This = WeakThis.Get();
+			if (!This)
+			{
+				OnComplete.ExecuteIfBound(false, FLLMAction());
+				return;
+			}
+
+			++This->Stats.Predictions;
+			This->Stats.InferenceSeconds += Seconds;
+
+			FLLMAction Action;
+			bool bServed = false;
+			if (Label == INDEX_NONE || Confidence < GetDefault<ULLMSettings>()->ClassifierMinConfidence)
+			{
+				++This->Stats.LowConfidence;
+			}
+			else if (!This->BuildAction(Input, LocalModel->GetLabel(Label), Confidence, WeakContext.Get(), Action))
+			{
+				++This->Stats.SlotMisses;
+			}
+			else
+			{
+				++This->Stats.Served;
+				bServed = true;
+			}
+
+			// Deferred: still tell the caller what was predicted (the tag is invalid without a label)
+			if (!bServed)
+			{
+				Action = FLLMAction();
+				if (Label != INDEX_NONE)
+				{
+					Action.IntentTag = FGameplayTag::RequestGameplayTag(FName(*LocalModel->GetLabel(Label)), false);
+					Action.Confidence = Confidence;
+				}
+			}
+
+			UE_LOG(LogTemp, Verbose, TEXT("[LLMIntentClassifier] '%s' -> %s (%.2f, %.3f ms) %s"), *Input,
+				Label == INDEX_NONE ? TEXT("none") : *LocalModel->GetLabel(Label), Confidence, Seconds * 1000.0,
+				bServed ? TEXT("served") : TEXT("deferred"));
+			OnComplete.ExecuteIfBound(bServed, Action);
+		});
+	});
+}
+
+bool ULLMIntentClassifier::BuildAction(const FString& Input, const FString& Label, float Confidence, UObject* WorldContext, FLLMAction& OutAction) const
+{
+	const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+	const FGameplayTag Tag = FGameplayTag::RequestGameplayTag(FName(*Label), false);
+	const ULLMIntentDefinition* Definition = Registry && Tag.IsValid() ? Registry->FindByTag(Tag) : nullptr;
+	if (!Definition)
+	{
+		return false;
+	}
+
+	OutAction = FLLMAction();
+	OutAction.Intent = Definition->BuiltInIntent;
+	OutAction.IntentTag = Definition->IntentTag;
+	OutAction.Confidence = Confidence;
+
+	// Slots come from names that exist in the world, never from the model
+	ULLMLocalCommandMatcher* Matcher = ULLMLocalCommandMatcher::Get(WorldContext);
+	switch (Definition->BuiltInIntent)
+	{
+	case ELLMIntent::MoveTo:
+		OutAction.Location.bUseCoordinates = false;
+		if (!Matcher || !Matcher->FindName(ELLMVocabularyCategory::NavPoint, Input, OutAction.Location.NavPointName))
+		{
+			return false;
+		}
+		break;
+	case ELLMIntent::Interact:
+		if (!Matcher || !Matcher->FindName(ELLMVocabularyCategory::TargetType, Input, OutAction.Target.Type))
+		{
+			return false;
+		}
+		break;
+	case ELLMIntent::PlayMontage:
+		if (!Matcher || !Matcher->FindName(ELLMVocabularyCategory::Montage, Input, OutAction.Montage.Name))
+		{
+			return false;
+		}
+		break;
+	case ELLMIntent::Speak:
+		if (!LLMIntentClassifierPrivate::ExtractQuotedText(Input, OutAction.Speak))
+		{
+			return false;
+		}
+		break;
+	default:
+		break;
+	}
+
+	FString ErrorMessage;
+	return ULLMActionParser::ValidateAction(OutAction, ErrorMessage);
+}
@@ -0,0 +1,89 @@
+// On-device intent classifier that answers routine requests without the LLM
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMIntentClassifier.generated.h"
+
+class FLLMIntentModel;
+
+/**
+ * Counters for the classifier fast path
+ */
+USTRUCT(BlueprintType)
+struct FLLMIntentClassifierStats
+{
+	GENERATED_BODY()
+
+	// Inputs classified
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Classifier")
+	int32 Predictions = 0;
+
+	// Inputs answered locally (LLM calls avoided)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Classifier")
+	int32 Served = 0;
+
+	// Deferred to the LLM: confidence below ClassifierMinConfidence
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Classifier")
+	int32 LowConfidence = 0;
+
+	// Deferred to the LLM: intent was confident but its slot could not be filled or validated
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Classifier")
+	int32 SlotMisses = 0;
+
+	// Total inference time on the worker, in seconds
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Classifier")
+	double InferenceSeconds = 0.0;
+};
+
+DECLARE_DELEGATE_TwoParams(FOnLLMClassified, bool /*bServed*/, const FLLMAction& /*Action*/);
+
+/**
+ * Serves requests from a linear model trained offline on logged (input, validated action)
+ * pairs (see ULLMDecisionLog and the LLMTrainIntentModel commandlet). Inference runs on a
+ * worker thread; slots are filled on the game thread from the world vocabulary. Only
+ * predictions whose calibrated confidence clears ULLMSettings::ClassifierMinConfidence and
+ * whose action validates are served; everything else is deferred to the LLM.
+ */
+UCLASS()
+class TESTCPP_API ULLMIntentClassifier : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMIntentClassifier* Get();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	/** (Re)load the model file from ULLMSettings::IntentModelPath */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Classifier")
+	bool ReloadModel();
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Classifier")
+	bool HasModel() const { return Model.IsValid(); }
+
+	/**
+	 * Classify on a worker thread and complete on the game thread
+	 * @param Input - Raw player text
+	 * @param WorldContext - World whose vocabulary fills the slots
+	 * @param OnComplete - bServed is false when the request should go to the LLM; Action then only
+	 *                     carries the predicted intent and its confidence
+	 */
+	void ClassifyAsync(const FString& Input, UObject* WorldContext, FOnLLMClassified OnComplete);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Classifier")
+	FLLMIntentClassifierStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|Classifier")
+	void ResetStats() { Stats = FLLMIntentClassifierStats(); }
+
+private:
+	// Turn a prediction into an action; false if the slot cannot be filled or the action is invalid
+	bool BuildAction(const FString& Input, const FString& Label, float Confidence, UObject* WorldContext, FLLMAction& OutAction) const;
+
+	// Shared with in-flight worker tasks; replaced, never mutated
+	TSharedPtr<const FLLMIntentModel, ESPMode::ThreadSafe> Model;
+
+	FLLMIntentClassifierStats Stats;
+};
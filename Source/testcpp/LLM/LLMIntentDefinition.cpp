@@ -0,0 +1,18 @@
+// Data asset describing one LLM intent: tag, wire name, rules and blackboard fields
+#include "LLM/LLMIntentDefinition.h"
+
+FString ULLMIntentDefinition::GetWireName() const
+{
+	if (!WireName.IsEmpty())
+	{
+		return WireName;
+	}
+
+	FString TagString = IntentTag.GetTagName().ToString();
+	int32 LastDot = INDEX_NONE;
+	if (TagString.FindLastChar(TEXT('.'), LastDot))
+	{
+		TagString.RightChopInline(LastDot + 1);
+	}
+	return TagString;
+}
@@ -0,0 +1,48 @@
+// Data asset describing one LLM intent: tag, wire name, rules and blackboard fields
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GameplayTagContainer.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLMIntentDefinition.generated.h"
+
+/**
+ * Defines an intent the LLM may emit
+ * Designers add intents by creating one of these and listing it in Project Settings -> LLM Actions
+ */
+UCLASS(BlueprintType)
+class TESTCPP_API ULLMIntentDefinition : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Tag identifying the intent on the blackboard and in decorators
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Intent", meta = (Categories = "LLM.Intent"))
+	FGameplayTag IntentTag;
+
+	// Value the model emits in the "intent" field (matched case-insensitively); defaults to the tag's last segment
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Intent")
+	FString WireName;
+
+	// One-line description listed for the model in the system prompt
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Intent")
+	FString Description;
+
+	// Native enum value for built-in intents; Custom for intents that exist only as data
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Intent")
+	ELLMIntent BuiltInIntent = ELLMIntent::Custom;
+
+	// Schema fragment and validator: Required/Range/MaxLength rules for this intent
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Schema")
+	TArray<FLLMFieldRule> Rules;
+
+	// Blackboard writer: action fields written to the blackboard for this intent
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Blackboard")
+	TArray<ELLMActionField> BlackboardFields;
+
+	/** WireName if set, otherwise the last segment of IntentTag */
+	UFUNCTION(BlueprintPure, Category = "LLM|Intent")
+	FString GetWireName() const;
+};
@@ -0,0 +1,153 @@
+// Hashed n-gram linear intent classifier distilled from logged LLM decisions
+#include "LLM/LLMIntentModel.h"
+#include "LLM/LLMTextNormalization.h"
+#include "Math/VectorRegister.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace LLMIntentModelPrivate
+{
+	static constexpr uint32 FileMagic = 0x494D4C4C; // "LLMI"
+	static constexpr uint32 FileVersion = 1;
+	static constexpr uint32 BigramSeed = 0x9E3779B9u;
+}
+
+FLLMIntentModel::FLLMIntentModel(int32 InNumBuckets, const TArray<FString>& InLabels)
+	: NumBuckets(InNumBuckets)
+	, Stride(Align(FMath::Min(InLabels.Num(), MaxLabels), 4))
+	, Labels(InLabels)
+{
+	Labels.SetNum(FMath::Min(Labels.Num(), MaxLabels));
+	Weights.SetNumZeroed(NumBuckets * Stride);
+	Biases.SetNumZeroed(Stride);
+}
+
+bool FLLMIntentModel::LoadFromFile(const FString& Path)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Bytes);
+	Serialize(Reader);
+	if (Reader.IsError() || !IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMIntentModel] %s is not a valid intent model"), *Path);
+		*this = FLLMIntentModel();
+		return false;
+	}
+	return true;
+}
+
+bool FLLMIntentModel::SaveToFile(const FString& Path) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+	const_cast<FLLMIntentModel*>(this)->Serialize(Writer);
+	return FFileHelper::SaveArrayToFile(Bytes, *Path);
+}
+
+void FLLMIntentModel::Serialize(FArchive& Ar)
+{
+	using namespace LLMIntentModelPrivate;
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	Ar << Magic << Version;
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		Ar.SetError();
+		return;
+	}
+
+	Ar << NumBuckets << Stride << Temperature << Labels << Weights << Biases;
+
+	// Reject anything the inner loops could overrun
+	if (Ar.IsLoading() && (Labels.Num() > MaxLabels || Stride != Align(Labels.Num(), 4) || NumBuckets <= 0
+		|| Weights.Num() != NumBuckets * Stride || Biases.Num() != Stride || Temperature <= 0.0f))
+	{
+		Ar.SetError();
+	}
+}
+
+int32 FLLMIntentModel::ExtractFeatures(const FString& Text, int32* OutBuckets) const
+{
+	using namespace LLMIntentModelPrivate;
+
+	uint32 Tokens[MaxTokens];
+	const int32 NumTokens = LLMTextNormalization::HashTokens(Text, Tokens, MaxTokens);
+
+	int32 NumFeatures = 0;
+	for (int32 Index = 0; Index < NumTokens; ++Index)
+	{
+		OutBuckets[NumFeatures++] = Tokens[Index] % NumBuckets;
+		if (Index > 0)
+		{
+			OutBuckets[NumFeatures++] = HashCombine(Tokens[Index - 1] ^ BigramSeed, Tokens[Index]) % NumBuckets;
+		}
+	}
+	return NumFeatures;
+}
+
+void FLLMIntentModel::ComputeProbabilities(const int32* Buckets, int32 NumFeatures, float InTemperature, float* OutProbabilities) const
+{
+	alignas(16) float Scores[MaxLabels];
+	FMemory::Memcpy(Scores, Biases.GetData(), Stride * sizeof(float));
+
+	// Stride is a multiple of 4: one vector add per 4 labels per feature
+	for (int32 Feature = 0; Feature < NumFeatures; ++Feature)
+	{
+		const float* Row = Weights.GetData() + Buckets[Feature] * Stride;
+		for (int32 Label = 0; Label < Stride; Label += 4)
+		{
+			VectorStoreAligned(VectorAdd(VectorLoadAligned(Scores + Label), VectorLoad(Row + Label)), Scores + Label);
+		}
+	}
+
+	const int32 NumLabels = Labels.Num();
+	float MaxScore = Scores[0];
+	for (int32 Label = 1; Label < NumLabels; ++Label)
+	{
+		MaxScore = FMath::Max(MaxScore, Scores[Label]);
+	}
+
+	float Sum = 0.0f;
+	for (int32 Label = 0; Label < NumLabels; ++Label)
+	{
+		OutProbabilities[Label] = FMath::Exp((Scores[Label] - MaxScore) / InTemperature);
+		Sum += OutProbabilities[Label];
+	}
+	for (int32 Label = 0; Label < NumLabels; ++Label)
+	{
+		OutProbabilities[Label] /= Sum;
+	}
+}
+
+int32 FLLMIntentModel::Predict(const FString& Text, float& OutConfidence) const
+{
+	OutConfidence = 0.0f;
+	if (!IsValid())
+	{
+		return INDEX_NONE;
+	}
+
+	int32 Buckets[MaxFeatures];
+	const int32 NumFeatures = ExtractFeatures(Text, Buckets);
+
+	float Probabilities[MaxLabels];
+	ComputeProbabilities(Buckets, NumFeatures, Temperature, Probabilities);
+
+	int32 Best = 0;
+	for (int32 Label = 1; Label < Labels.Num(); ++Label)
+	{
+		if (Probabilities[Label] > Probabilities[Best])
+		{
+			Best = Label;
+		}
+	}
+	OutConfidence = Probabilities[Best];
+	return Best;
+}
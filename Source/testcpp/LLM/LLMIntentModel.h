@@ -0,0 +1,72 @@
+// Hashed n-gram linear intent classifier distilled from logged LLM decisions
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Multinomial logistic regression over hashed word unigrams and bigrams
+ * Weights are stored bucket-major with the label dimension padded to a multiple of 4,
+ * so scoring adds one contiguous SIMD row per feature. Probabilities are calibrated
+ * with a softmax temperature fitted on held-out samples at training time.
+ * Immutable once loaded; Predict may run on any thread.
+ */
+class TESTCPP_API FLLMIntentModel
+{
+public:
+	static constexpr int32 MaxLabels = 32;
+	static constexpr int32 MaxTokens = 64;
+	// Unigrams plus bigrams
+	static constexpr int32 MaxFeatures = MaxTokens * 2;
+
+	FLLMIntentModel() = default;
+	FLLMIntentModel(int32 InNumBuckets, const TArray<FString>& InLabels);
+
+	/** Load from the binary file written by Save; false if missing or not a model file */
+	bool LoadFromFile(const FString& Path);
+	bool SaveToFile(const FString& Path) const;
+
+	/**
+	 * Bucket indices for the text's features; allocation-free
+	 * @param OutBuckets - At least MaxFeatures entries
+	 * @return Number of features
+	 */
+	int32 ExtractFeatures(const FString& Text, int32* OutBuckets) const;
+
+	/**
+	 * Most likely label; allocation-free
+	 * @param OutConfidence - Calibrated probability of the returned label
+	 * @return Label index, or INDEX_NONE if the model is empty
+	 */
+	int32 Predict(const FString& Text, float& OutConfidence) const;
+
+	/**
+	 * Class probabilities for pre-extracted features at a given softmax temperature (used by training)
+	 * Temperature 1 gives the raw probabilities; Predict uses the fitted temperature
+	 * @param OutProbabilities - At least GetNumLabels entries
+	 */
+	void ComputeProbabilities(const int32* Buckets, int32 NumFeatures, float InTemperature, float* OutProbabilities) const;
+
+	/** Training access: the weight row of a bucket and the bias row (GetStride floats each) */
+	float* GetRow(int32 Bucket) { return Weights.GetData() + Bucket * Stride; }
+	float* GetBiases() { return Biases.GetData(); }
+
+	bool IsValid() const { return Labels.Num() > 0 && NumBuckets > 0; }
+	int32 GetNumLabels() const { return Labels.Num(); }
+	int32 GetNumBuckets() const { return NumBuckets; }
+	const FString& GetLabel(int32 Index) const { return Labels[Index]; }
+
+	float GetTemperature() const { return Temperature; }
+	void SetTemperature(float InTemperature) { Temperature = InTemperature; }
+
+private:
+	void Serialize(FArchive& Ar);
+
+	int32 NumBuckets = 0;
+	int32 Stride = 0;
+	float Temperature = 1.0f;
+
+	// Intent tag names
+	TArray<FString> Labels;
+	TArray<float> Weights;
+	TArray<float> Biases;
+};
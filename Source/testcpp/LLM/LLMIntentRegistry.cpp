@@ -0,0 +1,222 @@
+// Registry of LLM intents keyed by GameplayTag and wire name
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/Engine.h"
+#include "Misc/CoreDelegates.h"
+
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_LLM_Intent_Idle, "LLM.Intent.Idle", "LLM intent: do nothing");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_LLM_Intent_MoveTo, "LLM.Intent.MoveTo", "LLM intent: move to a location");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_LLM_Intent_Interact, "LLM.Intent.Interact", "LLM intent: interact with a target");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_LLM_Intent_Speak, "LLM.Intent.Speak", "LLM intent: say a line");
+UE_DEFINE_GAMEPLAY_TAG_COMMENT(TAG_LLM_Intent_PlayMontage, "LLM.Intent.PlayMontage", "LLM intent: play a named montage");
+
+ULLMIntentRegistry* ULLMIntentRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<ULLMIntentRegistry>() : nullptr;
+}
+
+void ULLMIntentRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	AddBuiltInDefinitions();
+
+	// Data assets cannot be loaded while engine subsystems initialize; load them right after (commandlets included)
+	if (GEngine && GEngine->IsInitialized())
+	{
+		LoadProjectDefinitions();
+	}
+	else
+	{
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddUObject(this, &ULLMIntentRegistry::LoadProjectDefinitions);
+	}
+}
+
+void ULLMIntentRegistry::Deinitialize()
+{
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	Super::Deinitialize();
+}
+
+void ULLMIntentRegistry::RegisterDefinition(ULLMIntentDefinition* Definition)
+{
+	if (!Definition || !Definition->IntentTag.IsValid())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMIntentRegistry] Ignoring definition without an intent tag"));
+		return;
+	}
+
+	AddOrReplace(Definition);
+	RebuildLookups();
+}
+
+TArray<ULLMIntentDefinition*> ULLMIntentRegistry::GetDefinitions() const
+{
+	TArray<ULLMIntentDefinition*> Result;
+	Result.Reserve(Definitions.Num());
+	for (ULLMIntentDefinition* Definition : Definitions)
+	{
+		Result.Add(Definition);
+	}
+	return Result;
+}
+
+const ULLMIntentDefinition* ULLMIntentRegistry::FindByWireName(const FString& WireName) const
+{
+	const int32* Index = WireNameToIndex.Find(WireName);
+	return Index ? Definitions[*Index].Get() : nullptr;
+}
+
+const ULLMIntentDefinition* ULLMIntentRegistry::FindByTag(const FGameplayTag& Tag) const
+{
+	const int32* Index = TagToIndex.Find(Tag);
+	return Index ? Definitions[*Index].Get() : nullptr;
+}
+
+const ULLMIntentDefinition* ULLMIntentRegistry::FindByIntent(ELLMIntent Intent) const
+{
+	const int32* Index = IntentToIndex.Find(Intent);
+	return Index ? Definitions[*Index].Get() : nullptr;
+}
+
+const ULLMIntentDefinition* ULLMIntentRegistry::Resolve(const FLLMAction& Action) const
+{
+	return Action.IntentTag.IsValid() ? FindByTag(Action.IntentTag) : FindByIntent(Action.Intent);
+}
+
+FGameplayTag ULLMIntentRegistry::GetBuiltInTag(ELLMIntent Intent)
+{
+	switch (Intent)
+	{
+	case ELLMIntent::Idle: return TAG_LLM_Intent_Idle;
+	case ELLMIntent::MoveTo: return TAG_LLM_Intent_MoveTo;
+	case ELLMIntent::Interact: return TAG_LLM_Intent_Interact;
+	case ELLMIntent::Speak: return TAG_LLM_Intent_Speak;
+	case ELLMIntent::PlayMontage: return TAG_LLM_Intent_PlayMontage;
+	default: return FGameplayTag();
+	}
+}
+
+FString ULLMIntentRegistry::GetWireName(const FLLMAction& Action)
+{
+	if (const ULLMIntentRegistry* Registry = Get())
+	{
+		if (const ULLMIntentDefinition* Definition = Registry->Resolve(Action))
+		{
+			return Definition->GetWireName();
+		}
+	}
+	else if (Action.Intent != ELLMIntent::Custom)
+	{
+		return StaticEnum<ELLMIntent>()->GetNameStringByValue(static_cast<int64>(Action.Intent));
+	}
+	return TEXT("Unknown");
+}
+
+void ULLMIntentRegistry::AddBuiltInDefinitions()
+{
+	struct FBuiltIn
+	{
+		ELLMIntent Intent;
+		const TCHAR* Description;
+		TArray<ELLMActionField> BlackboardFields;
+	};
+
+	const FBuiltIn BuiltIns[] = {
+		{ ELLMIntent::Idle, TEXT("Do nothing"), {} },
+		{ ELLMIntent::MoveTo, TEXT("Move character to a location"), { ELLMActionField::Location } },
+		{ ELLMIntent::Interact, TEXT("Interact with an object"), { ELLMActionField::TargetId, ELLMActionField::TargetType } },
+		{ ELLMIntent::Speak, TEXT("Make character speak"), { ELLMActionField::Speak } },
+		{ ELLMIntent::PlayMontage, TEXT("Play an animation montage by name"),
+			{ ELLMActionField::MontageName, ELLMActionField::MontageSection, ELLMActionField::MontagePlayRate, ELLMActionField::MontageLoop } }
+	};
+
+	for (const FBuiltIn& BuiltIn : BuiltIns)
+	{
+		ULLMIntentDefinition* Definition = NewObject<ULLMIntentDefinition>(this);
+		Definition->IntentTag = GetBuiltInTag(BuiltIn.Intent);
+		Definition->WireName = StaticEnum<ELLMIntent>()->GetNameStringByValue(static_cast<int64>(BuiltIn.Intent));
+		Definition->Description = BuiltIn.Description;
+		Definition->BuiltInIntent = BuiltIn.Intent;
+		Definition->Rules = TArray<FLLMFieldRule>(ULLMActionSchema::GetBuiltInRules(BuiltIn.Intent));
+		Definition->BlackboardFields = BuiltIn.BlackboardFields;
+		AddOrReplace(Definition);
+	}
+
+	RebuildLookups();
+}
+
+void ULLMIntentRegistry::LoadProjectDefinitions()
+{
+	check(IsInGameThread());
+	if (bProjectDefinitionsLoaded)
+	{
+		return;
+	}
+	bProjectDefinitionsLoaded = true;
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	bool bAnyAdded = false;
+	for (const TSoftObjectPtr<ULLMIntentDefinition>& SoftDefinition : Settings->IntentDefinitions)
+	{
+		ULLMIntentDefinition* Definition = SoftDefinition.LoadSynchronous();
+		if (!Definition || !Definition->IntentTag.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMIntentRegistry] Skipping invalid intent definition '%s'"), *SoftDefinition.ToString());
+			continue;
+		}
+		AddOrReplace(Definition);
+		bAnyAdded = true;
+	}
+
+	if (bAnyAdded)
+	{
+		RebuildLookups();
+	}
+}
+
+void ULLMIntentRegistry::AddOrReplace(ULLMIntentDefinition* Definition)
+{
+	for (TObjectPtr<ULLMIntentDefinition>& Existing : Definitions)
+	{
+		if (Existing->IntentTag == Definition->IntentTag)
+		{
+			UE_LOG(LogTemp, Log, TEXT("[LLMIntentRegistry] Overriding intent %s with %s"),
+				*Definition->IntentTag.ToString(), *Definition->GetName());
+			Existing = Definition;
+			return;
+		}
+	}
+	Definitions.Add(Definition);
+}
+
+void ULLMIntentRegistry::RebuildLookups()
+{
+	WireNameToIndex.Reset();
+	TagToIndex.Reset();
+	IntentToIndex.Reset();
+
+	for (int32 Index = 0; Index < Definitions.Num(); ++Index)
+	{
+		const ULLMIntentDefinition* Definition = Definitions[Index];
+		const FString WireName = Definition->GetWireName();
+		if (WireNameToIndex.Contains(WireName))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMIntentRegistry] Duplicate wire name '%s' (%s), keeping first"),
+				*WireName, *Definition->IntentTag.ToString());
+		}
+		else
+		{
+			WireNameToIndex.Add(WireName, Index);
+		}
+		TagToIndex.Add(Definition->IntentTag, Index);
+		if (Definition->BuiltInIntent != ELLMIntent::Custom)
+		{
+			IntentToIndex.Add(Definition->BuiltInIntent, Index);
+		}
+	}
+
+	++Revision;
+	UE_LOG(LogTemp, Log, TEXT("[LLMIntentRegistry] %d intents registered (rev %d)"), Definitions.Num(), Revision);
+}
@@ -0,0 +1,89 @@
+// Registry of LLM intents keyed by GameplayTag and wire name
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "NativeGameplayTags.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMIntentRegistry.generated.h"
+
+class ULLMIntentDefinition;
+
+// Tags for the built-in intents
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LLM_Intent_Idle);
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LLM_Intent_MoveTo);
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LLM_Intent_Interact);
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LLM_Intent_Speak);
+UE_DECLARE_GAMEPLAY_TAG_EXTERN(TAG_LLM_Intent_PlayMontage);
+
+/**
+ * Holds every intent the pipeline understands: the built-in ones created in code plus
+ * data assets listed in ULLMSettings. Lookups by wire name and by tag are hashed.
+ * Revision changes whenever the set of definitions changes so dependent caches
+ * (response schema, validator table, system prompt) can rebuild.
+ */
+UCLASS()
+class TESTCPP_API ULLMIntentRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * The registry, or null before the engine is up
+	 * Never loads anything, so it is safe off the game thread; project definitions are loaded
+	 * on the game thread once the engine has initialized
+	 */
+	static ULLMIntentRegistry* Get();
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Add or replace (by tag) an intent definition at runtime
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Intent")
+	void RegisterDefinition(ULLMIntentDefinition* Definition);
+
+	/** All registered definitions in registration order */
+	UFUNCTION(BlueprintPure, Category = "LLM|Intent")
+	TArray<ULLMIntentDefinition*> GetDefinitions() const;
+
+	/** Case-insensitive hashed lookup of the "intent" string emitted by the model */
+	const ULLMIntentDefinition* FindByWireName(const FString& WireName) const;
+
+	/** Hashed lookup by intent tag */
+	const ULLMIntentDefinition* FindByTag(const FGameplayTag& Tag) const;
+
+	/** Definition backing a built-in enum value */
+	const ULLMIntentDefinition* FindByIntent(ELLMIntent Intent) const;
+
+	/** Definition for an action: its IntentTag when set, otherwise its built-in enum value */
+	const ULLMIntentDefinition* Resolve(const FLLMAction& Action) const;
+
+	int32 GetRevision() const { return Revision; }
+
+	/** Tag for a built-in enum value (available without the registry) */
+	static FGameplayTag GetBuiltInTag(ELLMIntent Intent);
+
+	/** Wire name for an action ("MoveTo", ...), or "Unknown" */
+	static FString GetWireName(const FLLMAction& Action);
+
+private:
+	void AddBuiltInDefinitions();
+	void LoadProjectDefinitions();
+	void AddOrReplace(ULLMIntentDefinition* Definition);
+	void RebuildLookups();
+
+	UPROPERTY()
+	TArray<TObjectPtr<ULLMIntentDefinition>> Definitions;
+
+	// FString keys hash and compare case-insensitively
+	TMap<FString, int32> WireNameToIndex;
+	TMap<FGameplayTag, int32> TagToIndex;
+	TMap<ELLMIntent, int32> IntentToIndex;
+
+	int32 Revision = 0;
+	bool bProjectDefinitionsLoaded = false;
+	FDelegateHandle PostEngineInitHandle;
+};
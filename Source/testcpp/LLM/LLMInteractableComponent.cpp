@@ -0,0 +1,66 @@
+// Marks an actor as something the LLM can target by id or type
+#include "LLM/LLMInteractableComponent.h"
+#include "LLM/LLMInteractableRegistry.h"
+#include "LLM/LLMWorldContext.h"
+#include "LLM/LLMSettings.h"
+#include "Components/SceneComponent.h"
+#include "GameFramework/Actor.h"
+
+void ULLMInteractableComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	Registry = ULLMInteractableRegistry::Get(this);
+	if (!Registry.IsValid())
+	{
+		return;
+	}
+	Registry->Register(this);
+
+	// Movable targets (NPCs, carts) keep their grid cell current; static ones never fire this
+	if (USceneComponent* Root = GetOwner()->GetRootComponent())
+	{
+		Root->TransformUpdated.AddUObject(this, &ULLMInteractableComponent::OnOwnerMoved);
+		TrackedRoot = Root;
+	}
+
+	ULLMWorldContext* WorldContext = bDescribeInWorldContext && GetDefault<ULLMSettings>()->bEnableWorldContext ? ULLMWorldContext::Get(this) : nullptr;
+	if (WorldContext)
+	{
+		WorldContext->RegisterEntity(GetOwner(), TargetType.IsEmpty() ? TEXT("Object") : TargetType, GetTargetId());
+	}
+}
+
+void ULLMInteractableComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (USceneComponent* Root = TrackedRoot.Get())
+	{
+		Root->TransformUpdated.RemoveAll(this);
+	}
+	TrackedRoot.Reset();
+
+	if (ULLMInteractableRegistry* Interactables = Registry.Get())
+	{
+		Interactables->Unregister(this);
+	}
+	Registry.Reset();
+	if (ULLMWorldContext* WorldContext = bDescribeInWorldContext ? ULLMWorldContext::Get(this) : nullptr)
+	{
+		WorldContext->UnregisterEntity(GetOwner());
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FString ULLMInteractableComponent::GetTargetId() const
+{
+	return !TargetId.IsEmpty() || !GetOwner() ? TargetId : GetOwner()->GetName();
+}
+
+void ULLMInteractableComponent::OnOwnerMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	if (ULLMInteractableRegistry* Interactables = Registry.Get())
+	{
+		Interactables->UpdateLocation(this);
+	}
+}
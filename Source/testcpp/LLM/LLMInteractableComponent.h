@@ -0,0 +1,47 @@
+// Marks an actor as something the LLM can target by id or type
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "Engine/EngineTypes.h"
+#include "LLMInteractableComponent.generated.h"
+
+class ULLMInteractableRegistry;
+
+/**
+ * Makes the owning actor an interaction target
+ * Registers with ULLMInteractableRegistry (and the world vocabulary) on BeginPlay, follows the
+ * owner's root component when it moves, and unregisters on EndPlay, so UBTTask_InteractTarget
+ * can resolve Target.Id and Target.Type without searching the world.
+ */
+UCLASS(ClassGroup = (AI), meta = (BlueprintSpawnableComponent))
+class TESTCPP_API ULLMInteractableComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** TargetId, or the owning actor's name when empty */
+	FString GetTargetId() const;
+
+public:
+	// Unique id the LLM can emit in target.id (case-insensitive); empty uses the owning actor's name
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LLM|Interactable")
+	FString TargetId;
+
+	// Kind of target for target.type, e.g. "Door", "Guard", "Chest"
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LLM|Interactable")
+	FString TargetType;
+
+	// Also list this actor in nearby agents' prompt context (ULLMWorldContext)
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LLM|Interactable")
+	bool bDescribeInWorldContext = true;
+
+private:
+	void OnOwnerMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	TWeakObjectPtr<ULLMInteractableRegistry> Registry;
+	TWeakObjectPtr<USceneComponent> TrackedRoot;
+};
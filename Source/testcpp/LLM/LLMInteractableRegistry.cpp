@@ -0,0 +1,215 @@
+// Id and type registry of interaction targets with per-type spatial grids
+#include "LLM/LLMInteractableRegistry.h"
+#include "LLM/LLMInteractableComponent.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMInteractableRegistryPrivate
+{
+	static double GetCellSize()
+	{
+		return FMath::Max(100.0f, GetDefault<ULLMSettings>()->InteractableGridCellSize);
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMInteractableRegistry* Registry = ULLMInteractableRegistry::Get(World);
+		if (!Registry)
+		{
+			return;
+		}
+
+		const FLLMInteractableStats Stats = Registry->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMInteractableRegistry] %d targets | %d id lookups (%d missed) | %d nearest queries | %d cell changes"),
+			Registry->GetTargetCount(), Stats.IdLookups, Stats.IdMisses, Stats.NearestQueries, Stats.CellChanges);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.InteractableStats"),
+		TEXT("Log interactable registry size and lookup counts"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMInteractableRegistry* ULLMInteractableRegistry::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMInteractableRegistry>() : nullptr;
+}
+
+FIntPoint ULLMInteractableRegistry::GetCell(const FVector& Location) const
+{
+	return FLLMSpatialGrid::GetCell(Location, LLMInteractableRegistryPrivate::GetCellSize());
+}
+
+void ULLMInteractableRegistry::Register(ULLMInteractableComponent* Interactable)
+{
+	AActor* Actor = Interactable ? Interactable->GetOwner() : nullptr;
+	if (!Actor)
+	{
+		return;
+	}
+
+	if (const int32* Existing = TargetIndices.Find(Interactable))
+	{
+		RemoveTarget(*Existing);
+	}
+
+	FTarget Target;
+	Target.Actor = Actor;
+	Target.Key = Interactable;
+	Target.Id = Interactable->GetTargetId();
+	Target.Type = Interactable->TargetType;
+	Target.Location = Actor->GetActorLocation();
+	Target.Cell = GetCell(Target.Location);
+
+	const int32 Index = Targets.Add(MoveTemp(Target));
+	TargetIndices.Add(Interactable, Index);
+
+	const FTarget& Added = Targets[Index];
+	if (!Added.Id.IsEmpty())
+	{
+		TArray<int32, TInlineAllocator<1>>& Holders = IdIndex.FindOrAdd(Added.Id);
+		if (Holders.Num() > 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMInteractableRegistry] Id '%s' of %s is already used by %s; the newest answers until it leaves"),
+				*Added.Id, *Actor->GetName(), *GetNameSafe(Targets[Holders.Last()].Actor.Get()));
+		}
+		Holders.Add(Index);
+	}
+
+	if (!Added.Type.IsEmpty())
+	{
+		AddToGrid(Index);
+		if (ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(this))
+		{
+			Vocabulary->RegisterName(ELLMVocabularyCategory::TargetType, Added.Type);
+		}
+	}
+}
+
+void ULLMInteractableRegistry::Unregister(ULLMInteractableComponent* Interactable)
+{
+	if (const int32* Index = TargetIndices.Find(Interactable))
+	{
+		RemoveTarget(*Index);
+	}
+}
+
+void ULLMInteractableRegistry::RemoveTarget(int32 Index)
+{
+	const FTarget& Target = Targets[Index];
+
+	// Keep registration order so the previous holder of a shared id answers again
+	if (TArray<int32, TInlineAllocator<1>>* Holders = Target.Id.IsEmpty() ? nullptr : IdIndex.Find(Target.Id))
+	{
+		Holders->RemoveSingle(Index);
+		if (Holders->Num() == 0)
+		{
+			IdIndex.Remove(Target.Id);
+		}
+	}
+
+	if (!Target.Type.IsEmpty())
+	{
+		RemoveFromGrid(Index);
+		if (ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(this))
+		{
+			Vocabulary->UnregisterName(ELLMVocabularyCategory::TargetType, Target.Type);
+		}
+	}
+
+	TargetIndices.Remove(Target.Key);
+	Targets.RemoveAt(Index);
+}
+
+void ULLMInteractableRegistry::AddToGrid(int32 Index)
+{
+	const FTarget& Target = Targets[Index];
+	TypeGrids.FindOrAdd(Target.Type).Add(Target.Cell, Index);
+}
+
+void ULLMInteractableRegistry::RemoveFromGrid(int32 Index)
+{
+	const FTarget& Target = Targets[Index];
+	if (FLLMSpatialGrid* Grid = TypeGrids.Find(Target.Type))
+	{
+		Grid->Remove(Target.Cell, Index);
+	}
+}
+
+void ULLMInteractableRegistry::UpdateLocation(ULLMInteractableComponent* Interactable)
+{
+	const int32* Index = TargetIndices.Find(Interactable);
+	const AActor* Actor = Index ? Targets[*Index].Actor.Get() : nullptr;
+	if (!Actor)
+	{
+		return;
+	}
+
+	FTarget& Target = Targets[*Index];
+	Target.Location = Actor->GetActorLocation();
+
+	const FIntPoint Cell = GetCell(Target.Location);
+	if (Cell != Target.Cell)
+	{
+		const bool bInGrid = !Target.Type.IsEmpty();
+		if (bInGrid)
+		{
+			RemoveFromGrid(*Index);
+		}
+		Target.Cell = Cell;
+		if (bInGrid)
+		{
+			AddToGrid(*Index);
+		}
+		++Stats.CellChanges;
+	}
+}
+
+AActor* ULLMInteractableRegistry::FindById(const FString& Id)
+{
+	++Stats.IdLookups;
+	const TArray<int32, TInlineAllocator<1>>* Holders = IdIndex.Find(Id);
+	AActor* Actor = Holders ? Targets[Holders->Last()].Actor.Get() : nullptr;
+	if (!Actor)
+	{
+		++Stats.IdMisses;
+	}
+	return Actor;
+}
+
+AActor* ULLMInteractableRegistry::FindNearest(const FString& Type, const FVector& Origin, float MaxDistance)
+{
+	TArray<AActor*> Nearest;
+	return FindKNearest(Type, Origin, 1, MaxDistance, Nearest) > 0 ? Nearest[0] : nullptr;
+}
+
+int32 ULLMInteractableRegistry::FindKNearest(const FString& Type, const FVector& Origin, int32 Count, float MaxDistance, TArray<AActor*>& OutActors)
+{
+	++Stats.NearestQueries;
+	OutActors.Reset();
+
+	const FLLMSpatialGrid* Grid = TypeGrids.Find(Type);
+	if (!Grid)
+	{
+		return 0;
+	}
+
+	TArray<int32> Nearest;
+	Grid->FindNearest(Origin, LLMInteractableRegistryPrivate::GetCellSize(), MaxDistance, Count,
+		[this](int32 Index, FVector& OutLocation)
+		{
+			OutLocation = Targets[Index].Location;
+			return Targets[Index].Actor.IsValid();
+		}, Nearest);
+
+	for (int32 Index : Nearest)
+	{
+		OutActors.Add(Targets[Index].Actor.Get());
+	}
+	return OutActors.Num();
+}
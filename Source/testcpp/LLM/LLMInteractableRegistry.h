@@ -0,0 +1,107 @@
+// Id and type registry of interaction targets with per-type spatial grids
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "LLM/LLMSpatialGrid.h"
+#include "LLMInteractableRegistry.generated.h"
+
+class ULLMInteractableComponent;
+
+/**
+ * Counters for the interactable registry
+ */
+USTRUCT(BlueprintType)
+struct FLLMInteractableStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Interactable")
+	int32 IdLookups = 0;
+
+	// Ids no registered target answers to
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Interactable")
+	int32 IdMisses = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Interactable")
+	int32 NearestQueries = 0;
+
+	// Moving targets that crossed into another grid cell
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Interactable")
+	int32 CellChanges = 0;
+};
+
+/**
+ * Interaction targets by id and by type
+ * ULLMInteractableComponent registers its actor on BeginPlay, reports moves and unregisters on
+ * EndPlay. Ids hash case-insensitively to their actor; when several targets share an id the
+ * newest answers and the previous one takes over again once it leaves. Each type has its own
+ * FLLMSpatialGrid of InteractableGridCellSize cells, so nearest-of-type queries only visit the cells around the
+ * origin instead of every actor of the class. Types are mirrored into the world vocabulary.
+ */
+UCLASS()
+class TESTCPP_API ULLMInteractableRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMInteractableRegistry* Get(const UObject* WorldContext);
+
+	void Register(ULLMInteractableComponent* Interactable);
+	void Unregister(ULLMInteractableComponent* Interactable);
+
+	/** Move a target to its owner's current location; only touches the grid when it changed cell */
+	void UpdateLocation(ULLMInteractableComponent* Interactable);
+
+	/** Target registered under an id (case-insensitive) */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Interactable")
+	AActor* FindById(const FString& Id);
+
+	/**
+	 * Nearest target of a type
+	 * @param MaxDistance - Search radius (cm); 0 searches every registered target of the type
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Interactable")
+	AActor* FindNearest(const FString& Type, const FVector& Origin, float MaxDistance = 0.0f);
+
+	/**
+	 * Up to Count nearest targets of a type, nearest first
+	 * @return Number of actors written to OutActors
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Interactable")
+	int32 FindKNearest(const FString& Type, const FVector& Origin, int32 Count, float MaxDistance, TArray<AActor*>& OutActors);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Interactable")
+	int32 GetTargetCount() const { return Targets.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Interactable")
+	FLLMInteractableStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|Interactable")
+	void ResetStats() { Stats = FLLMInteractableStats(); }
+
+private:
+	struct FTarget
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TObjectKey<ULLMInteractableComponent> Key;
+		FString Id;
+		FString Type;
+		FVector Location = FVector::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+	};
+
+	void RemoveTarget(int32 Index);
+	void AddToGrid(int32 Index);
+	void RemoveFromGrid(int32 Index);
+	FIntPoint GetCell(const FVector& Location) const;
+
+	TSparseArray<FTarget> Targets;
+	TMap<TObjectKey<ULLMInteractableComponent>, int32> TargetIndices;
+	// Id -> targets in registration order, newest last; FString keys hash and compare case-insensitively
+	TMap<FString, TArray<int32, TInlineAllocator<1>>> IdIndex;
+	TMap<FString, FLLMSpatialGrid> TypeGrids;
+
+	FLLMInteractableStats Stats;
+};
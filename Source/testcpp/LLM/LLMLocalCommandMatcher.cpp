@@ -0,0 +1,332 @@
+// Resolves simple player commands locally so they skip the LLM round trip
+#include "LLM/LLMLocalCommandMatcher.h"
+#include "LLM/LLMCommandGrammar.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMSettings.h"
+#include "LLM/LLMTextNormalization.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMLocalCommandMatcherPrivate
+{
+	static bool GetCategory(ELLMCommandSlot Slot, ELLMVocabularyCategory& OutCategory)
+	{
+		switch (Slot)
+		{
+		case ELLMCommandSlot::NavPoint:
+			OutCategory = ELLMVocabularyCategory::NavPoint;
+			return true;
+		case ELLMCommandSlot::TargetType:
+			OutCategory = ELLMVocabularyCategory::TargetType;
+			return true;
+		case ELLMCommandSlot::Montage:
+			OutCategory = ELLMVocabularyCategory::Montage;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMLocalCommandMatcher* Matcher = ULLMLocalCommandMatcher::Get(World);
+		if (!Matcher)
+		{
+			return;
+		}
+
+		const FLLMLocalCommandStats Stats = Matcher->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMLocalCommandMatcher] %d/%d commands resolved locally (%.1f%%), %.3f ms average match"),
+			Stats.Hits, Stats.Attempts, Matcher->GetHitRate() * 100.0f,
+			Stats.Attempts > 0 ? Stats.MatchSeconds * 1000.0 / Stats.Attempts : 0.0);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.LocalCommandStats"),
+		TEXT("Log how many commands the local grammar resolved without the LLM"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+void FLLMCommandPhraseTrie::Compile(const ULLMCommandGrammar& Grammar)
+{
+	Nodes.Reset();
+	Nodes.AddDefaulted();
+
+	Fillers.Reset();
+	for (const FString& Filler : Grammar.FillerWords)
+	{
+		Fillers.Add(LLMTextNormalization::Normalize(Filler));
+	}
+
+	TArray<FString> Words;
+	for (int32 RuleIndex = 0; RuleIndex < Grammar.Rules.Num(); ++RuleIndex)
+	{
+		for (const FString& Phrase : Grammar.Rules[RuleIndex].Phrases)
+		{
+			LLMTextNormalization::Tokenize(Phrase, Words);
+
+			int32 Node = 0;
+			for (const FString& Word : Words)
+			{
+				const int32* Child = Nodes[Node].Children.Find(Word);
+				if (Child)
+				{
+					Node = *Child;
+				}
+				else
+				{
+					const int32 NewNode = Nodes.AddDefaulted();
+					Nodes[Node].Children.Add(Word, NewNode);
+					Node = NewNode;
+				}
+			}
+			Nodes[Node].Rules.AddUnique(RuleIndex);
+		}
+	}
+}
+
+void FLLMCommandPhraseTrie::FindPhrases(const TArray<FString>& Tokens, int32 Start, TArray<TPair<int32, int32>, TInlineAllocator<8>>& OutMatches) const
+{
+	OutMatches.Reset();
+	if (Nodes.Num() == 0)
+	{
+		return;
+	}
+
+	// Collect every phrase end along the input, then report the longest phrase first
+	TArray<TPair<int32, int32>, TInlineAllocator<8>> PhraseEnds;
+	int32 Node = 0;
+	PhraseEnds.Emplace(0, Start);
+	for (int32 Index = Start; Index < Tokens.Num(); ++Index)
+	{
+		const int32* Child = Nodes[Node].Children.Find(Tokens[Index]);
+		if (!Child)
+		{
+			break;
+		}
+		Node = *Child;
+		PhraseEnds.Emplace(Node, Index + 1);
+	}
+
+	for (int32 End = PhraseEnds.Num() - 1; End >= 0; --End)
+	{
+		for (const int32 RuleIndex : Nodes[PhraseEnds[End].Key].Rules)
+		{
+			OutMatches.Emplace(RuleIndex, PhraseEnds[End].Value);
+		}
+	}
+}
+
+FString FLLMCommandPhraseTrie::JoinWithoutFillers(const TArray<FString>& Tokens, int32 Start, int32 End) const
+{
+	FString Result;
+	End = FMath::Min(End, Tokens.Num());
+	for (int32 Index = Start; Index < End; ++Index)
+	{
+		if (Fillers.Contains(Tokens[Index]))
+		{
+			continue;
+		}
+		if (!Result.IsEmpty())
+		{
+			Result.AppendChar(TEXT(' '));
+		}
+		Result += Tokens[Index];
+	}
+	return Result;
+}
+
+ULLMLocalCommandMatcher* ULLMLocalCommandMatcher::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMLocalCommandMatcher>() : nullptr;
+}
+
+void ULLMLocalCommandMatcher::SetGrammar(ULLMCommandGrammar* InGrammar)
+{
+	Grammar = InGrammar;
+	bCompiled = false;
+	// Filler words take part in name keys
+	NamesRevision = INDEX_NONE;
+}
+
+bool ULLMLocalCommandMatcher::TryMatch(const FString& Input, FLLMAction& OutAction)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	++Stats.Attempts;
+
+	CompileGrammarIfNeeded();
+	RefreshNamesIfStale();
+
+	TArray<FString> Tokens;
+	TArray<FString> Original;
+	LLMTextNormalization::Tokenize(Input, Tokens, &Original);
+
+	int32 Start = 0;
+	while (Start < Tokens.Num() && Phrases.IsFiller(Tokens[Start]))
+	{
+		++Start;
+	}
+
+	bool bMatched = false;
+	if (Start < Tokens.Num())
+	{
+		TArray<TPair<int32, int32>, TInlineAllocator<8>> Matches;
+		Phrases.FindPhrases(Tokens, Start, Matches);
+		for (const TPair<int32, int32>& Match : Matches)
+		{
+			if (MatchSlot(Match.Key, Tokens, Original, Match.Value, OutAction))
+			{
+				bMatched = true;
+				break;
+			}
+		}
+	}
+
+	Stats.MatchSeconds += FPlatformTime::Seconds() - StartTime;
+	if (bMatched)
+	{
+		++Stats.Hits;
+		UE_LOG(LogTemp, Log, TEXT("[LLMLocalCommandMatcher] '%s' resolved locally as %s"), *Input, *ULLMIntentRegistry::GetWireName(OutAction));
+	}
+	return bMatched;
+}
+
+bool ULLMLocalCommandMatcher::MatchSlot(int32 RuleIndex, const TArray<FString>& Tokens, const TArray<FString>& Original, int32 SlotStart, FLLMAction& OutAction) const
+{
+	using namespace LLMLocalCommandMatcherPrivate;
+
+	const FLLMCommandRule& Rule = Grammar->Rules[RuleIndex];
+	const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+	const ULLMIntentDefinition* Definition = Registry ? Registry->FindByTag(Rule.IntentTag) : nullptr;
+	if (!Definition)
+	{
+		return false;
+	}
+
+	FLLMAction Action;
+	Action.Intent = Definition->BuiltInIntent;
+	Action.IntentTag = Definition->IntentTag;
+	Action.Confidence = Rule.Confidence;
+
+	ELLMVocabularyCategory Category;
+	if (GetCategory(Rule.Slot, Category))
+	{
+		const FString* Name = NameLookup[static_cast<uint8>(Category)].Find(Phrases.JoinWithoutFillers(Tokens, SlotStart));
+		if (!Name)
+		{
+			return false;
+		}
+
+		switch (Rule.Slot)
+		{
+		case ELLMCommandSlot::NavPoint:
+			Action.Location.NavPointName = *Name;
+			Action.Location.bUseCoordinates = false;
+			break;
+		case ELLMCommandSlot::TargetType:
+			Action.Target.Type = *Name;
+			break;
+		default:
+			Action.Montage.Name = *Name;
+			break;
+		}
+	}
+	else if (Rule.Slot == ELLMCommandSlot::FreeText)
+	{
+		if (SlotStart >= Original.Num())
+		{
+			return false;
+		}
+		Action.Speak = FString::Join(TArrayView<const FString>(Original).RightChop(SlotStart), TEXT(" "));
+	}
+	else if (!Phrases.JoinWithoutFillers(Tokens, SlotStart).IsEmpty())
+	{
+		return false;
+	}
+
+	OutAction = MoveTemp(Action);
+	return true;
+}
+
+bool ULLMLocalCommandMatcher::FindName(ELLMVocabularyCategory Category, const FString& Text, FString& OutName)
+{
+	CompileGrammarIfNeeded();
+	RefreshNamesIfStale();
+
+	const TMap<FString, FString>& Lookup = NameLookup[static_cast<uint8>(Category)];
+	if (Lookup.Num() == 0)
+	{
+		return false;
+	}
+
+	TArray<FString> Tokens;
+	LLMTextNormalization::Tokenize(Text, Tokens);
+	for (int32 Length = Tokens.Num(); Length > 0; --Length)
+	{
+		for (int32 Start = 0; Start + Length <= Tokens.Num(); ++Start)
+		{
+			if (const FString* Name = Lookup.Find(Phrases.JoinWithoutFillers(Tokens, Start, Start + Length)))
+			{
+				OutName = *Name;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+void ULLMLocalCommandMatcher::CompileGrammarIfNeeded()
+{
+	if (bCompiled)
+	{
+		return;
+	}
+	bCompiled = true;
+
+	if (!Grammar)
+	{
+		Grammar = GetDefault<ULLMSettings>()->CommandGrammar.LoadSynchronous();
+	}
+	if (!Grammar)
+	{
+		Grammar = ULLMCommandGrammar::CreateDefault(this);
+	}
+
+	Phrases.Compile(*Grammar);
+	UE_LOG(LogTemp, Log, TEXT("[LLMLocalCommandMatcher] Compiled %d rules into %d trie nodes"), Grammar->Rules.Num(), Phrases.GetNumNodes());
+}
+
+void ULLMLocalCommandMatcher::RefreshNamesIfStale()
+{
+	const ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(this);
+	const int32 Revision = Vocabulary ? Vocabulary->GetRevision() : INDEX_NONE;
+	if (Revision == NamesRevision)
+	{
+		return;
+	}
+	NamesRevision = Revision;
+
+	TArray<FString> Words;
+	for (uint8 Category = 0; Category < UE_ARRAY_COUNT(NameLookup); ++Category)
+	{
+		NameLookup[Category].Reset();
+		if (!Vocabulary)
+		{
+			continue;
+		}
+
+		for (const FString& Name : Vocabulary->GetNames(static_cast<ELLMVocabularyCategory>(Category)))
+		{
+			LLMTextNormalization::Tokenize(Name, Words);
+			const FString Key = Phrases.JoinWithoutFillers(Words, 0);
+			if (!Key.IsEmpty())
+			{
+				NameLookup[Category].Add(Key, Name);
+			}
+		}
+	}
+}
@@ -0,0 +1,130 @@
+// Resolves simple player commands locally so they skip the LLM round trip
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "LLMLocalCommandMatcher.generated.h"
+
+class ULLMCommandGrammar;
+
+/**
+ * Counters for the local fast path
+ */
+USTRUCT(BlueprintType)
+struct FLLMLocalCommandStats
+{
+	GENERATED_BODY()
+
+	// Inputs offered to TryMatch
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|LocalCommands")
+	int32 Attempts = 0;
+
+	// Inputs resolved locally (LLM calls avoided)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|LocalCommands")
+	int32 Hits = 0;
+
+	// Total time spent matching, in seconds
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|LocalCommands")
+	double MatchSeconds = 0.0;
+};
+
+/**
+ * Verb phrases of a ULLMCommandGrammar compiled into a word trie, plus its filler words
+ * Read-only once compiled, so the game-thread matcher and FLLMRuleBasedRuntime on the local
+ * provider's pool share one implementation of the grammar.
+ */
+class TESTCPP_API FLLMCommandPhraseTrie
+{
+public:
+	void Compile(const ULLMCommandGrammar& Grammar);
+
+	/**
+	 * Rules with a phrase starting at Tokens[Start], longest phrase first
+	 * @param OutMatches - (rule index, first token after the phrase); rules with an empty phrase come last, ending at Start
+	 */
+	void FindPhrases(const TArray<FString>& Tokens, int32 Start, TArray<TPair<int32, int32>, TInlineAllocator<8>>& OutMatches) const;
+
+	bool IsFiller(const FString& Token) const { return Fillers.Contains(Token); }
+
+	/** Tokens[Start, End) joined with single spaces, filler words dropped */
+	FString JoinWithoutFillers(const TArray<FString>& Tokens, int32 Start, int32 End = MAX_int32) const;
+
+	int32 GetNumNodes() const { return Nodes.Num(); }
+
+private:
+	struct FNode
+	{
+		TMap<FString, int32> Children;
+		// Rules whose phrase ends here
+		TArray<int32, TInlineAllocator<1>> Rules;
+	};
+
+	// Node 0 is the root; rules on the root have an empty phrase
+	TArray<FNode> Nodes;
+	TSet<FString> Fillers;
+};
+
+/**
+ * Matches player input against a verb grammar (ULLMCommandGrammar) and the names in
+ * ULLMWorldVocabulary. Verb phrases are compiled into a word trie and names into a hash map
+ * of normalized names, so a match costs one trie walk and one lookup. Anything that does not
+ * match exactly (unknown names, extra words) is left to the LLM.
+ */
+UCLASS()
+class TESTCPP_API ULLMLocalCommandMatcher : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Convenience accessor; returns null if the world has no matcher */
+	static ULLMLocalCommandMatcher* Get(const UObject* WorldContext);
+
+	/**
+	 * Try to resolve the input without the LLM
+	 * @param Input - Raw player text
+	 * @param OutAction - Resolved action (intent, slot and the rule's confidence)
+	 * @return true if the whole input matched a rule
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|LocalCommands")
+	bool TryMatch(const FString& Input, FLLMAction& OutAction);
+
+	/**
+	 * Find the longest run of words in the text that names a registered vocabulary entry
+	 * @param OutName - Name as registered
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|LocalCommands")
+	bool FindName(ELLMVocabularyCategory Category, const FString& Text, FString& OutName);
+
+	/** Replace the grammar (null restores the one from project settings) */
+	UFUNCTION(BlueprintCallable, Category = "LLM|LocalCommands")
+	void SetGrammar(ULLMCommandGrammar* InGrammar);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|LocalCommands")
+	FLLMLocalCommandStats GetStats() const { return Stats; }
+
+	/** Share of attempts resolved locally (0 when nothing was attempted) */
+	UFUNCTION(BlueprintPure, Category = "LLM|LocalCommands")
+	float GetHitRate() const { return Stats.Attempts > 0 ? static_cast<float>(Stats.Hits) / Stats.Attempts : 0.0f; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|LocalCommands")
+	void ResetStats() { Stats = FLLMLocalCommandStats(); }
+
+private:
+	void CompileGrammarIfNeeded();
+	void RefreshNamesIfStale();
+	bool MatchSlot(int32 RuleIndex, const TArray<FString>& Tokens, const TArray<FString>& Original, int32 SlotStart, FLLMAction& OutAction) const;
+
+	UPROPERTY()
+	TObjectPtr<ULLMCommandGrammar> Grammar;
+
+	FLLMCommandPhraseTrie Phrases;
+	bool bCompiled = false;
+
+	// Normalized name (fillers removed) -> registered name, per ELLMVocabularyCategory
+	TMap<FString, FString> NameLookup[3];
+	int32 NamesRevision = INDEX_NONE;
+
+	FLLMLocalCommandStats Stats;
+};
@@ -0,0 +1,311 @@
+// In-process LLM provider: pluggable CPU runtime on a dedicated thread pool
+#include "LLM/LLMLocalProvider.h"
+#include "LLM/LLMRuleBasedRuntime.h"
+#include "LLM/LLMSettings.h"
+#include "Async/Async.h"
+#include "Misc/QueuedThreadPool.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/ScopeRWLock.h"
+#include "Hash/CityHash.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+class ULLMLocalProvider::FBatchWork : public IQueuedWork
+{
+public:
+	explicit FBatchWork(TSharedPtr<FQueue, ESPMode::ThreadSafe> InQueue)
+		: Queue(MoveTemp(InQueue))
+	{
+	}
+
+	virtual void DoThreadedWork() override
+	{
+		TArray<TSharedPtr<FPendingRequest, ESPMode::ThreadSafe>> Batch;
+		TArray<FLLMLocalRequest*> Requests;
+		for (;;)
+		{
+			// Continuous batching: whatever queued up while the last batch decoded forms the next one
+			{
+				FScopeLock ScopeLock(&Queue->Lock);
+				if (Queue->Pending.Num() == 0)
+				{
+					--Queue->ActiveWorkers;
+					break;
+				}
+				const int32 Count = FMath::Min(Queue->Pending.Num(), Queue->MaxBatchSize);
+				Batch.Reset();
+				Batch.Append(Queue->Pending.GetData(), Count);
+				Queue->Pending.RemoveAt(0, Count, EAllowShrinking::No);
+			}
+
+			// Requests are grouped by runtime and model; a runtime or profile switch mid-queue splits the batch
+			for (int32 Start = 0; Start < Batch.Num();)
+			{
+				const FPrefixEntry& First = *Batch[Start]->PrefixEntry;
+				const TSharedPtr<ILLMLocalRuntime, ESPMode::ThreadSafe> Runtime = First.Runtime;
+				const FString ModelPath = First.ModelPath;
+				int32 End = Start + 1;
+				while (End < Batch.Num() && Batch[End]->PrefixEntry->Runtime == Runtime
+					&& Batch[End]->PrefixEntry->ModelPath.Equals(ModelPath, ESearchCase::CaseSensitive))
+				{
+					++End;
+				}
+
+				// Another worker may load a different model between our load and our read lock: check again under it
+				for (;;)
+				{
+					{
+						FReadScopeLock RuntimeScope(Queue->RuntimeLock);
+						if (IsLoaded(Runtime, ModelPath))
+						{
+							Requests.Reset();
+							for (int32 Index = Start; Index < End; ++Index)
+							{
+								FPendingRequest& Pending = *Batch[Index];
+								Pending.Request.Prefix = GetPrefixState(*Pending.PrefixEntry, Queue->LoadSerial);
+								Requests.Add(&Pending.Request);
+							}
+							Runtime->Decode(Requests);
+							break;
+						}
+					}
+
+					if (!LoadModel(Runtime, ModelPath))
+					{
+						for (int32 Index = Start; Index < End; ++Index)
+						{
+							Batch[Index]->bLoadFailed = true;
+						}
+						break;
+					}
+				}
+				Start = End;
+			}
+
+			for (TSharedPtr<FPendingRequest, ESPMode::ThreadSafe>& Pending : Batch)
+			{
+				const bool bSuccess = Pending->Request.bSuccess && !Pending->bLoadFailed;
+				const FString Body = bSuccess ? MakeResponseBody(Pending->Request.Text)
+					: Pending->bLoadFailed ? FString(TEXT("{\"error\": \"Failed to load local model\"}"))
+					: FString(TEXT("{\"error\": \"Local generation failed\"}"));
+				const FOnGeminiResponse OnDone = Pending->OnDone;
+				AsyncTask(ENamedThreads::GameThread, [OnDone, bSuccess, Body]()
+				{
+					OnDone.ExecuteIfBound(bSuccess, Body);
+				});
+			}
+		}
+		delete this;
+	}
+
+	// Requests left in the queue are answered by ULLMLocalProvider::Deinitialize
+	virtual void Abandon() override
+	{
+		{
+			FScopeLock ScopeLock(&Queue->Lock);
+			--Queue->ActiveWorkers;
+		}
+		delete this;
+	}
+
+private:
+	// Caller holds RuntimeLock
+	bool IsLoaded(const TSharedPtr<ILLMLocalRuntime, ESPMode::ThreadSafe>& Runtime, const FString& ModelPath) const
+	{
+		return Queue->LoadedRuntime == Runtime && Queue->LoadedModelPath.Equals(ModelPath, ESearchCase::CaseSensitive);
+	}
+
+	// Waits for batches decoding against the current weights; only pool threads ever wait here
+	bool LoadModel(const TSharedPtr<ILLMLocalRuntime, ESPMode::ThreadSafe>& Runtime, const FString& ModelPath)
+	{
+		FWriteScopeLock RuntimeScope(Queue->RuntimeLock);
+		if (IsLoaded(Runtime, ModelPath))
+		{
+			return true;
+		}
+
+		++Queue->LoadSerial;
+		if (!Runtime->LoadModel(ModelPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("[LLMLocalProvider] %s failed to load model '%s'"), *Runtime->GetName(), *ModelPath);
+			Queue->LoadedRuntime.Reset();
+			Queue->LoadedModelPath.Reset();
+			return false;
+		}
+
+		UE_LOG(LogTemp, Log, TEXT("[LLMLocalProvider] %s loaded model '%s'"), *Runtime->GetName(), *ModelPath);
+		Queue->LoadedRuntime = Runtime;
+		Queue->LoadedModelPath = ModelPath;
+		return true;
+	}
+
+	// Caller holds RuntimeLock for reading, so the model cannot change underneath
+	static TSharedPtr<const FLLMLocalPrefixState, ESPMode::ThreadSafe> GetPrefixState(FPrefixEntry& Entry, uint32 LoadSerial)
+	{
+		FScopeLock ScopeLock(&Entry.Lock);
+		if (!Entry.State.IsValid() || Entry.StateSerial != LoadSerial)
+		{
+			Entry.State = Entry.Runtime->Prefill(Entry.SystemInstruction, Entry.Schema);
+			Entry.StateSerial = LoadSerial;
+		}
+		return Entry.State;
+	}
+
+	TSharedPtr<FQueue, ESPMode::ThreadSafe> Queue;
+};
+
+void ULLMLocalProvider::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	Queue = MakeShared<FQueue, ESPMode::ThreadSafe>();
+	Queue->MaxWorkers = FMath::Max(1, Settings->LocalProviderThreads);
+	Queue->MaxBatchSize = FMath::Max(1, Settings->LocalMaxBatchSize);
+
+	ThreadPool = FQueuedThreadPool::Allocate();
+	ThreadPool->Create(Queue->MaxWorkers, 256 * 1024, TPri_BelowNormal, TEXT("LLMLocalProvider"));
+
+	SetRuntime(MakeShared<FLLMRuleBasedRuntime, ESPMode::ThreadSafe>());
+}
+
+void ULLMLocalProvider::Deinitialize()
+{
+	if (ThreadPool)
+	{
+		// Abandons queued batches and joins the workers; callbacks already posted to the game thread still run
+		ThreadPool->Destroy();
+		delete ThreadPool;
+		ThreadPool = nullptr;
+	}
+	FailPending(TEXT("Local provider shut down"));
+	PrefixCache.Reset();
+	Super::Deinitialize();
+}
+
+void ULLMLocalProvider::FailPending(const FString& Error)
+{
+	TArray<TSharedPtr<FPendingRequest, ESPMode::ThreadSafe>> Abandoned;
+	if (Queue.IsValid())
+	{
+		FScopeLock ScopeLock(&Queue->Lock);
+		Abandoned = MoveTemp(Queue->Pending);
+		Queue->Pending.Reset();
+	}
+
+	const FString Body = FString::Printf(TEXT("{\"error\": \"%s\"}"), *Error);
+	for (const TSharedPtr<FPendingRequest, ESPMode::ThreadSafe>& Pending : Abandoned)
+	{
+		Pending->OnDone.ExecuteIfBound(false, Body);
+	}
+}
+
+void ULLMLocalProvider::SetRuntime(TSharedRef<ILLMLocalRuntime, ESPMode::ThreadSafe> InRuntime)
+{
+	Runtime = InRuntime;
+	PrefixCache.Reset();
+	UE_LOG(LogTemp, Log, TEXT("[LLMLocalProvider] Using runtime %s"), *Runtime->GetName());
+}
+
+void ULLMLocalProvider::GenerateContent(const FString& ModelPath, const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FOnGeminiResponse& OnDone)
+{
+	if (!ThreadPool || !Runtime.IsValid())
+	{
+		OnDone.ExecuteIfBound(false, TEXT("{\"error\": \"Local provider not initialized\"}"));
+		return;
+	}
+
+	TSharedPtr<FPendingRequest, ESPMode::ThreadSafe> Pending = MakeShared<FPendingRequest, ESPMode::ThreadSafe>();
+	Pending->Request.UserPrompt = UserPrompt;
+	Pending->Request.Temperature = Config.Temperature;
+	Pending->Request.MaxOutputTokens = Config.MaxOutputTokens;
+	// The model is loaded by the worker that picks this up, not here
+	Pending->PrefixEntry = FindOrAddPrefix(ModelPath, Config);
+	Pending->OnDone = OnDone;
+
+	bool bStartWorker = false;
+	{
+		FScopeLock ScopeLock(&Queue->Lock);
+		Queue->Pending.Add(MoveTemp(Pending));
+		if (Queue->ActiveWorkers < Queue->MaxWorkers && Queue->ActiveWorkers * Queue->MaxBatchSize < Queue->Pending.Num())
+		{
+			++Queue->ActiveWorkers;
+			bStartWorker = true;
+		}
+	}
+
+	if (bStartWorker)
+	{
+		ThreadPool->AddQueuedWork(new FBatchWork(Queue));
+	}
+}
+
+TSharedPtr<ULLMLocalProvider::FPrefixEntry, ESPMode::ThreadSafe> ULLMLocalProvider::FindOrAddPrefix(const FString& ModelPath, const FGeminiGenerateContentConfig& Config)
+{
+	// Keyed by content: configs that carry the schema as text build a new string every request
+	FString SchemaText = Config.ResponseSchemaJson;
+	if (Config.ResponseSchema.IsValid())
+	{
+		SchemaText.Reset();
+		const TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&SchemaText);
+		FJsonSerializer::Serialize(Config.ResponseSchema.ToSharedRef(), Writer);
+	}
+	const FTCHARToUTF8 Prefix(*(ModelPath + TEXT("\n") + Config.SystemInstruction + TEXT("\n") + SchemaText));
+	const uint64 Hash = CityHash64(Prefix.Get(), Prefix.Length());
+
+	for (int32 Index = 0; Index < PrefixCache.Num(); ++Index)
+	{
+		const TSharedPtr<FPrefixEntry, ESPMode::ThreadSafe> Entry = PrefixCache[Index];
+		if (Entry->Hash == Hash && Entry->ModelPath.Equals(ModelPath, ESearchCase::CaseSensitive)
+			&& Entry->SystemInstruction.Equals(Config.SystemInstruction, ESearchCase::CaseSensitive))
+		{
+			PrefixCache.RemoveAt(Index, EAllowShrinking::No);
+			PrefixCache.Insert(Entry, 0);
+			return Entry;
+		}
+	}
+
+	TSharedPtr<FJsonObject> Schema = Config.ResponseSchema;
+	if (!Schema.IsValid() && !SchemaText.IsEmpty())
+	{
+		const TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(SchemaText);
+		FJsonSerializer::Deserialize(Reader, Schema);
+	}
+
+	TSharedPtr<FPrefixEntry, ESPMode::ThreadSafe> Entry = MakeShared<FPrefixEntry, ESPMode::ThreadSafe>();
+	Entry->Hash = Hash;
+	Entry->ModelPath = ModelPath;
+	Entry->SystemInstruction = Config.SystemInstruction;
+	Entry->Schema = Schema;
+	Entry->Runtime = Runtime;
+	PrefixCache.Insert(Entry, 0);
+	PrefixCache.SetNum(FMath::Min(PrefixCache.Num(), FMath::Max(1, GetDefault<ULLMSettings>()->LocalPrefixCacheSize)));
+	return Entry;
+}
+
+FString ULLMLocalProvider::MakeResponseBody(const FString& Text)
+{
+	// {"candidates":[{"content":{"role":"model","parts":[{"text":...}]},"finishReason":"STOP"}]}
+	TSharedRef<FJsonObject> Part = MakeShared<FJsonObject>();
+	Part->SetStringField(TEXT("text"), Text);
+	TArray<TSharedPtr<FJsonValue>> Parts;
+	Parts.Add(MakeShared<FJsonValueObject>(Part));
+
+	TSharedRef<FJsonObject> Content = MakeShared<FJsonObject>();
+	Content->SetStringField(TEXT("role"), TEXT("model"));
+	Content->SetArrayField(TEXT("parts"), Parts);
+
+	TSharedRef<FJsonObject> Candidate = MakeShared<FJsonObject>();
+	Candidate->SetObjectField(TEXT("content"), Content);
+	Candidate->SetStringField(TEXT("finishReason"), TEXT("STOP"));
+	TArray<TSharedPtr<FJsonValue>> Candidates;
+	Candidates.Add(MakeShared<FJsonValueObject>(Candidate));
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetArrayField(TEXT("candidates"), Candidates);
+
+	FString Body;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Body);
+	FJsonSerializer::Serialize(Root, Writer);
+	return Body;
+}
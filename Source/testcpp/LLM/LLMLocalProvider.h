@@ -0,0 +1,148 @@
+// In-process LLM provider: pluggable CPU runtime on a dedicated thread pool
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "LLMLocalProvider.generated.h"
+
+class FQueuedThreadPool;
+
+/**
+ * Runtime-specific result of processing a shared prompt prefix (system instruction + response schema)
+ * For a transformer runtime this is the KV cache of the prefix; it is computed once and shared
+ * by every request with the same prefix.
+ */
+struct FLLMLocalPrefixState
+{
+	virtual ~FLLMLocalPrefixState() = default;
+};
+
+/**
+ * One generation request as seen by a runtime
+ */
+struct FLLMLocalRequest
+{
+	FString UserPrompt;
+	float Temperature = 0.7f;
+	int32 MaxOutputTokens = 2048;
+	TSharedPtr<const FLLMLocalPrefixState, ESPMode::ThreadSafe> Prefix;
+
+	// Filled by the runtime
+	FString Text;
+	bool bSuccess = false;
+};
+
+/**
+ * Inference backend used by ULLMLocalProvider
+ * Decode is called from pool threads, possibly concurrently with different batches.
+ */
+class TESTCPP_API ILLMLocalRuntime
+{
+public:
+	virtual ~ILLMLocalRuntime() = default;
+
+	virtual FString GetName() const = 0;
+
+	/**
+	 * Load model weights (APIData Model field); runtimes without weights return true
+	 * Called on a pool thread when a batch needs a model other than the loaded one. Never overlaps Prefill or Decode.
+	 */
+	virtual bool LoadModel(const FString& ModelPath) = 0;
+
+	/**
+	 * Process the shared prefix once. The output of every request using it must satisfy ResponseSchema when set.
+	 * Called on a pool thread; the schema is read-only.
+	 */
+	virtual TSharedPtr<const FLLMLocalPrefixState, ESPMode::ThreadSafe> Prefill(const FString& SystemInstruction, const TSharedPtr<FJsonObject>& ResponseSchema) = 0;
+
+	/** Generate the text of every request in the batch */
+	virtual void Decode(TArrayView<FLLMLocalRequest* const> Batch) = 0;
+};
+
+/**
+ * Serves UAPIData profiles whose Provider is Local without any network traffic.
+ * Requests are queued and drained by up to LocalProviderThreads workers in batches of up to
+ * LocalMaxBatchSize; requests arriving while a batch decodes join the next one. Model weights
+ * are loaded by the workers when a batch needs a model other than the loaded one (the game thread
+ * never waits for a load), so requests for a new profile queue behind it. Prefix states are
+ * cached by a hash of the model, system instruction and schema text so the shared system prompt
+ * is processed once per loaded model. Every request's OnDone fires exactly once, with an error if it never ran.
+ * Responses are wrapped in the generateContent body shape, so the rest of the pipeline
+ * cannot tell the providers apart.
+ * The default runtime is FLLMRuleBasedRuntime, a deterministic grammar-driven stand-in with no
+ * weights; a model inference backend plugs in through SetRuntime.
+ */
+UCLASS()
+class TESTCPP_API ULLMLocalProvider : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Same contract as UGeminiHTTPManager::GenerateContent; OnDone runs on the game thread */
+	void GenerateContent(const FString& ModelPath, const FString& UserPrompt, const FGeminiGenerateContentConfig& Config, const FOnGeminiResponse& OnDone);
+
+	/** Replace the runtime; requests already queued finish on the previous one */
+	void SetRuntime(TSharedRef<ILLMLocalRuntime, ESPMode::ThreadSafe> InRuntime);
+
+	/** Wrap generated text in a generateContent response body */
+	static FString MakeResponseBody(const FString& Text);
+
+private:
+	struct FPrefixEntry
+	{
+		// Of model path, system instruction and schema text
+		uint64 Hash = 0;
+		FString ModelPath;
+		FString SystemInstruction;
+		TSharedPtr<FJsonObject> Schema;
+		TSharedPtr<ILLMLocalRuntime, ESPMode::ThreadSafe> Runtime;
+		FCriticalSection Lock;
+		TSharedPtr<const FLLMLocalPrefixState, ESPMode::ThreadSafe> State;
+		// FQueue::LoadSerial State was computed under; a reload of the model recomputes it
+		uint32 StateSerial = 0;
+	};
+
+	struct FPendingRequest
+	{
+		FLLMLocalRequest Request;
+		TSharedPtr<FPrefixEntry, ESPMode::ThreadSafe> PrefixEntry;
+		FOnGeminiResponse OnDone;
+		bool bLoadFailed = false;
+	};
+
+	// Shared with the pool workers; outlives the subsystem while workers drain
+	struct FQueue
+	{
+		FCriticalSection Lock;
+		TArray<TSharedPtr<FPendingRequest, ESPMode::ThreadSafe>> Pending;
+		int32 ActiveWorkers = 0;
+		int32 MaxWorkers = 1;
+		int32 MaxBatchSize = 8;
+		// Read by workers while they prefill or decode, written while a model loads
+		FRWLock RuntimeLock;
+		// Guarded by RuntimeLock: what the runtime currently has loaded
+		TSharedPtr<ILLMLocalRuntime, ESPMode::ThreadSafe> LoadedRuntime;
+		FString LoadedModelPath;
+		uint32 LoadSerial = 0;
+	};
+
+	class FBatchWork;
+
+	TSharedPtr<FPrefixEntry, ESPMode::ThreadSafe> FindOrAddPrefix(const FString& ModelPath, const FGeminiGenerateContentConfig& Config);
+
+	/** Answer every queued request with an error (shutdown) */
+	void FailPending(const FString& Error);
+
+	TSharedPtr<ILLMLocalRuntime, ESPMode::ThreadSafe> Runtime;
+
+	TSharedPtr<FQueue, ESPMode::ThreadSafe> Queue;
+	FQueuedThreadPool* ThreadPool = nullptr;
+
+	// Most recently used first
+	TArray<TSharedPtr<FPrefixEntry, ESPMode::ThreadSafe>> PrefixCache;
+};
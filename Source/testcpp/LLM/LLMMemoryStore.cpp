@@ -0,0 +1,415 @@
+// Long-term NPC memory: embedded facts in per-owner append-only files, retrieved on a worker thread
+#include "LLM/LLMMemoryStore.h"
+#include "LLM/LLMSemanticCache.h"
+#include "LLM/LLMSettings.h"
+#include "Algo/BinarySearch.h"
+#include "Async/Async.h"
+#include "Async/MappedFileHandle.h"
+#include "Engine/GameInstance.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace LLMMemoryStorePrivate
+{
+	static constexpr uint32 FileMagic = 0x4D4D4C4C; // "LLMM"
+	static constexpr uint32 FileVersion = 1;
+
+	// Records are checked against the clock this often during a scan
+	static constexpr int32 DeadlineCheckInterval = 64;
+
+	// Facts this similar to one already remembered are not stored again
+	static constexpr float DuplicateSimilarity = 0.95f;
+
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint32 Dim;
+		uint32 RecordBytes;
+	};
+	static_assert(sizeof(FHeader) == 16, "Memory file header layout changed");
+	static_assert(sizeof(FLLMMemoryRecord) == 512, "Memory record layout changed");
+	static_assert(FLLMMemoryRecord::Dim == FLLMSemanticIndex::Dim, "Memory records store semantic index embeddings");
+
+	static float Similarity(const FLLMMemoryRecord& A, const FLLMMemoryRecord& B)
+	{
+		int32 Sum = 0;
+		for (int32 Index = 0; Index < FLLMMemoryRecord::Dim; ++Index)
+		{
+			Sum += int32(A.Vector[Index]) * int32(B.Vector[Index]);
+		}
+		return Sum * A.Scale * B.Scale;
+	}
+
+	struct FMatch
+	{
+		float Similarity;
+		const FLLMMemoryRecord* Record;
+	};
+
+	// Keep the K best matches at or above MinSimilarity, best first; false when the deadline passed
+	static bool Scan(TConstArrayView<FLLMMemoryRecord> Records, const FLLMMemoryRecord& Query, int32 K, float MinSimilarity,
+		double Deadline, TArray<FMatch>& InOutBest)
+	{
+		for (int32 Index = Records.Num() - 1; Index >= 0; --Index)
+		{
+			// Newest first, so a scan cut short has seen the most recent memories
+			if ((Index % DeadlineCheckInterval) == 0 && FPlatformTime::Seconds() > Deadline)
+			{
+				return false;
+			}
+
+			const float Score = Similarity(Records[Index], Query);
+			if (Score < MinSimilarity || (InOutBest.Num() == K && Score <= InOutBest.Last().Similarity))
+			{
+				continue;
+			}
+
+			if (InOutBest.Num() == K)
+			{
+				InOutBest.Pop(EAllowShrinking::No);
+			}
+			const int32 Insert = Algo::LowerBoundBy(InOutBest, -Score, [](const FMatch& Match) { return -Match.Similarity; });
+			InOutBest.Insert({ Score, &Records[Index] }, Insert);
+		}
+		return true;
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMMemoryStore* Store = ULLMMemoryStore::Get(World);
+		if (!Store)
+		{
+			return;
+		}
+
+		const FLLMMemoryStats Stats = Store->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMMemoryStore] %d retrievals (%.3f ms avg, %d over budget), %d memories returned | %d remembered, %d duplicates skipped | %d files mapped"),
+			Stats.Retrievals, Stats.Retrievals > 0 ? Stats.RetrievalSeconds * 1000.0 / Stats.Retrievals : 0.0, Stats.TimedOut,
+			Stats.Retrieved, Stats.Inserts, Stats.Duplicates, Stats.OpenFiles);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.MemoryStats"),
+		TEXT("Log long-term memory retrieval latency and counts"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+// Record
+
+FLLMMemoryRecord FLLMMemoryRecord::Make(const FString& Fact)
+{
+	FLLMMemoryRecord Record;
+	Record.Time = static_cast<uint32>(FDateTime::UtcNow().ToUnixTimestamp());
+
+	float Vector[Dim];
+	FLLMSemanticIndex::Embed(Fact, Vector);
+	float MaxAbs = 0.0f;
+	for (float Value : Vector)
+	{
+		MaxAbs = FMath::Max(MaxAbs, FMath::Abs(Value));
+	}
+	Record.Scale = MaxAbs > 0.0f ? MaxAbs / 127.0f : 0.0f;
+	for (int32 Index = 0; Index < Dim; ++Index)
+	{
+		Record.Vector[Index] = Record.Scale > 0.0f ? static_cast<int8>(FMath::RoundToInt32(Vector[Index] / Record.Scale)) : 0;
+	}
+
+	// Cut on a character boundary, never inside a multi-byte sequence
+	const FTCHARToUTF8 Utf8(*Fact);
+	int32 Bytes = FMath::Min(Utf8.Length(), MaxTextBytes);
+	while (Bytes < Utf8.Length() && Bytes > 0 && (static_cast<uint8>(Utf8.Get()[Bytes]) & 0xC0) == 0x80)
+	{
+		--Bytes;
+	}
+	FMemory::Memcpy(Record.Text, Utf8.Get(), Bytes);
+	Record.TextBytes = static_cast<uint16>(Bytes);
+	return Record;
+}
+
+FString FLLMMemoryRecord::GetText() const
+{
+	const FUTF8ToTCHAR Converted(Text, FMath::Min<int32>(TextBytes, MaxTextBytes));
+	return FString(Converted.Length(), Converted.Get());
+}
+
+// File
+
+FLLMMemoryFile::FLLMMemoryFile() = default;
+FLLMMemoryFile::~FLLMMemoryFile() = default;
+
+bool FLLMMemoryFile::Open(const FString& Path)
+{
+	using namespace LLMMemoryStorePrivate;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path))
+	{
+		return false;
+	}
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	FOpenMappedResult Mapped = PlatformFile.OpenMappedEx(*Path);
+	if (!Mapped.HasError())
+	{
+		MappedFile = Mapped.StealValue();
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Data = Bytes.GetData();
+		Size = Bytes.Num();
+	}
+
+	const FHeader* Header = reinterpret_cast<const FHeader*>(Data);
+	if (Size < static_cast<int64>(sizeof(FHeader)) || Header->Magic != FileMagic || Header->Version != FileVersion
+		|| Header->Dim != FLLMMemoryRecord::Dim || Header->RecordBytes != sizeof(FLLMMemoryRecord))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMMemoryStore] %s is not a memory file of version %u, ignoring"), *Path, FileVersion);
+		MappedRegion.Reset();
+		MappedFile.Reset();
+		Bytes.Empty();
+		return false;
+	}
+
+	const int32 NumRecords = static_cast<int32>((Size - sizeof(FHeader)) / sizeof(FLLMMemoryRecord));
+	Records = TConstArrayView<FLLMMemoryRecord>(reinterpret_cast<const FLLMMemoryRecord*>(Data + sizeof(FHeader)), NumRecords);
+	return true;
+}
+
+bool FLLMMemoryFile::Append(const FString& Path, TConstArrayView<FLLMMemoryRecord> NewRecords)
+{
+	using namespace LLMMemoryStorePrivate;
+
+	IFileManager& FileManager = IFileManager::Get();
+	const int64 ExistingSize = FileManager.FileSize(*Path);
+	const int64 RecordsSize = NewRecords.Num() * sizeof(FLLMMemoryRecord);
+
+	// An earlier append was cut short: rewrite the file without the partial record
+	if (ExistingSize > 0 && (ExistingSize < static_cast<int64>(sizeof(FHeader))
+		|| (ExistingSize - sizeof(FHeader)) % sizeof(FLLMMemoryRecord) != 0))
+	{
+		TArray<uint8> Bytes;
+		if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent) || Bytes.Num() < static_cast<int32>(sizeof(FHeader)))
+		{
+			return false;
+		}
+		Bytes.SetNum(sizeof(FHeader) + (Bytes.Num() - sizeof(FHeader)) / sizeof(FLLMMemoryRecord) * sizeof(FLLMMemoryRecord));
+		Bytes.Append(reinterpret_cast<const uint8*>(NewRecords.GetData()), RecordsSize);
+
+		const FString TempPath = Path + TEXT(".tmp");
+		return FFileHelper::SaveArrayToFile(Bytes, *TempPath) && FileManager.Move(*Path, *TempPath, true);
+	}
+
+	TUniquePtr<FArchive> Writer(FileManager.CreateFileWriter(*Path, FILEWRITE_Append | FILEWRITE_AllowRead));
+	if (!Writer)
+	{
+		return false;
+	}
+
+	if (ExistingSize <= 0)
+	{
+		FHeader Header = { FileMagic, FileVersion, FLLMMemoryRecord::Dim, sizeof(FLLMMemoryRecord) };
+		Writer->Serialize(&Header, sizeof(Header));
+	}
+	Writer->Serialize(const_cast<FLLMMemoryRecord*>(NewRecords.GetData()), RecordsSize);
+	return Writer->Close();
+}
+
+// Store
+
+ULLMMemoryStore* ULLMMemoryStore::Get(const UObject* WorldContext)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContext);
+	return GameInstance ? GameInstance->GetSubsystem<ULLMMemoryStore>() : nullptr;
+}
+
+void ULLMMemoryStore::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	LastFlushTime = FPlatformTime::Seconds();
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULLMMemoryStore::Tick), 1.0f);
+}
+
+void ULLMMemoryStore::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	Flush();
+	Owners.Reset();
+	Super::Deinitialize();
+}
+
+FString ULLMMemoryStore::GetMemoryPath(FName MemoryId)
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LLM"), TEXT("Memory"), FPaths::MakeValidFileName(MemoryId.ToString()) + TEXT(".mem"));
+}
+
+ULLMMemoryStore::FOwner& ULLMMemoryStore::GetOwner(FName MemoryId)
+{
+	FOwner& Owner = Owners.FindOrAdd(MemoryId);
+	if (!Owner.bOpened)
+	{
+		Owner.bOpened = true;
+		TSharedPtr<FLLMMemoryFile, ESPMode::ThreadSafe> File = MakeShared<FLLMMemoryFile, ESPMode::ThreadSafe>();
+		if (File->Open(GetMemoryPath(MemoryId)))
+		{
+			Owner.File = File;
+			++Stats.OpenFiles;
+		}
+	}
+	return Owner;
+}
+
+void ULLMMemoryStore::Remember(FName MemoryId, const FString& Fact)
+{
+	if (MemoryId.IsNone() || Fact.TrimStartAndEnd().IsEmpty())
+	{
+		return;
+	}
+
+	using namespace LLMMemoryStorePrivate;
+
+	// Pending facts, then the file newest first within the retrieval budget (a repeat is usually recent)
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	FOwner& Owner = GetOwner(MemoryId);
+	const FLLMMemoryRecord Record = FLLMMemoryRecord::Make(Fact);
+	const double Deadline = FPlatformTime::Seconds() + Settings->MemoryRetrievalBudgetMs / 1000.0;
+	TArray<FMatch> Duplicate;
+	Scan(Owner.Pending, Record, 1, DuplicateSimilarity, Deadline, Duplicate);
+	if (Duplicate.Num() == 0 && Owner.File.IsValid())
+	{
+		Scan(Owner.File->GetRecords(), Record, 1, DuplicateSimilarity, Deadline, Duplicate);
+	}
+	if (Duplicate.Num() > 0)
+	{
+		++Stats.Duplicates;
+		return;
+	}
+
+	Owner.Pending.Add(Record);
+	++Stats.Inserts;
+
+	if (Owner.Pending.Num() >= Settings->MemoryFlushPendingCount)
+	{
+		FlushOwner(MemoryId, Owner);
+	}
+}
+
+bool ULLMMemoryStore::Tick(float DeltaTime)
+{
+	const float Interval = GetDefault<ULLMSettings>()->MemoryFlushIntervalSeconds;
+	const double Now = FPlatformTime::Seconds();
+	if (Interval > 0.0f && Now - LastFlushTime >= Interval)
+	{
+		Flush();
+	}
+	return true;
+}
+
+void ULLMMemoryStore::RetrieveAsync(FName MemoryId, const FString& Query, FOnLLMMemoriesRetrieved OnComplete)
+{
+	using namespace LLMMemoryStorePrivate;
+
+	const FOwner& Owner = GetOwner(MemoryId);
+	if (!Owner.File.IsValid() && Owner.Pending.Num() == 0)
+	{
+		OnComplete.ExecuteIfBound(TArray<FString>());
+		return;
+	}
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	const int32 K = FMath::Max(1, Settings->MemoryTopK);
+	const float MinSimilarity = Settings->MemoryMinSimilarity;
+	const double Budget = Settings->MemoryRetrievalBudgetMs / 1000.0;
+
+	TWeakObjectPtr<ULLMMemoryStore> WeakThis(this);
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+		[WeakThis, File = Owner.File, Pending = Owner.Pending, Query, OnComplete, K, MinSimilarity, Budget]()
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		const double Deadline = StartTime + Budget;
+		const FLLMMemoryRecord QueryRecord = FLLMMemoryRecord::Make(Query);
+
+		// This session's facts, then the file from newest to oldest
+		TArray<FMatch> Best;
+		bool bCompleted = Scan(Pending, QueryRecord, K, MinSimilarity, Deadline, Best);
+		if (bCompleted && File.IsValid())
+		{
+			bCompleted = Scan(File->GetRecords(), QueryRecord, K, MinSimilarity, Deadline, Best);
+		}
+
+		TArray<FString> Memories;
+		for (const FMatch& Match : Best)
+		{
+			Memories.Add(Match.Record->GetText());
+		}
+		const double Seconds = FPlatformTime::Seconds() - StartTime;
+
+		AsyncTask(ENamedThreads::GameThread, [WeakThis, OnComplete, Memories = MoveTemp(Memories), bCompleted, Seconds]()
+		{
+			if (ULLMMemoryStore* This = WeakThis.Get())
+			{
+				++This->Stats.Retrievals;
+				This->Stats.TimedOut += bCompleted ? 0 : 1;
+				This->Stats.Retrieved += Memories.Num();
+				This->Stats.RetrievalSeconds += Seconds;
+			}
+			OnComplete.ExecuteIfBound(Memories);
+		});
+	});
+}
+
+void ULLMMemoryStore::Flush()
+{
+	LastFlushTime = FPlatformTime::Seconds();
+	for (TPair<FName, FOwner>& Pair : Owners)
+	{
+		FlushOwner(Pair.Key, Pair.Value);
+	}
+}
+
+void ULLMMemoryStore::FlushOwner(FName MemoryId, FOwner& Owner)
+{
+	if (Owner.Pending.Num() == 0)
+	{
+		return;
+	}
+
+	// Unmap before writing (some platforms refuse to write a mapped file); retrievals
+	// still scanning the old mapping keep it alive until they finish
+	const FString Path = GetMemoryPath(MemoryId);
+	const bool bWasOpen = Owner.File.IsValid();
+	Owner.File.Reset();
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+	if (FLLMMemoryFile::Append(Path, Owner.Pending))
+	{
+		Owner.Pending.Reset();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMMemoryStore] Failed to append to %s"), *Path);
+	}
+
+	TSharedPtr<FLLMMemoryFile, ESPMode::ThreadSafe> File = MakeShared<FLLMMemoryFile, ESPMode::ThreadSafe>();
+	if (File->Open(Path))
+	{
+		Owner.File = File;
+		Stats.OpenFiles += bWasOpen ? 0 : 1;
+	}
+	Owner.bOpened = true;
+}
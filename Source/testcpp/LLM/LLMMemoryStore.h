@@ -0,0 +1,158 @@
+// Long-term NPC memory: embedded facts in per-owner append-only files, retrieved on a worker thread
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "LLMMemoryStore.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * One remembered fact as stored on disk: an int8-quantized FLLMSemanticIndex embedding and
+ * the UTF-8 text, in a fixed 512-byte record so files are scanned in place
+ */
+struct FLLMMemoryRecord
+{
+	static constexpr int32 Dim = 256;
+	static constexpr int32 MaxTextBytes = 244;
+
+	// Dequantization factor of Vector
+	float Scale = 0.0f;
+	// Unix time the fact was remembered
+	uint32 Time = 0;
+	uint16 TextBytes = 0;
+	uint16 Reserved = 0;
+	int8 Vector[Dim] = {};
+	ANSICHAR Text[MaxTextBytes] = {};
+
+	/** Embed and quantize a fact; text beyond MaxTextBytes is cut */
+	static FLLMMemoryRecord Make(const FString& Fact);
+
+	FString GetText() const;
+};
+
+/**
+ * Read-only view of a memory file (header, then records appended in time order)
+ * The file is memory-mapped, so opening it reads nothing but the header; a trailing partial
+ * record left by an interrupted append is ignored.
+ */
+class TESTCPP_API FLLMMemoryFile
+{
+public:
+	FLLMMemoryFile();
+	~FLLMMemoryFile();
+
+	bool Open(const FString& Path);
+
+	TConstArrayView<FLLMMemoryRecord> GetRecords() const { return Records; }
+
+	/** Append records, writing the header first for a new file */
+	static bool Append(const FString& Path, TConstArrayView<FLLMMemoryRecord> NewRecords);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	// Fallback storage when the file cannot be mapped
+	TArray<uint8> Bytes;
+
+	TConstArrayView<FLLMMemoryRecord> Records;
+};
+
+DECLARE_DELEGATE_OneParam(FOnLLMMemoriesRetrieved, const TArray<FString>& /*Memories*/);
+
+/**
+ * Counters for long-term memory
+ */
+USTRUCT(BlueprintType)
+struct FLLMMemoryStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	int32 Retrievals = 0;
+
+	// Retrievals that hit MemoryRetrievalBudgetMs and returned the best matches scanned so far
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	int32 TimedOut = 0;
+
+	// Memories returned across all retrievals
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	int32 Retrieved = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	double RetrievalSeconds = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	int32 Inserts = 0;
+
+	// Facts not stored because a near-duplicate was already remembered (this session or on disk)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	int32 Duplicates = 0;
+
+	// Memory files mapped so far (opened on an owner's first use)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Memory")
+	int32 OpenFiles = 0;
+};
+
+/**
+ * Episodic memory of NPCs across sessions
+ * Each memory owner (ULLMAgentComponent::GetMemoryId; agents may share one, e.g. per persona)
+ * has its own file under Saved/LLM/Memory/. Files are mapped on the owner's first retrieval,
+ * so hundreds of NPCs cost nothing until they speak. New facts are kept in memory and appended
+ * once an owner has MemoryFlushPendingCount of them, every MemoryFlushIntervalSeconds, and on
+ * Flush or shutdown. Near-duplicates of pending facts or of the owner's file are not stored. Retrieval embeds the query and scans the owner's records on a worker
+ * thread, stopping at MemoryRetrievalBudgetMs with the best matches found so far.
+ */
+UCLASS()
+class TESTCPP_API ULLMMemoryStore : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMMemoryStore* Get(const UObject* WorldContext);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Remember a fact; near-duplicates of facts already remembered (this session or on disk) are skipped */
+	void Remember(FName MemoryId, const FString& Fact);
+
+	/**
+	 * Find the memories most relevant to a query
+	 * @param OnComplete - Called on the game thread with up to MemoryTopK facts, most relevant first
+	 */
+	void RetrieveAsync(FName MemoryId, const FString& Query, FOnLLMMemoriesRetrieved OnComplete);
+
+	/** Append all new facts to their files */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Memory")
+	void Flush();
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Memory")
+	FLLMMemoryStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|Memory")
+	void ResetStats() { Stats = FLLMMemoryStats(); }
+
+	static FString GetMemoryPath(FName MemoryId);
+
+private:
+	struct FOwner
+	{
+		// Shared with retrievals in flight, which keep an old mapping alive across a Flush
+		TSharedPtr<FLLMMemoryFile, ESPMode::ThreadSafe> File;
+		TArray<FLLMMemoryRecord> Pending;
+		bool bOpened = false;
+	};
+
+	FOwner& GetOwner(FName MemoryId);
+	void FlushOwner(FName MemoryId, FOwner& Owner);
+	bool Tick(float DeltaTime);
+
+	FTSTicker::FDelegateHandle TickHandle;
+	double LastFlushTime = 0.0;
+
+	TMap<FName, FOwner> Owners;
+	FLLMMemoryStats Stats;
+};
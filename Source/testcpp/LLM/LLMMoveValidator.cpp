@@ -0,0 +1,301 @@
+// Navmesh reachability check for LLM MoveTo targets before they reach the blackboard
+#include "LLM/LLMMoveValidator.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "NavigationSystem.h"
+#include "NavFilters/NavigationQueryFilter.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMMoveValidatorPrivate
+{
+	static constexpr float TickInterval = 0.25f;
+
+	// The search ran (found a path or proved there is none); an error or invalid query says nothing about the target
+	static bool IsSearchResult(ENavigationQueryResult::Type Result)
+	{
+		return Result == ENavigationQueryResult::Success || Result == ENavigationQueryResult::Fail;
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMMoveValidator* Validator = ULLMMoveValidator::Get(World);
+		if (!Validator)
+		{
+			return;
+		}
+
+		const FLLMMoveValidationStats Stats = Validator->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMMoveValidator] %d requests, %d targets | %d off the navmesh, %d unreachable | %d pathfound synchronously, %d timed out | %.2f ms avg latency"),
+			Stats.Requests, Stats.Checked, Stats.OffNavMesh, Stats.Unreachable, Stats.SyncFallbacks, Stats.TimedOut,
+			Stats.Requests > 0 ? Stats.LatencySeconds * 1000.0 / Stats.Requests : 0.0);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.MoveValidationStats"),
+		TEXT("Log how many LLM MoveTo targets were rejected before reaching the blackboard"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMMoveValidator* ULLMMoveValidator::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMMoveValidator>() : nullptr;
+}
+
+void ULLMMoveValidator::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULLMMoveValidator::Tick),
+		LLMMoveValidatorPrivate::TickInterval);
+}
+
+void ULLMMoveValidator::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+
+	// Queries die with the navigation system; answer their requests rather than leave them waiting
+	TArray<int32> Pending;
+	Requests.GetKeys(Pending);
+	for (int32 RequestId : Pending)
+	{
+		Expire(RequestId);
+	}
+	Super::Deinitialize();
+}
+
+void ULLMMoveValidator::ValidateAsync(const AActor* Agent, const TArray<FVector>& Targets, FOnLLMMovesValidated OnDone)
+{
+	if (const AController* Controller = Cast<AController>(Agent))
+	{
+		Agent = Controller->GetPawn();
+	}
+
+	const int32 RequestId = NextRequestId++;
+	FRequest& Request = Requests.Add(RequestId);
+	Request.OnDone = MoveTemp(OnDone);
+	Request.StartTime = FPlatformTime::Seconds();
+	Request.Checks.SetNum(Targets.Num());
+	for (int32 Index = 0; Index < Targets.Num(); ++Index)
+	{
+		Request.Checks[Index].Target = Targets[Index];
+		Request.Checks[Index].Projected = Targets[Index];
+	}
+
+	// Without a pawn or navmesh nothing can be checked: report every target as reachable
+	const APawn* Pawn = Cast<APawn>(Agent);
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const FNavAgentProperties& AgentProps = Pawn ? Pawn->GetNavAgentPropertiesRef() : FNavAgentProperties::DefaultProperties;
+	const ANavigationData* NavData = NavSys && Pawn ? NavSys->GetNavDataForProps(AgentProps, Pawn->GetActorLocation()) : nullptr;
+	if (!NavData)
+	{
+		for (FLLMMoveCheck& Check : Request.Checks)
+		{
+			Check.bOnNavMesh = true;
+			Check.bReachable = true;
+		}
+		Complete(RequestId);
+		return;
+	}
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	const FVector Extent = Settings->MoveProjectionExtent;
+	ULLMPathCache* PathCache = Settings->bCachePaths ? GetWorld()->GetSubsystem<ULLMPathCache>() : nullptr;
+	const FSharedConstNavQueryFilter Filter = UNavigationQueryFilter::GetQueryFilter(*NavData, Pawn, nullptr);
+	FVector Start = Pawn->GetNavAgentLocation();
+	for (int32 Index = 0; Index < Request.Checks.Num(); ++Index)
+	{
+		FLLMMoveCheck& Check = Request.Checks[Index];
+		++Stats.Checked;
+
+		FNavLocation Projected;
+		if (!NavSys->ProjectPointToNavigation(Check.Target, Projected, Extent, NavData, Filter))
+		{
+			++Stats.OffNavMesh;
+			continue;
+		}
+		Check.bOnNavMesh = true;
+		Check.Projected = Projected.Location;
+
+		const TPair<int32, int32> Waiter(RequestId, Index);
+		const FVector PathStart = Start;
+		Start = Check.Projected;
+
+		FLLMPathKey Key;
+		if (PathCache)
+		{
+			Key = ULLMPathCache::MakeKey(*NavData, PathStart, Check.Projected);
+			if (PathCache->Find(Key))
+			{
+				Check.bReachable = true;
+				continue;
+			}
+			if (PathCache->IsKnownUnreachable(Key))
+			{
+				++Stats.Unreachable;
+				continue;
+			}
+			if (const uint32* InFlight = QueriesByKey.Find(Key))
+			{
+				Queries[*InFlight].Waiters.Add(Waiter);
+				PathCache->NotifyJoined();
+				++Request.Remaining;
+				continue;
+			}
+		}
+
+		// Batched with every other async query of this frame and run on a worker thread
+		FPathFindingQuery Query(Pawn, *NavData, PathStart, Check.Projected, Filter);
+		Query.SetAllowPartialPaths(false);
+		const uint32 QueryId = NavSys->FindPathAsync(AgentProps, Query,
+			FNavPathQueryDelegate::CreateUObject(this, &ULLMMoveValidator::OnPathFound), EPathFindingMode::Regular);
+		if (QueryId == INVALID_NAVQUERYID)
+		{
+			// Not queued (e.g. async pathfinding is unavailable): answer this target here instead
+			const FPathFindingResult Found = NavSys->FindPathSync(AgentProps, Query, EPathFindingMode::Regular);
+			Check.bReachable = Found.IsSuccessful() && Found.Path.IsValid() && !Found.Path->IsPartial();
+			++Stats.SyncFallbacks;
+			if (!Check.bReachable)
+			{
+				++Stats.Unreachable;
+			}
+			if (PathCache && Check.bReachable)
+			{
+				PathCache->Add(Key, Found.Path);
+			}
+			else if (PathCache && LLMMoveValidatorPrivate::IsSearchResult(Found.Result))
+			{
+				PathCache->AddUnreachable(Key);
+			}
+		}
+		else
+		{
+			FQuery& Pending = Queries.Add(QueryId);
+			Pending.Key = Key;
+			Pending.bCacheable = PathCache != nullptr;
+			Pending.Waiters.Add(Waiter);
+			if (Pending.bCacheable)
+			{
+				QueriesByKey.Add(Key, QueryId);
+			}
+			++Request.Remaining;
+		}
+	}
+
+	if (Request.Remaining == 0)
+	{
+		Complete(RequestId);
+	}
+}
+
+void ULLMMoveValidator::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	FQuery Query;
+	if (!Queries.RemoveAndCopyValue(QueryId, Query))
+	{
+		return;
+	}
+
+	const bool bReachable = Result == ENavigationQueryResult::Success && Path.IsValid() && !Path->IsPartial();
+	if (Query.bCacheable)
+	{
+		QueriesByKey.Remove(Query.Key);
+		ULLMPathCache* PathCache = GetWorld()->GetSubsystem<ULLMPathCache>();
+		if (PathCache && bReachable)
+		{
+			PathCache->Add(Query.Key, Path);
+		}
+		else if (PathCache && LLMMoveValidatorPrivate::IsSearchResult(Result))
+		{
+			PathCache->AddUnreachable(Query.Key);
+		}
+	}
+
+	for (const TPair<int32, int32>& Target : Query.Waiters)
+	{
+		FRequest* Request = Requests.Find(Target.Key);
+		if (!Request)
+		{
+			continue;
+		}
+
+		Request->Checks[Target.Value].bReachable = bReachable;
+		if (!bReachable)
+		{
+			++Stats.Unreachable;
+		}
+
+		if (--Request->Remaining == 0)
+		{
+			Complete(Target.Key);
+		}
+	}
+}
+
+void ULLMMoveValidator::Complete(int32 RequestId)
+{
+	FRequest Request;
+	if (!Requests.RemoveAndCopyValue(RequestId, Request))
+	{
+		return;
+	}
+
+	++Stats.Requests;
+	Stats.LatencySeconds += FPlatformTime::Seconds() - Request.StartTime;
+	Request.OnDone.ExecuteIfBound(Request.Checks);
+}
+
+void ULLMMoveValidator::Expire(int32 RequestId)
+{
+	FRequest* Request = Requests.Find(RequestId);
+	if (!Request)
+	{
+		return;
+	}
+
+	// Detach the request from its queries; a query nobody waits for any more is forgotten, so its late answer is ignored
+	for (auto It = Queries.CreateIterator(); It; ++It)
+	{
+		FQuery& Query = It.Value();
+		for (int32 Index = Query.Waiters.Num() - 1; Index >= 0; --Index)
+		{
+			if (Query.Waiters[Index].Key == RequestId)
+			{
+				Request->Checks[Query.Waiters[Index].Value].bReachable = true;
+				Query.Waiters.RemoveAtSwap(Index);
+				++Stats.TimedOut;
+			}
+		}
+		if (Query.Waiters.Num() == 0)
+		{
+			if (Query.bCacheable)
+			{
+				QueriesByKey.Remove(Query.Key);
+			}
+			It.RemoveCurrent();
+		}
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("[LLMMoveValidator] Path queries of request %d did not answer; accepting its targets unchecked"), RequestId);
+	Complete(RequestId);
+}
+
+bool ULLMMoveValidator::Tick(float DeltaTime)
+{
+	const double Deadline = FPlatformTime::Seconds() - GetDefault<ULLMSettings>()->MoveValidationTimeoutSeconds;
+	TArray<int32, TInlineAllocator<4>> Expired;
+	for (const TPair<int32, FRequest>& Pair : Requests)
+	{
+		if (Pair.Value.StartTime < Deadline)
+		{
+			Expired.Add(Pair.Key);
+		}
+	}
+	for (int32 RequestId : Expired)
+	{
+		Expire(RequestId);
+	}
+	return true;
+}
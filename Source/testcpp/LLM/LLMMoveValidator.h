@@ -0,0 +1,130 @@
+// Navmesh reachability check for LLM MoveTo targets before they reach the blackboard
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/Ticker.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "LLM/LLMPathCache.h"
+#include "LLMMoveValidator.generated.h"
+
+/**
+ * Result for one MoveTo target
+ */
+struct FLLMMoveCheck
+{
+	FVector Target = FVector::ZeroVector;
+	// Target moved onto the navmesh (Target when it was not on it)
+	FVector Projected = FVector::ZeroVector;
+	bool bOnNavMesh = false;
+	bool bReachable = false;
+};
+
+DECLARE_DELEGATE_OneParam(FOnLLMMovesValidated, const TArray<FLLMMoveCheck>& /*Checks*/);
+
+/**
+ * Counters for MoveTo validation
+ */
+USTRUCT(BlueprintType)
+struct FLLMMoveValidationStats
+{
+	GENERATED_BODY()
+
+	// Targets checked
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	int32 Checked = 0;
+
+	// Targets with no navmesh within MoveProjectionExtent
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	int32 OffNavMesh = 0;
+
+	// Targets on the navmesh that no full path reaches
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	int32 Unreachable = 0;
+
+	// Targets pathfound on the game thread because the navigation system refused the async query
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	int32 SyncFallbacks = 0;
+
+	// Targets whose query did not answer within MoveValidationTimeoutSeconds (accepted unchecked)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	int32 TimedOut = 0;
+
+	// Total time from request to result, game thread and workers
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	double LatencySeconds = 0.0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|MoveValidation")
+	int32 Requests = 0;
+};
+
+/**
+ * Checks that MoveTo targets can be reached before a plan is written to the blackboard
+ * Targets are projected onto the agent's navmesh on the game thread (a cheap query), then one
+ * async path query per target goes to the navigation system, which batches the queries of every
+ * agent issued in a frame and runs them on a worker thread. Targets of one plan are chained:
+ * each path starts where the previous MoveTo ends. The callback fires on the game thread once
+ * every query of the request has answered; a query the navigation system refuses is run
+ * synchronously instead, and targets still unanswered after MoveValidationTimeoutSeconds (or when
+ * the world goes away) are accepted unchecked, so every request completes. With bCachePaths, ULLMPathCache answers targets recently
+ * reached from the same cell, and a target already being queried from that cell waits for the
+ * query in flight instead of issuing another.
+ */
+UCLASS()
+class TESTCPP_API ULLMMoveValidator : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMMoveValidator* Get(const UObject* WorldContext);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Check a plan's MoveTo targets
+	 * @param Agent - Pawn (or its controller) that will move; its nav agent properties pick the navmesh
+	 * @param Targets - MoveTo targets in plan order
+	 * @param OnDone - Called with one check per target; immediately when there is nothing to query
+	 */
+	void ValidateAsync(const AActor* Agent, const TArray<FVector>& Targets, FOnLLMMovesValidated OnDone);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|MoveValidation")
+	FLLMMoveValidationStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|MoveValidation")
+	void ResetStats() { Stats = FLLMMoveValidationStats(); }
+
+private:
+	struct FRequest
+	{
+		TArray<FLLMMoveCheck> Checks;
+		FOnLLMMovesValidated OnDone;
+		int32 Remaining = 0;
+		double StartTime = 0.0;
+	};
+
+	struct FQuery
+	{
+		FLLMPathKey Key;
+		bool bCacheable = false;
+		// (request, target index) of every target answered by this query
+		TArray<TPair<int32, int32>, TInlineAllocator<1>> Waiters;
+	};
+
+	void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+	void Complete(int32 RequestId);
+	// Accept the request's unanswered targets unchecked and complete it
+	void Expire(int32 RequestId);
+	bool Tick(float DeltaTime);
+
+	FTSTicker::FDelegateHandle TickHandle;
+
+	TMap<int32, FRequest> Requests;
+	TMap<uint32, FQuery> Queries;
+	// Cacheable queries in flight, for joining
+	TMap<FLLMPathKey, uint32> QueriesByKey;
+	int32 NextRequestId = 1;
+
+	FLLMMoveValidationStats Stats;
+};
@@ -0,0 +1,42 @@
+// Named navigation point the LLM can send agents to
+#include "LLM/LLMNavPointComponent.h"
+#include "LLM/LLMNavPointRegistry.h"
+#include "GameFramework/Actor.h"
+
+void ULLMNavPointComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (ULLMNavPointRegistry* Registry = ULLMNavPointRegistry::Get(this))
+	{
+		Registry->Register(this);
+	}
+}
+
+void ULLMNavPointComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ULLMNavPointRegistry* Registry = ULLMNavPointRegistry::Get(this))
+	{
+		Registry->Unregister(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+FString ULLMNavPointComponent::GetPointName() const
+{
+	if (!PointName.IsEmpty())
+	{
+		return PointName;
+	}
+	// Not the actor label: labels do not exist in cooked builds
+	return GetOwner() ? GetOwner()->GetName() : FString();
+}
+
+void ULLMNavPointComponent::Refresh()
+{
+	if (ULLMNavPointRegistry* Registry = HasBegunPlay() ? ULLMNavPointRegistry::Get(this) : nullptr)
+	{
+		Registry->Register(this);
+	}
+}
@@ -0,0 +1,41 @@
+// Named navigation point the LLM can send agents to
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SceneComponent.h"
+#include "LLMNavPointComponent.generated.h"
+
+/**
+ * Marks a location MoveTo actions can name ("go to the fountain")
+ * Registers with ULLMNavPointRegistry (and the world vocabulary) on BeginPlay and unregisters
+ * on EndPlay, so points in streamed levels come and go with their level.
+ */
+UCLASS(ClassGroup = (AI), meta = (BlueprintSpawnableComponent))
+class TESTCPP_API ULLMNavPointComponent : public USceneComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Point name: PointName, or the owning actor's name when empty */
+	FString GetPointName() const;
+
+	/** Re-register after moving the point or changing its names */
+	UFUNCTION(BlueprintCallable, Category = "LLM|NavPoint")
+	void Refresh();
+
+public:
+	// Name the LLM uses (case-insensitive); empty uses the owning actor's name
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LLM|NavPoint")
+	FString PointName;
+
+	// Other names that resolve to this point ("well" for "Fountain")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LLM|NavPoint")
+	TArray<FString> Aliases;
+
+	// Kind of place, for nearest-of-category queries (e.g. "Cover", "Shop", "Bench")
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "LLM|NavPoint")
+	FName Category;
+};
@@ -0,0 +1,223 @@
+// Hashed, spatially indexed registry of named navigation points
+#include "LLM/LLMNavPointRegistry.h"
+#include "LLM/LLMNavPointComponent.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "NavigationSystem.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMNavPointRegistryPrivate
+{
+	static double GetCellSize()
+	{
+		return FMath::Max(100.0f, GetDefault<ULLMSettings>()->NavPointGridCellSize);
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMNavPointRegistry* Registry = ULLMNavPointRegistry::Get(World);
+		if (!Registry)
+		{
+			return;
+		}
+
+		const FLLMNavPointStats Stats = Registry->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMNavPointRegistry] %d points | %d names resolved, %d unresolved | %d nearest queries | %d projected, %d off the navmesh"),
+			Registry->GetPointCount(), Stats.Resolved, Stats.Unresolved, Stats.NearestQueries, Stats.Projections, Stats.ProjectionFailures);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.NavPointStats"),
+		TEXT("Log nav point registry size and lookup counts"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMNavPointRegistry* ULLMNavPointRegistry::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMNavPointRegistry>() : nullptr;
+}
+
+FIntPoint ULLMNavPointRegistry::GetCell(const FVector& Location) const
+{
+	return FLLMSpatialGrid::GetCell(Location, LLMNavPointRegistryPrivate::GetCellSize());
+}
+
+void ULLMNavPointRegistry::Register(ULLMNavPointComponent* Point)
+{
+	if (!Point)
+	{
+		return;
+	}
+
+	// Re-registering (moved or renamed) replaces the old entry
+	if (const int32* Existing = PointIndices.Find(Point))
+	{
+		RemovePoint(*Existing);
+	}
+
+	FPoint Entry;
+	Entry.Component = Point;
+	Entry.Key = Point;
+	Entry.Category = Point->Category;
+	Entry.Location = Point->GetComponentLocation();
+	Entry.Cell = GetCell(Entry.Location);
+	Entry.Names.Add(Point->GetPointName());
+	for (const FString& Alias : Point->Aliases)
+	{
+		if (!Entry.Names.ContainsByPredicate([&Alias](const FString& Name) { return Name.Equals(Alias, ESearchCase::IgnoreCase); }))
+		{
+			Entry.Names.Add(Alias);
+		}
+	}
+	Entry.Names.RemoveAll([](const FString& Name) { return Name.IsEmpty(); });
+	if (Entry.Names.Num() == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMNavPointRegistry] Nav point on %s has no name"), *GetNameSafe(Point->GetOwner()));
+		return;
+	}
+
+	const int32 Index = Points.Add(MoveTemp(Entry));
+	PointIndices.Add(Point, Index);
+
+	const FPoint& Added = Points[Index];
+	ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(this);
+	for (const FString& Name : Added.Names)
+	{
+		NameIndex.FindOrAdd(Name).Add(Index);
+		if (Vocabulary)
+		{
+			Vocabulary->RegisterName(ELLMVocabularyCategory::NavPoint, Name);
+		}
+	}
+
+	if (!Added.Category.IsNone())
+	{
+		CategoryGrids.FindOrAdd(Added.Category).Add(Added.Cell, Index);
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("[LLMNavPointRegistry] Registered '%s' (%d names, category %s)"),
+		*Added.Names[0], Added.Names.Num(), *Added.Category.ToString());
+}
+
+void ULLMNavPointRegistry::Unregister(ULLMNavPointComponent* Point)
+{
+	if (const int32* Index = PointIndices.Find(Point))
+	{
+		RemovePoint(*Index);
+	}
+}
+
+void ULLMNavPointRegistry::RemovePoint(int32 Index)
+{
+	const FPoint& Point = Points[Index];
+
+	ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(this);
+	for (const FString& Name : Point.Names)
+	{
+		if (TArray<int32, TInlineAllocator<1>>* Indices = NameIndex.Find(Name))
+		{
+			Indices->RemoveSingleSwap(Index);
+			if (Indices->Num() == 0)
+			{
+				NameIndex.Remove(Name);
+			}
+		}
+		if (Vocabulary)
+		{
+			Vocabulary->UnregisterName(ELLMVocabularyCategory::NavPoint, Name);
+		}
+	}
+
+	if (FLLMSpatialGrid* Grid = Point.Category.IsNone() ? nullptr : CategoryGrids.Find(Point.Category))
+	{
+		Grid->Remove(Point.Cell, Index);
+	}
+
+	PointIndices.Remove(Point.Key);
+	Points.RemoveAt(Index);
+}
+
+const FVector& ULLMNavPointRegistry::GetNavLocation(FPoint& Point)
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	if (Point.bProjected || !Settings->bProjectNavPoints)
+	{
+		return Point.Location;
+	}
+
+	// No navigation system yet (e.g. still loading): use the placed location and try again next time
+	UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!NavSys)
+	{
+		return Point.Location;
+	}
+
+	FNavLocation Projected;
+	if (NavSys->ProjectPointToNavigation(Point.Location, Projected, Settings->NavPointProjectionExtent))
+	{
+		Point.Location = Projected.Location;
+		++Stats.Projections;
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMNavPointRegistry] '%s' is not near the navmesh; using its placed location"), *Point.Names[0]);
+		++Stats.ProjectionFailures;
+	}
+	Point.bProjected = true;
+	return Point.Location;
+}
+
+bool ULLMNavPointRegistry::ResolveName(const FString& Name, const FVector& Origin, FVector& OutLocation)
+{
+	const TArray<int32, TInlineAllocator<1>>* Indices = NameIndex.Find(Name);
+	if (!Indices)
+	{
+		++Stats.Unresolved;
+		return false;
+	}
+
+	int32 Best = (*Indices)[0];
+	for (int32 Candidate = 1; Candidate < Indices->Num(); ++Candidate)
+	{
+		const int32 Index = (*Indices)[Candidate];
+		if (FVector::DistSquared(Points[Index].Location, Origin) < FVector::DistSquared(Points[Best].Location, Origin))
+		{
+			Best = Index;
+		}
+	}
+
+	OutLocation = GetNavLocation(Points[Best]);
+	++Stats.Resolved;
+	return true;
+}
+
+bool ULLMNavPointRegistry::FindNearest(FName Category, const FVector& Origin, float MaxDistance, FVector& OutLocation, FString& OutName)
+{
+	++Stats.NearestQueries;
+
+	const FLLMSpatialGrid* Grid = CategoryGrids.Find(Category);
+	if (!Grid)
+	{
+		return false;
+	}
+
+	TArray<int32> Nearest;
+	Grid->FindNearest(Origin, LLMNavPointRegistryPrivate::GetCellSize(), MaxDistance, 1,
+		[this](int32 Index, FVector& OutLocation)
+		{
+			OutLocation = Points[Index].Location;
+			return true;
+		}, Nearest);
+	if (Nearest.Num() == 0)
+	{
+		return false;
+	}
+
+	FPoint& Best = Points[Nearest[0]];
+	OutName = Best.Names[0];
+	OutLocation = GetNavLocation(Best);
+	return true;
+}
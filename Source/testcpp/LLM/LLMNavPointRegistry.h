@@ -0,0 +1,111 @@
+// Hashed, spatially indexed registry of named navigation points
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "LLM/LLMSpatialGrid.h"
+#include "LLMNavPointRegistry.generated.h"
+
+class ULLMNavPointComponent;
+
+/**
+ * Counters for the nav point registry
+ */
+USTRUCT(BlueprintType)
+struct FLLMNavPointStats
+{
+	GENERATED_BODY()
+
+	// Names resolved to a location
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|NavPoint")
+	int32 Resolved = 0;
+
+	// Names no registered point answers to
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|NavPoint")
+	int32 Unresolved = 0;
+
+	// Points projected onto the navmesh (once per point, on first use)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|NavPoint")
+	int32 Projections = 0;
+
+	// Points left at their placed location because no navmesh was found near them
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|NavPoint")
+	int32 ProjectionFailures = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|NavPoint")
+	int32 NearestQueries = 0;
+};
+
+/**
+ * Named places MoveTo actions can refer to
+ * ULLMNavPointComponent registers itself on BeginPlay and leaves on EndPlay, so the registry
+ * follows level streaming without scanning. Names and aliases are hashed case-insensitively for
+ * constant-time lookup and also registered with the world vocabulary so the response schema
+ * only offers names that exist. Each point is projected onto the navmesh the first time it is
+ * used and the result is kept. Points are also bucketed by category in an FLLMSpatialGrid of
+ * NavPointGridCellSize cells for nearest-of-category queries.
+ */
+UCLASS()
+class TESTCPP_API ULLMNavPointRegistry : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMNavPointRegistry* Get(const UObject* WorldContext);
+
+	/** Add a point, or update it when already registered */
+	void Register(ULLMNavPointComponent* Point);
+	void Unregister(ULLMNavPointComponent* Point);
+
+	/**
+	 * Location of a named point, on the navmesh when one is near it
+	 * @param Name - Point name or alias (case-insensitive)
+	 * @param Origin - Where the agent is; picks the nearest when several points share the name
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|NavPoint")
+	bool ResolveName(const FString& Name, const FVector& Origin, FVector& OutLocation);
+
+	/**
+	 * Nearest point of a category
+	 * @param MaxDistance - Search radius (cm); 0 searches every registered point of the category
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|NavPoint")
+	bool FindNearest(FName Category, const FVector& Origin, float MaxDistance, FVector& OutLocation, FString& OutName);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|NavPoint")
+	int32 GetPointCount() const { return Points.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|NavPoint")
+	FLLMNavPointStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|NavPoint")
+	void ResetStats() { Stats = FLLMNavPointStats(); }
+
+private:
+	struct FPoint
+	{
+		TWeakObjectPtr<ULLMNavPointComponent> Component;
+		TObjectKey<ULLMNavPointComponent> Key;
+		// Primary name first, then aliases
+		TArray<FString> Names;
+		FName Category;
+		FVector Location = FVector::ZeroVector;
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		bool bProjected = false;
+	};
+
+	void RemovePoint(int32 Index);
+	FIntPoint GetCell(const FVector& Location) const;
+
+	// Location of a point, projecting it onto the navmesh on first use
+	const FVector& GetNavLocation(FPoint& Point);
+
+	TSparseArray<FPoint> Points;
+	TMap<TObjectKey<ULLMNavPointComponent>, int32> PointIndices;
+	// Name or alias -> points; FString keys hash and compare case-insensitively
+	TMap<FString, TArray<int32, TInlineAllocator<1>>> NameIndex;
+	TMap<FName, FLLMSpatialGrid> CategoryGrids;
+
+	FLLMNavPointStats Stats;
+};
@@ -0,0 +1,128 @@
+// Output token caps learned from how long answers actually are
+#include "LLM/LLMOutputBudget.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace LLMOutputBudgetPrivate
+{
+	// Lengths kept per key; old answers age out so caps follow prompt changes
+	static constexpr int32 MaxSamplesPerKey = 256;
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMOutputBudget* Budget = ULLMOutputBudget::Get(World);
+		if (!Budget)
+		{
+			return;
+		}
+
+		const FLLMOutputBudgetStats Stats = Budget->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMOutputBudget] %d samples | %d capped requests | %d truncated, %d retried, %d recovered"),
+			Stats.Samples, Stats.CappedRequests, Stats.Truncations, Stats.Retries, Stats.RetriesRecovered);
+		Budget->LogDistributions();
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.OutputBudgetStats"),
+		TEXT("Log learned output token caps and truncation counts"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMOutputBudget* ULLMOutputBudget::Get(const UObject* WorldContext)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContext);
+	return GameInstance ? GameInstance->GetSubsystem<ULLMOutputBudget>() : nullptr;
+}
+
+void ULLMOutputBudget::FLengths::Add(int32 Tokens)
+{
+	if (Samples.Num() < LLMOutputBudgetPrivate::MaxSamplesPerKey)
+	{
+		Samples.Add(Tokens);
+		return;
+	}
+	Samples[Next] = Tokens;
+	Next = (Next + 1) % Samples.Num();
+}
+
+int32 ULLMOutputBudget::FLengths::Percentile(float Fraction) const
+{
+	TArray<int32> Sorted = Samples;
+	Sorted.Sort();
+	return Sorted[FMath::Clamp(FMath::CeilToInt32(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1)];
+}
+
+int32 ULLMOutputBudget::GetOutputCap(FName PersonaId, const FGameplayTag& Intent, int32 MaxOutputTokens) const
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+
+	// Most specific distribution first; a persona or intent that is unknown falls back to the wider ones
+	const FKey Keys[] = {
+		FKey(PersonaId, Intent),
+		FKey(NAME_None, Intent),
+		FKey(PersonaId, FGameplayTag()),
+		FKey(NAME_None, FGameplayTag()) };
+	for (const FKey& Key : Keys)
+	{
+		const FLengths* Lengths = Distributions.Find(Key);
+		if (Lengths && Lengths->Samples.Num() >= Settings->OutputCapMinSamples)
+		{
+			const int32 Cap = FMath::CeilToInt32(Lengths->Percentile(0.99f) * Settings->OutputCapMargin);
+			return FMath::Min(FMath::Max(Cap, Settings->MinOutputCap), MaxOutputTokens);
+		}
+	}
+	return MaxOutputTokens;
+}
+
+void ULLMOutputBudget::Record(FName PersonaId, const FGameplayTag& Intent, int32 OutputTokens)
+{
+	if (OutputTokens <= 0)
+	{
+		return;
+	}
+
+	++Stats.Samples;
+	Distributions.FindOrAdd(FKey(PersonaId, Intent)).Add(OutputTokens);
+	if (!PersonaId.IsNone())
+	{
+		Distributions.FindOrAdd(FKey(NAME_None, Intent)).Add(OutputTokens);
+	}
+	if (Intent.IsValid())
+	{
+		Distributions.FindOrAdd(FKey(PersonaId, FGameplayTag())).Add(OutputTokens);
+		if (!PersonaId.IsNone())
+		{
+			Distributions.FindOrAdd(FKey(NAME_None, FGameplayTag())).Add(OutputTokens);
+		}
+	}
+}
+
+void ULLMOutputBudget::NotifyTruncated(bool bRetried)
+{
+	++Stats.Truncations;
+	if (bRetried)
+	{
+		++Stats.Retries;
+	}
+}
+
+void ULLMOutputBudget::LogDistributions() const
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	for (const TPair<FKey, FLengths>& Pair : Distributions)
+	{
+		// Per-intent rows across personas; the per-persona rows are detail
+		if (!Pair.Key.Key.IsNone())
+		{
+			continue;
+		}
+
+		const FLengths& Lengths = Pair.Value;
+		UE_LOG(LogTemp, Log, TEXT("[LLMOutputBudget]   %s: %d samples, p50 %d, p99 %d tokens%s"),
+			Pair.Key.Value.IsValid() ? *Pair.Key.Value.ToString() : TEXT("(any intent)"), Lengths.Samples.Num(),
+			Lengths.Percentile(0.5f), Lengths.Percentile(0.99f),
+			Lengths.Samples.Num() >= Settings->OutputCapMinSamples ? TEXT("") : TEXT(" (not enough samples to cap)"));
+	}
+}
@@ -0,0 +1,100 @@
+// Output token caps learned from how long answers actually are
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "GameplayTagContainer.h"
+#include "LLMOutputBudget.generated.h"
+
+/**
+ * Counters for adaptive output caps
+ */
+USTRUCT(BlueprintType)
+struct FLLMOutputBudgetStats
+{
+	GENERATED_BODY()
+
+	// Answers whose output length was recorded
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|OutputBudget")
+	int32 Samples = 0;
+
+	// Requests sent with a learned cap instead of the default
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|OutputBudget")
+	int32 CappedRequests = 0;
+
+	// Answers that stopped at MaxOutputTokens
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|OutputBudget")
+	int32 Truncations = 0;
+
+	// Truncated answers asked again with a wider cap
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|OutputBudget")
+	int32 Retries = 0;
+
+	// Retries that produced a usable plan
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|OutputBudget")
+	int32 RetriesRecovered = 0;
+};
+
+/**
+ * Keeps the output lengths (tokens per candidate, from usageMetadata) of recent LLM answers per
+ * intent, per persona and per (persona, intent), and derives MaxOutputTokens for the next request
+ * from the most specific distribution with OutputCapMinSamples: p99 times OutputCapMargin, never
+ * below MinOutputCap nor above the request's configured maximum. A tight cap bounds the latency
+ * and cost of runaway answers; ULLMGenerateActionAsync retries a truncated answer once with the
+ * cap doubled.
+ */
+UCLASS()
+class TESTCPP_API ULLMOutputBudget : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMOutputBudget* Get(const UObject* WorldContext);
+
+	/**
+	 * Output cap for the next request
+	 * @param PersonaId - Persona of the agent (NAME_None when unknown)
+	 * @param Intent - Expected intent, e.g. the classifier's prediction (invalid when unknown)
+	 * @param MaxOutputTokens - Configured maximum the cap never exceeds
+	 * @return Learned cap, or MaxOutputTokens while no distribution has enough samples
+	 */
+	int32 GetOutputCap(FName PersonaId, const FGameplayTag& Intent, int32 MaxOutputTokens) const;
+
+	/**
+	 * Record an answer that finished on its own (truncated answers would bias the caps low)
+	 * @param Intent - Intent of the answer's first step
+	 * @param OutputTokens - Output tokens per candidate
+	 */
+	void Record(FName PersonaId, const FGameplayTag& Intent, int32 OutputTokens);
+
+	void NotifyCapped() { ++Stats.CappedRequests; }
+	void NotifyTruncated(bool bRetried);
+	void NotifyRetryRecovered() { ++Stats.RetriesRecovered; }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|OutputBudget")
+	FLLMOutputBudgetStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|OutputBudget")
+	void ResetStats() { Stats = FLLMOutputBudgetStats(); }
+
+	/** Log the per-intent distributions and the caps they give */
+	void LogDistributions() const;
+
+private:
+	// Most recent output lengths of one key
+	struct FLengths
+	{
+		TArray<int32> Samples;
+		int32 Next = 0;
+
+		void Add(int32 Tokens);
+		int32 Percentile(float Fraction) const;
+	};
+
+	// (persona, intent); NAME_None / an empty tag stand for "any"
+	using FKey = TPair<FName, FGameplayTag>;
+
+	TMap<FKey, FLengths> Distributions;
+
+	FLLMOutputBudgetStats Stats;
+};
@@ -0,0 +1,172 @@
+// Cache of navmesh paths between recently used source cells and destinations
+#include "LLM/LLMPathCache.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "NavigationData.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMPathCachePrivate
+{
+	static void LogStats(UWorld* World)
+	{
+		const ULLMPathCache* Cache = ULLMPathCache::Get(World);
+		if (!Cache)
+		{
+			return;
+		}
+
+		const FLLMPathCacheStats Stats = Cache->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMPathCache] %d paths | %d lookups, %d hits (%.1f%%), %d known unreachable, %d joined in flight | %d inserted, %d invalidated, %d evicted"),
+			Cache->GetEntryCount(), Stats.Lookups, Stats.Hits,
+			Stats.Lookups > 0 ? 100.0 * Stats.Hits / Stats.Lookups : 0.0, Stats.UnreachableHits, Stats.Joined,
+			Stats.Inserts, Stats.Invalidations, Stats.Evictions);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.PathCacheStats"),
+		TEXT("Log path cache size and hit rate"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMPathCache* ULLMPathCache::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMPathCache>() : nullptr;
+}
+
+FLLMPathKey ULLMPathCache::MakeKey(const ANavigationData& NavData, const FVector& Source, const FVector& Destination)
+{
+	const double CellSize = FMath::Max(50.0f, GetDefault<ULLMSettings>()->PathCacheCellSize);
+	auto ToCell = [CellSize](const FVector& Location)
+	{
+		return FIntVector(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize),
+			FMath::FloorToInt32(Location.Z / CellSize));
+	};
+
+	FLLMPathKey Key;
+	Key.NavDataId = NavData.GetUniqueID();
+	Key.Source = ToCell(Source);
+	Key.Destination = ToCell(Destination);
+	return Key;
+}
+
+FNavPathSharedPtr ULLMPathCache::Find(const FLLMPathKey& Key)
+{
+	++Stats.Lookups;
+	FEntry* Entry = Entries.Find(Key);
+	if (!Entry)
+	{
+		return nullptr;
+	}
+
+	// The navmesh invalidated the path when a tile under its corridor was rebuilt
+	if (!Entry->Path.IsValid() || !Entry->Path->IsUpToDate())
+	{
+		Entries.Remove(Key);
+		++Stats.Invalidations;
+		return nullptr;
+	}
+
+	++Stats.Hits;
+	Entry->LastUsed = FPlatformTime::Seconds();
+	return Entry->Path;
+}
+
+void ULLMPathCache::Add(const FLLMPathKey& Key, FNavPathSharedPtr Path)
+{
+	ANavigationData* NavData = Path.IsValid() ? Path->GetNavigationDataUsed() : nullptr;
+	if (!NavData || !Path->IsValid() || Path->IsPartial())
+	{
+		return;
+	}
+
+	const int32 MaxEntries = FMath::Max(1, GetDefault<ULLMSettings>()->PathCacheMaxEntries);
+	if (!Entries.Contains(Key) && Entries.Num() >= MaxEntries)
+	{
+		// Out-of-date paths go first, then the least recently used one
+		const int32 Before = Entries.Num();
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (!It->Value.Path.IsValid() || !It->Value.Path->IsUpToDate())
+			{
+				It.RemoveCurrent();
+			}
+		}
+		Stats.Invalidations += Before - Entries.Num();
+
+		if (Entries.Num() >= MaxEntries)
+		{
+			const FLLMPathKey* Oldest = nullptr;
+			double OldestTime = TNumericLimits<double>::Max();
+			for (const TPair<FLLMPathKey, FEntry>& Pair : Entries)
+			{
+				if (Pair.Value.LastUsed < OldestTime)
+				{
+					OldestTime = Pair.Value.LastUsed;
+					Oldest = &Pair.Key;
+				}
+			}
+			if (Oldest)
+			{
+				Entries.Remove(FLLMPathKey(*Oldest));
+				++Stats.Evictions;
+			}
+		}
+	}
+
+	// Tile rebuilds only mark the path out of date; repathing it would be wasted work for a cache entry
+	Path->EnableRecalculationOnInvalidation(false);
+	NavData->RegisterActivePath(Path);
+
+	Unreachable.Remove(Key);
+	FEntry& Entry = Entries.FindOrAdd(Key);
+	Entry.Path = MoveTemp(Path);
+	Entry.LastUsed = FPlatformTime::Seconds();
+	++Stats.Inserts;
+}
+
+bool ULLMPathCache::IsKnownUnreachable(const FLLMPathKey& Key)
+{
+	const double* Expiry = Unreachable.Find(Key);
+	if (!Expiry)
+	{
+		return false;
+	}
+
+	if (*Expiry < FPlatformTime::Seconds())
+	{
+		Unreachable.Remove(Key);
+		return false;
+	}
+
+	++Stats.UnreachableHits;
+	return true;
+}
+
+void ULLMPathCache::AddUnreachable(const FLLMPathKey& Key)
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	if (Settings->PathCacheUnreachableSeconds <= 0.0f)
+	{
+		return;
+	}
+
+	// Failures are short-lived, so dropping the expired ones keeps the map small
+	const double Now = FPlatformTime::Seconds();
+	if (Unreachable.Num() >= FMath::Max(1, Settings->PathCacheMaxEntries))
+	{
+		for (auto It = Unreachable.CreateIterator(); It; ++It)
+		{
+			if (It->Value < Now)
+			{
+				It.RemoveCurrent();
+			}
+		}
+		if (Unreachable.Num() >= FMath::Max(1, Settings->PathCacheMaxEntries))
+		{
+			return;
+		}
+	}
+	Unreachable.Add(Key, Now + Settings->PathCacheUnreachableSeconds);
+}
@@ -0,0 +1,125 @@
+// Cache of navmesh paths between recently used source cells and destinations
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "LLMPathCache.generated.h"
+
+class ANavigationData;
+
+/**
+ * Navigation data plus source and destination cells of a cached path (PathCacheCellSize cubes)
+ * A named nav point always projects to the same point, so it always maps to one destination cell
+ */
+struct FLLMPathKey
+{
+	uint32 NavDataId = 0;
+	FIntVector Source = FIntVector::ZeroValue;
+	FIntVector Destination = FIntVector::ZeroValue;
+
+	bool operator==(const FLLMPathKey& Other) const
+	{
+		return NavDataId == Other.NavDataId && Source == Other.Source && Destination == Other.Destination;
+	}
+
+	friend uint32 GetTypeHash(const FLLMPathKey& Key)
+	{
+		return HashCombine(Key.NavDataId, HashCombine(GetTypeHash(Key.Source), GetTypeHash(Key.Destination)));
+	}
+};
+
+/**
+ * Counters for the path cache
+ */
+USTRUCT(BlueprintType)
+struct FLLMPathCacheStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 Lookups = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 Hits = 0;
+
+	// Lookups answered by a recent failure to reach the same destination cell from the same source cell
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 UnreachableHits = 0;
+
+	// Queries that joined an identical query already in flight instead of pathfinding again
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 Joined = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 Inserts = 0;
+
+	// Paths dropped because a navmesh tile under their corridor was rebuilt
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 Invalidations = 0;
+
+	// Paths dropped to stay within PathCacheMaxEntries
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|PathCache")
+	int32 Evictions = 0;
+};
+
+/**
+ * Paths found between the places LLM-driven agents keep travelling between
+ * Each path is registered with its navigation data as an active path, so rebuilding any navmesh
+ * tile its corridor crosses marks it out of date and its next lookup drops it; paths elsewhere stay.
+ * Failures are remembered too, for PathCacheUnreachableSeconds only, since no tile event marks
+ * them out of date. ULLMMoveValidator consults the cache before pathfinding a MoveTo target and
+ * also merges identical queries already in flight, so a crowd given the same command pathfinds
+ * once to validate it. The cache only replaces the validation pathfind: the behavior tree's
+ * MoveTo still finds its own path from the agent's exact location when it runs.
+ */
+UCLASS()
+class TESTCPP_API ULLMPathCache : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMPathCache* Get(const UObject* WorldContext);
+
+	static FLLMPathKey MakeKey(const ANavigationData& NavData, const FVector& Source, const FVector& Destination);
+
+	/** Cached path for a key, or null; counts toward the hit rate */
+	FNavPathSharedPtr Find(const FLLMPathKey& Key);
+
+	/** Store a complete path; it is dropped when its corridor's tiles are rebuilt */
+	void Add(const FLLMPathKey& Key, FNavPathSharedPtr Path);
+
+	/** The key was found unreachable within PathCacheUnreachableSeconds; counts toward the hit rate */
+	bool IsKnownUnreachable(const FLLMPathKey& Key);
+
+	/** Remember that no full path exists for a key, for PathCacheUnreachableSeconds */
+	void AddUnreachable(const FLLMPathKey& Key);
+
+	/** An identical query joined one in flight */
+	void NotifyJoined() { ++Stats.Joined; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|PathCache")
+	void Clear() { Entries.Reset(); Unreachable.Reset(); }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|PathCache")
+	int32 GetEntryCount() const { return Entries.Num(); }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|PathCache")
+	FLLMPathCacheStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|PathCache")
+	void ResetStats() { Stats = FLLMPathCacheStats(); }
+
+private:
+	struct FEntry
+	{
+		FNavPathSharedPtr Path;
+		double LastUsed = 0.0;
+	};
+
+	TMap<FLLMPathKey, FEntry> Entries;
+	// Keys with no full path -> when that stops being trusted
+	TMap<FLLMPathKey, double> Unreachable;
+
+	FLLMPathCacheStats Stats;
+};
@@ -0,0 +1,340 @@
+// System prompt templates with typed slots, compiled once into fragments
+#include "LLM/LLMPromptTemplate.h"
+#include "LLM/LLMAgentComponent.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "LLM/LLMSettings.h"
+#include "Hash/CityHash.h"
+
+namespace LLMPromptTemplatePrivate
+{
+	// Distinct slot values rendered per template before the cache starts over
+	static constexpr int32 MaxRenders = 64;
+
+	static const TCHAR* BuiltInTemplate = TEXT(
+		"You are an AI assistant that converts natural language commands into structured JSON actions for a game character. "
+		"You must ONLY output valid JSON with no additional text or explanation.\n\n"
+		"{?Persona}The character you control: {Persona}\n\n{/Persona}"
+		"Supported intents:\n"
+		"{Intents}"
+		"\nJSON schema:\n{\n  \"intent\": {IntentNames},\n"
+		"  \"target\": {\"id\": \"string\", \"type\": \"string\"} (optional, for Interact),\n"
+		"  \"location\": {\"x\": 0, \"y\": 0, \"z\": 0} | \"NavPointName\" (for MoveTo),\n"
+		"  \"speak\": \"text to say\" (for Speak),\n"
+		"  \"montage\": { \"name\": \"string\", \"section\": \"string?\", \"playRate\": 1.0, \"loop\": false } (for PlayMontage),\n"
+		"  \"params\": {} (optional),\n"
+		"  \"confidence\": 0.0-1.0 (required)\n"
+		"}\n\n"
+		"Examples:\n"
+		"User: \"Go to the fountain\"\n"
+		"{\"intent\":\"MoveTo\",\"location\":\"Fountain\",\"confidence\":0.9}\n\n"
+		"User: \"Talk to the guard\"\n"
+		"{\"intent\":\"Interact\",\"target\":{\"type\":\"Guard\"},\"confidence\":0.85}\n\n"
+		"User: \"Say hello\"\n"
+		"{\"intent\":\"Speak\",\"speak\":\"Hello\",\"confidence\":0.95}\n\n"
+		"User: \"Do a wave animation\"\n"
+		"{\"intent\":\"PlayMontage\",\"montage\":{\"name\":\"Wave\",\"playRate\":1.0},\"confidence\":0.9}\n\n"
+		"{PlanRules}"
+		"Output ONLY valid JSON. No markdown, no explanation.");
+
+	// Intent and plan slots, rebuilt only when the intent registry or the plan settings change
+	struct FIntentSlots
+	{
+		FString Intents;
+		FString IntentNames;
+		FString PlanRules;
+		int32 Revision = INDEX_NONE;
+		int32 MaxPlanSteps = INDEX_NONE;
+		bool bBuilt = false;
+	};
+
+	static const FIntentSlots& GetIntentSlots()
+	{
+		static FIntentSlots Slots;
+
+		const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+		const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+		const int32 Revision = Registry ? Registry->GetRevision() : INDEX_NONE;
+		const int32 MaxPlanSteps = Settings->bAllowPlans ? Settings->MaxPlanSteps : 0;
+		if (Slots.bBuilt && Slots.Revision == Revision && Slots.MaxPlanSteps == MaxPlanSteps)
+		{
+			return Slots;
+		}
+
+		Slots.Intents.Reset();
+		Slots.IntentNames.Reset();
+		if (Registry)
+		{
+			for (const ULLMIntentDefinition* Definition : Registry->GetDefinitions())
+			{
+				if (Definition->BuiltInIntent == ELLMIntent::Idle)
+				{
+					continue;
+				}
+				const FString WireName = Definition->GetWireName();
+				Slots.Intents += FString::Printf(TEXT("- %s: %s\n"), *WireName, *Definition->Description);
+				Slots.IntentNames += FString::Printf(TEXT("%s\"%s\""), Slots.IntentNames.IsEmpty() ? TEXT("") : TEXT(" | "), *WireName);
+			}
+		}
+		else
+		{
+			Slots.Intents = TEXT(
+				"- MoveTo: Move character to a location\n"
+				"- Interact: Interact with an object\n"
+				"- Speak: Make character speak\n"
+				"- PlayMontage: Play an animation montage by name\n");
+			Slots.IntentNames = TEXT("\"MoveTo\" | \"Interact\" | \"Speak\" | \"PlayMontage\"");
+		}
+
+		Slots.PlanRules.Reset();
+		if (MaxPlanSteps > 0)
+		{
+			Slots.PlanRules = FString::Printf(TEXT(
+				"Wrap your answer in a plan: {\"plan\": [step, ...]} with 1 to %d steps, where each step is an action object as above. "
+				"Use several steps when the command asks for a sequence. "
+				"A step may add \"condition\": \"Always\" | \"OnSuccess\" | \"OnFailure\" (default OnSuccess) to run relative to the previous step's outcome.\n"
+				"User: \"Walk to the door, open it, then say hi\"\n"
+				"{\"plan\":[{\"intent\":\"MoveTo\",\"location\":\"Door\",\"confidence\":0.9},"
+				"{\"intent\":\"Interact\",\"target\":{\"type\":\"Door\"},\"confidence\":0.85},"
+				"{\"intent\":\"Speak\",\"speak\":\"Hi!\",\"confidence\":0.9}]}\n\n"),
+				MaxPlanSteps);
+		}
+
+		Slots.Revision = Revision;
+		Slots.MaxPlanSteps = MaxPlanSteps;
+		Slots.bBuilt = true;
+		return Slots;
+	}
+
+	// Name lists of the last vocabulary asked for, rebuilt when it changes
+	struct FVocabularySlots
+	{
+		TWeakObjectPtr<const ULLMWorldVocabulary> Vocabulary;
+		int32 Revision = INDEX_NONE;
+		FString Names[3];
+	};
+
+	static const FVocabularySlots& GetVocabularySlots(const ULLMWorldVocabulary& Vocabulary)
+	{
+		static FVocabularySlots Slots;
+		if (Slots.Vocabulary.Get() != &Vocabulary || Slots.Revision != Vocabulary.GetRevision())
+		{
+			for (uint8 Category = 0; Category < UE_ARRAY_COUNT(Slots.Names); ++Category)
+			{
+				Slots.Names[Category] = FString::Join(Vocabulary.GetNames(static_cast<ELLMVocabularyCategory>(Category)), TEXT(", "));
+			}
+			Slots.Vocabulary = &Vocabulary;
+			Slots.Revision = Vocabulary.GetRevision();
+		}
+		return Slots;
+	}
+
+	static bool IsSlotNameChar(TCHAR Char)
+	{
+		return FChar::IsAlnum(Char);
+	}
+}
+
+void FLLMCompiledPrompt::Reset()
+{
+	Fragments.Reset();
+	Renders.Reset();
+	LiteralLength = 0;
+	UsedSlots = 0;
+	bCompiled = false;
+}
+
+void FLLMCompiledPrompt::Compile(const FString& Source)
+{
+	Reset();
+
+	const UEnum* SlotEnum = StaticEnum<ELLMPromptSlot>();
+	TArray<int32> OpenBlocks;
+	FString Literal;
+
+	auto FlushLiteral = [this, &Literal]()
+	{
+		if (!Literal.IsEmpty())
+		{
+			LiteralLength += Literal.Len();
+			Fragments.AddDefaulted_GetRef().Text = MoveTemp(Literal);
+			Literal.Reset();
+		}
+	};
+
+	for (int32 Index = 0; Index < Source.Len(); )
+	{
+		// A marker is '{', an optional '?' or '/', a slot name and '}'; anything else is text
+		if (Source[Index] == TEXT('{'))
+		{
+			int32 NameStart = Index + 1;
+			const TCHAR Prefix = NameStart < Source.Len() ? Source[NameStart] : TEXT('\0');
+			if (Prefix == TEXT('?') || Prefix == TEXT('/'))
+			{
+				++NameStart;
+			}
+			int32 NameEnd = NameStart;
+			while (NameEnd < Source.Len() && LLMPromptTemplatePrivate::IsSlotNameChar(Source[NameEnd]))
+			{
+				++NameEnd;
+			}
+
+			const int64 SlotValue = NameEnd > NameStart && NameEnd < Source.Len() && Source[NameEnd] == TEXT('}')
+				? SlotEnum->GetValueByNameString(Source.Mid(NameStart, NameEnd - NameStart)) : INDEX_NONE;
+			if (SlotValue != INDEX_NONE && SlotValue < static_cast<int64>(ELLMPromptSlot::Count))
+			{
+				const ELLMPromptSlot Slot = static_cast<ELLMPromptSlot>(SlotValue);
+				FlushLiteral();
+				if (Prefix == TEXT('/'))
+				{
+					if (OpenBlocks.Num() > 0 && Fragments[OpenBlocks.Last()].Slot == Slot)
+					{
+						Fragments[OpenBlocks.Pop()].SkipTo = Fragments.Num();
+					}
+					else
+					{
+						UE_LOG(LogTemp, Warning, TEXT("[LLMPromptTemplate] Unmatched {/%s} ignored"), *SlotEnum->GetNameStringByValue(SlotValue));
+					}
+				}
+				else
+				{
+					FFragment& Fragment = Fragments.AddDefaulted_GetRef();
+					Fragment.Kind = Prefix == TEXT('?') ? EFragmentKind::BeginOptional : EFragmentKind::Slot;
+					Fragment.Slot = Slot;
+					UsedSlots |= 1u << SlotValue;
+					if (Prefix == TEXT('?'))
+					{
+						OpenBlocks.Add(Fragments.Num() - 1);
+					}
+				}
+				Index = NameEnd + 1;
+				continue;
+			}
+		}
+
+		Literal.AppendChar(Source[Index]);
+		++Index;
+	}
+	FlushLiteral();
+
+	for (int32 Open : OpenBlocks)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMPromptTemplate] {?%s} is never closed; the block runs to the end of the template"),
+			*SlotEnum->GetNameStringByValue(static_cast<int64>(Fragments[Open].Slot)));
+		Fragments[Open].SkipTo = Fragments.Num();
+	}
+	bCompiled = true;
+}
+
+const FString& FLLMCompiledPrompt::Render(const FLLMPromptSlotValues& Values) const
+{
+	// Only slots the template uses take part in the key, so unrelated changes keep the cached render
+	uint64 Hash = 0;
+	int32 Length = LiteralLength;
+	for (int32 Slot = 0; Slot < static_cast<int32>(ELLMPromptSlot::Count); ++Slot)
+	{
+		if (UsedSlots & (1u << Slot))
+		{
+			const FStringView Value = Values.Values[Slot];
+			Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Value.GetData()), Value.Len() * sizeof(TCHAR), Hash ^ Value.Len());
+			Length += Value.Len();
+		}
+	}
+
+	if (const FString* Cached = Renders.Find(Hash))
+	{
+		return *Cached;
+	}
+
+	if (Renders.Num() >= LLMPromptTemplatePrivate::MaxRenders)
+	{
+		Renders.Reset();
+	}
+
+	FString& Out = Renders.Add(Hash);
+	Out.Reserve(Length);
+	for (int32 Index = 0; Index < Fragments.Num(); )
+	{
+		const FFragment& Fragment = Fragments[Index];
+		switch (Fragment.Kind)
+		{
+		case EFragmentKind::Literal:
+			Out += Fragment.Text;
+			++Index;
+			break;
+		case EFragmentKind::Slot:
+			Out.Append(Values[Fragment.Slot].GetData(), Values[Fragment.Slot].Len());
+			++Index;
+			break;
+		case EFragmentKind::BeginOptional:
+			Index = Values[Fragment.Slot].IsEmpty() ? Fragment.SkipTo : Index + 1;
+			break;
+		}
+	}
+	return Out;
+}
+
+void ULLMPromptTemplate::PostLoad()
+{
+	Super::PostLoad();
+	Compiled.Compile(Template);
+}
+
+#if WITH_EDITOR
+void ULLMPromptTemplate::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Compiled.Reset();
+}
+#endif
+
+const FLLMCompiledPrompt& ULLMPromptTemplate::GetCompiled()
+{
+	if (!Compiled.IsCompiled())
+	{
+		Compiled.Compile(Template);
+	}
+	return Compiled;
+}
+
+const FLLMCompiledPrompt& ULLMPromptTemplate::GetBuiltIn()
+{
+	static FLLMCompiledPrompt BuiltIn;
+	if (!BuiltIn.IsCompiled())
+	{
+		BuiltIn.Compile(LLMPromptTemplatePrivate::BuiltInTemplate);
+	}
+	return BuiltIn;
+}
+
+FString ULLMPromptTemplate::BuildSystemPrompt(const UObject* WorldContext, const ULLMAgentComponent* Agent)
+{
+	ULLMPromptTemplate* Asset = Agent ? Agent->PromptTemplate.Get() : nullptr;
+	if (!Asset)
+	{
+		Asset = GetDefault<ULLMSettings>()->DefaultPromptTemplate.LoadSynchronous();
+	}
+	const FLLMCompiledPrompt& Prompt = Asset ? Asset->GetCompiled() : GetBuiltIn();
+
+	const LLMPromptTemplatePrivate::FIntentSlots& IntentSlots = LLMPromptTemplatePrivate::GetIntentSlots();
+	FLLMPromptSlotValues Values;
+	Values[ELLMPromptSlot::Intents] = IntentSlots.Intents;
+	Values[ELLMPromptSlot::IntentNames] = IntentSlots.IntentNames;
+	Values[ELLMPromptSlot::PlanRules] = IntentSlots.PlanRules;
+	if (Agent)
+	{
+		Values[ELLMPromptSlot::Persona] = Agent->Persona;
+	}
+
+	const bool bUsesNames = Prompt.UsesSlot(ELLMPromptSlot::Montages) || Prompt.UsesSlot(ELLMPromptSlot::NavPoints) || Prompt.UsesSlot(ELLMPromptSlot::TargetTypes);
+	if (const ULLMWorldVocabulary* Vocabulary = bUsesNames && WorldContext ? ULLMWorldVocabulary::Get(WorldContext) : nullptr)
+	{
+		const LLMPromptTemplatePrivate::FVocabularySlots& Names = LLMPromptTemplatePrivate::GetVocabularySlots(*Vocabulary);
+		Values[ELLMPromptSlot::Montages] = Names.Names[static_cast<uint8>(ELLMVocabularyCategory::Montage)];
+		Values[ELLMPromptSlot::NavPoints] = Names.Names[static_cast<uint8>(ELLMVocabularyCategory::NavPoint)];
+		Values[ELLMPromptSlot::TargetTypes] = Names.Names[static_cast<uint8>(ELLMVocabularyCategory::TargetType)];
+	}
+
+	return Prompt.Render(Values);
+}
@@ -0,0 +1,127 @@
+// System prompt templates with typed slots, compiled once into fragments
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "LLMPromptTemplate.generated.h"
+
+class ULLMAgentComponent;
+
+/**
+ * Values a prompt template can reference, written {Name} in the template
+ * {?Name}...{/Name} encloses text emitted only when the slot is non-empty
+ */
+UENUM(BlueprintType)
+enum class ELLMPromptSlot : uint8
+{
+	// The agent's ULLMAgentComponent::Persona
+	Persona UMETA(DisplayName = "Persona"),
+	// "- Wire: Description" line per registered intent
+	Intents UMETA(DisplayName = "Intents"),
+	// "\"MoveTo\" | \"Interact\" | ..." for the JSON schema description
+	IntentNames UMETA(DisplayName = "Intent Names"),
+	// Montage names registered in the world vocabulary, comma separated
+	Montages UMETA(DisplayName = "Montages"),
+	// Nav point names registered in the world vocabulary
+	NavPoints UMETA(DisplayName = "Nav Points"),
+	// Interactable target types registered in the world vocabulary
+	TargetTypes UMETA(DisplayName = "Target Types"),
+	// Plan instructions and example; empty when plans are disabled
+	PlanRules UMETA(DisplayName = "Plan Rules"),
+
+	Count UMETA(Hidden)
+};
+
+/** Slot values for one render; views into strings owned by the caller */
+struct FLLMPromptSlotValues
+{
+	FStringView Values[static_cast<int32>(ELLMPromptSlot::Count)];
+
+	FStringView& operator[](ELLMPromptSlot Slot) { return Values[static_cast<int32>(Slot)]; }
+	const FStringView& operator[](ELLMPromptSlot Slot) const { return Values[static_cast<int32>(Slot)]; }
+};
+
+/**
+ * A template compiled into literal, slot and optional-block fragments
+ * Literal fragments are stored once and shared by every agent using the template. Renders are
+ * cached by a hash of the slot values, so agents with the same persona and an unchanged world
+ * vocabulary and intent registry get the same string back without rebuilding it.
+ */
+class TESTCPP_API FLLMCompiledPrompt
+{
+public:
+	/** Parse a template; braces that are not slot markers (e.g. JSON examples) are kept as text */
+	void Compile(const FString& Source);
+	bool IsCompiled() const { return bCompiled; }
+	void Reset();
+
+	/** Whether the template references a slot, in a marker or an optional block */
+	bool UsesSlot(ELLMPromptSlot Slot) const { return (UsedSlots & (1u << static_cast<uint32>(Slot))) != 0; }
+
+	/** The template with slots filled in and optional blocks of empty slots left out; valid until the next Render */
+	const FString& Render(const FLLMPromptSlotValues& Values) const;
+
+private:
+	enum class EFragmentKind : uint8
+	{
+		Literal,
+		Slot,
+		// Start of {?Slot}...{/Slot}; SkipTo is the fragment after the block
+		BeginOptional
+	};
+
+	struct FFragment
+	{
+		EFragmentKind Kind = EFragmentKind::Literal;
+		ELLMPromptSlot Slot = ELLMPromptSlot::Count;
+		FString Text;
+		int32 SkipTo = INDEX_NONE;
+	};
+
+	TArray<FFragment> Fragments;
+	int32 LiteralLength = 0;
+	uint32 UsedSlots = 0;
+	bool bCompiled = false;
+
+	// Slot values hash -> rendered prompt
+	mutable TMap<uint64, FString> Renders;
+};
+
+/**
+ * Designer-authored system prompt for action requests
+ * Assign one to ULLMAgentComponent::PromptTemplate for an NPC, or to
+ * ULLMSettings::DefaultPromptTemplate for every agent. Agents without either use the built-in
+ * template (ULLMActionParser::GetRecommendedSystemPrompt). Conversation history, memories and
+ * surroundings are not slots: they are sent as budgeted context sections and turns.
+ */
+UCLASS(BlueprintType)
+class TESTCPP_API ULLMPromptTemplate : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Prompt text with {Slot} and {?Slot}...{/Slot} markers (see ELLMPromptSlot)
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Prompt", meta = (MultiLine = true))
+	FString Template;
+
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** Compiled form of Template; compiled on first use */
+	const FLLMCompiledPrompt& GetCompiled();
+
+	/**
+	 * System prompt for an agent's action request
+	 * @param WorldContext - World whose vocabulary fills the name slots; null leaves them empty
+	 * @param Agent - Agent whose template and persona are used; null uses the default template
+	 */
+	static FString BuildSystemPrompt(const UObject* WorldContext, const ULLMAgentComponent* Agent);
+
+	/** Template used when neither the agent nor the settings name one */
+	static const FLLMCompiledPrompt& GetBuiltIn();
+
+private:
+	FLLMCompiledPrompt Compiled;
+};
@@ -0,0 +1,458 @@
+// Versioned on-disk table of validated plans keyed by normalized input, probed in place through a memory mapping
+#include "LLM/LLMResponseTable.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMSettings.h"
+#include "LLM/LLMTextNormalization.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "Async/MappedFileHandle.h"
+#include "Engine/GameInstance.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Hash/CityHash.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace LLMResponseTablePrivate
+{
+	static constexpr uint32 FileMagic = 0x424D4C4C; // "LLMB"
+	static constexpr uint32 FileVersion = 1;
+	// Slots are at most half full so probe chains stay short
+	static constexpr int32 SlotsPerEntry = 2;
+	static constexpr int32 MaxPlanSteps = 64;
+
+	// Little-endian on every supported platform; the file is read in place
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint64 ContractHash;
+		uint32 NumSlots;
+		uint32 NumEntries;
+		uint64 Reserved;
+	};
+	static_assert(sizeof(FHeader) == 32, "Response table header layout changed");
+
+	// Key 0 marks an empty slot; offsets are from the start of the file
+	struct FSlot
+	{
+		uint64 Key;
+		uint32 Offset;
+		uint32 Size;
+	};
+	static_assert(sizeof(FSlot) == 16, "Response table slot layout changed");
+
+	static const FHeader& GetHeader(const uint8* Data)
+	{
+		return *reinterpret_cast<const FHeader*>(Data);
+	}
+
+	static const FSlot* GetSlots(const uint8* Data)
+	{
+		return reinterpret_cast<const FSlot*>(Data + sizeof(FHeader));
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMResponseTable* Table = ULLMResponseTable::Get(World);
+		if (!Table)
+		{
+			return;
+		}
+
+		const FLLMResponseTableStats Stats = Table->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMResponseTable] %d lookups: %d baked hits, %d session hits, %d stale | %d inserts"),
+			Stats.Lookups, Stats.BakedHits, Stats.SessionHits, Stats.StaleHits, Stats.Inserts);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.ResponseTableStats"),
+		TEXT("Log how many requests the baked and saved response tables answered"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+FLLMResponseTableFile::FLLMResponseTableFile() = default;
+
+FLLMResponseTableFile::~FLLMResponseTableFile()
+{
+	Close();
+}
+
+bool FLLMResponseTableFile::Open(const FString& Path)
+{
+	using namespace LLMResponseTablePrivate;
+
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*Path))
+	{
+		return false;
+	}
+
+	FOpenMappedResult Mapped = PlatformFile.OpenMappedEx(*Path);
+	if (!Mapped.HasError())
+	{
+		MappedFile = Mapped.StealValue();
+		MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else
+	{
+		MappedFile.Reset();
+		if (!FFileHelper::LoadFileToArray(Bytes, *Path, FILEREAD_Silent))
+		{
+			return false;
+		}
+		Data = Bytes.GetData();
+		Size = Bytes.Num();
+	}
+
+	// Everything Find touches without further checks must be inside the file
+	const bool bValid = Size >= static_cast<int64>(sizeof(FHeader))
+		&& GetHeader(Data).Magic == FileMagic
+		&& GetHeader(Data).Version == FileVersion
+		&& FMath::IsPowerOfTwo(GetHeader(Data).NumSlots)
+		&& static_cast<int64>(sizeof(FHeader)) + static_cast<int64>(GetHeader(Data).NumSlots) * sizeof(FSlot) <= Size;
+	if (!bValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMResponseTable] %s is not a response table of version %u, ignoring"), *Path, FileVersion);
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void FLLMResponseTableFile::Close()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Bytes.Empty();
+	Data = nullptr;
+	Size = 0;
+}
+
+uint64 FLLMResponseTableFile::GetContractHash() const
+{
+	return Data ? LLMResponseTablePrivate::GetHeader(Data).ContractHash : 0;
+}
+
+int32 FLLMResponseTableFile::Num() const
+{
+	return Data ? static_cast<int32>(LLMResponseTablePrivate::GetHeader(Data).NumEntries) : 0;
+}
+
+bool FLLMResponseTableFile::Find(uint64 Key, FLLMPlan& OutPlan) const
+{
+	using namespace LLMResponseTablePrivate;
+
+	if (!Data)
+	{
+		return false;
+	}
+
+	const uint32 Mask = GetHeader(Data).NumSlots - 1;
+	const FSlot* Slots = GetSlots(Data);
+	for (uint32 Probe = 0, Index = static_cast<uint32>(Key) & Mask; Probe <= Mask; ++Probe, Index = (Index + 1) & Mask)
+	{
+		const FSlot& Slot = Slots[Index];
+		if (Slot.Key == 0)
+		{
+			return false;
+		}
+		if (Slot.Key != Key)
+		{
+			continue;
+		}
+
+		if (static_cast<int64>(Slot.Offset) + Slot.Size > Size)
+		{
+			return false;
+		}
+
+		FMemoryReaderView Reader(TArrayView<const uint8>(Data + Slot.Offset, Slot.Size));
+		OutPlan = FLLMPlan();
+		SerializePlan(Reader, OutPlan);
+		return !Reader.IsError() && OutPlan.Steps.Num() > 0;
+	}
+	return false;
+}
+
+void FLLMResponseTableFile::ForEachRecord(TFunctionRef<void(uint64 Key, TConstArrayView<uint8> Record)> Visitor) const
+{
+	using namespace LLMResponseTablePrivate;
+
+	if (!Data)
+	{
+		return;
+	}
+
+	const FSlot* Slots = GetSlots(Data);
+	for (uint32 Index = 0; Index < GetHeader(Data).NumSlots; ++Index)
+	{
+		const FSlot& Slot = Slots[Index];
+		if (Slot.Key != 0 && static_cast<int64>(Slot.Offset) + Slot.Size <= Size)
+		{
+			Visitor(Slot.Key, TConstArrayView<uint8>(Data + Slot.Offset, Slot.Size));
+		}
+	}
+}
+
+bool FLLMResponseTableFile::Write(const FString& Path, uint64 ContractHash, const TMap<uint64, TArray<uint8>>& Records)
+{
+	using namespace LLMResponseTablePrivate;
+
+	const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(FMath::Max(Records.Num() * SlotsPerEntry, 1));
+	const int64 SlotsEnd = sizeof(FHeader) + static_cast<int64>(NumSlots) * sizeof(FSlot);
+
+	int64 TotalSize = SlotsEnd;
+	for (const TPair<uint64, TArray<uint8>>& Record : Records)
+	{
+		TotalSize += Record.Value.Num();
+	}
+	if (TotalSize > MAX_uint32)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMResponseTable] %lld bytes is too large for a response table"), TotalSize);
+		return false;
+	}
+
+	TArray<uint8> Out;
+	Out.SetNumZeroed(SlotsEnd);
+	FHeader& Header = *reinterpret_cast<FHeader*>(Out.GetData());
+	Header.Magic = FileMagic;
+	Header.Version = FileVersion;
+	Header.ContractHash = ContractHash;
+	Header.NumSlots = NumSlots;
+	Header.NumEntries = Records.Num();
+
+	for (const TPair<uint64, TArray<uint8>>& Record : Records)
+	{
+		check(Record.Key != 0);
+		const uint32 Offset = Out.Num();
+		Out.Append(Record.Value);
+
+		// Re-fetch after Append may have reallocated
+		FSlot* Slots = reinterpret_cast<FSlot*>(Out.GetData() + sizeof(FHeader));
+		uint32 Index = static_cast<uint32>(Record.Key) & (NumSlots - 1);
+		while (Slots[Index].Key != 0)
+		{
+			Index = (Index + 1) & (NumSlots - 1);
+		}
+		Slots[Index] = { Record.Key, Offset, static_cast<uint32>(Record.Value.Num()) };
+	}
+
+	// Readers (including a running game) must never see a half-written table
+	const FString TempPath = Path + TEXT(".tmp");
+	return FFileHelper::SaveArrayToFile(Out, *TempPath) && IFileManager::Get().Move(*Path, *TempPath, true);
+}
+
+uint64 FLLMResponseTableFile::MakeKey(const FString& Input, FName PersonaId)
+{
+	// FName hashes depend on the name table, so the persona is hashed by its text
+	const FTCHARToUTF8 Persona(*PersonaId.ToString().ToLower());
+	const FTCHARToUTF8 Normalized(*LLMTextNormalization::Normalize(Input));
+	const uint64 Key = CityHash64WithSeed(Normalized.Get(), Normalized.Length(), CityHash64(Persona.Get(), Persona.Length()));
+	return Key != 0 ? Key : 1;
+}
+
+uint64 FLLMResponseTableFile::GetCurrentContractHash()
+{
+	static int32 CachedRevision = INDEX_NONE;
+	static uint64 CachedHash = 0;
+
+	const int32 Revision = ULLMActionSchema::GetRevision();
+	if (Revision != CachedRevision)
+	{
+		const FTCHARToUTF8 Schema(*ULLMActionSchema::GetResponseSchemaJson());
+		CachedHash = CityHash64(Schema.Get(), Schema.Length());
+		CachedRevision = Revision;
+	}
+	return CachedHash;
+}
+
+void FLLMResponseTableFile::SerializePlan(FArchive& Ar, FLLMPlan& Plan)
+{
+	using namespace LLMResponseTablePrivate;
+
+	int32 NumSteps = Plan.Steps.Num();
+	Ar << NumSteps;
+	if (Ar.IsLoading())
+	{
+		if (NumSteps <= 0 || NumSteps > MaxPlanSteps)
+		{
+			Ar.SetError();
+			return;
+		}
+		Plan.Steps.SetNum(NumSteps);
+	}
+
+	for (FLLMPlanStep& Step : Plan.Steps)
+	{
+		FLLMAction& Action = Step.Action;
+		uint8 Condition = static_cast<uint8>(Step.Condition);
+		uint8 Intent = static_cast<uint8>(Action.Intent);
+		FString IntentTag = Action.IntentTag.ToString();
+
+		Ar << Condition << Intent << IntentTag;
+		Ar << Action.Target.Id << Action.Target.Type;
+		Ar << Action.Location.Coordinates << Action.Location.NavPointName << Action.Location.bUseCoordinates;
+		Ar << Action.Speak << Action.Params;
+		Ar << Action.Montage.Name << Action.Montage.Section << Action.Montage.PlayRate << Action.Montage.bLoop;
+		Ar << Action.Confidence;
+
+		if (Ar.IsLoading())
+		{
+			if (Condition > static_cast<uint8>(ELLMPlanStepCondition::OnFailure) || Intent > static_cast<uint8>(ELLMIntent::Custom))
+			{
+				Ar.SetError();
+				return;
+			}
+			Step.Condition = static_cast<ELLMPlanStepCondition>(Condition);
+			Action.Intent = static_cast<ELLMIntent>(Intent);
+			Action.IntentTag = FGameplayTag::RequestGameplayTag(FName(*IntentTag), false);
+		}
+	}
+}
+
+ULLMResponseTable* ULLMResponseTable::Get(const UObject* WorldContext)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContext);
+	return GameInstance ? GameInstance->GetSubsystem<ULLMResponseTable>() : nullptr;
+}
+
+FString ULLMResponseTable::GetSessionTablePath()
+{
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("LLM"), TEXT("ResponseCache.bin"));
+}
+
+void ULLMResponseTable::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	if (!Settings->BakedResponseTablePath.IsEmpty()
+		&& BakedTable.Open(FPaths::Combine(FPaths::ProjectContentDir(), Settings->BakedResponseTablePath)))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMResponseTable] Mapped %d baked responses"), BakedTable.Num());
+	}
+
+	if (Settings->bPersistResponseCache && SessionTable.Open(GetSessionTablePath()))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMResponseTable] Mapped %d saved responses"), SessionTable.Num());
+	}
+}
+
+void ULLMResponseTable::Deinitialize()
+{
+	Flush();
+	BakedTable.Close();
+	SessionTable.Close();
+	Super::Deinitialize();
+}
+
+bool ULLMResponseTable::IsCurrent(const FLLMResponseTableFile& Table)
+{
+	return Table.IsOpen() && Table.GetContractHash() == FLLMResponseTableFile::GetCurrentContractHash();
+}
+
+bool ULLMResponseTable::Lookup(const FString& Input, FName PersonaId, UObject* WorldContext, FLLMPlan& OutPlan)
+{
+	++Stats.Lookups;
+
+	// Newest answers first: this session, earlier sessions, then the shipped table
+	const uint64 Key = FLLMResponseTableFile::MakeKey(Input, PersonaId);
+	bool bBaked = false;
+	if (const FLLMPlan* Cached = Pending.Find(Key))
+	{
+		OutPlan = *Cached;
+	}
+	else if (!(IsCurrent(SessionTable) && SessionTable.Find(Key, OutPlan)))
+	{
+		if (!(IsCurrent(BakedTable) && BakedTable.Find(Key, OutPlan)))
+		{
+			return false;
+		}
+		bBaked = true;
+	}
+
+	const ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(WorldContext);
+	if (Vocabulary && !Vocabulary->IsPlanGrounded(OutPlan))
+	{
+		++Stats.StaleHits;
+		return false;
+	}
+
+	if (bBaked)
+	{
+		++Stats.BakedHits;
+	}
+	else
+	{
+		++Stats.SessionHits;
+	}
+	UE_LOG(LogTemp, Log, TEXT("[LLMResponseTable] %s hit for '%s'"), bBaked ? TEXT("Baked") : TEXT("Saved"), *Input);
+	return true;
+}
+
+void ULLMResponseTable::Insert(const FString& Input, FName PersonaId, const FLLMPlan& Plan)
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	if (!Settings->bPersistResponseCache || Plan.Steps.Num() == 0 || Pending.Num() >= Settings->ResponseCacheMaxEntries)
+	{
+		return;
+	}
+
+	Pending.Add(FLLMResponseTableFile::MakeKey(Input, PersonaId), Plan);
+	++Stats.Inserts;
+}
+
+void ULLMResponseTable::Flush()
+{
+	if (Pending.Num() == 0)
+	{
+		return;
+	}
+
+	// This session's answers win; earlier ones fill the remaining room
+	TMap<uint64, TArray<uint8>> Records;
+	for (TPair<uint64, FLLMPlan>& Entry : Pending)
+	{
+		TArray<uint8>& Record = Records.Add(Entry.Key);
+		FMemoryWriter Writer(Record);
+		FLLMResponseTableFile::SerializePlan(Writer, Entry.Value);
+	}
+
+	const int32 MaxEntries = GetDefault<ULLMSettings>()->ResponseCacheMaxEntries;
+	if (IsCurrent(SessionTable))
+	{
+		SessionTable.ForEachRecord([&Records, MaxEntries](uint64 Key, TConstArrayView<uint8> Record)
+		{
+			if (Records.Num() < MaxEntries && !Records.Contains(Key))
+			{
+				Records.Add(Key, TArray<uint8>(Record));
+			}
+		});
+	}
+
+	// The mapping must be released before the file can be replaced
+	SessionTable.Close();
+	const FString Path = GetSessionTablePath();
+	if (FLLMResponseTableFile::Write(Path, FLLMResponseTableFile::GetCurrentContractHash(), Records))
+	{
+		UE_LOG(LogTemp, Log, TEXT("[LLMResponseTable] Saved %d responses (%d new) to %s"), Records.Num(), Pending.Num(), *Path);
+		Pending.Reset();
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("[LLMResponseTable] Failed to write %s"), *Path);
+	}
+	SessionTable.Open(Path);
+}
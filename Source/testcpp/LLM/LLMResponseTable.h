@@ -0,0 +1,145 @@
+// Versioned on-disk table of validated plans keyed by normalized input, probed in place through a memory mapping
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMResponseTable.generated.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Read-only view of a response table file
+ * Layout: header (magic, format version, intent contract hash), an open-addressing slot array of
+ * (key, offset, size), then the serialized plans. The file is memory-mapped and probed in place,
+ * so opening costs nothing beyond the header check and only the plan that is found gets decoded.
+ * A file that cannot be mapped (e.g. compressed in a pak) is read into memory once instead.
+ */
+class TESTCPP_API FLLMResponseTableFile
+{
+public:
+	FLLMResponseTableFile();
+	~FLLMResponseTableFile();
+
+	/** Map a table; fails on a missing file or a bad header */
+	bool Open(const FString& Path);
+	void Close();
+	bool IsOpen() const { return Data != nullptr; }
+
+	/** Hash of the intent contract the plans were validated against (see GetCurrentContractHash) */
+	uint64 GetContractHash() const;
+
+	int32 Num() const;
+
+	/** Decode the plan stored under a key */
+	bool Find(uint64 Key, FLLMPlan& OutPlan) const;
+
+	/** Visit the serialized record of every entry (used to merge a table into a new file) */
+	void ForEachRecord(TFunctionRef<void(uint64 Key, TConstArrayView<uint8> Record)> Visitor) const;
+
+	/**
+	 * Write a table; replaces the file atomically
+	 * @param Records - Key -> plan serialized with SerializePlan
+	 */
+	static bool Write(const FString& Path, uint64 ContractHash, const TMap<uint64, TArray<uint8>>& Records);
+
+	/** Key of an input: its normalized text (LLMTextNormalization) scoped by persona; stable across runs */
+	static uint64 MakeKey(const FString& Input, FName PersonaId);
+
+	/** Hash of the current response schema; tables built against another contract are ignored */
+	static uint64 GetCurrentContractHash();
+
+	/** Compact binary form of a plan (RawJson is not stored) */
+	static void SerializePlan(FArchive& Ar, FLLMPlan& Plan);
+
+private:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	// Fallback storage when the file cannot be mapped
+	TArray<uint8> Bytes;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+};
+
+/**
+ * Counters for the response table
+ */
+USTRUCT(BlueprintType)
+struct FLLMResponseTableStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|ResponseTable")
+	int32 Lookups = 0;
+
+	// Answered from the table baked with the game (LLMBakeResponses commandlet)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|ResponseTable")
+	int32 BakedHits = 0;
+
+	// Answered from LLM results saved by this or an earlier session
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|ResponseTable")
+	int32 SessionHits = 0;
+
+	// Found, but the plan names something the world does not have
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|ResponseTable")
+	int32 StaleHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|ResponseTable")
+	int32 Inserts = 0;
+};
+
+/**
+ * Exact-match answers consulted before any network request
+ * Two tables in the FLLMResponseTableFile format are mapped at startup: the baked table shipped
+ * under Content/ (ULLMSettings::BakedResponseTablePath) for scripted and tutorial lines, and
+ * Saved/LLM/ResponseCache.bin holding LLM results from earlier sessions. Results of this session
+ * are kept in memory and merged into the saved table on shutdown or Flush. Tables validated
+ * against another intent contract are skipped, and hits are re-checked against the world vocabulary.
+ */
+UCLASS()
+class TESTCPP_API ULLMResponseTable : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMResponseTable* Get(const UObject* WorldContext);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Find the stored plan for an input
+	 * @param PersonaId - Scope (ULLMAgentComponent::PersonaId)
+	 * @param WorldContext - World whose vocabulary must contain the plan's names
+	 */
+	bool Lookup(const FString& Input, FName PersonaId, UObject* WorldContext, FLLMPlan& OutPlan);
+
+	/** Remember a validated LLM plan; saved with the next Flush when bPersistResponseCache is set */
+	void Insert(const FString& Input, FName PersonaId, const FLLMPlan& Plan);
+
+	/** Merge this session's results into Saved/LLM/ResponseCache.bin and remap it */
+	UFUNCTION(BlueprintCallable, Category = "LLM|ResponseTable")
+	void Flush();
+
+	UFUNCTION(BlueprintPure, Category = "LLM|ResponseTable")
+	FLLMResponseTableStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|ResponseTable")
+	void ResetStats() { Stats = FLLMResponseTableStats(); }
+
+	static FString GetSessionTablePath();
+
+private:
+	// Table usable with the current intent contract
+	static bool IsCurrent(const FLLMResponseTableFile& Table);
+
+	FLLMResponseTableFile BakedTable;
+	FLLMResponseTableFile SessionTable;
+
+	// Results of this session not yet written
+	TMap<uint64, FLLMPlan> Pending;
+
+	FLLMResponseTableStats Stats;
+};
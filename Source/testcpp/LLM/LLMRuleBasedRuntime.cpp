@@ -0,0 +1,275 @@
+// Deterministic rule-based runtime for the in-process LLM provider
+#include "LLM/LLMRuleBasedRuntime.h"
+#include "LLM/LLMIntentDefinition.h"
+#include "LLM/LLMIntentRegistry.h"
+#include "LLM/LLMSettings.h"
+#include "LLM/LLMTextNormalization.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace LLMRuleBasedRuntimePrivate
+{
+	// Value sets the schema allows, pre-tokenized
+	struct FPrefixState : public FLLMLocalPrefixState
+	{
+		struct FValue
+		{
+			FString Value;
+			TArray<FString> Words;
+		};
+
+		TSet<FString> Intents;
+		TArray<FValue> NavPoints;
+		TArray<FValue> TargetTypes;
+		TArray<FValue> Montages;
+		bool bPlan = false;
+	};
+
+	static const TArray<TSharedPtr<FJsonValue>>* FindEnum(const TSharedPtr<FJsonObject>& Schema, const TCHAR* Property, const TCHAR* SubProperty = nullptr)
+	{
+		const TSharedPtr<FJsonObject>* Props = nullptr;
+		const TSharedPtr<FJsonObject>* Field = nullptr;
+		if (!Schema.IsValid() || !Schema->TryGetObjectField(TEXT("properties"), Props) || !(*Props)->TryGetObjectField(Property, Field))
+		{
+			return nullptr;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+		if (SubProperty)
+		{
+			return FindEnum(*Field, SubProperty);
+		}
+		if ((*Field)->TryGetArrayField(TEXT("enum"), Values))
+		{
+			return Values;
+		}
+
+		// anyOf variants (location): the string variant carries the names
+		const TArray<TSharedPtr<FJsonValue>>* Variants = nullptr;
+		if ((*Field)->TryGetArrayField(TEXT("anyOf"), Variants))
+		{
+			for (const TSharedPtr<FJsonValue>& Variant : *Variants)
+			{
+				const TSharedPtr<FJsonObject>* VariantObj = nullptr;
+				if (Variant->TryGetObject(VariantObj) && (*VariantObj)->TryGetArrayField(TEXT("enum"), Values))
+				{
+					return Values;
+				}
+			}
+		}
+		return nullptr;
+	}
+
+	static void ReadValues(const TArray<TSharedPtr<FJsonValue>>* Enum, TArray<FPrefixState::FValue>& OutValues)
+	{
+		if (!Enum)
+		{
+			return;
+		}
+		for (const TSharedPtr<FJsonValue>& Value : *Enum)
+		{
+			FPrefixState::FValue& Entry = OutValues.AddDefaulted_GetRef();
+			Entry.Value = Value->AsString();
+			LLMTextNormalization::Tokenize(Entry.Value, Entry.Words);
+		}
+		// Prefer the most specific name when several match
+		OutValues.StableSort([](const FPrefixState::FValue& A, const FPrefixState::FValue& B) { return A.Words.Num() > B.Words.Num(); });
+	}
+
+	// First value whose words all occur in the prompt
+	static const FString* ChooseValue(const TArray<FPrefixState::FValue>& Values, const TArray<FString>& Tokens)
+	{
+		for (const FPrefixState::FValue& Value : Values)
+		{
+			bool bAll = Value.Words.Num() > 0;
+			for (const FString& Word : Value.Words)
+			{
+				bAll = bAll && Tokens.Contains(Word);
+			}
+			if (bAll)
+			{
+				return &Value.Value;
+			}
+		}
+		return nullptr;
+	}
+}
+
+FLLMRuleBasedRuntime::FLLMRuleBasedRuntime()
+{
+	check(IsInGameThread());
+
+	const ULLMCommandGrammar* Grammar = GetDefault<ULLMSettings>()->CommandGrammar.LoadSynchronous();
+	if (!Grammar)
+	{
+		Grammar = ULLMCommandGrammar::CreateDefault(GetTransientPackage());
+	}
+
+	Phrases.Compile(*Grammar);
+
+	const ULLMIntentRegistry* Registry = ULLMIntentRegistry::Get();
+	for (const FLLMCommandRule& GrammarRule : Grammar->Rules)
+	{
+		const ULLMIntentDefinition* Definition = Registry ? Registry->FindByTag(GrammarRule.IntentTag) : nullptr;
+		FRule& Rule = Rules.AddDefaulted_GetRef();
+		Rule.WireName = Definition ? Definition->GetWireName() : FString();
+		Rule.Slot = GrammarRule.Slot;
+		Rule.Confidence = GrammarRule.Confidence;
+	}
+}
+
+TSharedPtr<const FLLMLocalPrefixState, ESPMode::ThreadSafe> FLLMRuleBasedRuntime::Prefill(const FString& SystemInstruction, const TSharedPtr<FJsonObject>& ResponseSchema)
+{
+	using namespace LLMRuleBasedRuntimePrivate;
+
+	TSharedRef<FPrefixState, ESPMode::ThreadSafe> State = MakeShared<FPrefixState, ESPMode::ThreadSafe>();
+
+	// Plan schemas wrap the action schema in {"plan": {"items": ...}}
+	TSharedPtr<FJsonObject> ActionSchema = ResponseSchema;
+	const TSharedPtr<FJsonObject>* Props = nullptr;
+	const TSharedPtr<FJsonObject>* PlanField = nullptr;
+	const TSharedPtr<FJsonObject>* Items = nullptr;
+	if (ResponseSchema.IsValid() && ResponseSchema->TryGetObjectField(TEXT("properties"), Props)
+		&& (*Props)->TryGetObjectField(TEXT("plan"), PlanField) && (*PlanField)->TryGetObjectField(TEXT("items"), Items))
+	{
+		State->bPlan = true;
+		ActionSchema = *Items;
+	}
+
+	if (const TArray<TSharedPtr<FJsonValue>>* IntentEnum = FindEnum(ActionSchema, TEXT("intent")))
+	{
+		for (const TSharedPtr<FJsonValue>& Value : *IntentEnum)
+		{
+			State->Intents.Add(Value->AsString());
+		}
+	}
+	ReadValues(FindEnum(ActionSchema, TEXT("location")), State->NavPoints);
+	ReadValues(FindEnum(ActionSchema, TEXT("target"), TEXT("type")), State->TargetTypes);
+	ReadValues(FindEnum(ActionSchema, TEXT("montage"), TEXT("name")), State->Montages);
+	return State;
+}
+
+void FLLMRuleBasedRuntime::Decode(TArrayView<FLLMLocalRequest* const> Batch)
+{
+	for (FLLMLocalRequest* Request : Batch)
+	{
+		Request->Text = Generate(*Request);
+		Request->bSuccess = true;
+	}
+}
+
+FString FLLMRuleBasedRuntime::Generate(const FLLMLocalRequest& Request) const
+{
+	using namespace LLMRuleBasedRuntimePrivate;
+
+	const FPrefixState& State = static_cast<const FPrefixState&>(*Request.Prefix);
+
+	TArray<FString> Tokens;
+	TArray<FString> Original;
+	LLMTextNormalization::Tokenize(Request.UserPrompt, Tokens, &Original);
+
+	TSharedRef<FJsonObject> Action = MakeShared<FJsonObject>();
+
+	// Fill the rule's slot from the text after SlotStart; false if the schema allows no matching value
+	auto TryRule = [&State, &Tokens, &Original, &Action](const FRule& Rule, int32 SlotStart)
+	{
+		if (Rule.WireName.IsEmpty() || (State.Intents.Num() > 0 && !State.Intents.Contains(Rule.WireName)))
+		{
+			return false;
+		}
+
+		const TArray<FPrefixState::FValue>* Values = nullptr;
+		const TCHAR* Object = nullptr;
+		const TCHAR* Field = nullptr;
+		switch (Rule.Slot)
+		{
+		case ELLMCommandSlot::NavPoint: Values = &State.NavPoints; Field = TEXT("location"); break;
+		case ELLMCommandSlot::TargetType: Values = &State.TargetTypes; Object = TEXT("target"); Field = TEXT("type"); break;
+		case ELLMCommandSlot::Montage: Values = &State.Montages; Object = TEXT("montage"); Field = TEXT("name"); break;
+		case ELLMCommandSlot::FreeText:
+			if (SlotStart >= Original.Num())
+			{
+				return false;
+			}
+			Action->SetStringField(TEXT("speak"), FString::Join(TArrayView<const FString>(Original).RightChop(SlotStart), TEXT(" ")));
+			break;
+		default:
+			break;
+		}
+
+		if (Values)
+		{
+			const FString* Value = ChooseValue(*Values, Tokens);
+			if (!Value)
+			{
+				return false;
+			}
+			if (Object)
+			{
+				TSharedRef<FJsonObject> Child = MakeShared<FJsonObject>();
+				Child->SetStringField(Field, *Value);
+				Action->SetObjectField(Object, Child);
+			}
+			else
+			{
+				Action->SetStringField(Field, *Value);
+			}
+		}
+
+		Action->SetStringField(TEXT("intent"), Rule.WireName);
+		Action->SetNumberField(TEXT("confidence"), Rule.Confidence);
+		return true;
+	};
+
+	// Earliest verb phrase, longest at that position; slot-only rules ("wave") last
+	TArray<TPair<int32, int32>, TInlineAllocator<8>> Matches;
+	bool bGrounded = false;
+	for (int32 Start = 0; Start < Tokens.Num() && !bGrounded; ++Start)
+	{
+		Phrases.FindPhrases(Tokens, Start, Matches);
+		for (const TPair<int32, int32>& Match : Matches)
+		{
+			// Empty phrases end where they start and are tried once below
+			if (Match.Value > Start && TryRule(Rules[Match.Key], Match.Value))
+			{
+				bGrounded = true;
+				break;
+			}
+		}
+	}
+
+	if (!bGrounded)
+	{
+		// Past the last token only the empty-phrase rules remain
+		Phrases.FindPhrases(Tokens, Tokens.Num(), Matches);
+		for (const TPair<int32, int32>& Match : Matches)
+		{
+			const FRule& Rule = Rules[Match.Key];
+			if (Rule.Slot != ELLMCommandSlot::None && Rule.Slot != ELLMCommandSlot::FreeText && TryRule(Rule, 0))
+			{
+				bGrounded = true;
+				break;
+			}
+		}
+	}
+
+	if (!bGrounded)
+	{
+		Action->SetStringField(TEXT("intent"), TEXT("Idle"));
+		Action->SetNumberField(TEXT("confidence"), 0.2);
+	}
+
+	TSharedRef<FJsonObject> Root = Action;
+	if (State.bPlan)
+	{
+		TArray<TSharedPtr<FJsonValue>> Steps;
+		Steps.Add(MakeShared<FJsonValueObject>(Action));
+		Root = MakeShared<FJsonObject>();
+		Root->SetArrayField(TEXT("plan"), Steps);
+	}
+
+	FString Text;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Text);
+	FJsonSerializer::Serialize(Root, Writer);
+	return Text;
+}
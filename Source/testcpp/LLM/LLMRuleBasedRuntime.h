@@ -0,0 +1,43 @@
+// Deterministic rule-based runtime for the in-process LLM provider
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LLM/LLMLocalProvider.h"
+#include "LLM/LLMCommandGrammar.h"
+#include "LLM/LLMLocalCommandMatcher.h"
+
+/**
+ * Deterministic offline runtime: not a language model and loads no weights
+ * Finds a verb phrase of the command grammar anywhere in the prompt, using the same compiled
+ * FLLMCommandPhraseTrie as ULLMLocalCommandMatcher, and fills its slot by choosing among the
+ * values the response schema allows ("enum" lists from ULLMWorldVocabulary), so every answer
+ * conforms to the FLLMAction contract. Same input, same output: used for offline play and as a
+ * reproducible backend when exercising the provider. Answers it cannot ground are returned as
+ * low-confidence Idle. Model inference plugs in as another ILLMLocalRuntime.
+ */
+class TESTCPP_API FLLMRuleBasedRuntime : public ILLMLocalRuntime
+{
+public:
+	/** Snapshots the grammar from ULLMSettings (or the built-in one); call on the game thread */
+	FLLMRuleBasedRuntime();
+
+	virtual FString GetName() const override { return TEXT("RuleBased"); }
+	virtual bool LoadModel(const FString& ModelPath) override { return true; }
+	virtual TSharedPtr<const FLLMLocalPrefixState, ESPMode::ThreadSafe> Prefill(const FString& SystemInstruction, const TSharedPtr<FJsonObject>& ResponseSchema) override;
+	virtual void Decode(TArrayView<FLLMLocalRequest* const> Batch) override;
+
+private:
+	// Grammar rule resolved against the intent registry; WireName is empty for unregistered intents
+	struct FRule
+	{
+		FString WireName;
+		ELLMCommandSlot Slot = ELLMCommandSlot::None;
+		float Confidence = 0.9f;
+	};
+
+	FString Generate(const FLLMLocalRequest& Request) const;
+
+	FLLMCommandPhraseTrie Phrases;
+	// Indexed like the grammar's rules
+	TArray<FRule> Rules;
+};
@@ -0,0 +1,439 @@
+// Semantic response cache: paraphrases of past requests reuse their validated plans
+#include "LLM/LLMSemanticCache.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMDecisionLog.h"
+#include "LLM/LLMSettings.h"
+#include "LLM/LLMTextNormalization.h"
+#include "LLM/LLMWorldVocabulary.h"
+#include "Dom/JsonObject.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "Math/VectorRegister.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+namespace LLMSemanticCachePrivate
+{
+	// Exhaustive scan below this many entries; IVF above
+	static constexpr int32 IVFThreshold = 64;
+	static constexpr int32 NumLists = 16;
+	static constexpr int32 NumProbes = 3;
+	static constexpr int32 KMeansIterations = 5;
+	// Treated as the same request on insert
+	static constexpr float DuplicateSimilarity = 0.99f;
+	static constexpr float TrigramWeight = 0.5f;
+
+	static void AddFeature(float* Vector, uint32 Hash, float Weight)
+	{
+		Vector[Hash % FLLMSemanticIndex::Dim] += (Hash & 0x80000000u) ? -Weight : Weight;
+	}
+
+	// Same intent and same slot values: a cached answer that would have been correct
+	static bool IsSameDecision(const FLLMAction& A, const FLLMAction& B)
+	{
+		return A.IntentTag == B.IntentTag
+			&& A.Location.NavPointName.Equals(B.Location.NavPointName)
+			&& A.Target.Type.Equals(B.Target.Type)
+			&& A.Montage.Name.Equals(B.Montage.Name)
+			&& A.Speak.Equals(B.Speak);
+	}
+
+	// Replays the decision log in order against a fresh index: each entry is looked up, then inserted
+	static void RunBenchmark(const TArray<FString>& Args)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *ULLMDecisionLog::GetLogPath()))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("[LLMSemanticCache] No decision log at %s (enable bLogDecisions)"), *ULLMDecisionLog::GetLogPath());
+			return;
+		}
+
+		TArray<FString> Inputs;
+		TArray<FLLMAction> Actions;
+		for (const FString& Line : Lines)
+		{
+			TSharedPtr<FJsonObject> Entry;
+			FString Input;
+			FString Intent;
+			if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Line), Entry) || !Entry.IsValid()
+				|| !Entry->TryGetStringField(TEXT("input"), Input) || !Entry->TryGetStringField(TEXT("intent"), Intent))
+			{
+				continue;
+			}
+
+			FLLMAction& Action = Actions.AddDefaulted_GetRef();
+			Action.IntentTag = FGameplayTag::RequestGameplayTag(FName(*Intent), false);
+			Entry->TryGetStringField(TEXT("navPoint"), Action.Location.NavPointName);
+			Entry->TryGetStringField(TEXT("targetType"), Action.Target.Type);
+			Entry->TryGetStringField(TEXT("montage"), Action.Montage.Name);
+			Entry->TryGetStringField(TEXT("speak"), Action.Speak);
+			Inputs.Add(Input);
+		}
+
+		TArray<float> Thresholds;
+		if (Args.Num() > 0)
+		{
+			Thresholds.Add(FCString::Atof(*Args[0]));
+		}
+		else
+		{
+			Thresholds = { 0.7f, 0.75f, 0.8f, 0.85f, 0.9f, 0.95f };
+		}
+
+		TArray<float> Vectors;
+		Vectors.SetNumUninitialized(Inputs.Num() * FLLMSemanticIndex::Dim);
+		for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+		{
+			FLLMSemanticIndex::Embed(Inputs[Index], Vectors.GetData() + Index * FLLMSemanticIndex::Dim);
+		}
+
+		for (const float Threshold : Thresholds)
+		{
+			FLLMSemanticIndex Index(GetDefault<ULLMSettings>()->SemanticCacheMaxEntries);
+			int32 Hits = 0;
+			int32 FalseHits = 0;
+			for (int32 Sample = 0; Sample < Inputs.Num(); ++Sample)
+			{
+				const float* Vector = Vectors.GetData() + Sample * FLLMSemanticIndex::Dim;
+				float Similarity = 0.0f;
+				const FLLMPlan* Cached = Index.FindNearest(Vector, Similarity);
+				if (Cached && Similarity >= Threshold)
+				{
+					++Hits;
+					FalseHits += IsSameDecision(Cached->Steps[0].Action, Actions[Sample]) ? 0 : 1;
+				}
+
+				FLLMPlan Plan;
+				Plan.Steps.AddDefaulted_GetRef().Action = Actions[Sample];
+				Index.Add(Vector, Plan);
+			}
+
+			UE_LOG(LogTemp, Log, TEXT("[LLMSemanticCache] Threshold %.2f: %d samples, hit rate %.1f%%, false hits %d (%.1f%% of hits)"),
+				Threshold, Inputs.Num(), Inputs.Num() > 0 ? 100.0f * Hits / Inputs.Num() : 0.0f,
+				FalseHits, Hits > 0 ? 100.0f * FalseHits / Hits : 0.0f);
+		}
+	}
+
+	static FAutoConsoleCommand BenchmarkCommand(
+		TEXT("LLM.SemanticCacheBench"),
+		TEXT("Replay the decision log through the semantic cache and report hit/false-hit rates. Optional arg: threshold (default: sweep)"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RunBenchmark));
+}
+
+// Index
+
+FLLMSemanticIndex::FLLMSemanticIndex(int32 InCapacity)
+	: Capacity(FMath::Max(1, InCapacity))
+{
+}
+
+void FLLMSemanticIndex::Embed(const FString& Text, float* OutVector)
+{
+	using namespace LLMSemanticCachePrivate;
+
+	FMemory::Memzero(OutVector, Dim * sizeof(float));
+
+	TArray<FString> Tokens;
+	LLMTextNormalization::Tokenize(Text, Tokens);
+	for (const FString& Token : Tokens)
+	{
+		AddFeature(OutVector, GetTypeHash(Token), 1.0f);
+
+		// Character trigrams of "#token#" tolerate inflections and typos ("door"/"doors")
+		const int32 Len = Token.Len() + 2;
+		for (int32 Start = 0; Start + 3 <= Len; ++Start)
+		{
+			uint32 Hash = 2166136261u;
+			for (int32 Offset = 0; Offset < 3; ++Offset)
+			{
+				const int32 Pos = Start + Offset - 1;
+				const TCHAR C = (Pos < 0 || Pos >= Token.Len()) ? TEXT('#') : Token[Pos];
+				Hash = (Hash ^ static_cast<uint32>(C)) * 16777619u;
+			}
+			AddFeature(OutVector, Hash, TrigramWeight);
+		}
+	}
+
+	float SquaredNorm = Dot(OutVector, OutVector);
+	if (SquaredNorm > 0.0f)
+	{
+		const float Scale = FMath::InvSqrt(SquaredNorm);
+		for (int32 Index = 0; Index < Dim; ++Index)
+		{
+			OutVector[Index] *= Scale;
+		}
+	}
+}
+
+float FLLMSemanticIndex::Dot(const float* A, const float* B)
+{
+	VectorRegister4Float Sum = VectorZeroFloat();
+	for (int32 Index = 0; Index < Dim; Index += 4)
+	{
+		Sum = VectorMultiplyAdd(VectorLoad(A + Index), VectorLoad(B + Index), Sum);
+	}
+	alignas(16) float Lanes[4];
+	VectorStoreAligned(Sum, Lanes);
+	return Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+}
+
+const FLLMPlan* FLLMSemanticIndex::FindNearest(const float* Query, float& OutSimilarity) const
+{
+	using namespace LLMSemanticCachePrivate;
+
+	int32 Best = INDEX_NONE;
+	OutSimilarity = -1.0f;
+	auto Consider = [this, Query, &Best, &OutSimilarity](int32 Entry)
+	{
+		const float Similarity = Dot(Query, GetVector(Entry));
+		if (Similarity > OutSimilarity)
+		{
+			OutSimilarity = Similarity;
+			Best = Entry;
+		}
+	};
+
+	if (Lists.Num() == 0)
+	{
+		for (int32 Entry = 0; Entry < Plans.Num(); ++Entry)
+		{
+			Consider(Entry);
+		}
+	}
+	else
+	{
+		// Probe the lists whose centroids are closest to the query
+		TArray<TPair<float, int32>, TInlineAllocator<NumLists>> Ranked;
+		for (int32 List = 0; List < Lists.Num(); ++List)
+		{
+			Ranked.Emplace(Dot(Query, Centroids.GetData() + List * Dim), List);
+		}
+		Ranked.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+
+		for (int32 Probe = 0; Probe < FMath::Min(NumProbes, Ranked.Num()); ++Probe)
+		{
+			for (const int32 Entry : Lists[Ranked[Probe].Value])
+			{
+				Consider(Entry);
+			}
+		}
+	}
+
+	return Best != INDEX_NONE ? &Plans[Best] : nullptr;
+}
+
+void FLLMSemanticIndex::Add(const float* Vector, const FLLMPlan& Plan)
+{
+	using namespace LLMSemanticCachePrivate;
+
+	float Similarity = 0.0f;
+	if (const FLLMPlan* Existing = FindNearest(Vector, Similarity))
+	{
+		if (Similarity >= DuplicateSimilarity)
+		{
+			Plans[Existing - Plans.GetData()] = Plan;
+			return;
+		}
+	}
+
+	int32 Entry;
+	if (Plans.Num() < Capacity)
+	{
+		Entry = Plans.Add(Plan);
+		Vectors.AddUninitialized(Dim);
+		EntryLists.Add(INDEX_NONE);
+	}
+	else
+	{
+		Entry = NextSlot;
+		NextSlot = (NextSlot + 1) % Capacity;
+		Plans[Entry] = Plan;
+		if (EntryLists[Entry] != INDEX_NONE)
+		{
+			Lists[EntryLists[Entry]].RemoveSwap(Entry);
+		}
+	}
+	FMemory::Memcpy(Vectors.GetData() + Entry * Dim, Vector, Dim * sizeof(float));
+
+	// Retrain when the index has doubled since the last training; otherwise file under the nearest list
+	if (Plans.Num() >= IVFThreshold && Plans.Num() >= TrainedSize * 2)
+	{
+		Train();
+	}
+	else if (Lists.Num() > 0)
+	{
+		EntryLists[Entry] = NearestCentroid(Vector);
+		Lists[EntryLists[Entry]].Add(Entry);
+	}
+}
+
+int32 FLLMSemanticIndex::NearestCentroid(const float* Vector) const
+{
+	int32 Best = 0;
+	float BestSimilarity = -2.0f;
+	for (int32 List = 0; List < Lists.Num(); ++List)
+	{
+		const float Similarity = Dot(Vector, Centroids.GetData() + List * Dim);
+		if (Similarity > BestSimilarity)
+		{
+			BestSimilarity = Similarity;
+			Best = List;
+		}
+	}
+	return Best;
+}
+
+void FLLMSemanticIndex::Train()
+{
+	using namespace LLMSemanticCachePrivate;
+
+	const int32 Count = Plans.Num();
+	const int32 K = FMath::Min(NumLists, Count);
+	Centroids.SetNumUninitialized(K * Dim);
+	Lists.SetNum(K);
+
+	// Deterministic seeding: evenly spaced entries
+	for (int32 List = 0; List < K; ++List)
+	{
+		FMemory::Memcpy(Centroids.GetData() + List * Dim, GetVector(List * Count / K), Dim * sizeof(float));
+	}
+
+	// Spherical k-means: assign by cosine, re-normalize the means
+	for (int32 Iteration = 0; Iteration < KMeansIterations; ++Iteration)
+	{
+		for (int32 Entry = 0; Entry < Count; ++Entry)
+		{
+			EntryLists[Entry] = NearestCentroid(GetVector(Entry));
+		}
+
+		FMemory::Memzero(Centroids.GetData(), K * Dim * sizeof(float));
+		for (int32 Entry = 0; Entry < Count; ++Entry)
+		{
+			float* Centroid = Centroids.GetData() + EntryLists[Entry] * Dim;
+			const float* Vector = GetVector(Entry);
+			for (int32 Index = 0; Index < Dim; ++Index)
+			{
+				Centroid[Index] += Vector[Index];
+			}
+		}
+		for (int32 List = 0; List < K; ++List)
+		{
+			float* Centroid = Centroids.GetData() + List * Dim;
+			const float SquaredNorm = Dot(Centroid, Centroid);
+			if (SquaredNorm > 0.0f)
+			{
+				const float Scale = FMath::InvSqrt(SquaredNorm);
+				for (int32 Index = 0; Index < Dim; ++Index)
+				{
+					Centroid[Index] *= Scale;
+				}
+			}
+		}
+	}
+
+	for (TArray<int32>& List : Lists)
+	{
+		List.Reset();
+	}
+	for (int32 Entry = 0; Entry < Count; ++Entry)
+	{
+		EntryLists[Entry] = NearestCentroid(GetVector(Entry));
+		Lists[EntryLists[Entry]].Add(Entry);
+	}
+	TrainedSize = Count;
+}
+
+// Subsystem
+
+ULLMSemanticCache* ULLMSemanticCache::Get(const UObject* WorldContext)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContext);
+	return GameInstance ? GameInstance->GetSubsystem<ULLMSemanticCache>() : nullptr;
+}
+
+uint32 ULLMSemanticCache::MakeScopeKey(FName PersonaId, const UObject* WorldContext)
+{
+	// The contract revision changes whenever intents change; nothing built against the old contract may replay
+	const int32 ContractRevision = ULLMActionSchema::GetRevision();
+	if (ContractRevision != ScopesContractRevision)
+	{
+		Scopes.Reset();
+		ScopesContractRevision = ContractRevision;
+	}
+
+	const ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(WorldContext);
+	return HashCombine(GetTypeHash(PersonaId), Vocabulary ? Vocabulary->GetContentHash() : 0);
+}
+
+bool ULLMSemanticCache::Lookup(const FString& Input, FName PersonaId, UObject* WorldContext, FLLMPlan& OutPlan, float& OutSimilarity)
+{
+	OutSimilarity = 0.0f;
+	++Stats.Lookups;
+
+	FScope* Scope = Scopes.Find(MakeScopeKey(PersonaId, WorldContext));
+	if (!Scope || Scope->Index.Num() == 0)
+	{
+		return false;
+	}
+	Scope->LastUsed = FPlatformTime::Seconds();
+	const FLLMSemanticIndex* Index = &Scope->Index;
+
+	alignas(16) float Query[FLLMSemanticIndex::Dim];
+	FLLMSemanticIndex::Embed(Input, Query);
+	const FLLMPlan* Cached = Index->FindNearest(Query, OutSimilarity);
+	if (!Cached || OutSimilarity < GetDefault<ULLMSettings>()->SemanticCacheThreshold)
+	{
+		return false;
+	}
+
+	const ULLMWorldVocabulary* Vocabulary = ULLMWorldVocabulary::Get(WorldContext);
+	if (Vocabulary && !Vocabulary->IsPlanGrounded(*Cached))
+	{
+		++Stats.StaleHits;
+		return false;
+	}
+
+	++Stats.Hits;
+	OutPlan = *Cached;
+	UE_LOG(LogTemp, Log, TEXT("[LLMSemanticCache] Hit for '%s' (similarity %.2f)"), *Input, OutSimilarity);
+	return true;
+}
+
+void ULLMSemanticCache::Insert(const FString& Input, FName PersonaId, UObject* WorldContext, const FLLMPlan& Plan)
+{
+	if (Plan.Steps.Num() == 0)
+	{
+		return;
+	}
+
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	const uint32 Key = MakeScopeKey(PersonaId, WorldContext);
+	FScope* Scope = Scopes.Find(Key);
+	if (!Scope)
+	{
+		// Scopes of worlds (or personas) not seen lately go first
+		while (Scopes.Num() >= FMath::Max(1, Settings->SemanticCacheMaxScopes))
+		{
+			uint32 Oldest = 0;
+			double OldestTime = TNumericLimits<double>::Max();
+			for (const TPair<uint32, FScope>& Pair : Scopes)
+			{
+				if (Pair.Value.LastUsed < OldestTime)
+				{
+					OldestTime = Pair.Value.LastUsed;
+					Oldest = Pair.Key;
+				}
+			}
+			Scopes.Remove(Oldest);
+		}
+		Scope = &Scopes.Emplace(Key, FScope(Settings->SemanticCacheMaxEntries));
+	}
+	Scope->LastUsed = FPlatformTime::Seconds();
+
+	alignas(16) float Vector[FLLMSemanticIndex::Dim];
+	FLLMSemanticIndex::Embed(Input, Vector);
+	Scope->Index.Add(Vector, Plan);
+	++Stats.Inserts;
+}
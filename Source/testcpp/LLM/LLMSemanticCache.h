@@ -0,0 +1,134 @@
+// Semantic response cache: paraphrases of past requests reuse their validated plans
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMSemanticCache.generated.h"
+
+/**
+ * Approximate nearest-neighbour index over hashed text embeddings
+ * Embeddings are signed feature-hashed word unigrams and character trigrams, L2-normalized, so
+ * a dot product is a cosine similarity. Up to IVF threshold entries are scanned exhaustively;
+ * beyond that, entries are partitioned into k-means lists (IVF) and only the lists nearest to
+ * the query are scanned. Dot products use 4-wide SIMD. Oldest entries are replaced when full.
+ */
+class TESTCPP_API FLLMSemanticIndex
+{
+public:
+	static constexpr int32 Dim = 256;
+
+	explicit FLLMSemanticIndex(int32 InCapacity = 1024);
+
+	/** Embedding of normalized text; OutVector must hold Dim floats */
+	static void Embed(const FString& Text, float* OutVector);
+
+	/**
+	 * Most similar entry
+	 * @param OutSimilarity - Cosine similarity of the returned entry
+	 * @return Entry plan, or null when the index is empty
+	 */
+	const FLLMPlan* FindNearest(const float* Query, float& OutSimilarity) const;
+
+	/** Add an entry; an almost identical existing entry is updated instead */
+	void Add(const float* Vector, const FLLMPlan& Plan);
+
+	int32 Num() const { return Plans.Num(); }
+
+private:
+	static float Dot(const float* A, const float* B);
+
+	const float* GetVector(int32 Entry) const { return Vectors.GetData() + Entry * Dim; }
+	int32 NearestCentroid(const float* Vector) const;
+	void Train();
+
+	int32 Capacity;
+	// Ring position of the next overwrite once full
+	int32 NextSlot = 0;
+
+	TArray<float> Vectors;
+	TArray<FLLMPlan> Plans;
+	// IVF list of each entry (INDEX_NONE before training)
+	TArray<int32> EntryLists;
+
+	TArray<float> Centroids;
+	TArray<TArray<int32>> Lists;
+	int32 TrainedSize = 0;
+};
+
+/**
+ * Counters for the semantic cache
+ */
+USTRUCT(BlueprintType)
+struct FLLMSemanticCacheStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|SemanticCache")
+	int32 Lookups = 0;
+
+	// Lookups answered from the cache (LLM calls avoided)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|SemanticCache")
+	int32 Hits = 0;
+
+	// Similar enough, but the cached plan names something no longer in the world
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|SemanticCache")
+	int32 StaleHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|SemanticCache")
+	int32 Inserts = 0;
+};
+
+/**
+ * Cache of validated LLM plans keyed by what the player said, matched by meaning rather than
+ * exact text ("come here" finds "come over here"). Entries are scoped by the agent's persona and
+ * a hash of the world vocabulary (the montage, nav point and target type names that exist), so
+ * NPCs never share answers across personas and a changed world starts a fresh scope. All scopes
+ * are dropped when the intent contract changes, and only the SemanticCacheMaxScopes most
+ * recently used are kept. Hits are still re-checked against the world vocabulary.
+ * LLM.SemanticCacheBench replays the decision log to measure hit and false-hit rates per threshold.
+ */
+UCLASS()
+class TESTCPP_API ULLMSemanticCache : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMSemanticCache* Get(const UObject* WorldContext);
+
+	/**
+	 * Find a cached plan for a paraphrase of the input
+	 * @param PersonaId - Scope (ULLMAgentComponent::PersonaId)
+	 * @param WorldContext - World whose vocabulary scopes the entries and must still contain the plan's names
+	 * @return true if a plan with similarity >= ULLMSettings::SemanticCacheThreshold was found
+	 */
+	bool Lookup(const FString& Input, FName PersonaId, UObject* WorldContext, FLLMPlan& OutPlan, float& OutSimilarity);
+
+	/** Remember a validated plan for the input, in the scope of the persona and the world's current vocabulary */
+	void Insert(const FString& Input, FName PersonaId, UObject* WorldContext, const FLLMPlan& Plan);
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|SemanticCache")
+	void Clear() { Scopes.Reset(); }
+
+	UFUNCTION(BlueprintPure, Category = "LLM|SemanticCache")
+	FLLMSemanticCacheStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|SemanticCache")
+	void ResetStats() { Stats = FLLMSemanticCacheStats(); }
+
+private:
+	struct FScope
+	{
+		FLLMSemanticIndex Index;
+		double LastUsed = 0.0;
+
+		explicit FScope(int32 MaxEntries) : Index(MaxEntries) {}
+	};
+
+	/** Scope key for the persona and world; drops every scope first when the contract changed */
+	uint32 MakeScopeKey(FName PersonaId, const UObject* WorldContext);
+
+	TMap<uint32, FScope> Scopes;
+	int32 ScopesContractRevision = INDEX_NONE;
+	FLLMSemanticCacheStats Stats;
+};
@@ -0,0 +1,2 @@
+// Project settings for the LLM action system
+#include "LLM/LLMSettings.h"
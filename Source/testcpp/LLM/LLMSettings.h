@@ -0,0 +1,286 @@
+// Project settings for the LLM action system
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DeveloperSettings.h"
+#include "LLMSettings.generated.h"
+
+class ULLMIntentDefinition;
+class ULLMCommandGrammar;
+class ULLMPromptTemplate;
+
+/**
+ * Project-wide configuration for the LLM action pipeline
+ * Edit under Project Settings -> Game -> LLM Actions
+ */
+UCLASS(config = Game, defaultconfig, meta = (DisplayName = "LLM Actions"))
+class TESTCPP_API ULLMSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	// Data-defined intents. An entry whose tag matches a built-in intent replaces the built-in definition.
+	UPROPERTY(config, EditAnywhere, Category = "Intents")
+	TArray<TSoftObjectPtr<ULLMIntentDefinition>> IntentDefinitions;
+
+	// Let the model answer with a multi-step plan instead of a single action
+	UPROPERTY(config, EditAnywhere, Category = "Plans")
+	bool bAllowPlans = true;
+
+	// Upper bound on plan length (enforced by the response schema and the parser)
+	UPROPERTY(config, EditAnywhere, Category = "Plans", meta = (ClampMin = "1", ClampMax = "16", EditCondition = "bAllowPlans"))
+	int32 MaxPlanSteps = 5;
+
+	// Times an agent may automatically ask for a new plan after a step fails before giving up
+	UPROPERTY(config, EditAnywhere, Category = "Plans", meta = (ClampMin = "0"))
+	int32 MaxReplanAttempts = 2;
+
+	// Alternative responses requested per action call; more than one lets a failed candidate be replaced locally instead of retried
+	UPROPERTY(config, EditAnywhere, Category = "Candidates", meta = (ClampMin = "1", ClampMax = "8"))
+	int32 CandidateCount = 1;
+
+	// Try the local command grammar before calling the LLM
+	UPROPERTY(config, EditAnywhere, Category = "Local Commands")
+	bool bEnableLocalCommands = true;
+
+	// Grammar used by the local matcher; the built-in English grammar is used when unset
+	UPROPERTY(config, EditAnywhere, Category = "Local Commands", meta = (EditCondition = "bEnableLocalCommands"))
+	TSoftObjectPtr<ULLMCommandGrammar> CommandGrammar;
+
+	// Local matches below this confidence fall back to the LLM
+	UPROPERTY(config, EditAnywhere, Category = "Local Commands", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bEnableLocalCommands"))
+	float LocalCommandMinConfidence = 0.9f;
+
+	// Append every validated single-action LLM decision to Saved/LLM/Decisions.jsonl (training data for the classifier)
+	UPROPERTY(config, EditAnywhere, Category = "Classifier")
+	bool bLogDecisions = false;
+
+	// Serve routine requests from the on-device intent classifier when its model is present
+	UPROPERTY(config, EditAnywhere, Category = "Classifier")
+	bool bEnableIntentClassifier = true;
+
+	// Classifier model written by the LLMTrainIntentModel commandlet, relative to Content/ (stage it as a non-UFS file)
+	UPROPERTY(config, EditAnywhere, Category = "Classifier", meta = (EditCondition = "bEnableIntentClassifier"))
+	FString IntentModelPath = TEXT("LLM/IntentModel.bin");
+
+	// Minimum calibrated classifier confidence to answer without the LLM
+	// LLMTrainIntentModel logs held-out precision and local-answer share per threshold; pick the lowest with acceptable precision
+	UPROPERTY(config, EditAnywhere, Category = "Classifier", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bEnableIntentClassifier"))
+	float ClassifierMinConfidence = 0.85f;
+
+	// Worker threads of the in-process provider (UAPIData Provider = Local)
+	UPROPERTY(config, EditAnywhere, Category = "Local Provider", meta = (ClampMin = "1", ClampMax = "16"))
+	int32 LocalProviderThreads = 2;
+
+	// Most requests decoded together by one worker
+	UPROPERTY(config, EditAnywhere, Category = "Local Provider", meta = (ClampMin = "1", ClampMax = "64"))
+	int32 LocalMaxBatchSize = 8;
+
+	// Distinct system prompt / schema prefixes kept processed
+	UPROPERTY(config, EditAnywhere, Category = "Local Provider", meta = (ClampMin = "1", ClampMax = "32"))
+	int32 LocalPrefixCacheSize = 4;
+
+	// Answer paraphrases of earlier requests from ULLMSemanticCache
+	UPROPERTY(config, EditAnywhere, Category = "Semantic Cache")
+	bool bEnableSemanticCache = true;
+
+	// Minimum cosine similarity for a cache hit; measure with LLM.SemanticCacheBench before lowering
+	UPROPERTY(config, EditAnywhere, Category = "Semantic Cache", meta = (ClampMin = "0.5", ClampMax = "1.0", EditCondition = "bEnableSemanticCache"))
+	float SemanticCacheThreshold = 0.9f;
+
+	// Entries kept per persona before the oldest are replaced
+	UPROPERTY(config, EditAnywhere, Category = "Semantic Cache", meta = (ClampMin = "16", EditCondition = "bEnableSemanticCache"))
+	int32 SemanticCacheMaxEntries = 1024;
+
+	// Persona and world-vocabulary scopes kept; the least recently used scope is dropped past this
+	UPROPERTY(config, EditAnywhere, Category = "Semantic Cache", meta = (ClampMin = "1", EditCondition = "bEnableSemanticCache"))
+	int32 SemanticCacheMaxScopes = 32;
+
+	// Answer exact repeats from the baked and saved response tables before any other path
+	UPROPERTY(config, EditAnywhere, Category = "Response Table")
+	bool bEnableResponseTable = true;
+
+	// Table written by the LLMBakeResponses commandlet, relative to Content/ (stage it as a non-UFS file)
+	UPROPERTY(config, EditAnywhere, Category = "Response Table", meta = (EditCondition = "bEnableResponseTable"))
+	FString BakedResponseTablePath = TEXT("LLM/BakedResponses.bin");
+
+	// Keep validated LLM answers across sessions in Saved/LLM/ResponseCache.bin
+	UPROPERTY(config, EditAnywhere, Category = "Response Table", meta = (EditCondition = "bEnableResponseTable"))
+	bool bPersistResponseCache = true;
+
+	// Saved answers kept; answers beyond this are not saved
+	UPROPERTY(config, EditAnywhere, Category = "Response Table", meta = (ClampMin = "16", EditCondition = "bEnableResponseTable"))
+	int32 ResponseCacheMaxEntries = 4096;
+
+	// Share structured LLM responses between all game processes on a host through a memory-mapped file
+	UPROPERTY(config, EditAnywhere, Category = "Shared Cache")
+	bool bEnableSharedResponseCache = false;
+
+	// Cache file every process maps; empty uses Saved/LLM/SharedResponses.cache. A tmpfs path such as /dev/shm/... avoids disk writes
+	UPROPERTY(config, EditAnywhere, Category = "Shared Cache", meta = (EditCondition = "bEnableSharedResponseCache"))
+	FString SharedResponseCachePath;
+
+	// Slots in the shared table (rounded up to a power of two); all processes must agree
+	UPROPERTY(config, EditAnywhere, Category = "Shared Cache", meta = (ClampMin = "64", EditCondition = "bEnableSharedResponseCache"))
+	int32 SharedResponseCacheSlots = 4096;
+
+	// Bytes per slot; larger responses are not shared. All processes must agree
+	UPROPERTY(config, EditAnywhere, Category = "Shared Cache", meta = (ClampMin = "1024", EditCondition = "bEnableSharedResponseCache"))
+	int32 SharedResponseCacheSlotBytes = 8192;
+
+	// Shared responses older than this are ignored
+	UPROPERTY(config, EditAnywhere, Category = "Shared Cache", meta = (ClampMin = "1", EditCondition = "bEnableSharedResponseCache"))
+	int32 SharedResponseCacheTTLSeconds = 3600;
+
+	// Send the player's draft to the LLM while they type (ULLMSpeculativeGenerator::UpdateDraft)
+	UPROPERTY(config, EditAnywhere, Category = "Speculation")
+	bool bEnableSpeculation = true;
+
+	// Pause in typing before a draft is speculated on
+	UPROPERTY(config, EditAnywhere, Category = "Speculation", meta = (ClampMin = "0.05", EditCondition = "bEnableSpeculation"))
+	float SpeculationDebounceSeconds = 0.4f;
+
+	// Shorter drafts are not speculated on
+	UPROPERTY(config, EditAnywhere, Category = "Speculation", meta = (ClampMin = "1", EditCondition = "bEnableSpeculation"))
+	int32 SpeculationMinWords = 2;
+
+	// Finished speculations nobody submitted are dropped after this long
+	UPROPERTY(config, EditAnywhere, Category = "Speculation", meta = (ClampMin = "1.0", EditCondition = "bEnableSpeculation"))
+	float SpeculationResultLifetimeSeconds = 30.0f;
+
+	// Provider request quota per minute for this game instance
+	UPROPERTY(config, EditAnywhere, Category = "Speculation", meta = (ClampMin = "1"))
+	int32 RequestsPerMinuteQuota = 60;
+
+	// Largest share of RequestsPerMinuteQuota speculation may use
+	UPROPERTY(config, EditAnywhere, Category = "Speculation", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bEnableSpeculation"))
+	float SpeculationQuotaShare = 0.2f;
+
+	// Cap MaxOutputTokens per intent and persona from the output lengths observed so far (ULLMOutputBudget)
+	UPROPERTY(config, EditAnywhere, Category = "Output Budget")
+	bool bAdaptiveOutputCap = true;
+
+	// Cap = p99 of the observed lengths times this
+	UPROPERTY(config, EditAnywhere, Category = "Output Budget", meta = (ClampMin = "1.0", EditCondition = "bAdaptiveOutputCap"))
+	float OutputCapMargin = 1.25f;
+
+	// Observations needed before a distribution sets caps
+	UPROPERTY(config, EditAnywhere, Category = "Output Budget", meta = (ClampMin = "1", EditCondition = "bAdaptiveOutputCap"))
+	int32 OutputCapMinSamples = 20;
+
+	// Caps never go below this
+	UPROPERTY(config, EditAnywhere, Category = "Output Budget", meta = (ClampMin = "16", EditCondition = "bAdaptiveOutputCap"))
+	int32 MinOutputCap = 128;
+
+	// Give each agent a memory of its conversation with the player (ULLMAgentComponent::GetConversation)
+	UPROPERTY(config, EditAnywhere, Category = "Conversation")
+	bool bEnableConversationHistory = true;
+
+	// Most recent exchanges sent verbatim; older ones are folded into the summary
+	UPROPERTY(config, EditAnywhere, Category = "Conversation", meta = (ClampMin = "1", EditCondition = "bEnableConversationHistory"))
+	int32 ConversationVerbatimTurns = 6;
+
+	// Estimated tokens the verbatim turns may use per request
+	UPROPERTY(config, EditAnywhere, Category = "Conversation", meta = (ClampMin = "0", EditCondition = "bEnableConversationHistory"))
+	int32 ConversationTokenBudget = 1024;
+
+	// Size of the rolling summary of older turns
+	UPROPERTY(config, EditAnywhere, Category = "Conversation", meta = (ClampMin = "16", EditCondition = "bEnableConversationHistory"))
+	int32 ConversationSummaryTokens = 256;
+
+	// Retrieve relevant long-term memories of the agent before each LLM request (ULLMMemoryStore)
+	UPROPERTY(config, EditAnywhere, Category = "Memory")
+	bool bEnableLongTermMemory = true;
+
+	// Also remember what the player said to an agent when the LLM answered it
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (EditCondition = "bEnableLongTermMemory"))
+	bool bRememberPlayerRequests = true;
+
+	// Memories injected per request
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "1", ClampMax = "32", EditCondition = "bEnableLongTermMemory"))
+	int32 MemoryTopK = 4;
+
+	// Memories less similar to the request than this are not injected
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bEnableLongTermMemory"))
+	float MemoryMinSimilarity = 0.3f;
+
+	// Worker-thread scan time per retrieval; the best matches found by then are used
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0.1", EditCondition = "bEnableLongTermMemory"))
+	float MemoryRetrievalBudgetMs = 2.0f;
+
+	// New facts of one owner held in memory before they are appended to its file
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "1", EditCondition = "bEnableLongTermMemory"))
+	int32 MemoryFlushPendingCount = 16;
+
+	// New facts are appended at least this often, so a crash loses little (0 = only on count, Flush and shutdown)
+	UPROPERTY(config, EditAnywhere, Category = "Memory", meta = (ClampMin = "0.0", EditCondition = "bEnableLongTermMemory"))
+	float MemoryFlushIntervalSeconds = 30.0f;
+
+	// Describe registered entities near the agent in each prompt (ULLMWorldContext)
+	UPROPERTY(config, EditAnywhere, Category = "World Context")
+	bool bEnableWorldContext = true;
+
+	// Entities farther than this from the agent are not mentioned (cm)
+	UPROPERTY(config, EditAnywhere, Category = "World Context", meta = (ClampMin = "100.0", EditCondition = "bEnableWorldContext"))
+	float WorldContextRadius = 2000.0f;
+
+	// Entities mentioned per prompt, nearest first
+	UPROPERTY(config, EditAnywhere, Category = "World Context", meta = (ClampMin = "1", ClampMax = "64", EditCondition = "bEnableWorldContext"))
+	int32 WorldContextMaxEntities = 12;
+
+	// Positions are rounded to this (cm); movement below it does not change the prompt
+	UPROPERTY(config, EditAnywhere, Category = "World Context", meta = (ClampMin = "1.0", EditCondition = "bEnableWorldContext"))
+	float WorldContextQuantization = 100.0f;
+
+	// How often registered entities are checked for movement
+	UPROPERTY(config, EditAnywhere, Category = "World Context", meta = (ClampMin = "0.0", EditCondition = "bEnableWorldContext"))
+	float WorldContextRefreshSeconds = 0.25f;
+
+	// System prompt template for agents that do not set their own; the built-in template is used when unset
+	UPROPERTY(config, EditAnywhere, Category = "Prompt")
+	TSoftObjectPtr<ULLMPromptTemplate> DefaultPromptTemplate;
+
+	// Move named nav points onto the navmesh the first time they are used (ULLMNavPointRegistry)
+	UPROPERTY(config, EditAnywhere, Category = "Nav Points")
+	bool bProjectNavPoints = true;
+
+	// Search box for the navmesh projection (cm)
+	UPROPERTY(config, EditAnywhere, Category = "Nav Points", meta = (EditCondition = "bProjectNavPoints"))
+	FVector NavPointProjectionExtent = FVector(100.0f, 100.0f, 250.0f);
+
+	// Grid cell size for nearest-of-category queries (cm); about the typical distance between points
+	UPROPERTY(config, EditAnywhere, Category = "Nav Points", meta = (ClampMin = "100.0"))
+	float NavPointGridCellSize = 2000.0f;
+
+	// Grid cell size for nearest-of-type target queries (cm); about the typical distance between targets of a type
+	UPROPERTY(config, EditAnywhere, Category = "Interactables", meta = (ClampMin = "100.0"))
+	float InteractableGridCellSize = 1000.0f;
+
+	// Check LLM MoveTo targets against the navmesh before the plan reaches the blackboard (ULLMMoveValidator)
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation")
+	bool bValidateMoves = true;
+
+	// Search box for projecting a MoveTo target onto the navmesh (cm)
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation", meta = (EditCondition = "bValidateMoves"))
+	FVector MoveProjectionExtent = FVector(100.0f, 100.0f, 250.0f);
+
+	// Path queries not answered by then (e.g. the navmesh was rebuilt under them) count as reachable
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation", meta = (ClampMin = "0.1", EditCondition = "bValidateMoves"))
+	float MoveValidationTimeoutSeconds = 2.0f;
+
+	// Reuse paths between recently travelled source cells and destinations when validating MoveTo targets (ULLMPathCache)
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation", meta = (EditCondition = "bValidateMoves"))
+	bool bCachePaths = true;
+
+	// Size of the source and destination cells a cached path stands for (cm); agents in one cell share its paths
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation", meta = (ClampMin = "50.0", EditCondition = "bValidateMoves && bCachePaths"))
+	float PathCacheCellSize = 400.0f;
+
+	// Most paths kept; the least recently used path is dropped past this
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation", meta = (ClampMin = "1", EditCondition = "bValidateMoves && bCachePaths"))
+	int32 PathCacheMaxEntries = 256;
+
+	// How long a target found unreachable from a cell is rejected without pathfinding again (0 = never remembered)
+	UPROPERTY(config, EditAnywhere, Category = "Move Validation", meta = (ClampMin = "0.0", EditCondition = "bValidateMoves && bCachePaths"))
+	float PathCacheUnreachableSeconds = 5.0f;
+};
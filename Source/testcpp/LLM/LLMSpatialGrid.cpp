@@ -0,0 +1,116 @@
+// Uniform 2D grid of registry entries for nearest-neighbour queries
+#include "LLM/LLMSpatialGrid.h"
+
+FIntPoint FLLMSpatialGrid::GetCell(const FVector& Location, double CellSize)
+{
+	return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+void FLLMSpatialGrid::Add(const FIntPoint& Cell, int32 Index)
+{
+	Cells.FindOrAdd(Cell).Add(Index);
+	if (bHasBounds)
+	{
+		Bounds.Include(Cell);
+	}
+	else
+	{
+		Bounds = FIntRect(Cell, Cell);
+		bHasBounds = true;
+	}
+}
+
+void FLLMSpatialGrid::Remove(const FIntPoint& Cell, int32 Index)
+{
+	if (TArray<int32>* Indices = Cells.Find(Cell))
+	{
+		Indices->RemoveSingleSwap(Index);
+		if (Indices->Num() == 0)
+		{
+			Cells.Remove(Cell);
+		}
+	}
+}
+
+void FLLMSpatialGrid::FindNearest(const FVector& Origin, double CellSize, float MaxDistance, int32 Count,
+	TFunctionRef<bool(int32 Index, FVector& OutLocation)> GetLocation, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+	if (Cells.Num() == 0 || Count <= 0)
+	{
+		return;
+	}
+
+	const FIntPoint Center = GetCell(Origin, CellSize);
+	const int32 MaxRing = MaxDistance > 0.0f
+		? FMath::CeilToInt32(MaxDistance / CellSize)
+		: FMath::Max(FMath::Max(FMath::Abs(Center.X - Bounds.Min.X), FMath::Abs(Center.X - Bounds.Max.X)),
+			FMath::Max(FMath::Abs(Center.Y - Bounds.Min.Y), FMath::Abs(Center.Y - Bounds.Max.Y)));
+	const double LimitSquared = MaxDistance > 0.0f ? FMath::Square(double(MaxDistance)) : TNumericLimits<double>::Max();
+
+	// Best candidates so far, nearest first, at most Count
+	TArray<TPair<double, int32>, TInlineAllocator<8>> Best;
+	auto VisitCell = [&](const FIntPoint& Cell)
+	{
+		const TArray<int32>* Indices = Cells.Find(Cell);
+		if (!Indices)
+		{
+			return;
+		}
+		for (int32 Index : *Indices)
+		{
+			FVector Location;
+			if (!GetLocation(Index, Location))
+			{
+				continue;
+			}
+			const double DistSquared = FVector::DistSquared(Location, Origin);
+			if (DistSquared > LimitSquared || (Best.Num() == Count && DistSquared >= Best.Last().Key))
+			{
+				continue;
+			}
+			int32 Insert = Best.Num();
+			while (Insert > 0 && Best[Insert - 1].Key > DistSquared)
+			{
+				--Insert;
+			}
+			Best.Insert(TPair<double, int32>(DistSquared, Index), Insert);
+			if (Best.Num() > Count)
+			{
+				Best.Pop(EAllowShrinking::No);
+			}
+		}
+	};
+
+	// Rings of cells outward from the origin's cell; anything in ring R+1 is at least R cells away
+	for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+	{
+		if (Ring == 0)
+		{
+			VisitCell(Center);
+		}
+		else
+		{
+			for (int32 X = -Ring; X <= Ring; ++X)
+			{
+				VisitCell(Center + FIntPoint(X, -Ring));
+				VisitCell(Center + FIntPoint(X, Ring));
+			}
+			for (int32 Y = -Ring + 1; Y < Ring; ++Y)
+			{
+				VisitCell(Center + FIntPoint(-Ring, Y));
+				VisitCell(Center + FIntPoint(Ring, Y));
+			}
+		}
+
+		if (Best.Num() == Count && Best.Last().Key <= FMath::Square(Ring * CellSize))
+		{
+			break;
+		}
+	}
+
+	for (const TPair<double, int32>& Candidate : Best)
+	{
+		OutIndices.Add(Candidate.Value);
+	}
+}
@@ -0,0 +1,37 @@
+// Uniform 2D grid of registry entries for nearest-neighbour queries
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Registry indices bucketed into square cells on the XY plane
+ * ULLMNavPointRegistry keeps one per category and ULLMInteractableRegistry one per type; each
+ * owns its entries and their locations and hands the grid indices and cells. Nearest queries
+ * visit rings of cells outward from the origin's cell and stop once no unvisited cell can hold
+ * anything nearer, so they only touch the cells around the origin.
+ */
+class TESTCPP_API FLLMSpatialGrid
+{
+public:
+	static FIntPoint GetCell(const FVector& Location, double CellSize);
+
+	void Add(const FIntPoint& Cell, int32 Index);
+	void Remove(const FIntPoint& Cell, int32 Index);
+
+	bool IsEmpty() const { return Cells.Num() == 0; }
+
+	/**
+	 * Up to Count entries nearest to Origin, nearest first
+	 * @param CellSize - Size the cells were computed with
+	 * @param MaxDistance - Search radius (cm); 0 searches every cell that ever held an entry
+	 * @param GetLocation - Location of an entry; returns false to skip it (e.g. its actor is gone)
+	 */
+	void FindNearest(const FVector& Origin, double CellSize, float MaxDistance, int32 Count,
+		TFunctionRef<bool(int32 Index, FVector& OutLocation)> GetLocation, TArray<int32>& OutIndices) const;
+
+private:
+	TMap<FIntPoint, TArray<int32>> Cells;
+	// Cells that ever held an entry; bounds an unlimited search
+	FIntRect Bounds;
+	bool bHasBounds = false;
+};
@@ -0,0 +1,254 @@
+// Type-ahead speculation: the LLM request starts while the player is still typing
+#include "LLM/LLMSpeculativeGenerator.h"
+#include "LLM/LLMGenerateActionAsync.h"
+#include "LLM/LLMSettings.h"
+#include "LLM/LLMTextNormalization.h"
+#include "HTTP/APIData.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Engine/GameInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace LLMSpeculativeGeneratorPrivate
+{
+	static constexpr float TickInterval = 0.05f;
+	static constexpr double BudgetWindowSeconds = 60.0;
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMSpeculativeGenerator* Generator = ULLMSpeculativeGenerator::Get(World);
+		if (!Generator)
+		{
+			return;
+		}
+
+		const FLLMSpeculationStats Stats = Generator->GetStats();
+		const int32 Hits = Stats.CompletedHits + Stats.InFlightHits;
+		UE_LOG(LogTemp, Log, TEXT("[LLMSpeculativeGenerator] %d/%d submits reused a speculation (%.1f%%; %d ready, %d in flight) | %d started, %d cancelled, %d wasted, %d denied by budget, %d skipped for context"),
+			Hits, Stats.Submits, Stats.Submits > 0 ? 100.0f * Hits / Stats.Submits : 0.0f, Stats.CompletedHits, Stats.InFlightHits,
+			Stats.Started, Stats.Cancelled, Stats.Wasted, Stats.BudgetDenied, Stats.ContextSkipped);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.SpeculationStats"),
+		TEXT("Log type-ahead speculation hit rate and cost"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMSpeculativeGenerator* ULLMSpeculativeGenerator::Get(const UObject* WorldContext)
+{
+	const UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(WorldContext);
+	return GameInstance ? GameInstance->GetSubsystem<ULLMSpeculativeGenerator>() : nullptr;
+}
+
+void ULLMSpeculativeGenerator::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &ULLMSpeculativeGenerator::Tick),
+		LLMSpeculativeGeneratorPrivate::TickInterval);
+}
+
+void ULLMSpeculativeGenerator::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+	ClearDraft();
+	Super::Deinitialize();
+}
+
+void ULLMSpeculativeGenerator::UpdateDraft(UObject* WorldContextObject, UAPIData* APIData, const FString& PartialInput, float Temperature, UBlackboardComponent* Blackboard)
+{
+	if (!GetDefault<ULLMSettings>()->bEnableSpeculation)
+	{
+		return;
+	}
+
+	DraftContext = WorldContextObject;
+	DraftBlackboard = Blackboard;
+	DraftAPIData = APIData;
+	Draft = PartialInput;
+	DraftKey = LLMTextNormalization::Normalize(PartialInput);
+	DraftTemperature = Temperature;
+	DraftTime = FPlatformTime::Seconds();
+
+	// Edits that normalize away (a trailing '?', casing) keep the speculation; anything else outdates it
+	const bool bSpeculationMatches = (bInFlight || bCompleted) && DraftKey == SpeculatedKey
+		&& APIData == SpeculatedAPIData && Temperature == SpeculatedTemperature;
+	if (!bSpeculationMatches)
+	{
+		Discard();
+	}
+	bDraftPending = !bSpeculationMatches;
+}
+
+void ULLMSpeculativeGenerator::ClearDraft()
+{
+	bDraftPending = false;
+	Draft.Empty();
+	DraftKey.Empty();
+	Discard();
+}
+
+bool ULLMSpeculativeGenerator::Claim(const FString& FinalInput, UAPIData* APIData, float Temperature, const FOnGeminiResponse& OnDone)
+{
+	bDraftPending = false;
+	if (!GetDefault<ULLMSettings>()->bEnableSpeculation || Waiter.IsBound())
+	{
+		return false;
+	}
+
+	++Stats.Submits;
+	const bool bMatches = (bInFlight || bCompleted) && LLMTextNormalization::Normalize(FinalInput) == SpeculatedKey
+		&& APIData == SpeculatedAPIData && Temperature == SpeculatedTemperature;
+	if (!bMatches)
+	{
+		Discard();
+		return false;
+	}
+
+	if (bInFlight)
+	{
+		++Stats.InFlightHits;
+		Waiter = OnDone;
+		UE_LOG(LogTemp, Log, TEXT("[LLMSpeculativeGenerator] Submitted input joins the speculation in flight"));
+		return true;
+	}
+
+	++Stats.CompletedHits;
+	const FString Body = MoveTemp(ResponseBody);
+	bCompleted = false;
+	SpeculatedKey.Empty();
+	UE_LOG(LogTemp, Log, TEXT("[LLMSpeculativeGenerator] Submitted input answered by a finished speculation"));
+	OnDone.ExecuteIfBound(true, Body);
+	return true;
+}
+
+bool ULLMSpeculativeGenerator::Tick(float DeltaTime)
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	const double Now = FPlatformTime::Seconds();
+
+	if (bCompleted && Now - CompletedTime > Settings->SpeculationResultLifetimeSeconds)
+	{
+		Discard();
+	}
+
+	if (bDraftPending && !bInFlight && Now - DraftTime >= Settings->SpeculationDebounceSeconds)
+	{
+		bDraftPending = false;
+		StartSpeculation();
+	}
+	return true;
+}
+
+bool ULLMSpeculativeGenerator::IsWithinBudget(double Now)
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	RecentStarts.RemoveAll([Now](double Start) { return Now - Start > LLMSpeculativeGeneratorPrivate::BudgetWindowSeconds; });
+	return RecentStarts.Num() < FMath::FloorToInt32(Settings->RequestsPerMinuteQuota * Settings->SpeculationQuotaShare);
+}
+
+void ULLMSpeculativeGenerator::StartSpeculation()
+{
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	UObject* Context = DraftContext.Get();
+	UAPIData* APIData = DraftAPIData;
+
+	// The in-process provider cannot be cancelled and costs no quota, so it gains nothing here
+	TArray<FString> Words;
+	DraftKey.ParseIntoArray(Words, TEXT(" "));
+	if (!Context || !APIData || APIData->GetProvider() == ELLMProvider::Local || Words.Num() < Settings->SpeculationMinWords)
+	{
+		return;
+	}
+
+	// The submitted request would add turns or sections, so it could never claim this
+	if (!ULLMGenerateActionAsync::SendsPlainPrompt(Context, DraftBlackboard.Get()))
+	{
+		++Stats.ContextSkipped;
+		return;
+	}
+
+	UGameInstance* GameInstance = UGameplayStatics::GetGameInstance(Context);
+	UGeminiHTTPManager* Manager = GameInstance ? GameInstance->GetSubsystem<UGeminiHTTPManager>() : nullptr;
+	if (!Manager || Manager->GetActiveRequestCount() > 0)
+	{
+		// Low priority: real requests go first; try again once the player types more
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	if (!IsWithinBudget(Now))
+	{
+		++Stats.BudgetDenied;
+		return;
+	}
+
+	RecentStarts.Add(Now);
+	++Stats.Started;
+	SpeculatedAPIData = APIData;
+	SpeculatedKey = DraftKey;
+	SpeculatedTemperature = DraftTemperature;
+	bInFlight = true;
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMSpeculativeGenerator] Speculating on '%s'"), *Draft);
+
+	FOnGeminiResponse Delegate;
+	Delegate.BindUFunction(this, GET_FUNCTION_NAME_CHECKED(ULLMSpeculativeGenerator, OnSpeculationResponse));
+	Manager->InitializeWithData(APIData);
+	RequestId = Manager->GenerateContent(Draft, ULLMGenerateActionAsync::MakeActionConfig(Context, DraftTemperature), Delegate);
+}
+
+void ULLMSpeculativeGenerator::OnSpeculationResponse(bool bSuccess, const FString& JsonResponse)
+{
+	bInFlight = false;
+	RequestId = 0;
+
+	if (Waiter.IsBound())
+	{
+		const FOnGeminiResponse Submitted = Waiter;
+		Waiter.Unbind();
+		SpeculatedKey.Empty();
+		Submitted.ExecuteIfBound(bSuccess, JsonResponse);
+		return;
+	}
+
+	if (!bSuccess)
+	{
+		SpeculatedKey.Empty();
+		return;
+	}
+
+	bCompleted = true;
+	ResponseBody = JsonResponse;
+	CompletedTime = FPlatformTime::Seconds();
+}
+
+void ULLMSpeculativeGenerator::Discard()
+{
+	// Claimed by a submitted request: no longer speculative, it runs to completion
+	if (Waiter.IsBound())
+	{
+		return;
+	}
+
+	if (bInFlight)
+	{
+		UGameInstance* GameInstance = GetGameInstance();
+		UGeminiHTTPManager* Manager = GameInstance ? GameInstance->GetSubsystem<UGeminiHTTPManager>() : nullptr;
+		if (Manager && RequestId != 0)
+		{
+			Manager->CancelRequest(RequestId);
+		}
+		++Stats.Cancelled;
+	}
+	else if (bCompleted)
+	{
+		++Stats.Wasted;
+	}
+
+	bInFlight = false;
+	bCompleted = false;
+	RequestId = 0;
+	ResponseBody.Empty();
+	SpeculatedKey.Empty();
+}
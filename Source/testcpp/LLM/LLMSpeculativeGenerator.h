@@ -0,0 +1,144 @@
+// Type-ahead speculation: the LLM request starts while the player is still typing
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Containers/Ticker.h"
+#include "HTTP/GeminiHTTPManager.h"
+#include "LLMSpeculativeGenerator.generated.h"
+
+class UAPIData;
+class UBlackboardComponent;
+
+/**
+ * Counters for type-ahead speculation
+ */
+USTRUCT(BlueprintType)
+struct FLLMSpeculationStats
+{
+	GENERATED_BODY()
+
+	// Speculative requests sent
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 Started = 0;
+
+	// Submitted inputs that reached the LLM stage (where a speculation could be reused)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 Submits = 0;
+
+	// Submits answered by a speculation that had already completed
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 CompletedHits = 0;
+
+	// Submits that took over a speculation still in flight
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 InFlightHits = 0;
+
+	// Speculations cancelled because the player kept typing or submitted something else
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 Cancelled = 0;
+
+	// Speculations that completed but were never used
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 Wasted = 0;
+
+	// Drafts not speculated on because the quota share was used up
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 BudgetDenied = 0;
+
+	// Drafts not speculated on because the submitted request would carry conversation, memories, surroundings or a persona
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|Speculation")
+	int32 ContextSkipped = 0;
+};
+
+/**
+ * Sends the player's draft to the LLM once they pause typing, so the answer is often ready
+ * (or nearly) when they submit. Feed it from the input box's text-changed event with UpdateDraft;
+ * ULLMGenerateActionAsync claims the speculation when the submitted text normalizes to the
+ * speculated draft (case, punctuation and spacing edits still match). A speculation for text the
+ * player has since changed is cancelled through its UGeminiHTTPManager request handle.
+ * Speculations are sent as the bare action prompt, so drafts for a blackboard whose request would
+ * carry more (see ULLMGenerateActionAsync::SendsPlainPrompt) are not speculated on.
+ * Speculation is low priority: one request at a time, never while another request is in flight,
+ * and at most SpeculationQuotaShare of RequestsPerMinuteQuota per minute.
+ */
+UCLASS()
+class TESTCPP_API ULLMSpeculativeGenerator : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMSpeculativeGenerator* Get(const UObject* WorldContext);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Report the current contents of the input box; speculation starts after SpeculationDebounceSeconds without changes
+	 * @param APIData - Profile the submitted request will use
+	 * @param PartialInput - Text typed so far
+	 * @param Temperature - Temperature the submitted request will use
+	 * @param Blackboard - Blackboard the submitted request will be made for
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Speculation", meta = (WorldContext = "WorldContextObject"))
+	void UpdateDraft(UObject* WorldContextObject, UAPIData* APIData, const FString& PartialInput, float Temperature = 0.7f, UBlackboardComponent* Blackboard = nullptr);
+
+	/** The input box closed without submitting: drop the draft and cancel its speculation */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Speculation")
+	void ClearDraft();
+
+	/**
+	 * Hand a submitted request the matching speculation, if any
+	 * @param OnDone - Called with the response (immediately when it already arrived)
+	 * @return true if the speculation was claimed; otherwise the caller sends its own request
+	 */
+	bool Claim(const FString& FinalInput, UAPIData* APIData, float Temperature, const FOnGeminiResponse& OnDone);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|Speculation")
+	FLLMSpeculationStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|Speculation")
+	void ResetStats() { Stats = FLLMSpeculationStats(); }
+
+private:
+	bool Tick(float DeltaTime);
+	void StartSpeculation();
+	// Forget the current speculation, cancelling it if still in flight
+	void Discard();
+	bool IsWithinBudget(double Now);
+
+	UFUNCTION()
+	void OnSpeculationResponse(bool bSuccess, const FString& JsonResponse);
+
+	FTSTicker::FDelegateHandle TickHandle;
+
+	// Latest draft
+	TWeakObjectPtr<UObject> DraftContext;
+	TWeakObjectPtr<UBlackboardComponent> DraftBlackboard;
+	UPROPERTY()
+	TObjectPtr<UAPIData> DraftAPIData;
+	FString Draft;
+	FString DraftKey;
+	float DraftTemperature = 0.7f;
+	double DraftTime = 0.0;
+	bool bDraftPending = false;
+
+	// Current speculation
+	UPROPERTY()
+	TObjectPtr<UAPIData> SpeculatedAPIData;
+	FString SpeculatedKey;
+	float SpeculatedTemperature = 0.0f;
+	int32 RequestId = 0;
+	bool bInFlight = false;
+	bool bCompleted = false;
+	FString ResponseBody;
+	double CompletedTime = 0.0;
+
+	// Submitted request waiting for the speculation in flight
+	FOnGeminiResponse Waiter;
+
+	// Start times of recent speculations, for the per-minute budget
+	TArray<double> RecentStarts;
+
+	FLLMSpeculationStats Stats;
+};
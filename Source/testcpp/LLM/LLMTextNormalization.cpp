@@ -0,0 +1,91 @@
+// Shared normalization of player command text for local matching
+#include "LLM/LLMTextNormalization.h"
+
+namespace LLMTextNormalization
+{
+	static bool IsWordChar(TCHAR C)
+	{
+		return FChar::IsAlnum(C) || C > 127;
+	}
+
+	void Tokenize(const FString& Text, TArray<FString>& OutTokens, TArray<FString>* OutOriginal)
+	{
+		OutTokens.Reset();
+		if (OutOriginal)
+		{
+			OutOriginal->Reset();
+		}
+
+		const int32 Len = Text.Len();
+		int32 Index = 0;
+		while (Index < Len)
+		{
+			// Skip separators
+			while (Index < Len && !IsWordChar(Text[Index]))
+			{
+				++Index;
+			}
+			if (Index >= Len)
+			{
+				break;
+			}
+
+			// Word: word chars plus apostrophes between word chars ("don't")
+			const int32 Start = Index;
+			while (Index < Len && (IsWordChar(Text[Index])
+				|| (Text[Index] == TEXT('\'') && Index + 1 < Len && IsWordChar(Text[Index + 1]))))
+			{
+				++Index;
+			}
+
+			FString Token = Text.Mid(Start, Index - Start);
+			if (OutOriginal)
+			{
+				// Original token keeps trailing punctuation up to the next space ("hello!")
+				int32 End = Index;
+				while (End < Len && !FChar::IsWhitespace(Text[End]) && !IsWordChar(Text[End]))
+				{
+					++End;
+				}
+				OutOriginal->Add(Text.Mid(Start, End - Start));
+			}
+			OutTokens.Add(Token.ToLower());
+		}
+	}
+
+	int32 HashTokens(const FString& Text, uint32* OutHashes, int32 MaxHashes)
+	{
+		const int32 Len = Text.Len();
+		int32 Count = 0;
+		int32 Index = 0;
+		while (Index < Len && Count < MaxHashes)
+		{
+			while (Index < Len && !IsWordChar(Text[Index]))
+			{
+				++Index;
+			}
+			if (Index >= Len)
+			{
+				break;
+			}
+
+			// FNV-1a over the lowercased characters, same word boundaries as Tokenize
+			uint32 Hash = 2166136261u;
+			while (Index < Len && (IsWordChar(Text[Index])
+				|| (Text[Index] == TEXT('\'') && Index + 1 < Len && IsWordChar(Text[Index + 1]))))
+			{
+				Hash = (Hash ^ static_cast<uint32>(FChar::ToLower(Text[Index]))) * 16777619u;
+				++Index;
+			}
+			OutHashes[Count++] = Hash;
+		}
+		return Count;
+	}
+
+	FString Normalize(const FString& Text)
+	{
+		TArray<FString> Tokens;
+		Tokenize(Text, Tokens);
+		return FString::Join(Tokens, TEXT(" "));
+	}
+}
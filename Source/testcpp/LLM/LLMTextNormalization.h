@@ -0,0 +1,28 @@
+// Shared normalization of player command text for local matching
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Lowercase/punctuation-insensitive tokenization shared by the local command matchers
+ * so data-side names ("Fountain_North") and player input ("the north fountain!") compare alike
+ */
+namespace LLMTextNormalization
+{
+	/**
+	 * Split text into lowercase word tokens; punctuation and '_' separate words, apostrophes inside words are kept
+	 * @param OutTokens - Normalized tokens
+	 * @param OutOriginal - Optional: the same tokens with their original casing and inner punctuation
+	 */
+	TESTCPP_API void Tokenize(const FString& Text, TArray<FString>& OutTokens, TArray<FString>* OutOriginal = nullptr);
+
+	/**
+	 * Hash the tokens Tokenize would produce, without allocating
+	 * @param OutHashes - Receives up to MaxHashes token hashes, in order
+	 * @return Number of hashes written
+	 */
+	TESTCPP_API int32 HashTokens(const FString& Text, uint32* OutHashes, int32 MaxHashes);
+
+	/** Tokens joined with single spaces ("Fountain_North" -> "fountain north") */
+	TESTCPP_API FString Normalize(const FString& Text);
+}
@@ -0,0 +1,229 @@
+// Offline trainer for the on-device intent classifier
+#include "LLM/LLMTrainIntentModelCommandlet.h"
+#include "LLM/LLMIntentModel.h"
+#include "LLM/LLMDecisionLog.h"
+#include "LLM/LLMSettings.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+
+namespace LLMTrainIntentModelPrivate
+{
+	struct FSample
+	{
+		int32 Buckets[FLLMIntentModel::MaxFeatures];
+		int32 NumFeatures = 0;
+		int32 Label = INDEX_NONE;
+	};
+
+	static constexpr float LearningRate = 0.2f;
+	static constexpr float L2 = 1e-5f;
+	// Every tenth sample is held out to calibrate the confidence
+	static constexpr int32 HoldOutEvery = 10;
+
+	static void TrainEpoch(FLLMIntentModel& Model, const TArray<FSample>& Samples, const TArray<int32>& Order, float Rate)
+	{
+		float Probabilities[FLLMIntentModel::MaxLabels];
+		for (const int32 SampleIndex : Order)
+		{
+			const FSample& Sample = Samples[SampleIndex];
+			Model.ComputeProbabilities(Sample.Buckets, Sample.NumFeatures, 1.0f, Probabilities);
+
+			// Softmax cross-entropy gradient: p - y
+			for (int32 Label = 0; Label < Model.GetNumLabels(); ++Label)
+			{
+				const float Gradient = Probabilities[Label] - (Label == Sample.Label ? 1.0f : 0.0f);
+				Model.GetBiases()[Label] -= Rate * Gradient;
+				for (int32 Feature = 0; Feature < Sample.NumFeatures; ++Feature)
+				{
+					float& Weight = Model.GetRow(Sample.Buckets[Feature])[Label];
+					Weight -= Rate * (Gradient + L2 * Weight);
+				}
+			}
+		}
+	}
+
+	static double NegativeLogLikelihood(const FLLMIntentModel& Model, const TArray<FSample>& Samples, const TArray<int32>& Indices, float Temperature, int32* OutCorrect = nullptr)
+	{
+		float Probabilities[FLLMIntentModel::MaxLabels];
+		double Loss = 0.0;
+		int32 Correct = 0;
+		for (const int32 SampleIndex : Indices)
+		{
+			const FSample& Sample = Samples[SampleIndex];
+			Model.ComputeProbabilities(Sample.Buckets, Sample.NumFeatures, Temperature, Probabilities);
+			Loss -= FMath::Loge(FMath::Max(Probabilities[Sample.Label], 1e-7f));
+
+			int32 Best = 0;
+			for (int32 Label = 1; Label < Model.GetNumLabels(); ++Label)
+			{
+				Best = Probabilities[Label] > Probabilities[Best] ? Label : Best;
+			}
+			Correct += Best == Sample.Label ? 1 : 0;
+		}
+		if (OutCorrect)
+		{
+			*OutCorrect = Correct;
+		}
+		return Loss;
+	}
+
+	// For each ClassifierMinConfidence candidate: share of held-out inputs answered locally and how many of those are right
+	static void LogThresholdTable(const FLLMIntentModel& Model, const TArray<FSample>& Samples, const TArray<int32>& Indices)
+	{
+		TArray<TPair<float, bool>> Predictions;
+		float Probabilities[FLLMIntentModel::MaxLabels];
+		for (const int32 SampleIndex : Indices)
+		{
+			const FSample& Sample = Samples[SampleIndex];
+			Model.ComputeProbabilities(Sample.Buckets, Sample.NumFeatures, Model.GetTemperature(), Probabilities);
+			int32 Best = 0;
+			for (int32 Label = 1; Label < Model.GetNumLabels(); ++Label)
+			{
+				Best = Probabilities[Label] > Probabilities[Best] ? Label : Best;
+			}
+			Predictions.Emplace(Probabilities[Best], Best == Sample.Label);
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("[LLMTrainIntentModel] Pick ClassifierMinConfidence where held-out precision is acceptable:"));
+		for (int32 Step = 10; Step <= 19; ++Step)
+		{
+			const float Threshold = Step * 0.05f;
+			int32 Answered = 0;
+			int32 Right = 0;
+			for (const TPair<float, bool>& Prediction : Predictions)
+			{
+				if (Prediction.Key >= Threshold)
+				{
+					++Answered;
+					Right += Prediction.Value ? 1 : 0;
+				}
+			}
+			UE_LOG(LogTemp, Display, TEXT("[LLMTrainIntentModel]   >= %.2f: answers %.1f%% locally, %.1f%% of those correct"),
+				Threshold, Predictions.Num() > 0 ? 100.0f * Answered / Predictions.Num() : 0.0f,
+				Answered > 0 ? 100.0f * Right / Answered : 100.0f);
+		}
+	}
+}
+
+ULLMTrainIntentModelCommandlet::ULLMTrainIntentModelCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 ULLMTrainIntentModelCommandlet::Main(const FString& Params)
+{
+	using namespace LLMTrainIntentModelPrivate;
+
+	FString LogPath = ULLMDecisionLog::GetLogPath();
+	FString OutPath = FPaths::Combine(FPaths::ProjectContentDir(), GetDefault<ULLMSettings>()->IntentModelPath);
+	int32 NumBuckets = 16384;
+	int32 Epochs = 20;
+	FParse::Value(*Params, TEXT("Log="), LogPath);
+	FParse::Value(*Params, TEXT("Out="), OutPath);
+	FParse::Value(*Params, TEXT("Buckets="), NumBuckets);
+	FParse::Value(*Params, TEXT("Epochs="), Epochs);
+
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *LogPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMTrainIntentModel] Cannot read %s"), *LogPath);
+		return 1;
+	}
+
+	// First pass: inputs and label set
+	TArray<FString> Inputs;
+	TArray<FString> LabelNames;
+	TArray<int32> SampleLabels;
+	for (const FString& Line : Lines)
+	{
+		TSharedPtr<FJsonObject> Entry;
+		FString Input;
+		FString Intent;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Line), Entry) || !Entry.IsValid()
+			|| !Entry->TryGetStringField(TEXT("input"), Input) || !Entry->TryGetStringField(TEXT("intent"), Intent))
+		{
+			continue;
+		}
+
+		int32 Label = LabelNames.IndexOfByKey(Intent);
+		if (Label == INDEX_NONE)
+		{
+			if (LabelNames.Num() >= FLLMIntentModel::MaxLabels)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("[LLMTrainIntentModel] More than %d intents, skipping %s"), FLLMIntentModel::MaxLabels, *Intent);
+				continue;
+			}
+			Label = LabelNames.Add(Intent);
+		}
+		Inputs.Add(Input);
+		SampleLabels.Add(Label);
+	}
+
+	if (LabelNames.Num() < 2)
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMTrainIntentModel] Need samples of at least two intents, found %d samples of %d"), Inputs.Num(), LabelNames.Num());
+		return 1;
+	}
+
+	FLLMIntentModel Model(FMath::Max(NumBuckets, 1), LabelNames);
+	TArray<FSample> Samples;
+	Samples.SetNum(Inputs.Num());
+	TArray<int32> TrainIndices;
+	TArray<int32> HoldOutIndices;
+	for (int32 Index = 0; Index < Inputs.Num(); ++Index)
+	{
+		Samples[Index].NumFeatures = Model.ExtractFeatures(Inputs[Index], Samples[Index].Buckets);
+		Samples[Index].Label = SampleLabels[Index];
+		(Index % HoldOutEvery == HoldOutEvery - 1 ? HoldOutIndices : TrainIndices).Add(Index);
+	}
+	if (HoldOutIndices.Num() == 0)
+	{
+		HoldOutIndices = TrainIndices;
+	}
+
+	FRandomStream Random(1234);
+	for (int32 Epoch = 0; Epoch < Epochs; ++Epoch)
+	{
+		for (int32 Index = TrainIndices.Num() - 1; Index > 0; --Index)
+		{
+			TrainIndices.Swap(Index, Random.RandRange(0, Index));
+		}
+		TrainEpoch(Model, Samples, TrainIndices, LearningRate / (1.0f + Epoch * 0.1f));
+	}
+
+	// Temperature scaling on the held-out samples so confidence thresholds mean what they say
+	float BestTemperature = 1.0f;
+	double BestLoss = TNumericLimits<double>::Max();
+	for (float Temperature = 0.5f; Temperature <= 4.0f; Temperature += 0.1f)
+	{
+		const double Loss = NegativeLogLikelihood(Model, Samples, HoldOutIndices, Temperature);
+		if (Loss < BestLoss)
+		{
+			BestLoss = Loss;
+			BestTemperature = Temperature;
+		}
+	}
+	Model.SetTemperature(BestTemperature);
+
+	int32 Correct = 0;
+	NegativeLogLikelihood(Model, Samples, HoldOutIndices, BestTemperature, &Correct);
+	UE_LOG(LogTemp, Display, TEXT("[LLMTrainIntentModel] %d samples, %d intents, held-out accuracy %.1f%%, temperature %.1f"),
+		Samples.Num(), LabelNames.Num(), 100.0f * Correct / HoldOutIndices.Num(), BestTemperature);
+	LogThresholdTable(Model, Samples, HoldOutIndices);
+
+	if (!Model.SaveToFile(OutPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("[LLMTrainIntentModel] Failed to write %s"), *OutPath);
+		return 1;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("[LLMTrainIntentModel] Wrote %s"), *OutPath);
+	return 0;
+}
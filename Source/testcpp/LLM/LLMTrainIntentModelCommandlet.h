@@ -0,0 +1,22 @@
+// Offline trainer for the on-device intent classifier
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LLMTrainIntentModelCommandlet.generated.h"
+
+/**
+ * Trains FLLMIntentModel from a ULLMDecisionLog file and writes the binary model
+ * UnrealEditor-Cmd testcpp.uproject -run=LLMTrainIntentModel [-Log=<jsonl>] [-Out=<bin>] [-Buckets=N] [-Epochs=N]
+ * Defaults: Saved/LLM/Decisions.jsonl -> Content/<ULLMSettings::IntentModelPath>, 16384 buckets, 20 epochs
+ */
+UCLASS()
+class TESTCPP_API ULLMTrainIntentModelCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	ULLMTrainIntentModelCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
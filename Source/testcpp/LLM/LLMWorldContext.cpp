@@ -0,0 +1,294 @@
+// Per-agent description of the surroundings, kept up to date incrementally for prompt context
+#include "LLM/LLMWorldContext.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+
+namespace LLMWorldContextPrivate
+{
+	static int32 FloorDiv(int32 Value, int32 Divisor)
+	{
+		return Value >= 0 ? Value / Divisor : -((-Value + Divisor - 1) / Divisor);
+	}
+
+	static void LogStats(UWorld* World)
+	{
+		const ULLMWorldContext* Context = ULLMWorldContext::Get(World);
+		if (!Context)
+		{
+			return;
+		}
+
+		const FLLMWorldContextStats Stats = Context->GetStats();
+		UE_LOG(LogTemp, Log, TEXT("[LLMWorldContext] %d requests, %d from cache (%.1f%%), %.2f us avg | %d fragment updates"),
+			Stats.Requests, Stats.CachedViews, Stats.Requests > 0 ? 100.0f * Stats.CachedViews / Stats.Requests : 0.0f,
+			Stats.Requests > 0 ? Stats.AssemblySeconds * 1e6 / Stats.Requests : 0.0, Stats.FragmentUpdates);
+	}
+
+	static FAutoConsoleCommandWithWorld LogStatsCommand(
+		TEXT("LLM.WorldContextStats"),
+		TEXT("Log how often agent world context was served from cache and its assembly cost"),
+		FConsoleCommandWithWorldDelegate::CreateStatic(&LogStats));
+}
+
+ULLMWorldContext* ULLMWorldContext::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMWorldContext>() : nullptr;
+}
+
+TStatId ULLMWorldContext::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULLMWorldContext, STATGROUP_Tickables);
+}
+
+void ULLMWorldContext::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	TimeSinceRefresh += DeltaTime;
+	if (TimeSinceRefresh < GetDefault<ULLMSettings>()->WorldContextRefreshSeconds)
+	{
+		return;
+	}
+	TimeSinceRefresh = 0.0f;
+
+	// Only registered entities are visited, never the whole world
+	for (auto It = Entities.CreateIterator(); It; ++It)
+	{
+		if (It->Actor.IsValid())
+		{
+			RefreshEntity(It.GetIndex(), false);
+		}
+		else
+		{
+			RemoveEntity(It.GetIndex());
+		}
+	}
+
+	for (auto It = Views.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void ULLMWorldContext::RegisterEntity(AActor* Actor, const FString& Type, const FString& DisplayName)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	int32 Index = INDEX_NONE;
+	if (const int32* Existing = EntityIndices.Find(Actor))
+	{
+		Index = *Existing;
+	}
+	else
+	{
+		FEntity Entity;
+		Entity.Actor = Actor;
+		Entity.Key = Actor;
+		Index = Entities.Add(MoveTemp(Entity));
+		EntityIndices.Add(Actor, Index);
+	}
+
+	FEntity& Entity = Entities[Index];
+	Entity.Type = Type;
+	Entity.Name = DisplayName.IsEmpty() ? Actor->GetName() : DisplayName;
+	RefreshEntity(Index, true);
+}
+
+void ULLMWorldContext::UnregisterEntity(AActor* Actor)
+{
+	if (const int32* Index = EntityIndices.Find(Actor))
+	{
+		RemoveEntity(*Index);
+	}
+}
+
+void ULLMWorldContext::SetEntityState(AActor* Actor, const FString& State)
+{
+	const int32* Index = EntityIndices.Find(Actor);
+	if (Index && !Entities[*Index].State.Equals(State, ESearchCase::CaseSensitive))
+	{
+		Entities[*Index].State = State;
+		RefreshEntity(*Index, true);
+	}
+}
+
+FIntVector ULLMWorldContext::Quantize(const FVector& Location) const
+{
+	const float Step = FMath::Max(1.0f, GetDefault<ULLMSettings>()->WorldContextQuantization);
+	return FIntVector(FMath::RoundToInt32(Location.X / Step), FMath::RoundToInt32(Location.Y / Step), FMath::RoundToInt32(Location.Z / Step));
+}
+
+FIntPoint ULLMWorldContext::GetGridCell(const FIntVector& Position) const
+{
+	// Cells are one radius wide, so the 3x3 block around an agent covers its whole radius
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	const int32 CellUnits = FMath::Max(1, FMath::CeilToInt32(Settings->WorldContextRadius / FMath::Max(1.0f, Settings->WorldContextQuantization)));
+	return FIntPoint(LLMWorldContextPrivate::FloorDiv(Position.X, CellUnits), LLMWorldContextPrivate::FloorDiv(Position.Y, CellUnits));
+}
+
+uint64 ULLMWorldContext::GetCellsSignature(const FIntPoint& Center) const
+{
+	uint64 Signature = 0;
+	for (int32 Y = -1; Y <= 1; ++Y)
+	{
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			const FGridCell* Cell = Grid.Find(Center + FIntPoint(X, Y));
+			Signature = (Signature * 1099511628211ull) ^ (Cell ? Cell->Revision + 1 : 0);
+		}
+	}
+	return Signature;
+}
+
+void ULLMWorldContext::TouchCell(const FIntPoint& Cell)
+{
+	++Grid.FindOrAdd(Cell).Revision;
+}
+
+void ULLMWorldContext::RefreshEntity(int32 Index, bool bForce)
+{
+	FEntity& Entity = Entities[Index];
+	const AActor* Actor = Entity.Actor.Get();
+	if (!Actor)
+	{
+		return;
+	}
+
+	const FIntVector Position = Quantize(Actor->GetActorLocation());
+	const bool bRegistered = !Entity.Fragment.IsEmpty();
+	if (bRegistered && !bForce && Position == Entity.Position)
+	{
+		return;
+	}
+
+	const FIntPoint Cell = GetGridCell(Position);
+	if (!bRegistered || Cell != Entity.GridCell)
+	{
+		if (bRegistered)
+		{
+			if (FGridCell* OldCell = Grid.Find(Entity.GridCell))
+			{
+				OldCell->Entities.RemoveSwap(Index);
+				++OldCell->Revision;
+			}
+		}
+		Grid.FindOrAdd(Cell).Entities.Add(Index);
+	}
+
+	Entity.Position = Position;
+	Entity.GridCell = Cell;
+
+	const float Meters = GetDefault<ULLMSettings>()->WorldContextQuantization / 100.0f;
+	Entity.Fragment = FString::Printf(TEXT("%s (%s) at (%d, %d, %d) m"), *Entity.Name, *Entity.Type,
+		FMath::RoundToInt32(Position.X * Meters), FMath::RoundToInt32(Position.Y * Meters), FMath::RoundToInt32(Position.Z * Meters));
+	if (!Entity.State.IsEmpty())
+	{
+		Entity.Fragment += FString::Printf(TEXT(", %s"), *Entity.State);
+	}
+	TouchCell(Cell);
+	++Stats.FragmentUpdates;
+}
+
+void ULLMWorldContext::RemoveEntity(int32 Index)
+{
+	FEntity& Entity = Entities[Index];
+	if (FGridCell* Cell = Grid.Find(Entity.GridCell))
+	{
+		Cell->Entities.RemoveSwap(Index);
+		++Cell->Revision;
+	}
+	EntityIndices.Remove(Entity.Key);
+	Entities.RemoveAt(Index);
+}
+
+const FString& ULLMWorldContext::GetContextFor(const AActor* Agent)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	++Stats.Requests;
+
+	// Agents are usually addressed through their controller
+	if (const AController* Controller = Cast<AController>(Agent))
+	{
+		Agent = Controller->GetPawn();
+	}
+	if (!Agent)
+	{
+		static const FString Empty;
+		return Empty;
+	}
+
+	const FIntVector Position = Quantize(Agent->GetActorLocation());
+	const FIntPoint Center = GetGridCell(Position);
+	const uint64 Signature = GetCellsSignature(Center);
+
+	FAgentView& View = Views.FindOrAdd(Agent);
+	if (View.Position == Position && View.CellsSignature == Signature)
+	{
+		++Stats.CachedViews;
+		Stats.AssemblySeconds += FPlatformTime::Seconds() - StartTime;
+		return View.Text;
+	}
+
+	// Nearest entities within the radius, from the 3x3 block of cells
+	const ULLMSettings* Settings = GetDefault<ULLMSettings>();
+	const float Step = FMath::Max(1.0f, Settings->WorldContextQuantization);
+	const int64 RadiusUnits = FMath::CeilToInt64(Settings->WorldContextRadius / Step);
+	TArray<TPair<int64, int32>, TInlineAllocator<64>> Nearby;
+	for (int32 Y = -1; Y <= 1; ++Y)
+	{
+		for (int32 X = -1; X <= 1; ++X)
+		{
+			const FGridCell* Cell = Grid.Find(Center + FIntPoint(X, Y));
+			if (!Cell)
+			{
+				continue;
+			}
+			for (int32 Index : Cell->Entities)
+			{
+				const FEntity& Entity = Entities[Index];
+				if (Entity.Actor.Get() == Agent)
+				{
+					continue;
+				}
+				const FIntVector Delta = Entity.Position - Position;
+				const int64 SquaredDistance = int64(Delta.X) * Delta.X + int64(Delta.Y) * Delta.Y + int64(Delta.Z) * Delta.Z;
+				if (SquaredDistance <= RadiusUnits * RadiusUnits)
+				{
+					Nearby.Emplace(SquaredDistance, Index);
+				}
+			}
+		}
+	}
+	Nearby.Sort([](const TPair<int64, int32>& A, const TPair<int64, int32>& B) { return A.Key < B.Key; });
+
+	const float Meters = Step / 100.0f;
+	View.Position = Position;
+	View.CellsSignature = Signature;
+	View.Text.Reset();
+	View.Text += FString::Printf(TEXT("You are at (%d, %d, %d) m."),
+		FMath::RoundToInt32(Position.X * Meters), FMath::RoundToInt32(Position.Y * Meters), FMath::RoundToInt32(Position.Z * Meters));
+	for (int32 Rank = 0; Rank < FMath::Min(Nearby.Num(), Settings->WorldContextMaxEntities); ++Rank)
+	{
+		View.Text += TEXT("\n- ");
+		View.Text += Entities[Nearby[Rank].Value].Fragment;
+		View.Text += FString::Printf(TEXT(", %d m away"), FMath::RoundToInt32(FMath::Sqrt(double(Nearby[Rank].Key)) * Meters));
+	}
+	if (Nearby.Num() == 0)
+	{
+		View.Text.Reset();
+	}
+
+	Stats.AssemblySeconds += FPlatformTime::Seconds() - StartTime;
+	return View.Text;
+}
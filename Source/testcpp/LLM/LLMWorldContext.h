@@ -0,0 +1,126 @@
+// Per-agent description of the surroundings, kept up to date incrementally for prompt context
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "LLMWorldContext.generated.h"
+
+/**
+ * Counters for the world context
+ */
+USTRUCT(BlueprintType)
+struct FLLMWorldContextStats
+{
+	GENERATED_BODY()
+
+	// Context requests
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|WorldContext")
+	int32 Requests = 0;
+
+	// Requests answered with the agent's cached text (nothing nearby changed)
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|WorldContext")
+	int32 CachedViews = 0;
+
+	// Entity fragments re-serialized because the entity moved or changed state
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|WorldContext")
+	int32 FragmentUpdates = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "LLM|WorldContext")
+	double AssemblySeconds = 0.0;
+};
+
+/**
+ * What an agent can see around it, as prompt text
+ * Gameplay code registers the entities worth mentioning (RegisterEntity). Every
+ * WorldContextRefreshSeconds their positions are quantized to WorldContextQuantization; an
+ * entity whose quantized position or state changed has its one-line fragment re-serialized
+ * and its grid cell's revision bumped. An agent's context is the fragments of the nearest
+ * entities in the 3x3 grid cells around it, rebuilt only when the agent's own quantized
+ * position or one of those cells changed, so most requests just return the cached text.
+ */
+UCLASS()
+class TESTCPP_API ULLMWorldContext : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static ULLMWorldContext* Get(const UObject* WorldContext);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Describe an actor to nearby agents
+	 * @param Type - Kind of entity, e.g. "Door", "NPC", "Item"
+	 * @param DisplayName - Name the LLM should use; empty uses the actor's name
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|WorldContext")
+	void RegisterEntity(AActor* Actor, const FString& Type, const FString& DisplayName = TEXT(""));
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|WorldContext")
+	void UnregisterEntity(AActor* Actor);
+
+	/** Short state shown after the entity, e.g. "locked" or "hostile"; empty clears it */
+	UFUNCTION(BlueprintCallable, Category = "LLM|WorldContext")
+	void SetEntityState(AActor* Actor, const FString& State);
+
+	/**
+	 * Surroundings of an agent, nearest first
+	 * @param Agent - The agent's pawn (a controller is resolved to its pawn)
+	 * @return Cached text; empty when nothing registered is within WorldContextRadius
+	 */
+	const FString& GetContextFor(const AActor* Agent);
+
+	UFUNCTION(BlueprintPure, Category = "LLM|WorldContext")
+	FLLMWorldContextStats GetStats() const { return Stats; }
+
+	UFUNCTION(BlueprintCallable, Category = "LLM|WorldContext")
+	void ResetStats() { Stats = FLLMWorldContextStats(); }
+
+private:
+	struct FEntity
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TObjectKey<AActor> Key;
+		FString Name;
+		FString Type;
+		FString State;
+		// Position in WorldContextQuantization units
+		FIntVector Position = FIntVector::ZeroValue;
+		FIntPoint GridCell = FIntPoint::ZeroValue;
+		// "Name (Type) at (x, y, z) m[, state]"
+		FString Fragment;
+	};
+
+	struct FGridCell
+	{
+		TArray<int32> Entities;
+		uint32 Revision = 0;
+	};
+
+	struct FAgentView
+	{
+		FIntVector Position = FIntVector(MAX_int32);
+		uint64 CellsSignature = 0;
+		FString Text;
+	};
+
+	FIntVector Quantize(const FVector& Location) const;
+	FIntPoint GetGridCell(const FIntVector& Position) const;
+	uint64 GetCellsSignature(const FIntPoint& Center) const;
+
+	// Re-read an entity's actor; re-serializes and moves it between grid cells when it changed
+	void RefreshEntity(int32 Index, bool bForce);
+	void RemoveEntity(int32 Index);
+	void TouchCell(const FIntPoint& Cell);
+
+	TSparseArray<FEntity> Entities;
+	TMap<TObjectKey<AActor>, int32> EntityIndices;
+	TMap<FIntPoint, FGridCell> Grid;
+	TMap<TObjectKey<AActor>, FAgentView> Views;
+
+	float TimeSinceRefresh = 0.0f;
+
+	FLLMWorldContextStats Stats;
+};
@@ -0,0 +1,134 @@
+// Live registry of names the LLM may reference (montages, nav points, target types)
+#include "LLM/LLMWorldVocabulary.h"
+#include "LLM/LLMActionSchema.h"
+#include "LLM/LLMSettings.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+
+namespace LLMWorldVocabularyPrivate
+{
+	// FString hashes ignore case, like the name sets
+	static uint32 HashName(ELLMVocabularyCategory Category, const FString& Name)
+	{
+		return HashCombine(static_cast<uint32>(Category) + 1, GetTypeHash(Name));
+	}
+}
+
+ULLMWorldVocabulary* ULLMWorldVocabulary::Get(const UObject* WorldContext)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContext, EGetWorldErrorMode::ReturnNull) : nullptr;
+	return World ? World->GetSubsystem<ULLMWorldVocabulary>() : nullptr;
+}
+
+void ULLMWorldVocabulary::RegisterName(ELLMVocabularyCategory Category, const FString& Name)
+{
+	if (Name.IsEmpty())
+	{
+		return;
+	}
+
+	int32& Count = Names[static_cast<uint8>(Category)].FindOrAdd(Name, 0);
+	if (Count++ == 0)
+	{
+		++Revision;
+		ContentHash += LLMWorldVocabularyPrivate::HashName(Category, Name);
+		UE_LOG(LogTemp, Verbose, TEXT("[LLMWorldVocabulary] Registered %s '%s'"),
+			*StaticEnum<ELLMVocabularyCategory>()->GetNameStringByValue(static_cast<int64>(Category)), *Name);
+	}
+}
+
+void ULLMWorldVocabulary::UnregisterName(ELLMVocabularyCategory Category, const FString& Name)
+{
+	TMap<FString, int32>& Set = Names[static_cast<uint8>(Category)];
+	int32* Count = Set.Find(Name);
+	if (!Count)
+	{
+		return;
+	}
+
+	if (--(*Count) <= 0)
+	{
+		Set.Remove(Name);
+		++Revision;
+		ContentHash -= LLMWorldVocabularyPrivate::HashName(Category, Name);
+		UE_LOG(LogTemp, Verbose, TEXT("[LLMWorldVocabulary] Unregistered %s '%s'"),
+			*StaticEnum<ELLMVocabularyCategory>()->GetNameStringByValue(static_cast<int64>(Category)), *Name);
+	}
+}
+
+TArray<FString> ULLMWorldVocabulary::GetNames(ELLMVocabularyCategory Category) const
+{
+	TArray<FString> Result;
+	Names[static_cast<uint8>(Category)].GetKeys(Result);
+	return Result;
+}
+
+bool ULLMWorldVocabulary::ContainsName(ELLMVocabularyCategory Category, const FString& Name) const
+{
+	return Names[static_cast<uint8>(Category)].Contains(Name);
+}
+
+int32 ULLMWorldVocabulary::CountUnknownNames(const FLLMPlan& Plan) const
+{
+	// An empty category means nothing is registered, so nothing can be checked
+	auto IsUnknown = [this](ELLMVocabularyCategory Category, const FString& Name)
+	{
+		return !Name.IsEmpty() && GetNameCount(Category) > 0 && !ContainsName(Category, Name);
+	};
+
+	int32 Unknown = 0;
+	for (const FLLMPlanStep& Step : Plan.Steps)
+	{
+		const FLLMAction& Action = Step.Action;
+		Unknown += IsUnknown(ELLMVocabularyCategory::Montage, Action.Montage.Name) ? 1 : 0;
+		Unknown += IsUnknown(ELLMVocabularyCategory::TargetType, Action.Target.Type) ? 1 : 0;
+		if (!Action.Location.bUseCoordinates)
+		{
+			Unknown += IsUnknown(ELLMVocabularyCategory::NavPoint, Action.Location.NavPointName) ? 1 : 0;
+		}
+	}
+	return Unknown;
+}
+
+TSharedRef<FJsonObject> ULLMWorldVocabulary::GetConstrainedResponseSchema()
+{
+	RebuildSchemasIfStale();
+	return CachedSchema.ToSharedRef();
+}
+
+TSharedRef<FJsonObject> ULLMWorldVocabulary::GetConstrainedPlanSchema()
+{
+	RebuildSchemasIfStale();
+	return CachedPlanSchema.ToSharedRef();
+}
+
+void ULLMWorldVocabulary::RebuildSchemasIfStale()
+{
+	// Also rebuild when the intent registry changed the base schema or the plan length changed
+	const int32 SchemaRevision = ULLMActionSchema::GetRevision();
+	const int32 MaxPlanSteps = GetDefault<ULLMSettings>()->MaxPlanSteps;
+	if (CachedSchema.IsValid() && CachedSchemaRevision == Revision && CachedBaseSchemaRevision == SchemaRevision
+		&& CachedMaxPlanSteps == MaxPlanSteps)
+	{
+		return;
+	}
+
+	FLLMSchemaConstraints Constraints;
+	Constraints.MontageNames = GetNames(ELLMVocabularyCategory::Montage);
+	Constraints.NavPointNames = GetNames(ELLMVocabularyCategory::NavPoint);
+	Constraints.TargetTypes = GetNames(ELLMVocabularyCategory::TargetType);
+
+	// Stable ordering keeps the payload identical across rebuilds with the same contents
+	Constraints.MontageNames.Sort();
+	Constraints.NavPointNames.Sort();
+	Constraints.TargetTypes.Sort();
+
+	CachedSchema = ULLMActionSchema::BuildConstrainedSchema(Constraints);
+	CachedPlanSchema = ULLMActionSchema::MakePlanSchema(CachedSchema.ToSharedRef());
+	CachedSchemaRevision = Revision;
+	CachedBaseSchemaRevision = SchemaRevision;
+	CachedMaxPlanSteps = MaxPlanSteps;
+
+	UE_LOG(LogTemp, Log, TEXT("[LLMWorldVocabulary] Rebuilt constrained schema (rev %d): %d montages, %d nav points, %d target types"),
+		Revision, Constraints.MontageNames.Num(), Constraints.NavPointNames.Num(), Constraints.TargetTypes.Num());
+}
@@ -0,0 +1,104 @@
+// Live registry of names the LLM may reference (montages, nav points, target types)
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Dom/JsonObject.h"
+#include "LLM/LLMActionTypes.h"
+#include "LLMWorldVocabulary.generated.h"
+
+/**
+ * Categories of names tracked by the vocabulary
+ */
+UENUM(BlueprintType)
+enum class ELLMVocabularyCategory : uint8
+{
+	Montage UMETA(DisplayName = "Montage"),
+	NavPoint UMETA(DisplayName = "Nav Point"),
+	TargetType UMETA(DisplayName = "Target Type")
+};
+
+/**
+ * Tracks the montage names, named navigation points and interactable target types that
+ * currently exist in the world. Names are reference counted so several registrants can
+ * share one entry. The response schema with matching "enum" constraints is cached and
+ * rebuilt only when the registered sets change.
+ */
+UCLASS()
+class TESTCPP_API ULLMWorldVocabulary : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	/** Convenience accessor; returns null if the world has no vocabulary */
+	static ULLMWorldVocabulary* Get(const UObject* WorldContext);
+
+	/**
+	 * Add a reference to a name (case-insensitive)
+	 * @param Category - Which set the name belongs to
+	 * @param Name - Name as the LLM should emit it
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Vocabulary")
+	void RegisterName(ELLMVocabularyCategory Category, const FString& Name);
+
+	/**
+	 * Release a reference to a name; the name is removed when its last reference goes
+	 */
+	UFUNCTION(BlueprintCallable, Category = "LLM|Vocabulary")
+	void UnregisterName(ELLMVocabularyCategory Category, const FString& Name);
+
+	/** All names currently registered in a category */
+	UFUNCTION(BlueprintPure, Category = "LLM|Vocabulary")
+	TArray<FString> GetNames(ELLMVocabularyCategory Category) const;
+
+	/** Number of names registered in a category */
+	UFUNCTION(BlueprintPure, Category = "LLM|Vocabulary")
+	int32 GetNameCount(ELLMVocabularyCategory Category) const { return Names[static_cast<uint8>(Category)].Num(); }
+
+	/** Whether a name is registered in a category (case-insensitive) */
+	UFUNCTION(BlueprintPure, Category = "LLM|Vocabulary")
+	bool ContainsName(ELLMVocabularyCategory Category, const FString& Name) const;
+
+	/**
+	 * Number of montage, target type and nav point names in the plan that are not registered
+	 * Categories with nothing registered are not checked
+	 */
+	int32 CountUnknownNames(const FLLMPlan& Plan) const;
+
+	/** Whether every name the plan uses is registered (CountUnknownNames is 0) */
+	bool IsPlanGrounded(const FLLMPlan& Plan) const { return CountUnknownNames(Plan) == 0; }
+
+	/** Incremented whenever any set changes */
+	UFUNCTION(BlueprintPure, Category = "LLM|Vocabulary")
+	int32 GetRevision() const { return Revision; }
+
+	/** Order-independent hash of every registered name; equal for equal sets, in any world */
+	uint32 GetContentHash() const { return ContentHash; }
+
+	/**
+	 * Response schema with enum constraints for montage.name, location and target.type.
+	 * Cached per revision; treat as read-only.
+	 */
+	TSharedRef<FJsonObject> GetConstrainedResponseSchema();
+
+	/**
+	 * Plan form of GetConstrainedResponseSchema ({"plan": [...]}); cached alongside it
+	 */
+	TSharedRef<FJsonObject> GetConstrainedPlanSchema();
+
+private:
+	void RebuildSchemasIfStale();
+
+	// Name -> reference count; FString keys hash and compare case-insensitively
+	TMap<FString, int32> Names[3];
+
+	int32 Revision = 0;
+	// Sum of the hashes of (category, name); updated as names come and go
+	uint32 ContentHash = 0;
+
+	TSharedPtr<FJsonObject> CachedSchema;
+	TSharedPtr<FJsonObject> CachedPlanSchema;
+	int32 CachedSchemaRevision = INDEX_NONE;
+	int32 CachedBaseSchemaRevision = INDEX_NONE;
+	int32 CachedMaxPlanSteps = INDEX_NONE;
+};